@@ -6,6 +6,7 @@
 #include "arena_dyn.h"
 #include "lexer.h"
 #include "parser.h"
+#include "ast_cache.h"
 #include "diagnostics.h"
 #include "evaluator.h"
 #include "event_ir.h"
@@ -294,7 +295,7 @@ static bool nobify_resolve_codegen_contract(Nob_Codegen_Platform requested_platf
 
 static void print_usage(const char *program) {
     nob_log(NOB_INFO,
-            "Usage: %s [--strict] [--tokens] [--ast] [--events] [--platform host|linux|darwin|windows] [--backend auto|posix|win32-msvc] [--source-root path] [--binary-root path] [--out path] [input]",
+            "Usage: %s [--strict] [--tokens] [--ast] [--events] [--platform host|linux|darwin|windows] [--backend auto|posix|win32-msvc] [--source-root path] [--binary-root path] [--ast-cache] [--stream] [--events-spool path] [--events-out path] [--events-in path] [--out path] [input]",
             program);
 }
 
@@ -329,8 +330,9 @@ static Event_Stream *nobify_wrap_stream_with_root(Arena *arena,
     ev.as.directory_enter.binary_dir = binary_dir;
     if (!event_stream_push(wrapped, &ev)) return NULL;
 
-    for (size_t i = 0; i < stream->count; ++i) {
-        if (!event_stream_push(wrapped, &stream->items[i])) return NULL;
+    Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        if (!event_stream_push(wrapped, it.current)) return NULL;
     }
 
     nobify_init_event(&ev, EVENT_DIRECTORY_LEAVE, current_file, 0);
@@ -341,11 +343,55 @@ static Event_Stream *nobify_wrap_stream_with_root(Arena *arena,
     return wrapped;
 }
 
+// Consumer for --stream: build-semantic events go straight into the builder
+// and everything else is printed, spooled or dropped.
+typedef struct {
+    BM_Builder *builder;
+    FILE *spool;
+    bool print_events;
+    bool builder_failed;
+} Nobify_Event_Sink;
+
+static void nobify_event_sink(void *userdata, const Event *ev) {
+    Nobify_Event_Sink *sink = (Nobify_Event_Sink *)userdata;
+    if (!sink || !ev) return;
+    if (sink->print_events) event_dump(stdout, ev);
+    if (event_kind_has_role(ev->h.kind, EVENT_ROLE_BUILD_SEMANTIC)) {
+        if (!sink->builder_failed && !bm_builder_apply_event(sink->builder, ev)) {
+            sink->builder_failed = true;
+        }
+        return;
+    }
+    if (sink->spool) event_dump(sink->spool, ev);
+}
+
+static bool nobify_apply_root_directory_event(BM_Builder *builder,
+                                              Event_Kind kind,
+                                              const char *current_file,
+                                              String_View source_dir,
+                                              String_View binary_dir) {
+    Event ev = {0};
+    nobify_init_event(&ev, kind, current_file, 0);
+    if (kind == EVENT_DIRECTORY_ENTER) {
+        ev.as.directory_enter.source_dir = source_dir;
+        ev.as.directory_enter.binary_dir = binary_dir;
+    } else {
+        ev.as.directory_leave.source_dir = source_dir;
+        ev.as.directory_leave.binary_dir = binary_dir;
+    }
+    return bm_builder_apply_event(builder, &ev);
+}
+
 int main(int argc, char **argv) {
     bool strict_mode = false;
     bool print_tokens = false;
     bool print_ast_tree = false;
     bool print_events = false;
+    bool use_ast_cache = false;
+    bool stream_events = false;
+    const char *events_spool_path = NULL;
+    const char *events_out_path = NULL;
+    const char *events_in_path = NULL;
     const char *input_path = "CMakeLists.txt";
     const char *output_path = NULL;
     const char *source_root_path = NULL;
@@ -376,6 +422,41 @@ int main(int argc, char **argv) {
             print_events = true;
             continue;
         }
+        if (strcmp(argv[i], "--ast-cache") == 0) {
+            use_ast_cache = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--stream") == 0) {
+            stream_events = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--events-spool") == 0) {
+            if (i + 1 >= argc) {
+                nob_log(NOB_ERROR, "Missing value for --events-spool");
+                print_usage(argv[0]);
+                return 1;
+            }
+            events_spool_path = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--events-out") == 0) {
+            if (i + 1 >= argc) {
+                nob_log(NOB_ERROR, "Missing value for --events-out");
+                print_usage(argv[0]);
+                return 1;
+            }
+            events_out_path = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--events-in") == 0) {
+            if (i + 1 >= argc) {
+                nob_log(NOB_ERROR, "Missing value for --events-in");
+                print_usage(argv[0]);
+                return 1;
+            }
+            events_in_path = argv[++i];
+            continue;
+        }
         if (strcmp(argv[i], "--platform") == 0) {
             if (i + 1 >= argc) {
                 nob_log(NOB_ERROR, "Missing value for --platform");
@@ -441,6 +522,24 @@ int main(int argc, char **argv) {
         input_path = argv[i];
     }
 
+    if (events_spool_path && !stream_events) {
+        nob_log(NOB_ERROR, "--events-spool requires --stream");
+        print_usage(argv[0]);
+        return 1;
+    }
+    // --stream keeps only a few families in the stream, so there would be
+    // nothing complete to save; a loaded file replaces evaluation altogether.
+    if (stream_events && (events_out_path || events_in_path)) {
+        nob_log(NOB_ERROR, "--events-out and --events-in cannot be combined with --stream");
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (events_in_path && events_out_path) {
+        nob_log(NOB_ERROR, "--events-out cannot be combined with --events-in");
+        print_usage(argv[0]);
+        return 1;
+    }
+
     if (!output_path) {
         output_path = nob_temp_sprintf("%s/nob.c", nob_temp_dir_name(input_path));
     }
@@ -462,22 +561,27 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    Nob_String_Builder sb_input = {0};
-    if (!nob_read_entire_file(input_path, &sb_input)) {
-        nob_log(NOB_ERROR, "Failed to read input file: %s", input_path);
-        arena_destroy(arena);
-        return 1;
-    }
+    // A saved event file stands in for the whole front end, so the listfile
+    // itself is not needed.
+    String_View content = {0};
+    if (!events_in_path) {
+        Nob_String_Builder sb_input = {0};
+        if (!nob_read_entire_file(input_path, &sb_input)) {
+            nob_log(NOB_ERROR, "Failed to read input file: %s", input_path);
+            arena_destroy(arena);
+            return 1;
+        }
 
-    char *content_cstr = arena_strndup(arena, sb_input.items, sb_input.count);
-    nob_sb_free(sb_input);
-    if (!content_cstr) {
-        nob_log(NOB_ERROR, "Failed to copy input into arena");
-        arena_destroy(arena);
-        return 1;
-    }
+        char *content_cstr = arena_strndup(arena, sb_input.items, sb_input.count);
+        nob_sb_free(sb_input);
+        if (!content_cstr) {
+            nob_log(NOB_ERROR, "Failed to copy input into arena");
+            arena_destroy(arena);
+            return 1;
+        }
 
-    String_View content = nob_sv_from_parts(content_cstr, strlen(content_cstr));
+        content = nob_sv_from_parts(content_cstr, strlen(content_cstr));
+    }
     char *input_dir = arena_strdup(arena, nob_temp_dir_name(input_path));
     char *source_root = NULL;
     char *binary_root = NULL;
@@ -498,50 +602,66 @@ int main(int argc, char **argv) {
         arena_destroy(arena);
         return 1;
     }
-    Lexer lexer = lexer_init(content);
-    Token_List tokens = NULL;
-
-    for (;;) {
-        Token token = lexer_next(&lexer);
-        if (token.kind == TOKEN_END) break;
-
-        if (token.kind == TOKEN_INVALID) {
-            diag_log(
-                DIAG_SEV_ERROR,
-                "lexer",
-                input_path,
-                token.line,
-                token.col,
-                "token",
-                "invalid token",
-                "check quoting, escapes or variable syntax"
-            );
-            arena_destroy(arena);
-            return 1;
-        }
 
-        if (!token_list_append(arena, &tokens, token)) {
-            nob_log(NOB_ERROR, "Out of memory while appending tokens");
-            arena_destroy(arena);
-            return 1;
+    // The on-disk cache is keyed by content, so a hit skips lexing and
+    // parsing entirely. --tokens still needs the token stream.
+    const char *ast_cache_dir = use_ast_cache
+        ? arena_strdup(arena, nob_temp_sprintf("%s/%s", binary_root, AST_CACHE_DEFAULT_SUBDIR))
+        : NULL;
+    Ast_Root ast = NULL;
+    bool ast_from_cache = !events_in_path && ast_cache_dir && !print_tokens && ast_cache_load(arena, ast_cache_dir, content, &ast);
+    if (ast_from_cache) {
+        nob_log(NOB_INFO, "Loaded %zu root nodes from AST cache", arena_arr_len(ast));
+    } else if (!events_in_path) {
+        size_t diags_before = diag_error_count() + diag_warning_count();
+        Lexer lexer = lexer_init(content);
+        Token_List tokens = NULL;
+
+        for (;;) {
+            Token token = lexer_next(&lexer);
+            if (token.kind == TOKEN_END) break;
+
+            if (token.kind == TOKEN_INVALID) {
+                diag_log(
+                    DIAG_SEV_ERROR,
+                    "lexer",
+                    input_path,
+                    token.line,
+                    token.col,
+                    "token",
+                    "invalid token",
+                    "check quoting, escapes or variable syntax"
+                );
+                arena_destroy(arena);
+                return 1;
+            }
+
+            if (!token_list_append(arena, &tokens, token)) {
+                nob_log(NOB_ERROR, "Out of memory while appending tokens");
+                arena_destroy(arena);
+                return 1;
+            }
+
+            if (print_tokens) {
+                nob_log(
+                    NOB_INFO,
+                    "TOKEN|kind=%s|line=%zu|col=%zu|text=%.*s",
+                    token_kind_name(token.kind),
+                    token.line,
+                    token.col,
+                    (int)token.text.count,
+                    token.text.data ? token.text.data : ""
+                );
+            }
         }
 
-        if (print_tokens) {
-            nob_log(
-                NOB_INFO,
-                "TOKEN|kind=%s|line=%zu|col=%zu|text=%.*s",
-                token_kind_name(token.kind),
-                token.line,
-                token.col,
-                (int)token.text.count,
-                token.text.data ? token.text.data : ""
-            );
+        ast = parse_tokens(arena, tokens);
+        nob_log(NOB_INFO, "Parsed %zu tokens into %zu root nodes", arena_arr_len(tokens), arena_arr_len(ast));
+        if (ast_cache_dir && diag_error_count() + diag_warning_count() == diags_before) {
+            (void)ast_cache_store(ast_cache_dir, content, ast);
         }
     }
 
-    Ast_Root ast = parse_tokens(arena, tokens);
-    nob_log(NOB_INFO, "Parsed %zu tokens into %zu root nodes", arena_arr_len(tokens), arena_arr_len(ast));
-
     if (print_ast_tree) {
         print_ast(ast, 0);
     }
@@ -556,73 +676,30 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    Event_Stream *stream = event_stream_create(event_arena);
+    Event_Stream *stream = events_in_path
+        ? event_stream_load_file(event_arena, events_in_path)
+        : event_stream_create(event_arena);
     Event_Stream *build_stream = NULL;
     if (!stream) {
-        nob_log(NOB_ERROR, "Failed to create event stream");
-        arena_destroy(event_arena);
-        arena_destroy(eval_arena);
-        arena_destroy(arena);
-        return 1;
-    }
-
-    EvalSession_Config session_cfg = {0};
-    session_cfg.persistent_arena = event_arena;
-    session_cfg.source_root = sv_from_cstr(source_root);
-    session_cfg.binary_root = sv_from_cstr(binary_root);
-    session_cfg.enable_export_host_effects = false;
-
-    EvalSession *session = eval_session_create(&session_cfg);
-    if (!session) {
-        nob_log(NOB_ERROR, "Failed to create evaluator session");
-        arena_destroy(event_arena);
-        arena_destroy(eval_arena);
-        arena_destroy(arena);
-        return 1;
-    }
-
-    EvalExec_Request eval_request = {0};
-    eval_request.scratch_arena = eval_arena;
-    eval_request.source_dir = sv_from_cstr(source_root);
-    eval_request.binary_dir = sv_from_cstr(binary_root);
-    eval_request.list_file = input_path;
-    eval_request.stream = stream;
-
-    EvalRunResult run_result = eval_session_run(session, &eval_request, ast);
-    if (eval_result_is_fatal(run_result.result)) {
-        nob_log(NOB_ERROR, "Evaluator failed while processing AST");
-        eval_session_destroy(session);
-        arena_destroy(event_arena);
-        arena_destroy(eval_arena);
-        arena_destroy(arena);
-        return 1;
-    }
-    eval_session_destroy(session);
-
-    if (print_events) {
-        event_stream_dump(stream);
-    }
-    nob_log(NOB_INFO,
-            "Semantic Event IR ready: events=%zu",
-            arena_arr_len(stream->items));
-
-    diag_telemetry_emit_summary();
-    (void)diag_telemetry_write_report("nobify_v2_unsupported_commands.log", input_path);
-
-    if (diag_has_errors()) {
-        nob_log(NOB_ERROR, "Finished with %zu error(s) and %zu warning(s)", diag_error_count(), diag_warning_count());
+        if (events_in_path) {
+            nob_log(NOB_ERROR, "Failed to load event file: %s", events_in_path);
+        } else {
+            nob_log(NOB_ERROR, "Failed to create event stream");
+        }
         arena_destroy(event_arena);
         arena_destroy(eval_arena);
         arena_destroy(arena);
         return 1;
     }
-
-    if (diag_has_warnings()) {
-        nob_log(NOB_WARNING, "Finished with %zu warning(s)", diag_warning_count());
-    } else {
-        nob_log(NOB_INFO, "Finished without diagnostics");
+    // Only build-semantic events reach the builder. Trace, state and
+    // diagnostic events are produced only when they are printed, spooled or
+    // saved; diagnostics still reach the log either way.
+    if (!print_events && !events_spool_path && !events_out_path) {
+        event_stream_subscribe(stream, EVENT_ROLE_BUILD_SEMANTIC);
     }
 
+    // The builder exists before evaluation so that --stream can feed it while
+    // the evaluator runs.
     Arena *build_model_arena = arena_create(16 * 1024 * 1024);
     Arena *build_model_validate_arena = arena_create(8 * 1024 * 1024);
     Arena *build_model_freeze_arena = arena_create(16 * 1024 * 1024);
@@ -651,13 +728,87 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    build_stream = nobify_wrap_stream_with_root(event_arena,
-                                                stream,
-                                                input_path,
-                                                eval_request.source_dir,
-                                                eval_request.binary_dir);
-    if (!build_stream) {
-        nob_log(NOB_ERROR, "Failed to wrap semantic events with root directory context");
+    // In streaming mode only the directory and test families stay in the
+    // stream: ctest_*() commands read them back while evaluation runs.
+    Nobify_Event_Sink event_sink = {0};
+    if (stream_events) {
+        event_sink.builder = builder;
+        event_sink.print_events = print_events;
+        if (events_spool_path) {
+            event_sink.spool = fopen(events_spool_path, "w");
+            if (!event_sink.spool) {
+                nob_log(NOB_ERROR, "Failed to open event spool: %s", events_spool_path);
+                arena_destroy(build_model_freeze_arena);
+                arena_destroy(build_model_validate_arena);
+                arena_destroy(build_model_arena);
+                arena_destroy(event_arena);
+                arena_destroy(eval_arena);
+                arena_destroy(arena);
+                return 1;
+            }
+        }
+        event_stream_set_sink(stream,
+                              nobify_event_sink,
+                              &event_sink,
+                              (1u << EVENT_FAMILY_DIRECTORY) | (1u << EVENT_FAMILY_TEST));
+        if (!nobify_apply_root_directory_event(builder,
+                                               EVENT_DIRECTORY_ENTER,
+                                               input_path,
+                                               sv_from_cstr(source_root),
+                                               sv_from_cstr(binary_root))) {
+            event_sink.builder_failed = true;
+        }
+    }
+
+    if (!events_in_path) {
+        EvalSession_Config session_cfg = {0};
+        session_cfg.persistent_arena = event_arena;
+        session_cfg.source_root = sv_from_cstr(source_root);
+        session_cfg.binary_root = sv_from_cstr(binary_root);
+        if (ast_cache_dir) session_cfg.ast_cache_dir = sv_from_cstr(ast_cache_dir);
+        session_cfg.enable_export_host_effects = false;
+
+        EvalSession *session = eval_session_create(&session_cfg);
+        if (!session) {
+            nob_log(NOB_ERROR, "Failed to create evaluator session");
+            if (event_sink.spool) fclose(event_sink.spool);
+            arena_destroy(build_model_freeze_arena);
+            arena_destroy(build_model_validate_arena);
+            arena_destroy(build_model_arena);
+            arena_destroy(event_arena);
+            arena_destroy(eval_arena);
+            arena_destroy(arena);
+            return 1;
+        }
+
+        EvalExec_Request eval_request = {0};
+        eval_request.scratch_arena = eval_arena;
+        eval_request.source_dir = sv_from_cstr(source_root);
+        eval_request.binary_dir = sv_from_cstr(binary_root);
+        eval_request.list_file = input_path;
+        eval_request.stream = stream;
+
+        EvalRunResult run_result = eval_session_run(session, &eval_request, ast);
+        if (event_sink.spool) {
+            fclose(event_sink.spool);
+            event_sink.spool = NULL;
+        }
+        if (eval_result_is_fatal(run_result.result)) {
+            nob_log(NOB_ERROR, "Evaluator failed while processing AST");
+            eval_session_destroy(session);
+            arena_destroy(build_model_freeze_arena);
+            arena_destroy(build_model_validate_arena);
+            arena_destroy(build_model_arena);
+            arena_destroy(event_arena);
+            arena_destroy(eval_arena);
+            arena_destroy(arena);
+            return 1;
+        }
+        eval_session_destroy(session);
+    }
+
+    if (events_out_path && !event_stream_write_file(stream, events_out_path)) {
+        nob_log(NOB_ERROR, "Failed to write event file: %s", events_out_path);
         arena_destroy(build_model_freeze_arena);
         arena_destroy(build_model_validate_arena);
         arena_destroy(build_model_arena);
@@ -666,8 +817,64 @@ int main(int argc, char **argv) {
         arena_destroy(arena);
         return 1;
     }
+    if (print_events && !stream_events) {
+        event_stream_dump(stream);
+    }
+    nob_log(NOB_INFO,
+            "Semantic Event IR ready: events=%zu retained=%zu strings=%zu dedup_saved=%zu bytes",
+            stream->pushed_count,
+            arena_arr_len(stream->records),
+            stream->intern_count,
+            stream->intern_bytes_saved);
+
+    diag_telemetry_emit_summary();
+    (void)diag_telemetry_write_report("nobify_v2_unsupported_commands.log", input_path);
+
+    if (diag_has_errors()) {
+        nob_log(NOB_ERROR, "Finished with %zu error(s) and %zu warning(s)", diag_error_count(), diag_warning_count());
+        arena_destroy(build_model_freeze_arena);
+        arena_destroy(build_model_validate_arena);
+        arena_destroy(build_model_arena);
+        arena_destroy(event_arena);
+        arena_destroy(eval_arena);
+        arena_destroy(arena);
+        return 1;
+    }
+
+    if (diag_has_warnings()) {
+        nob_log(NOB_WARNING, "Finished with %zu warning(s)", diag_warning_count());
+    } else {
+        nob_log(NOB_INFO, "Finished without diagnostics");
+    }
+
+    bool builder_ok = false;
+    if (stream_events) {
+        builder_ok = !event_sink.builder_failed &&
+                     nobify_apply_root_directory_event(builder,
+                                                       EVENT_DIRECTORY_LEAVE,
+                                                       input_path,
+                                                       sv_from_cstr(source_root),
+                                                       sv_from_cstr(binary_root));
+    } else {
+        build_stream = nobify_wrap_stream_with_root(event_arena,
+                                                    stream,
+                                                    input_path,
+                                                    sv_from_cstr(source_root),
+                                                    sv_from_cstr(binary_root));
+        if (!build_stream) {
+            nob_log(NOB_ERROR, "Failed to wrap semantic events with root directory context");
+            arena_destroy(build_model_freeze_arena);
+            arena_destroy(build_model_validate_arena);
+            arena_destroy(build_model_arena);
+            arena_destroy(event_arena);
+            arena_destroy(eval_arena);
+            arena_destroy(arena);
+            return 1;
+        }
+        builder_ok = bm_builder_apply_stream(builder, build_stream);
+    }
 
-    if (!bm_builder_apply_stream(builder, build_stream)) {
+    if (!builder_ok) {
         nob_log(NOB_ERROR, "Build-model builder failed while consuming semantic events");
         arena_destroy(build_model_freeze_arena);
         arena_destroy(build_model_validate_arena);
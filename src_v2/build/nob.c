@@ -429,6 +429,7 @@ static void append_evaluator_sources(Nob_Cmd *cmd) {
         "src_v2/arena/arena.c",
         "src_v2/lexer/lexer.c",
         "src_v2/parser/parser.c",
+        "src_v2/parser/ast_cache.c",
         "src_v2/diagnostics/diagnostics.c",
         "src_v2/transpiler/event_ir.c",
         "src_v2/build_model/build_model_builder.c",
@@ -497,6 +498,7 @@ static void append_evaluator_sources(Nob_Cmd *cmd) {
         "src_v2/evaluator/eval_math.c",
         "src_v2/evaluator/eval_compat.c",
         "src_v2/evaluator/eval_policy_engine.c",
+        "src_v2/evaluator/eval_regex_cache.c",
         "src_v2/evaluator/eval_report.c",
         "src_v2/evaluator/eval_runtime_process.c",
         "src_v2/evaluator/eval_string_text.c",
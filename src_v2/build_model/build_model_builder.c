@@ -164,6 +164,49 @@ bool bm_add_name_index(Arena *arena, BM_Name_Index_Entry **index, String_View na
     return arena_arr_push(arena, *index, entry);
 }
 
+static size_t bm_name_hash_of(String_View name) {
+    size_t hash = (size_t)14695981039346656037ull;
+    for (size_t i = 0; i < name.count; ++i) {
+        hash ^= (unsigned char)name.data[i];
+        hash *= (size_t)1099511628211ull;
+    }
+    return hash;
+}
+
+static size_t bm_name_hash_probe(const BM_Name_Hash *hash, String_View name) {
+    for (size_t slot = bm_name_hash_of(name) & hash->mask;; slot = (slot + 1) & hash->mask) {
+        const BM_Name_Index_Entry *entry = &hash->slots[slot];
+        if (entry->id == UINT32_MAX || nob_sv_eq(entry->name, name)) return slot;
+    }
+}
+
+bool bm_name_hash_build(Arena *arena, const BM_Name_Index_Entry *index, BM_Name_Hash *out) {
+    if (!arena || !out) return false;
+    *out = (BM_Name_Hash){0};
+    size_t count = arena_arr_len(index);
+    if (count == 0) return true;
+
+    size_t capacity = 16;
+    while (capacity < count * 2) capacity <<= 1;
+    BM_Name_Index_Entry *slots = arena_alloc_array(arena, BM_Name_Index_Entry, capacity);
+    if (!slots) return false;
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i] = (BM_Name_Index_Entry){.id = UINT32_MAX};
+    }
+    out->slots = slots;
+    out->mask = capacity - 1;
+    for (size_t i = 0; i < count; ++i) {
+        BM_Name_Index_Entry *entry = &slots[bm_name_hash_probe(out, index[i].name)];
+        if (entry->id == UINT32_MAX) *entry = index[i];
+    }
+    return true;
+}
+
+uint32_t bm_name_hash_find(const BM_Name_Hash *hash, String_View name) {
+    if (!hash || !hash->slots) return UINT32_MAX;
+    return hash->slots[bm_name_hash_probe(hash, name)].id;
+}
+
 bool bm_sv_eq_ci_lit(String_View sv, const char *lit) {
     if (!lit) return false;
     size_t lit_len = strlen(lit);
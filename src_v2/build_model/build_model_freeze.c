@@ -357,6 +357,10 @@ static bool bm_clone_directories(const Build_Model_Draft *draft, Build_Model *mo
     return true;
 }
 
+static BM_Target_Id bm_freeze_find_target_id(const Build_Model *model, String_View name) {
+    return (BM_Target_Id)bm_name_hash_find(&model->target_name_hash, name);
+}
+
 static bool bm_clone_targets(const Build_Model_Draft *draft, Build_Model *model, Arena *arena, Diag_Sink *sink) {
     for (size_t i = 0; i < arena_arr_len(draft->targets); ++i) {
         const BM_Target_Record *src = &draft->targets[i];
@@ -392,30 +396,37 @@ static bool bm_clone_targets(const Build_Model_Draft *draft, Build_Model *model,
             return false;
         }
 
+        if (!arena_arr_push(arena, model->targets, target) ||
+            !bm_add_name_index(arena, &model->target_name_index, target.name, target.id)) {
+            return false;
+        }
+    }
+    if (!bm_name_hash_build(arena, model->target_name_index, &model->target_name_hash)) return false;
+
+    // Aliases and explicit dependencies may name later targets, so they are
+    // resolved once every name is indexed.
+    for (size_t i = 0; i < arena_arr_len(model->targets); ++i) {
+        const BM_Target_Record *src = &draft->targets[i];
+        BM_Target_Record *target = &model->targets[i];
         if (!bm_string_view_is_empty(src->alias_of_name)) {
-            target.alias_of_id = bm_draft_find_target_id(draft, src->alias_of_name);
-            if (target.alias_of_id == BM_TARGET_ID_INVALID) {
+            target->alias_of_id = bm_freeze_find_target_id(model, src->alias_of_name);
+            if (target->alias_of_id == BM_TARGET_ID_INVALID) {
                 bm_diag_error(sink, src->provenance, "build_model_freeze", "freeze", "alias target could not be resolved during freeze", "fix unresolved alias targets before freeze");
                 return false;
             }
-            target.kind = draft->targets[target.alias_of_id].kind;
-            target.alias_global = draft->targets[target.alias_of_id].imported
-                ? draft->targets[target.alias_of_id].imported_global
+            target->kind = draft->targets[target->alias_of_id].kind;
+            target->alias_global = draft->targets[target->alias_of_id].imported
+                ? draft->targets[target->alias_of_id].imported_global
                 : true;
         }
 
         for (size_t dep = 0; dep < arena_arr_len(src->explicit_dependency_names); ++dep) {
-            BM_Target_Id dep_id = bm_draft_find_target_id(draft, src->explicit_dependency_names[dep]);
+            BM_Target_Id dep_id = bm_freeze_find_target_id(model, src->explicit_dependency_names[dep]);
             if (dep_id == BM_TARGET_ID_INVALID) {
                 bm_diag_error(sink, src->provenance, "build_model_freeze", "freeze", "target dependency could not be resolved during freeze", "run validation and fix unresolved explicit dependencies");
                 return false;
             }
-            if (!arena_arr_push(arena, target.explicit_dependency_ids, dep_id)) return false;
-        }
-
-        if (!arena_arr_push(arena, model->targets, target) ||
-            !bm_add_name_index(arena, &model->target_name_index, target.name, target.id)) {
-            return false;
+            if (!arena_arr_push(arena, target->explicit_dependency_ids, dep_id)) return false;
         }
     }
     return true;
@@ -468,8 +479,7 @@ static bool bm_clone_replay_actions(const Build_Model_Draft *draft, Build_Model
     return true;
 }
 
-static bool bm_resolve_build_step_effective_paths(const Build_Model_Draft *draft,
-                                                  Build_Model *model,
+static bool bm_resolve_build_step_effective_paths(Build_Model *model,
                                                   Arena *arena,
                                                   Diag_Sink *sink) {
     for (size_t i = 0; i < arena_arr_len(model->build_steps); ++i) {
@@ -478,7 +488,7 @@ static bool bm_resolve_build_step_effective_paths(const Build_Model_Draft *draft
         if ((size_t)step->owner_directory_id >= arena_arr_len(model->directories)) return false;
         owner_directory = &model->directories[step->owner_directory_id];
         if (!bm_string_view_is_empty(step->owner_target_name)) {
-            step->owner_target_id = bm_draft_find_target_id(draft, step->owner_target_name);
+            step->owner_target_id = bm_freeze_find_target_id(model, step->owner_target_name);
             if (step->owner_target_id == BM_TARGET_ID_INVALID) {
                 bm_diag_error(sink,
                               step->provenance,
@@ -531,28 +541,74 @@ static bool bm_promote_custom_target_kinds(Build_Model *model) {
     return true;
 }
 
-static BM_Build_Step_Id bm_find_producer_step_id_by_path(const Build_Model *model, String_View effective_path) {
-    if (!model) return BM_BUILD_STEP_ID_INVALID;
+static bool bm_sv_has_genex_open(String_View value) {
+    for (size_t i = 0; i + 1 < value.count; ++i) {
+        if (value.data[i] == '$' && value.data[i + 1] == '<') return true;
+    }
+    return false;
+}
+
+static bool bm_index_build_step_producers(Build_Model *model, Arena *arena) {
+    BM_Name_Index_Entry *paths = NULL;
     for (size_t i = 0; i < arena_arr_len(model->build_steps); ++i) {
-        const BM_Build_Step_Record *step = &model->build_steps[i];
+        BM_Build_Step_Record *step = &model->build_steps[i];
         for (size_t output = 0; output < arena_arr_len(step->effective_outputs); ++output) {
-            if (nob_sv_eq(step->effective_outputs[output], effective_path)) return step->id;
+            if (!bm_add_name_index(arena, &paths, step->effective_outputs[output], step->id)) return false;
+            step->has_genex_outputs = step->has_genex_outputs || bm_sv_has_genex_open(step->effective_outputs[output]);
         }
         for (size_t byproduct = 0; byproduct < arena_arr_len(step->effective_byproducts); ++byproduct) {
-            if (nob_sv_eq(step->effective_byproducts[byproduct], effective_path)) return step->id;
+            if (!bm_add_name_index(arena, &paths, step->effective_byproducts[byproduct], step->id)) return false;
+            step->has_genex_outputs = step->has_genex_outputs || bm_sv_has_genex_open(step->effective_byproducts[byproduct]);
         }
+        if (step->has_genex_outputs && !arena_arr_push(arena, model->genex_output_step_ids, step->id)) return false;
     }
-    return BM_BUILD_STEP_ID_INVALID;
+    return bm_name_hash_build(arena, paths, &model->producer_path_hash);
 }
 
-static const BM_Source_Generated_Mark_Record *bm_find_generated_source_mark(const Build_Model_Draft *draft,
-                                                                            String_View effective_path) {
-    if (!draft) return NULL;
-    for (size_t i = 0; i < arena_arr_len(draft->generated_source_marks); ++i) {
+static BM_Build_Step_Id bm_find_producer_step_id_by_path(const Build_Model *model, String_View effective_path) {
+    if (!model) return BM_BUILD_STEP_ID_INVALID;
+    return (BM_Build_Step_Id)bm_name_hash_find(&model->producer_path_hash, effective_path);
+}
+
+// Freeze-only path -> generated-mark table. A path keeps its first mark for
+// lookups; `mark_path_generated` folds every mark on that path together.
+typedef struct {
+    BM_Name_Hash mark_by_path;
+    bool *mark_path_generated;
+} BM_Freeze_Mark_Index;
+
+static bool bm_freeze_mark_index_build(const Build_Model_Draft *draft, Arena *scratch, BM_Freeze_Mark_Index *out) {
+    BM_Name_Index_Entry *marks = NULL;
+    size_t mark_count = 0;
+    if (!draft || !scratch || !out) return false;
+    *out = (BM_Freeze_Mark_Index){0};
+
+    mark_count = arena_arr_len(draft->generated_source_marks);
+    if (mark_count == 0) return true;
+    for (size_t i = 0; i < mark_count; ++i) {
+        if (!bm_add_name_index(scratch, &marks, draft->generated_source_marks[i].path, (uint32_t)i)) return false;
+    }
+    if (!bm_name_hash_build(scratch, marks, &out->mark_by_path)) return false;
+
+    out->mark_path_generated = arena_alloc_array_zero(scratch, bool, mark_count);
+    if (!out->mark_path_generated) return false;
+    for (size_t i = 0; i < mark_count; ++i) {
         const BM_Source_Generated_Mark_Record *mark = &draft->generated_source_marks[i];
-        if (nob_sv_eq(mark->path, effective_path)) return mark;
+        uint32_t first = bm_name_hash_find(&out->mark_by_path, mark->path);
+        if (first == UINT32_MAX) return false;
+        out->mark_path_generated[first] = out->mark_path_generated[first] || mark->generated;
     }
-    return NULL;
+    return true;
+}
+
+static const BM_Source_Generated_Mark_Record *bm_find_generated_source_mark(const Build_Model_Draft *draft,
+                                                                            const BM_Freeze_Mark_Index *marks,
+                                                                            String_View effective_path) {
+    uint32_t index = UINT32_MAX;
+    if (!draft || !marks) return NULL;
+    index = bm_name_hash_find(&marks->mark_by_path, effective_path);
+    if (index == UINT32_MAX) return NULL;
+    return &draft->generated_source_marks[index];
 }
 
 static bool bm_sv_has_path_prefix(String_View value, String_View prefix) {
@@ -614,15 +670,15 @@ static BM_Target_Id bm_freeze_resolve_alias_target_id(const Build_Model *model,
     return BM_TARGET_ID_INVALID;
 }
 
-static bool bm_resolve_link_item_target_ids(const Build_Model_Draft *draft, Build_Model *model) {
-    if (!draft || !model) return false;
+static bool bm_resolve_link_item_target_ids(Build_Model *model) {
+    if (!model) return false;
 
     for (size_t i = 0; i < arena_arr_len(model->targets); ++i) {
         for (size_t item_index = 0; item_index < arena_arr_len(model->targets[i].link_libraries); ++item_index) {
             BM_Link_Item_View *item = &model->targets[i].link_libraries[item_index];
             BM_Target_Id target_id = BM_TARGET_ID_INVALID;
             if (item->semantic.kind != EVENT_LINK_ITEM_TARGET_REF || item->semantic.target_name.count == 0) continue;
-            target_id = bm_draft_find_target_id(draft, item->semantic.target_name);
+            target_id = bm_freeze_find_target_id(model, item->semantic.target_name);
             if (bm_target_id_is_valid(target_id)) target_id = bm_freeze_resolve_alias_target_id(model, target_id);
             item->target_id = target_id;
         }
@@ -633,7 +689,7 @@ static bool bm_resolve_link_item_target_ids(const Build_Model_Draft *draft, Buil
             BM_Link_Item_View *item = &model->directories[i].link_libraries[item_index];
             BM_Target_Id target_id = BM_TARGET_ID_INVALID;
             if (item->semantic.kind != EVENT_LINK_ITEM_TARGET_REF || item->semantic.target_name.count == 0) continue;
-            target_id = bm_draft_find_target_id(draft, item->semantic.target_name);
+            target_id = bm_freeze_find_target_id(model, item->semantic.target_name);
             if (bm_target_id_is_valid(target_id)) target_id = bm_freeze_resolve_alias_target_id(model, target_id);
             item->target_id = target_id;
         }
@@ -643,7 +699,7 @@ static bool bm_resolve_link_item_target_ids(const Build_Model_Draft *draft, Buil
         BM_Link_Item_View *item = &model->global_properties.link_libraries[i];
         BM_Target_Id target_id = BM_TARGET_ID_INVALID;
         if (item->semantic.kind != EVENT_LINK_ITEM_TARGET_REF || item->semantic.target_name.count == 0) continue;
-        target_id = bm_draft_find_target_id(draft, item->semantic.target_name);
+        target_id = bm_freeze_find_target_id(model, item->semantic.target_name);
         if (bm_target_id_is_valid(target_id)) target_id = bm_freeze_resolve_alias_target_id(model, target_id);
         item->target_id = target_id;
     }
@@ -651,9 +707,7 @@ static bool bm_resolve_link_item_target_ids(const Build_Model_Draft *draft, Buil
     return true;
 }
 
-static bool bm_resolve_build_step_dependencies(const Build_Model_Draft *draft,
-                                               Build_Model *model,
-                                               Arena *arena) {
+static bool bm_resolve_build_step_dependencies(Build_Model *model, Arena *arena) {
     for (size_t i = 0; i < arena_arr_len(model->build_steps); ++i) {
         BM_Build_Step_Record *step = &model->build_steps[i];
         const BM_Directory_Record *owner_directory = &model->directories[step->owner_directory_id];
@@ -661,7 +715,7 @@ static bool bm_resolve_build_step_dependencies(const Build_Model_Draft *draft,
             BM_Build_Step_Dependency_Record *record = &step->dependencies[dep];
             String_View token = record->raw_token;
             if (record->kind == BM_BUILD_STEP_DEP_TARGET_REF) {
-                BM_Target_Id target_id = bm_draft_find_target_id(draft, record->target_name);
+                BM_Target_Id target_id = bm_freeze_find_target_id(model, record->target_name);
                 if (bm_target_id_is_valid(target_id)) target_id = bm_freeze_resolve_alias_target_id(model, target_id);
                 record->target_id = target_id;
                 if (!bm_target_id_is_valid(target_id)) continue;
@@ -886,6 +940,7 @@ static bool bm_materialize_imported_target_metadata(Build_Model *model, Arena *a
 
 static bool bm_resolve_target_source_records(const Build_Model_Draft *draft,
                                              Build_Model *model,
+                                             const BM_Freeze_Mark_Index *marks,
                                              Arena *arena) {
     for (size_t i = 0; i < arena_arr_len(model->targets); ++i) {
         BM_Target_Record *target = &model->targets[i];
@@ -919,12 +974,12 @@ static bool bm_resolve_target_source_records(const Build_Model_Draft *draft,
                 !nob_sv_eq(source_stripped_effective, nob_sv_from_cstr("."))) {
                 stripped_producer_id = bm_find_producer_step_id_by_path(model, source_stripped_effective);
             }
-            direct_mark = bm_find_generated_source_mark(draft, direct_effective);
-            source_mark = bm_find_generated_source_mark(draft, source_effective);
-            binary_mark = bm_find_generated_source_mark(draft, binary_effective);
+            direct_mark = bm_find_generated_source_mark(draft, marks, direct_effective);
+            source_mark = bm_find_generated_source_mark(draft, marks, source_effective);
+            binary_mark = bm_find_generated_source_mark(draft, marks, binary_effective);
             if (source_stripped_effective.count > 0 &&
                 !nob_sv_eq(source_stripped_effective, nob_sv_from_cstr("."))) {
-                stripped_mark = bm_find_generated_source_mark(draft, source_stripped_effective);
+                stripped_mark = bm_find_generated_source_mark(draft, marks, source_stripped_effective);
             }
 
             source->effective_path = source_effective;
@@ -962,16 +1017,15 @@ static bool bm_resolve_target_source_records(const Build_Model_Draft *draft,
     return true;
 }
 
-static bool bm_apply_generated_source_marks(const Build_Model_Draft *draft, Build_Model *model) {
-    for (size_t mark_index = 0; mark_index < arena_arr_len(draft->generated_source_marks); ++mark_index) {
-        const BM_Source_Generated_Mark_Record *mark = &draft->generated_source_marks[mark_index];
-        for (size_t target_index = 0; target_index < arena_arr_len(model->targets); ++target_index) {
-            BM_Target_Record *target = &model->targets[target_index];
-            for (size_t source_index = 0; source_index < arena_arr_len(target->source_records); ++source_index) {
-                BM_Target_Source_Record *source = &target->source_records[source_index];
-                if (!nob_sv_eq(source->effective_path, mark->path)) continue;
-                source->generated = mark->generated || source->generated;
-            }
+static bool bm_apply_generated_source_marks(Build_Model *model, const BM_Freeze_Mark_Index *marks) {
+    if (!marks->mark_path_generated) return true;
+    for (size_t target_index = 0; target_index < arena_arr_len(model->targets); ++target_index) {
+        BM_Target_Record *target = &model->targets[target_index];
+        for (size_t source_index = 0; source_index < arena_arr_len(target->source_records); ++source_index) {
+            BM_Target_Source_Record *source = &target->source_records[source_index];
+            uint32_t mark_index = bm_name_hash_find(&marks->mark_by_path, source->effective_path);
+            if (mark_index == UINT32_MAX) continue;
+            source->generated = marks->mark_path_generated[mark_index] || source->generated;
         }
     }
     return true;
@@ -1218,7 +1272,7 @@ static bool bm_clone_tests(const Build_Model_Draft *draft, Build_Model *model, A
             return false;
         }
     }
-    return true;
+    return bm_name_hash_build(arena, model->test_name_index, &model->test_name_hash);
 }
 
 static bool bm_clone_install_rules(const Build_Model_Draft *draft, Build_Model *model, Arena *arena, Diag_Sink *sink) {
@@ -1245,7 +1299,7 @@ static bool bm_clone_install_rules(const Build_Model_Draft *draft, Build_Model *
             return false;
         }
         if (src->kind == BM_INSTALL_RULE_TARGET) {
-            rule.resolved_target_id = bm_draft_find_target_id(draft, src->item);
+            rule.resolved_target_id = bm_freeze_find_target_id(model, src->item);
             if (rule.resolved_target_id == BM_TARGET_ID_INVALID) {
                 bm_diag_error(sink, src->provenance, "build_model_freeze", "freeze", "install rule target could not be resolved during freeze", "fix unresolved install target names before freeze");
                 return false;
@@ -1291,7 +1345,7 @@ static bool bm_clone_exports(const Build_Model_Draft *draft, Build_Model *model,
             }
         } else if (src->kind == BM_EXPORT_BUILD_TREE) {
             for (size_t target_index = 0; target_index < arena_arr_len(src->target_names); ++target_index) {
-                BM_Target_Id target_id = bm_draft_find_target_id(draft, src->target_names[target_index]);
+                BM_Target_Id target_id = bm_freeze_find_target_id(model, src->target_names[target_index]);
                 if (target_id == BM_TARGET_ID_INVALID) {
                     bm_diag_error(sink,
                                   src->provenance,
@@ -1321,7 +1375,7 @@ static bool bm_clone_packages(const Build_Model_Draft *draft, Build_Model *model
             return false;
         }
     }
-    return true;
+    return bm_name_hash_build(arena, model->package_name_index, &model->package_name_hash);
 }
 
 static bool bm_clone_cpack(const Build_Model_Draft *draft, Build_Model *model, Arena *arena, Diag_Sink *sink) {
@@ -1715,7 +1769,9 @@ const Build_Model *bm_freeze_draft(const Build_Model_Draft *draft,
                                    Arena *out_arena,
                                    Diag_Sink *sink) {
     Build_Model *model = NULL;
+    Arena *marks_arena = NULL;
     Arena *validate_arena = NULL;
+    BM_Freeze_Mark_Index marks = {0};
     bool had_error = false;
     if (!draft || !out_arena) return NULL;
     if (!bm_freeze_check_invariants(draft, sink)) return NULL;
@@ -1741,14 +1797,26 @@ const Build_Model *bm_freeze_draft(const Build_Model_Draft *draft,
         return NULL;
     }
 
-    if (!bm_resolve_build_step_effective_paths(draft, model, out_arena, sink) ||
-        !bm_resolve_link_item_target_ids(draft, model) ||
+    if (!bm_resolve_build_step_effective_paths(model, out_arena, sink) ||
+        !bm_index_build_step_producers(model, out_arena) ||
+        !bm_resolve_link_item_target_ids(model) ||
         !bm_materialize_imported_target_metadata(model, out_arena) ||
         !bm_promote_custom_target_kinds(model) ||
-        !bm_resolve_build_step_dependencies(draft, model, out_arena) ||
-        !bm_resolve_target_source_records(draft, model, out_arena) ||
-        !bm_apply_generated_source_marks(draft, model) ||
-        !bm_apply_source_property_mutations(draft, model, out_arena) ||
+        !bm_resolve_build_step_dependencies(model, out_arena)) {
+        return NULL;
+    }
+
+    marks_arena = arena_create(256 * 1024);
+    if (!marks_arena) return NULL;
+    if (!bm_freeze_mark_index_build(draft, marks_arena, &marks) ||
+        !bm_resolve_target_source_records(draft, model, &marks, out_arena) ||
+        !bm_apply_generated_source_marks(model, &marks)) {
+        arena_destroy(marks_arena);
+        return NULL;
+    }
+    arena_destroy(marks_arena);
+
+    if (!bm_apply_source_property_mutations(draft, model, out_arena) ||
         !bm_populate_target_file_sets(model, out_arena) ||
         !bm_collect_known_configurations(model, out_arena)) {
         return NULL;
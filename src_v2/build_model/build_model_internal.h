@@ -16,6 +16,14 @@ typedef struct {
     uint32_t id;
 } BM_Name_Index_Entry;
 
+// Read-only open-addressed table over a name index, built once at freeze.
+// Empty slots carry UINT32_MAX as id. A repeated name keeps its first id,
+// as the linear scans it replaces did.
+typedef struct {
+    BM_Name_Index_Entry *slots;
+    size_t mask; // capacity - 1; 0 with no slots
+} BM_Name_Hash;
+
 typedef struct BM_Raw_Property_Record BM_Raw_Property_Record;
 
 typedef struct {
@@ -112,6 +120,7 @@ typedef struct {
     BM_Build_Step_Id *resolved_producer_dependencies;
     String_View *resolved_file_dependencies;
     BM_Build_Step_Command_Record *commands;
+    bool has_genex_outputs; // some effective output or byproduct contains a generator expression
 } BM_Build_Step_Record;
 
 typedef struct {
@@ -421,6 +430,13 @@ struct Build_Model {
     BM_Name_Index_Entry *target_name_index;
     BM_Name_Index_Entry *test_name_index;
     BM_Name_Index_Entry *package_name_index;
+    BM_Name_Hash target_name_hash;
+    BM_Name_Hash test_name_hash;
+    BM_Name_Hash package_name_hash;
+    // Effective output/byproduct path -> producing step, plus the steps whose
+    // paths only resolve under a query context and must still be scanned.
+    BM_Name_Hash producer_path_hash;
+    BM_Build_Step_Id *genex_output_step_ids;
 };
 
 struct BM_Builder {
@@ -435,6 +451,8 @@ bool bm_copy_string(Arena *arena, String_View input, String_View *out);
 BM_Provenance bm_provenance_from_event(Arena *arena, const Event *ev);
 bool bm_split_cmake_list(Arena *arena, String_View raw, String_View **out_items);
 bool bm_add_name_index(Arena *arena, BM_Name_Index_Entry **index, String_View name, uint32_t id);
+bool bm_name_hash_build(Arena *arena, const BM_Name_Index_Entry *index, BM_Name_Hash *out);
+uint32_t bm_name_hash_find(const BM_Name_Hash *hash, String_View name);
 bool bm_sv_eq_ci_lit(String_View sv, const char *lit);
 bool bm_sv_truthy(String_View sv);
 bool bm_string_view_is_empty(String_View sv);
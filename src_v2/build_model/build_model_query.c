@@ -196,10 +196,7 @@ static const BM_Raw_Property_Record *bm_find_raw_property(const BM_Raw_Property_
 
 static BM_Target_Id bm_find_target_by_name_id(const Build_Model *model, String_View name) {
     if (!model) return BM_TARGET_ID_INVALID;
-    for (size_t i = 0; i < arena_arr_len(model->target_name_index); ++i) {
-        if (nob_sv_eq(model->target_name_index[i].name, name)) return (BM_Target_Id)model->target_name_index[i].id;
-    }
-    return BM_TARGET_ID_INVALID;
+    return (BM_Target_Id)bm_name_hash_find(&model->target_name_hash, name);
 }
 
 static BM_Query_Eval_Context bm_default_query_eval_context(BM_Target_Id current_target_id,
@@ -1522,18 +1519,12 @@ BM_Target_Id bm_query_target_by_name(const Build_Model *model, String_View name)
 
 BM_Test_Id bm_query_test_by_name(const Build_Model *model, String_View name) {
     if (!model) return BM_TEST_ID_INVALID;
-    for (size_t i = 0; i < arena_arr_len(model->test_name_index); ++i) {
-        if (nob_sv_eq(model->test_name_index[i].name, name)) return (BM_Test_Id)model->test_name_index[i].id;
-    }
-    return BM_TEST_ID_INVALID;
+    return (BM_Test_Id)bm_name_hash_find(&model->test_name_hash, name);
 }
 
 BM_Package_Id bm_query_package_by_name(const Build_Model *model, String_View name) {
     if (!model) return BM_PACKAGE_ID_INVALID;
-    for (size_t i = 0; i < arena_arr_len(model->package_name_index); ++i) {
-        if (nob_sv_eq(model->package_name_index[i].name, name)) return (BM_Package_Id)model->package_name_index[i].id;
-    }
-    return BM_PACKAGE_ID_INVALID;
+    return (BM_Package_Id)bm_name_hash_find(&model->package_name_hash, name);
 }
 
 String_View bm_query_target_name(const Build_Model *model, BM_Target_Id id) {
@@ -2408,17 +2399,33 @@ static bool bm_query_build_step_dependency_matches_producer(const Build_Model *m
                                                             String_View resolved_path,
                                                             BM_Build_Step_Id **producer_deps,
                                                             bool *matched) {
+    BM_Build_Step_Id literal_id = BM_BUILD_STEP_ID_INVALID;
+    BM_Build_Step_Id match_id = BM_BUILD_STEP_ID_INVALID;
     if (matched) *matched = false;
     if (!model || !scratch || !producer_deps || !matched || resolved_path.count == 0) return false;
-    for (size_t candidate = 0; candidate < arena_arr_len(model->build_steps); ++candidate) {
-        BM_Build_Step_Id candidate_id = (BM_Build_Step_Id)candidate;
+
+    // Paths without generator expressions resolve to themselves, so their
+    // producer comes from the freeze-time hash. Only steps with genex paths
+    // are resolved here, and only those ahead of the hashed producer, which
+    // keeps the lowest matching step id as before.
+    literal_id = (BM_Build_Step_Id)bm_name_hash_find(&model->producer_path_hash, resolved_path);
+    if (bm_build_step_id_is_valid(literal_id) &&
+        (literal_id == self_id || model->build_steps[literal_id].has_genex_outputs)) {
+        literal_id = BM_BUILD_STEP_ID_INVALID;
+    }
+    for (size_t i = 0; i < arena_arr_len(model->genex_output_step_ids); ++i) {
+        BM_Build_Step_Id candidate_id = model->genex_output_step_ids[i];
+        if (bm_build_step_id_is_valid(literal_id) && candidate_id > literal_id) break;
         if (candidate_id == self_id) continue;
         if (bm_query_build_step_resolved_path_matches(model, candidate_id, ctx, scratch, resolved_path)) {
-            if (!bm_query_push_unique_step_id(scratch, producer_deps, candidate_id)) return false;
-            *matched = true;
-            return true;
+            match_id = candidate_id;
+            break;
         }
     }
+    if (!bm_build_step_id_is_valid(match_id)) match_id = literal_id;
+    if (!bm_build_step_id_is_valid(match_id)) return true;
+    if (!bm_query_push_unique_step_id(scratch, producer_deps, match_id)) return false;
+    *matched = true;
     return true;
 }
 
@@ -2534,14 +2541,14 @@ bool bm_query_build_step_effective_view(const Build_Model *model,
         if (matched_producer) continue;
         if (!bm_query_resolve_build_step_dependency_token(model, step, ctx, scratch, record->raw_token, &resolved)) return false;
         if (resolved.count == 0) continue;
-        for (size_t candidate = 0; candidate < arena_arr_len(model->build_steps); ++candidate) {
-            BM_Build_Step_Id candidate_id = (BM_Build_Step_Id)candidate;
-            if (candidate_id == id) continue;
-            if (bm_query_build_step_resolved_path_matches(model, candidate_id, ctx, scratch, resolved)) {
-                if (!bm_query_push_unique_step_id(scratch, &producer_deps, candidate_id)) return false;
-                matched_producer = true;
-                break;
-            }
+        if (!bm_query_build_step_dependency_matches_producer(model,
+                                                             id,
+                                                             ctx,
+                                                             scratch,
+                                                             resolved,
+                                                             &producer_deps,
+                                                             &matched_producer)) {
+            return false;
         }
         if (!matched_producer && !bm_query_push_unique_sv(scratch, &file_deps, resolved)) return false;
     }
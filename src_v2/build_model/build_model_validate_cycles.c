@@ -63,14 +63,57 @@ static bool bm_build_step_produces_path(const BM_Build_Step_Record *step, String
     return false;
 }
 
+// Flags every output/byproduct slot whose path also appears in another slot,
+// numbering slots step by step, outputs before byproducts. Only flagged slots
+// need the pairwise scan below, which keeps producer-heavy models linear.
+static bool bm_collect_repeated_producer_paths(const Build_Model *model,
+                                               Arena *scratch,
+                                               bool **out_repeated) {
+    BM_Name_Index_Entry *paths = NULL;
+    BM_Name_Hash hash = {0};
+    bool *repeated = NULL;
+    size_t count = 0;
+    if (!model || !scratch || !out_repeated) return false;
+    *out_repeated = NULL;
+
+    for (size_t i = 0; i < arena_arr_len(model->build_steps); ++i) {
+        const BM_Build_Step_Record *step = &model->build_steps[i];
+        for (size_t j = 0; j < arena_arr_len(step->effective_outputs); ++j) {
+            if (!bm_add_name_index(scratch, &paths, step->effective_outputs[j], (uint32_t)count++)) return false;
+        }
+        for (size_t j = 0; j < arena_arr_len(step->effective_byproducts); ++j) {
+            if (!bm_add_name_index(scratch, &paths, step->effective_byproducts[j], (uint32_t)count++)) return false;
+        }
+    }
+    if (count == 0) return true;
+    if (!bm_name_hash_build(scratch, paths, &hash)) return false;
+    repeated = arena_alloc_array_zero(scratch, bool, count);
+    if (!repeated) return false;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t first = bm_name_hash_find(&hash, paths[i].name);
+        if (first == UINT32_MAX) return false;
+        if (first == paths[i].id) continue;
+        repeated[first] = true;
+        repeated[i] = true;
+    }
+    *out_repeated = repeated;
+    return true;
+}
+
 static bool bm_validate_duplicate_step_producers(const Build_Model *model,
+                                                 Arena *scratch,
                                                  Diag_Sink *sink,
                                                  bool *had_error) {
+    bool *repeated = NULL;
+    size_t slot = 0;
     if (!model || !had_error) return false;
+    if (!bm_collect_repeated_producer_paths(model, scratch, &repeated)) return false;
+    if (!repeated) return true;
     for (size_t i = 0; i < arena_arr_len(model->build_steps); ++i) {
         const BM_Build_Step_Record *lhs = &model->build_steps[i];
         for (size_t j = 0; j < arena_arr_len(lhs->effective_outputs); ++j) {
             String_View lhs_path = lhs->effective_outputs[j];
+            if (!repeated[slot++]) continue;
             for (size_t k = 0; k < arena_arr_len(model->build_steps); ++k) {
                 const BM_Build_Step_Record *rhs = &model->build_steps[k];
                 size_t start = (i == k) ? (j + 1) : 0;
@@ -98,6 +141,7 @@ static bool bm_validate_duplicate_step_producers(const Build_Model *model,
         }
         for (size_t j = 0; j < arena_arr_len(lhs->effective_byproducts); ++j) {
             String_View lhs_path = lhs->effective_byproducts[j];
+            if (!repeated[slot++]) continue;
             for (size_t k = 0; k < arena_arr_len(model->build_steps); ++k) {
                 const BM_Build_Step_Record *rhs = &model->build_steps[k];
                 size_t output_start = 0;
@@ -464,7 +508,7 @@ bool bm_validate_execution_graph(const Build_Model *model,
                                  Diag_Sink *sink,
                                  bool *had_error) {
     if (!model || !scratch || !had_error) return false;
-    if (!bm_validate_duplicate_step_producers(model, sink, had_error) ||
+    if (!bm_validate_duplicate_step_producers(model, scratch, sink, had_error) ||
         !bm_validate_step_owner_contracts(model, sink, had_error) ||
         !bm_validate_target_source_producers(model, sink, had_error) ||
         !bm_validate_execution_cycles(model, scratch, sink, had_error)) {
@@ -129,8 +129,13 @@ static bool cg_is_bare_library_name(String_View sv) {
 }
 
 static char *cg_arena_vsprintf(Arena *scratch, const char *fmt, va_list ap) {
+    // The copy lives in `scratch`, so the temporary allocator is handed back
+    // right away instead of growing with the size of the model.
+    size_t temp_mark = nob_temp_save();
     char *tmp = nob_temp_vsprintf(fmt, ap);
-    return tmp ? arena_strdup(scratch, tmp) : NULL;
+    char *out = tmp ? arena_strdup(scratch, tmp) : NULL;
+    nob_temp_rewind(temp_mark);
+    return out;
 }
 
 static char *cg_arena_sprintf(Arena *scratch, const char *fmt, ...) {
@@ -623,10 +628,11 @@ static bool cg_init_targets(CG_Context *ctx) {
         }
 
         info->emits_artifact = !info->alias && !info->imported && cg_target_is_supported_concrete(info->kind);
-        if (info->emits_artifact && !cg_init_target_artifact_branches(ctx, info)) {
-            return false;
-        }
-        if (!cg_compute_target_state_path(ctx, info, &info->state_path)) return false;
+        size_t temp_mark = nob_temp_save();
+        bool ok = (!info->emits_artifact || cg_init_target_artifact_branches(ctx, info)) &&
+                  cg_compute_target_state_path(ctx, info, &info->state_path);
+        nob_temp_rewind(temp_mark);
+        if (!ok) return false;
     }
 
     for (size_t i = 0; i < ctx->target_count; ++i) {
@@ -700,11 +706,14 @@ static bool cg_init_build_steps(CG_Context *ctx) {
         info->kind = bm_query_build_step_kind(ctx->model, id);
         info->owner_directory_id = bm_query_build_step_owner_directory(ctx->model, id);
         info->owner_target_id = bm_query_build_step_owner_target(ctx->model, id);
+        size_t temp_mark = nob_temp_save();
         info->ident = cg_make_identifier(ctx->scratch,
                                          nob_sv_from_cstr(nob_temp_sprintf("step_%u", (unsigned)id)),
                                          i);
-        if (!info->ident) return false;
-        if (!cg_compute_step_sentinel_path(ctx, id, &info->sentinel_path, &info->uses_stamp)) return false;
+        bool ok = info->ident &&
+                  cg_compute_step_sentinel_path(ctx, id, &info->sentinel_path, &info->uses_stamp);
+        nob_temp_rewind(temp_mark);
+        if (!ok) return false;
     }
     return true;
 }
@@ -2480,15 +2489,24 @@ bool nob_codegen_render(const Build_Model *model,
         return false;
     }
 
+    // Each function is appended to `out` before the next one starts, so the
+    // temporary allocator is rewound per step/target instead of accumulating
+    // across the whole model.
     for (size_t i = 0; i < ctx.build_step_count; ++i) {
-        if (!cg_emit_step_function(&ctx, &ctx.build_steps[i], out)) {
+        size_t temp_mark = nob_temp_save();
+        bool ok = cg_emit_step_function(&ctx, &ctx.build_steps[i], out);
+        nob_temp_rewind(temp_mark);
+        if (!ok) {
             nob_log(NOB_ERROR, "codegen: failed while emitting build step %" PRIu64, (uint64_t)ctx.build_steps[i].id);
             return false;
         }
     }
 
     for (size_t i = 0; i < ctx.target_count; ++i) {
-        if (!cg_emit_target_function(&ctx, &ctx.targets[i], out)) {
+        size_t temp_mark = nob_temp_save();
+        bool ok = cg_emit_target_function(&ctx, &ctx.targets[i], out);
+        nob_temp_rewind(temp_mark);
+        if (!ok) {
             nob_log(NOB_ERROR, "codegen: failed while emitting target %" PRIu64, (uint64_t)ctx.targets[i].id);
             return false;
         }
@@ -467,24 +467,47 @@ static bool cg_emit_replay_configure_helpers(CG_Context *ctx, Nob_String_Builder
             "        0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au,\n"
             "        0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u\n"
             "    };\n"
-            "    Nob_String_Builder sb = {0};\n"
+            "    static unsigned char chunk[64u * 1024u];\n"
+            "    FILE *f = NULL;\n"
             "    uint32_t state[8] = {0};\n"
             "    unsigned char tail[128] = {0};\n"
             "    unsigned char digest[32] = {0};\n"
+            "    uint64_t total = 0;\n"
             "    uint64_t bits = 0;\n"
-            "    size_t full_blocks = 0;\n"
             "    size_t rem = 0;\n"
+            "    size_t got = 0;\n"
+            "    bool read_failed = false;\n"
             "    if (!path || !out_hex) return false;\n"
             "    memcpy(state, init, sizeof(state));\n"
-            "    if (!nob_read_entire_file(path, &sb)) {\n"
+            "    f = fopen(path, \"rb\");\n"
+            "    if (!f) {\n"
             "        nob_log(NOB_ERROR, \"configure: failed to read %s for SHA256 verification\", path);\n"
             "        return false;\n"
             "    }\n"
-            "    bits = (uint64_t)sb.count * 8ull;\n"
-            "    full_blocks = sb.count / 64u;\n"
-            "    rem = sb.count % 64u;\n"
-            "    for (size_t i = 0; i < full_blocks; ++i) replay_sha256_process_block(state, (const unsigned char *)sb.items + i * 64u);\n"
-            "    if (rem > 0) memcpy(tail, (const unsigned char *)sb.items + full_blocks * 64u, rem);\n"
+            "    while ((got = fread(chunk, 1, sizeof(chunk), f)) > 0) {\n"
+            "        size_t off = 0;\n"
+            "        total += got;\n"
+            "        if (rem > 0) {\n"
+            "            size_t take = 64u - rem < got ? 64u - rem : got;\n"
+            "            memcpy(tail + rem, chunk, take);\n"
+            "            rem += take;\n"
+            "            off = take;\n"
+            "            if (rem < 64u) continue;\n"
+            "            replay_sha256_process_block(state, tail);\n"
+            "            rem = 0;\n"
+            "        }\n"
+            "        for (; off + 64u <= got; off += 64u) replay_sha256_process_block(state, chunk + off);\n"
+            "        rem = got - off;\n"
+            "        if (rem > 0) memcpy(tail, chunk + off, rem);\n"
+            "    }\n"
+            "    read_failed = ferror(f) != 0;\n"
+            "    fclose(f);\n"
+            "    if (read_failed) {\n"
+            "        nob_log(NOB_ERROR, \"configure: failed to read %s for SHA256 verification\", path);\n"
+            "        return false;\n"
+            "    }\n"
+            "    bits = total * 8ull;\n"
+            "    memset(tail + rem, 0, sizeof(tail) - rem);\n"
             "    tail[rem] = 0x80u;\n"
             "    if (rem + 1u > 56u) {\n"
             "        replay_sha256_process_block(state, tail);\n"
@@ -499,7 +522,6 @@ static bool cg_emit_replay_configure_helpers(CG_Context *ctx, Nob_String_Builder
             "    tail[62] = (unsigned char)((bits >> 8) & 0xffu);\n"
             "    tail[63] = (unsigned char)(bits & 0xffu);\n"
             "    replay_sha256_process_block(state, tail);\n"
-            "    nob_sb_free(sb);\n"
             "    for (size_t i = 0; i < 8; ++i) {\n"
             "        digest[i * 4 + 0] = (unsigned char)((state[i] >> 24) & 0xffu);\n"
             "        digest[i * 4 + 1] = (unsigned char)((state[i] >> 16) & 0xffu);\n"
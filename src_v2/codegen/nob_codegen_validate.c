@@ -211,6 +211,42 @@ static bool cg_validate_package_model(CG_Context *ctx) {
     return true;
 }
 
+static bool cg_validate_target(CG_Context *ctx, const CG_Target_Info *info) {
+    if (!cg_reject_unsupported_precompile_headers(ctx, info) ||
+        !cg_reject_unsupported_platform_target_properties(ctx, info)) {
+        return false;
+    }
+
+    if (!info->alias && !info->imported && info->emits_artifact) {
+        CG_Source_Info *sources = NULL;
+        String_View *compile_args = NULL;
+        String_View *link_args = NULL;
+        String_View *link_rebuild_inputs = NULL;
+        if (!cg_collect_compile_sources(ctx, info->id, &sources)) return false;
+        for (size_t branch = 0; branch <= arena_arr_len(ctx->known_configs); ++branch) {
+            String_View config = branch < arena_arr_len(ctx->known_configs) ? ctx->known_configs[branch] : nob_sv_from_cstr("");
+            for (size_t source_index = 0; source_index < arena_arr_len(sources); ++source_index) {
+                compile_args = NULL;
+                if (!cg_collect_compile_args(ctx,
+                                             info->id,
+                                             config,
+                                             &sources[source_index],
+                                             &compile_args)) {
+                    return false;
+                }
+            }
+            link_args = NULL;
+            link_rebuild_inputs = NULL;
+            if (!cg_collect_link_dir_args(ctx, info->id, config, &link_args) ||
+                !cg_collect_link_option_args(ctx, info->id, config, &link_args) ||
+                !cg_collect_link_library_args(ctx, info->id, config, &link_args, &link_rebuild_inputs)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 bool cg_validate_model_for_backend(CG_Context *ctx) {
     if (!ctx) return false;
 
@@ -271,39 +307,11 @@ bool cg_validate_model_for_backend(CG_Context *ctx) {
     }
 
     for (size_t i = 0; i < ctx->target_count; ++i) {
-        const CG_Target_Info *info = &ctx->targets[i];
-        if (!cg_reject_unsupported_precompile_headers(ctx, info) ||
-            !cg_reject_unsupported_platform_target_properties(ctx, info)) {
-            return false;
-        }
-
-        if (!info->alias && !info->imported && info->emits_artifact) {
-            CG_Source_Info *sources = NULL;
-            String_View *compile_args = NULL;
-            String_View *link_args = NULL;
-            String_View *link_rebuild_inputs = NULL;
-            if (!cg_collect_compile_sources(ctx, info->id, &sources)) return false;
-            for (size_t branch = 0; branch <= arena_arr_len(ctx->known_configs); ++branch) {
-                String_View config = branch < arena_arr_len(ctx->known_configs) ? ctx->known_configs[branch] : nob_sv_from_cstr("");
-                for (size_t source_index = 0; source_index < arena_arr_len(sources); ++source_index) {
-                    compile_args = NULL;
-                    if (!cg_collect_compile_args(ctx,
-                                                 info->id,
-                                                 config,
-                                                 &sources[source_index],
-                                                 &compile_args)) {
-                        return false;
-                    }
-                }
-                link_args = NULL;
-                link_rebuild_inputs = NULL;
-                if (!cg_collect_link_dir_args(ctx, info->id, config, &link_args) ||
-                    !cg_collect_link_option_args(ctx, info->id, config, &link_args) ||
-                    !cg_collect_link_library_args(ctx, info->id, config, &link_args, &link_rebuild_inputs)) {
-                    return false;
-                }
-            }
-        }
+        size_t temp_mark = nob_temp_save();
+        bool ok = cg_validate_target(ctx, &ctx->targets[i]);
+        // The collected arguments are only checked here, not kept.
+        nob_temp_rewind(temp_mark);
+        if (!ok) return false;
     }
 
     for (size_t rule_index = 0; rule_index < bm_query_install_rule_count(ctx->model); ++rule_index) {
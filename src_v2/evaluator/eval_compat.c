@@ -98,14 +98,23 @@ bool eval_compat_set_profile(EvalExecContext *ctx, Eval_Compat_Profile profile)
                         profile == EVAL_PROFILE_PERMISSIVE ? nob_sv_from_cstr("1") : nob_sv_from_cstr("0"));
 }
 
+void eval_compat_note_var_write(EvalExecContext *ctx, String_View key) {
+    if (!ctx) return;
+    if (nob_sv_starts_with(key, nob_sv_from_cstr("CMAKE_NOBIFY_"))) ctx->runtime_state.compat_dirty = true;
+}
+
 void eval_refresh_runtime_compat(EvalExecContext *ctx) {
     if (!ctx) return;
     if (eval_scope_visible_depth(ctx) == 0) return;
     Eval_Runtime_State *runtime = eval_runtime_slice(ctx);
+    if (!runtime->compat_dirty) return;
+    runtime->compat_dirty = false;
 
     // This refresh snapshots evaluator-local compatibility knobs for the current
     // command cycle. Callers are expected to invoke it once at command entry and
-    // then keep the resulting snapshot stable for the rest of that cycle.
+    // then keep the resulting snapshot stable for the rest of that cycle. Writes
+    // to the knobs, scope pops and rollbacks mark the snapshot dirty; otherwise
+    // the re-read is skipped.
     String_View profile = eval_var_get_visible(ctx, nob_sv_from_cstr(EVAL_VAR_NOBIFY_COMPAT_PROFILE));
     if (profile.count > 0) runtime->compat_profile = eval_profile_from_sv(profile);
 
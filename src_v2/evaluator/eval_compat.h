@@ -6,6 +6,7 @@
 String_View eval_compat_profile_to_sv(Eval_Compat_Profile profile);
 bool eval_compat_set_profile(EvalExecContext *ctx, Eval_Compat_Profile profile);
 void eval_refresh_runtime_compat(EvalExecContext *ctx);
+void eval_compat_note_var_write(EvalExecContext *ctx, String_View key);
 Cmake_Diag_Severity eval_compat_effective_severity(const EvalExecContext *ctx, Cmake_Diag_Severity sev);
 bool eval_compat_decide_on_diag(EvalExecContext *ctx, Cmake_Diag_Severity effective_sev);
 
@@ -1955,10 +1955,15 @@ static bool ctest_coverage_collect_filtered_sources(EvalExecContext *ctx,
     *out_entries = NULL;
     if (requested_labels.count == 0) return true;
 
-    for (size_t i = 0; i < arena_arr_len(ctx->semantic_state.properties.records); i++) {
-        const Eval_Property_Record *record = &ctx->semantic_state.properties.records[i];
-        if (!eval_sv_eq_ci_lit(record->scope_upper, "SOURCE")) continue;
-        if (!eval_sv_eq_ci_lit(record->property_upper, "LABELS")) continue;
+    size_t *family = NULL;
+    if (!eval_property_engine_collect_family(ctx,
+                                             nob_sv_from_cstr("SOURCE"),
+                                             nob_sv_from_cstr("LABELS"),
+                                             &family)) {
+        return false;
+    }
+    for (size_t i = 0; i < arena_arr_len(family); i++) {
+        const Eval_Property_Record *record = &ctx->semantic_state.properties.records[family[i]];
         if (record->value.count == 0) continue;
         bool matches_filter = ctest_labels_intersect(ctx, requested_labels, record->value);
         if (eval_should_stop(ctx)) return false;
@@ -3185,15 +3190,8 @@ static void ctest_new_process_end(EvalExecContext *ctx, const Ctest_New_Process_
     if (ctx->message_check_stack) {
         arena_arr_set_len(ctx->message_check_stack, state->message_check_count);
     }
-    if (ctx->command_state.user_commands) {
-        arena_arr_set_len(ctx->command_state.user_commands, state->user_commands_count);
-    }
-    if (ctx->semantic_state.targets.records) {
-        arena_arr_set_len(ctx->semantic_state.targets.records, state->known_targets_count);
-    }
-    if (ctx->semantic_state.targets.aliases) {
-        arena_arr_set_len(ctx->semantic_state.targets.aliases, state->alias_targets_count);
-    }
+    eval_user_cmd_truncate(ctx, state->user_commands_count);
+    eval_target_truncate(ctx, state->known_targets_count, state->alias_targets_count);
     ctx->semantic_state.package.dependency_provider.command_name = state->dependency_provider_command_name;
     ctx->semantic_state.package.dependency_provider.supports_find_package = state->dependency_provider_supports_find_package;
     ctx->semantic_state.package.dependency_provider.supports_fetchcontent_makeavailable_serial =
@@ -77,6 +77,9 @@ static bool msg_check_stack_pop(EvalExecContext *ctx, String_View *out_msg) {
     if (!ctx || !out_msg) return false;
     if (arena_arr_len(ctx->message_check_stack) == 0) return false;
     *out_msg = ctx->message_check_stack[arena_arr_len(ctx->message_check_stack) - 1];
+    if (!eval_command_tx_note_slice(ctx, EVAL_TX_SLICE_MESSAGE_CHECK, arena_arr_len(ctx->message_check_stack) - 1)) {
+        return false;
+    }
     arena_arr_set_len(ctx->message_check_stack, arena_arr_len(ctx->message_check_stack) - 1);
     return true;
 }
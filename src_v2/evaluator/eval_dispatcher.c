@@ -53,13 +53,61 @@ bool eval_dispatcher_is_known_command(const EvalExecContext *ctx, String_View na
     return eval_native_cmd_find_const(ctx, name) != NULL;
 }
 
+// Resolves the command a node names, reusing the result cached on the node
+// while neither the native registry nor the user command list has changed.
+// Nodes without a dispatch cache are resolved every time.
+static Eval_Node_Dispatch_Kind dispatch_resolve_command(EvalExecContext *ctx,
+                                                        const Node *node,
+                                                        const Eval_Native_Command **out_native,
+                                                        const User_Command **out_user) {
+    *out_native = NULL;
+    *out_user = NULL;
+    size_t registry_generation = ctx->registry ? ctx->registry->generation : 0;
+    size_t user_generation = eval_command_slice(ctx)->user_commands_generation;
+
+    Command_Dispatch_Cache *cache = node->as.cmd.dispatch_cache;
+    if (cache &&
+        cache->kind != EVAL_NODE_DISPATCH_UNRESOLVED &&
+        cache->registry_generation == registry_generation &&
+        cache->user_generation == user_generation) {
+        Eval_Node_Dispatch_Kind kind = (Eval_Node_Dispatch_Kind)cache->kind;
+        if (kind == EVAL_NODE_DISPATCH_NATIVE) *out_native = (const Eval_Native_Command*)cache->command;
+        if (kind == EVAL_NODE_DISPATCH_USER) *out_user = (const User_Command*)cache->command;
+        return kind;
+    }
+
+    Eval_Node_Dispatch_Kind kind = EVAL_NODE_DISPATCH_UNKNOWN;
+    const void *resolved = NULL;
+    *out_native = eval_native_cmd_find_const(ctx, node->as.cmd.name);
+    if (*out_native) {
+        kind = EVAL_NODE_DISPATCH_NATIVE;
+        resolved = *out_native;
+    } else {
+        *out_user = eval_user_cmd_find(ctx, node->as.cmd.name);
+        if (*out_user) {
+            kind = EVAL_NODE_DISPATCH_USER;
+            resolved = *out_user;
+        }
+    }
+
+    if (cache) {
+        cache->command = resolved;
+        cache->registry_generation = registry_generation;
+        cache->user_generation = user_generation;
+        cache->kind = (int)kind;
+    }
+    return kind;
+}
+
 Eval_Result eval_dispatch_command(EvalExecContext *ctx, const Node *node) {
     if (!ctx || eval_should_stop(ctx) || !node || node->kind != NODE_COMMAND) return eval_result_fatal();
     Eval_Runtime_State *runtime = eval_runtime_slice(ctx);
     Event_Origin o = eval_origin_from_node(ctx, node);
     uint32_t argc = (uint32_t) arena_arr_len(node->as.cmd.args);
 
-    const Eval_Native_Command *native = eval_native_cmd_find_const(ctx, node->as.cmd.name);
+    const Eval_Native_Command *native = NULL;
+    const User_Command *user = NULL;
+    (void)dispatch_resolve_command(ctx, node, &native, &user);
     if (native) {
         Eval_Command_Transaction tx = {0};
         if (!eval_command_tx_begin(ctx, &tx)) return eval_result_fatal();
@@ -92,7 +140,6 @@ Eval_Result eval_dispatch_command(EvalExecContext *ctx, const Node *node) {
         return eval_result_merge(native_result, running_result);
     }
 
-    User_Command *user = eval_user_cmd_find(ctx, node->as.cmd.name);
     if (user) {
         Eval_Command_Transaction tx = {0};
         Event_Command_Dispatch_Kind dispatch_kind =
@@ -118,7 +165,7 @@ Eval_Result eval_dispatch_command(EvalExecContext *ctx, const Node *node) {
             return eval_result_fatal();
         }
         size_t error_count_before = runtime->run_report.error_count;
-        if (eval_user_cmd_invoke(ctx, node->as.cmd.name, &args, o)) {
+        if (eval_user_cmd_invoke_resolved(ctx, user, node->as.cmd.name, &args, o)) {
             Eval_Result running_result = eval_result_ok_if_running(ctx);
             bool user_succeeded = !eval_result_is_fatal(running_result) &&
                                   runtime->run_report.error_count == error_count_before &&
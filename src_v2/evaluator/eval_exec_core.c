@@ -77,7 +77,7 @@ static Eval_Result eval_node(EvalExecContext *ctx, const Node *node);
 
 static Eval_Result eval_if(EvalExecContext *ctx, const Node *node) {
     Cmake_Event_Origin origin = eval_origin_from_node(ctx, node);
-    bool cond = eval_condition(ctx, &node->as.if_stmt.condition);
+    bool cond = eval_condition_cached(ctx, &node->as.if_stmt.condition, node->as.if_stmt.condition_cache);
     if (ctx->oom) return eval_result_fatal();
     if (!eval_emit_flow_if_eval(ctx, origin, cond)) return eval_result_fatal();
     if (cond) {
@@ -87,7 +87,7 @@ static Eval_Result eval_if(EvalExecContext *ctx, const Node *node) {
 
     for (size_t i = 0; i < arena_arr_len(node->as.if_stmt.elseif_clauses); i++) {
         const ElseIf_Clause *cl = &node->as.if_stmt.elseif_clauses[i];
-        bool elseif_cond = eval_condition(ctx, &cl->condition);
+        bool elseif_cond = eval_condition_cached(ctx, &cl->condition, cl->condition_cache);
         if (ctx->oom) return eval_result_fatal();
         if (!eval_emit_flow_if_eval(ctx, origin, elseif_cond)) return eval_result_fatal();
         if (elseif_cond) {
@@ -302,7 +302,7 @@ static Eval_Result eval_while(EvalExecContext *ctx, const Node *node) {
     if (!exec) return eval_result_fatal();
     exec->loop_depth++;
     for (size_t iter = 0; iter < max_iter; iter++) {
-        bool cond = eval_condition(ctx, &node->as.while_stmt.condition);
+        bool cond = eval_condition_cached(ctx, &node->as.while_stmt.condition, node->as.while_stmt.condition_cache);
         if (ctx->oom) {
             exec->loop_depth--;
             return eval_result_fatal();
@@ -357,18 +357,7 @@ static Eval_Result eval_node(EvalExecContext *ctx, const Node *node) {
     // on the context instead of re-reading CMAKE_NOBIFY_* mid-cycle.
     eval_refresh_runtime_compat(ctx);
     if (eval_should_stop(ctx)) return eval_result_fatal();
-
-    {
-        char line_buf[32];
-        int n = snprintf(line_buf, sizeof(line_buf), "%zu", node->line);
-        if (n < 0 || (size_t)n >= sizeof(line_buf)) {
-            (void)ctx_oom(ctx);
-            return eval_result_fatal();
-        }
-        if (!eval_var_set_current(ctx, nob_sv_from_cstr("CMAKE_CURRENT_LIST_LINE"), nob_sv_from_cstr(line_buf))) {
-            return eval_result_fatal();
-        }
-    }
+    ctx->current_list_line = node->line;
 
     Arena_Mark mark = arena_mark(ctx->arena);
     Eval_Result result = eval_result_ok();
@@ -1,6 +1,7 @@
 #include "eval_expr.h"
 #include "evaluator_internal.h"
 #include "eval_dispatcher.h"
+#include "eval_regex_cache.h"
 #include "sv_utils.h"
 #include <ctype.h>
 #include <stdio.h>
@@ -15,7 +16,6 @@
 
 #define EVAL_EXPAND_MAX_RECURSION 100
 #define EVAL_EXPAND_MAX_RECURSION_HARD_CAP 10000
-#define EVAL_ESCAPED_DOLLAR_SENTINEL '\x1f'
 
 static bool path_exists_cstr(const char *path) {
     if (!path || path[0] == '\0') return false;
@@ -540,356 +540,535 @@ String_View eval_expand_vars(struct EvalExecContext *ctx, String_View input) {
     return eval_expand_vars_depth(ctx, input, 0);
 }
 
+// -----------------------------------------------------------------------------
+// Condition programs
+// -----------------------------------------------------------------------------
+//
+// if(), elseif() and while() conditions are lowered into a flat program:
+// operators become opcodes bound to the token positions of their operands,
+// and AND/OR jump over right-hand sides that have no side effects. Parsing
+// only looks at which tokens are keywords, so a program is valid for every
+// expansion with the same keyword classes. Programs for AST conditions are
+// cached on the node from their second execution in a session and rebuilt
+// when an expansion changes shape.
+
+typedef enum {
+    COND_TOK_OPERAND = 0,
+    COND_TOK_LPAREN,
+    COND_TOK_RPAREN,
+    COND_TOK_NOT,
+    COND_TOK_AND,
+    COND_TOK_OR,
+    // Unary predicates.
+    COND_TOK_DEFINED,
+    COND_TOK_TARGET,
+    COND_TOK_COMMAND,
+    COND_TOK_POLICY,
+    COND_TOK_EXISTS,
+    COND_TOK_IS_DIRECTORY,
+    COND_TOK_IS_SYMLINK,
+    COND_TOK_IS_ABSOLUTE,
+    COND_TOK_IS_READABLE,
+    COND_TOK_IS_WRITABLE,
+    COND_TOK_IS_EXECUTABLE,
+    COND_TOK_TEST,
+    // Binary operators.
+    COND_TOK_STREQUAL,
+    COND_TOK_EQUAL,
+    COND_TOK_LESS,
+    COND_TOK_GREATER,
+    COND_TOK_LESS_EQUAL,
+    COND_TOK_GREATER_EQUAL,
+    COND_TOK_STRLESS,
+    COND_TOK_STRGREATER,
+    COND_TOK_STRLESS_EQUAL,
+    COND_TOK_STRGREATER_EQUAL,
+    COND_TOK_VERSION_LESS,
+    COND_TOK_VERSION_GREATER,
+    COND_TOK_VERSION_EQUAL,
+    COND_TOK_VERSION_LESS_EQUAL,
+    COND_TOK_VERSION_GREATER_EQUAL,
+    COND_TOK_MATCHES,
+    COND_TOK_IN_LIST,
+    COND_TOK_PATH_EQUAL,
+    COND_TOK_IS_NEWER_THAN,
+} Cond_Token_Class;
+
+#define COND_TOK_IS_UNARY(cls) ((cls) >= COND_TOK_DEFINED && (cls) <= COND_TOK_TEST)
+#define COND_TOK_IS_BINARY(cls) ((cls) >= COND_TOK_STREQUAL && (cls) <= COND_TOK_IS_NEWER_THAN)
+
+#define COND_KEYWORD(lit, cls) {lit, sizeof(lit) - 1, cls}
+static const struct {
+    const char *text;
+    size_t len;
+    Cond_Token_Class cls;
+} s_cond_keywords[] = {
+    COND_KEYWORD("NOT", COND_TOK_NOT),
+    COND_KEYWORD("AND", COND_TOK_AND),
+    COND_KEYWORD("OR", COND_TOK_OR),
+    COND_KEYWORD("DEFINED", COND_TOK_DEFINED),
+    COND_KEYWORD("TARGET", COND_TOK_TARGET),
+    COND_KEYWORD("COMMAND", COND_TOK_COMMAND),
+    COND_KEYWORD("POLICY", COND_TOK_POLICY),
+    COND_KEYWORD("EXISTS", COND_TOK_EXISTS),
+    COND_KEYWORD("IS_DIRECTORY", COND_TOK_IS_DIRECTORY),
+    COND_KEYWORD("IS_SYMLINK", COND_TOK_IS_SYMLINK),
+    COND_KEYWORD("IS_ABSOLUTE", COND_TOK_IS_ABSOLUTE),
+    COND_KEYWORD("IS_READABLE", COND_TOK_IS_READABLE),
+    COND_KEYWORD("IS_WRITABLE", COND_TOK_IS_WRITABLE),
+    COND_KEYWORD("IS_EXECUTABLE", COND_TOK_IS_EXECUTABLE),
+    COND_KEYWORD("TEST", COND_TOK_TEST),
+    COND_KEYWORD("STREQUAL", COND_TOK_STREQUAL),
+    COND_KEYWORD("EQUAL", COND_TOK_EQUAL),
+    COND_KEYWORD("LESS", COND_TOK_LESS),
+    COND_KEYWORD("GREATER", COND_TOK_GREATER),
+    COND_KEYWORD("LESS_EQUAL", COND_TOK_LESS_EQUAL),
+    COND_KEYWORD("GREATER_EQUAL", COND_TOK_GREATER_EQUAL),
+    COND_KEYWORD("STRLESS", COND_TOK_STRLESS),
+    COND_KEYWORD("STRGREATER", COND_TOK_STRGREATER),
+    COND_KEYWORD("STRLESS_EQUAL", COND_TOK_STRLESS_EQUAL),
+    COND_KEYWORD("STRGREATER_EQUAL", COND_TOK_STRGREATER_EQUAL),
+    COND_KEYWORD("VERSION_LESS", COND_TOK_VERSION_LESS),
+    COND_KEYWORD("VERSION_GREATER", COND_TOK_VERSION_GREATER),
+    COND_KEYWORD("VERSION_EQUAL", COND_TOK_VERSION_EQUAL),
+    COND_KEYWORD("VERSION_LESS_EQUAL", COND_TOK_VERSION_LESS_EQUAL),
+    COND_KEYWORD("VERSION_GREATER_EQUAL", COND_TOK_VERSION_GREATER_EQUAL),
+    COND_KEYWORD("MATCHES", COND_TOK_MATCHES),
+    COND_KEYWORD("IN_LIST", COND_TOK_IN_LIST),
+    COND_KEYWORD("PATH_EQUAL", COND_TOK_PATH_EQUAL),
+    COND_KEYWORD("IS_NEWER_THAN", COND_TOK_IS_NEWER_THAN),
+};
+#undef COND_KEYWORD
+
+#define COND_KEYWORD_MAX_LEN 21
+
+static uint8_t cond_classify(String_View tok) {
+    if (tok.count == 0 || tok.count > COND_KEYWORD_MAX_LEN) return COND_TOK_OPERAND;
+    if (tok.count == 1 && tok.data[0] == '(') return COND_TOK_LPAREN;
+    if (tok.count == 1 && tok.data[0] == ')') return COND_TOK_RPAREN;
+    if (!isalpha((unsigned char)tok.data[0])) return COND_TOK_OPERAND;
+    for (size_t i = 0; i < NOB_ARRAY_LEN(s_cond_keywords); i++) {
+        if (s_cond_keywords[i].len == tok.count && eval_sv_eq_ci_lit(tok, s_cond_keywords[i].text)) {
+            return (uint8_t)s_cond_keywords[i].cls;
+        }
+    }
+    return COND_TOK_OPERAND;
+}
+
+typedef enum {
+    COND_OP_FALSE = 0,     // push false (operand missing)
+    COND_OP_TRUTHY,        // push the truthiness of token a
+    COND_OP_UNARY,         // push predicate cls applied to token a
+    COND_OP_BINARY,        // push operator cls applied to tokens a and b
+    COND_OP_NOT,
+    COND_OP_AND,
+    COND_OP_OR,
+    COND_OP_JUMP_IF_FALSE, // keep the top and continue at a when it is false
+    COND_OP_JUMP_IF_TRUE,  // keep the top and continue at a when it is true
+    COND_OP_MISSING_PAREN, // report an unclosed '('
+    COND_OP_NOP,
+} Cond_Op_Code;
+
+typedef struct {
+    uint8_t code;
+    uint8_t cls;
+    size_t a;
+    size_t b;
+} Cond_Op;
+
+typedef struct {
+    uint8_t *classes;     // keyword class of each token the program was built for
+    size_t token_count;
+    Cond_Op *ops;
+    size_t op_count;
+    bool trailing_tokens; // the expression ends before the last token
+    size_t rebuilds;
+} Cond_Program;
+
 typedef struct {
-    struct EvalExecContext *ctx;
-    String_View *toks;
+    Arena *arena;
+    const uint8_t *classes;
     size_t count;
     size_t pos;
-    Cmake_Event_Origin origin;
-} Expr;
-
-static bool expr_has(Expr *e) { return e->pos < e->count; }
-static String_View expr_peek(Expr *e) { return e->toks[e->pos]; }
-static String_View expr_next(Expr *e) { return e->toks[e->pos++]; }
-static bool parse_expr(Expr *e);
-static bool parse_cmp(Expr *e);
-
-static bool parse_primary(Expr *e) {
-    if (!expr_has(e)) return false;
-    String_View tok = expr_next(e);
-
-    if (eval_sv_eq_ci_lit(tok, "(")) {
-        bool v = parse_expr(e);
-        if (expr_has(e) && eval_sv_eq_ci_lit(expr_peek(e), ")")) {
-            expr_next(e);
-        } else {
-            EVAL_DIAG_EMIT_SEV(e->ctx, EV_DIAG_ERROR, EVAL_DIAG_MISSING_REQUIRED, nob_sv_from_cstr("eval_expr"), nob_sv_from_cstr("if"), e->origin, nob_sv_from_cstr("Missing ')' in expression"), nob_sv_from_cstr("Close parentheses"));
-        }
-        return v;
-    }
+    Cond_Op *ops;
+    bool oom;
+} Cond_Compiler;
+
+static void cond_emit(Cond_Compiler *c, Cond_Op_Code code, uint8_t cls, size_t a, size_t b) {
+    Cond_Op op = {.code = (uint8_t)code, .cls = cls, .a = a, .b = b};
+    if (!arena_arr_push(c->arena, c->ops, op)) c->oom = true;
+}
 
-    return eval_truthy(e->ctx, tok);
+// Points a short-circuit jump past the operator that follows its right-hand
+// side, or drops it when skipping that side would lose a side effect.
+static void cond_patch_jump(Cond_Compiler *c, size_t jump, bool rhs_pure) {
+    if (c->oom) return;
+    if (rhs_pure) c->ops[jump].a = arena_arr_len(c->ops);
+    else c->ops[jump].code = COND_OP_NOP;
 }
 
-static bool parse_unary(Expr *e) {
-    if (!expr_has(e)) return false;
-    String_View tok = expr_peek(e);
+static bool cond_compile_expr(Cond_Compiler *c);
+static bool cond_compile_cmp(Cond_Compiler *c);
 
-    if (eval_sv_eq_ci_lit(tok, "NOT")) {
-        expr_next(e);
+// Each cond_compile_* mirrors one level of the if() grammar and returns
+// whether the code it emitted is free of side effects (variable writes or
+// diagnostics).
+static bool cond_compile_primary(Cond_Compiler *c) {
+    if (c->pos >= c->count) {
+        cond_emit(c, COND_OP_FALSE, 0, 0, 0);
+        return true;
+    }
+    size_t tok = c->pos++;
+    if (c->classes[tok] == COND_TOK_LPAREN) {
+        bool pure = cond_compile_expr(c);
+        if (c->pos < c->count && c->classes[c->pos] == COND_TOK_RPAREN) {
+            c->pos++;
+            return pure;
+        }
+        cond_emit(c, COND_OP_MISSING_PAREN, 0, 0, 0);
+        return false;
+    }
+    cond_emit(c, COND_OP_TRUTHY, 0, tok, 0);
+    return true;
+}
+
+static bool cond_compile_unary(Cond_Compiler *c) {
+    uint8_t cls = c->classes[c->pos];
+    if (cls == COND_TOK_NOT) {
+        c->pos++;
         // CMake allows constructs like:
         //   if(NOT A STREQUAL B)
         // so NOT must bind over the next comparison expression, not only a
         // single primary/unary atom.
-        return !parse_cmp(e);
+        bool pure = cond_compile_cmp(c);
+        cond_emit(c, COND_OP_NOT, 0, 0, 0);
+        return pure;
     }
-
-    if (eval_sv_eq_ci_lit(tok, "DEFINED")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View var_name = expr_next(e);
-
-        if (var_name.count > 4 && memcmp(var_name.data, "ENV{", 4) == 0 && var_name.data[var_name.count - 1] == '}') {
-            size_t n = var_name.count - 5;
-            String_View env_name_sv = nob_sv_from_parts(var_name.data + 4, n);
-            char *env_name = eval_sv_to_cstr_temp(e->ctx, env_name_sv);
-            EVAL_OOM_RETURN_IF_NULL(e->ctx, env_name, false);
-            return eval_has_env(e->ctx, env_name);
+    if (COND_TOK_IS_UNARY(cls)) {
+        c->pos++;
+        if (c->pos >= c->count) {
+            cond_emit(c, COND_OP_FALSE, 0, 0, 0);
+            return true;
         }
-
-        return eval_var_defined_visible(e->ctx, var_name);
+        cond_emit(c, COND_OP_UNARY, cls, c->pos++, 0);
+        return true;
     }
+    return cond_compile_primary(c);
+}
 
-    if (eval_sv_eq_ci_lit(tok, "TARGET")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        return eval_target_visible(e->ctx, expr_next(e));
+static bool cond_compile_cmp(Cond_Compiler *c) {
+    if (c->pos >= c->count) {
+        cond_emit(c, COND_OP_FALSE, 0, 0, 0);
+        return true;
     }
 
-    if (eval_sv_eq_ci_lit(tok, "COMMAND")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View name = expr_next(e);
-        if (eval_dispatcher_is_known_command(e->ctx, name)) return true;
-        return eval_user_cmd_find(e->ctx, name) != NULL;
+    uint8_t first = c->classes[c->pos];
+    if (first == COND_TOK_LPAREN || first == COND_TOK_NOT || COND_TOK_IS_UNARY(first)) {
+        return cond_compile_unary(c);
     }
 
-    if (eval_sv_eq_ci_lit(tok, "POLICY")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        return eval_policy_is_known(expr_next(e));
+    size_t lhs = c->pos++;
+    if (c->pos < c->count && COND_TOK_IS_BINARY(c->classes[c->pos])) {
+        uint8_t op = c->classes[c->pos++];
+        if (c->pos >= c->count) {
+            cond_emit(c, COND_OP_FALSE, 0, 0, 0);
+            return true;
+        }
+        cond_emit(c, COND_OP_BINARY, op, lhs, c->pos++);
+        return op != COND_TOK_MATCHES;
     }
 
-    if (eval_sv_eq_ci_lit(tok, "EXISTS")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        char *path = eval_sv_to_cstr_temp(e->ctx, expr_next(e));
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, path, false);
-        return path_exists_cstr(path);
-    }
+    cond_emit(c, COND_OP_TRUTHY, 0, lhs, 0);
+    return true;
+}
 
-    if (eval_sv_eq_ci_lit(tok, "IS_DIRECTORY")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        char *path = eval_sv_to_cstr_temp(e->ctx, expr_next(e));
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, path, false);
-        return path_is_dir_cstr(path);
+static bool cond_compile_and(Cond_Compiler *c) {
+    bool pure = cond_compile_cmp(c);
+    while (c->pos < c->count && c->classes[c->pos] == COND_TOK_AND) {
+        c->pos++;
+        size_t jump = arena_arr_len(c->ops);
+        cond_emit(c, COND_OP_JUMP_IF_FALSE, 0, 0, 0);
+        bool rhs_pure = cond_compile_cmp(c);
+        cond_emit(c, COND_OP_AND, 0, 0, 0);
+        cond_patch_jump(c, jump, rhs_pure);
+        pure = pure && rhs_pure;
     }
+    return pure;
+}
 
-    if (eval_sv_eq_ci_lit(tok, "IS_SYMLINK")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        char *path = eval_sv_to_cstr_temp(e->ctx, expr_next(e));
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, path, false);
-        return path_is_symlink_cstr(path);
+static bool cond_compile_expr(Cond_Compiler *c) {
+    bool pure = cond_compile_and(c);
+    while (c->pos < c->count && c->classes[c->pos] == COND_TOK_OR) {
+        c->pos++;
+        size_t jump = arena_arr_len(c->ops);
+        cond_emit(c, COND_OP_JUMP_IF_TRUE, 0, 0, 0);
+        bool rhs_pure = cond_compile_and(c);
+        cond_emit(c, COND_OP_OR, 0, 0, 0);
+        cond_patch_jump(c, jump, rhs_pure);
+        pure = pure && rhs_pure;
     }
+    return pure;
+}
 
-    if (eval_sv_eq_ci_lit(tok, "IS_ABSOLUTE")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        return eval_sv_is_abs_path(expr_next(e));
+// Builds the program for `classes` in `arena`. Scratch space comes from the
+// temp arena; when `arena` is the temp arena the program borrows `classes`.
+static Cond_Program *cond_program_compile(EvalExecContext *ctx,
+                                          Arena *arena,
+                                          const uint8_t *classes,
+                                          size_t count) {
+    Cond_Compiler c = {0};
+    c.arena = ctx->arena;
+    c.classes = classes;
+    c.count = count;
+    (void)cond_compile_expr(&c);
+    if (c.oom) {
+        ctx_oom(ctx);
+        return NULL;
     }
 
-    if (eval_sv_eq_ci_lit(tok, "IS_READABLE")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        char *path = eval_sv_to_cstr_temp(e->ctx, expr_next(e));
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, path, false);
-        return path_is_readable_cstr(path);
+    Cond_Program *program = arena_alloc_zero(arena, sizeof(*program));
+    EVAL_OOM_RETURN_IF_NULL(ctx, program, NULL);
+    program->token_count = count;
+    program->op_count = arena_arr_len(c.ops);
+    program->trailing_tokens = c.pos != count;
+    if (arena == ctx->arena) {
+        program->classes = (uint8_t*)classes;
+        program->ops = c.ops;
+        return program;
     }
 
-    if (eval_sv_eq_ci_lit(tok, "IS_WRITABLE")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        char *path = eval_sv_to_cstr_temp(e->ctx, expr_next(e));
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, path, false);
-        return path_is_writable_cstr(path);
-    }
+    program->classes = (uint8_t*)arena_alloc(arena, count);
+    program->ops = (Cond_Op*)arena_alloc(arena, program->op_count * sizeof(*program->ops));
+    EVAL_OOM_RETURN_IF_NULL(ctx, program->classes, NULL);
+    EVAL_OOM_RETURN_IF_NULL(ctx, program->ops, NULL);
+    memcpy(program->classes, classes, count);
+    memcpy(program->ops, c.ops, program->op_count * sizeof(*program->ops));
+    return program;
+}
 
-    if (eval_sv_eq_ci_lit(tok, "IS_EXECUTABLE")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        char *path = eval_sv_to_cstr_temp(e->ctx, expr_next(e));
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, path, false);
-        return path_is_executable_cstr(path);
+static const Cond_Program *cond_program_get(EvalExecContext *ctx,
+                                            Condition_Cache *cache,
+                                            const uint8_t *classes,
+                                            size_t count) {
+    const Cond_Program *cached = NULL;
+    bool store = false;
+    if (cache && ctx->session) {
+        size_t owner = ctx->session->instance_id;
+        if (cache->compiled_owner != owner) {
+            cache->compiled_owner = owner;
+            cache->compiled = NULL;
+        } else {
+            cached = (const Cond_Program*)cache->compiled;
+            if (cached &&
+                cached->token_count == count &&
+                memcmp(cached->classes, classes, count) == 0) {
+                eval_runtime_slice(ctx)->run_report.cond_program_hits++;
+                return cached;
+            }
+            store = !cached || cached->rebuilds < COND_PROGRAM_MAX_REBUILDS;
+        }
     }
 
-    if (eval_sv_eq_ci_lit(tok, "TEST")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View name = expr_next(e);
-        return eval_test_known(e->ctx, name);
+    Cond_Program *program = cond_program_compile(ctx, store ? eval_event_arena(ctx) : ctx->arena, classes, count);
+    if (!program) return NULL;
+    if (store) {
+        program->rebuilds = cached ? cached->rebuilds + 1 : 0;
+        cache->compiled = program;
+        eval_runtime_slice(ctx)->run_report.cond_program_builds++;
     }
-
-    return parse_primary(e);
+    return program;
 }
 
-static bool parse_cmp(Expr *e) {
-    if (!expr_has(e)) return false;
-
-    String_View first = expr_peek(e);
-    if (eval_sv_eq_ci_lit(first, "(") ||
-        eval_sv_eq_ci_lit(first, "NOT") ||
-        eval_sv_eq_ci_lit(first, "DEFINED") ||
-        eval_sv_eq_ci_lit(first, "TARGET") ||
-        eval_sv_eq_ci_lit(first, "COMMAND") ||
-        eval_sv_eq_ci_lit(first, "POLICY") ||
-        eval_sv_eq_ci_lit(first, "EXISTS") ||
-        eval_sv_eq_ci_lit(first, "IS_DIRECTORY") ||
-        eval_sv_eq_ci_lit(first, "IS_SYMLINK") ||
-        eval_sv_eq_ci_lit(first, "IS_ABSOLUTE") ||
-        eval_sv_eq_ci_lit(first, "IS_READABLE") ||
-        eval_sv_eq_ci_lit(first, "IS_WRITABLE") ||
-        eval_sv_eq_ci_lit(first, "IS_EXECUTABLE") ||
-        eval_sv_eq_ci_lit(first, "TEST")) {
-        return parse_unary(e);
+static bool cond_eval_unary(EvalExecContext *ctx, uint8_t cls, String_View operand) {
+    switch ((Cond_Token_Class)cls) {
+    case COND_TOK_DEFINED: {
+        if (operand.count > 4 && memcmp(operand.data, "ENV{", 4) == 0 && operand.data[operand.count - 1] == '}') {
+            size_t n = operand.count - 5;
+            String_View env_name_sv = nob_sv_from_parts(operand.data + 4, n);
+            char *env_name = eval_sv_to_cstr_temp(ctx, env_name_sv);
+            EVAL_OOM_RETURN_IF_NULL(ctx, env_name, false);
+            return eval_has_env(ctx, env_name);
+        }
+        return eval_var_defined_visible(ctx, operand);
     }
-
-    size_t save = e->pos;
-    String_View lhs = expr_next(e);
-
-    if (eval_sv_eq_ci_lit(lhs, "(")) {
-        e->pos = save;
-        return parse_unary(e);
+    case COND_TOK_TARGET:
+        return eval_target_visible(ctx, operand);
+    case COND_TOK_COMMAND:
+        if (eval_dispatcher_is_known_command(ctx, operand)) return true;
+        return eval_user_cmd_find(ctx, operand) != NULL;
+    case COND_TOK_POLICY:
+        return eval_policy_is_known(operand);
+    case COND_TOK_IS_ABSOLUTE:
+        return eval_sv_is_abs_path(operand);
+    case COND_TOK_TEST:
+        return eval_test_known(ctx, operand);
+    case COND_TOK_EXISTS:
+    case COND_TOK_IS_DIRECTORY:
+    case COND_TOK_IS_SYMLINK:
+    case COND_TOK_IS_READABLE:
+    case COND_TOK_IS_WRITABLE:
+    case COND_TOK_IS_EXECUTABLE: {
+        char *path = eval_sv_to_cstr_temp(ctx, operand);
+        EVAL_OOM_RETURN_IF_NULL(ctx, path, false);
+        if (cls == COND_TOK_EXISTS) return path_exists_cstr(path);
+        if (cls == COND_TOK_IS_DIRECTORY) return path_is_dir_cstr(path);
+        if (cls == COND_TOK_IS_SYMLINK) return path_is_symlink_cstr(path);
+        if (cls == COND_TOK_IS_READABLE) return path_is_readable_cstr(path);
+        if (cls == COND_TOK_IS_WRITABLE) return path_is_writable_cstr(path);
+        return path_is_executable_cstr(path);
     }
+    default:
+        return false;
+    }
+}
 
-    if (!expr_has(e)) return eval_truthy(e->ctx, lhs);
-
-    String_View op = expr_peek(e);
-
-    if (eval_sv_eq_ci_lit(op, "STREQUAL")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View rhs = expr_next(e);
-        return sv_eq(sv_lookup_if_var(e->ctx, lhs), sv_lookup_if_var(e->ctx, rhs));
+static bool cond_eval_matches(EvalExecContext *ctx, String_View lhs, String_View rhs) {
+    enum { MAX_REGEX_MATCHES = 10 };
+    rhs = sv_lookup_if_var(ctx, rhs);
+    lhs = sv_lookup_if_var(ctx, lhs);
+    char *subj = eval_sv_to_cstr_temp(ctx, lhs);
+    EVAL_OOM_RETURN_IF_NULL(ctx, subj, false);
+
+    const regex_t *re = eval_regex_cache_get(ctx, rhs, REG_EXTENDED);
+    if (!re) return false;
+    regmatch_t matches[MAX_REGEX_MATCHES];
+    for (size_t i = 0; i < MAX_REGEX_MATCHES; i++) {
+        matches[i].rm_so = -1;
+        matches[i].rm_eo = -1;
     }
+    int rc = regexec(re, subj, MAX_REGEX_MATCHES, matches, 0);
+    if (!eval_set_regex_match_vars(ctx, subj, matches, MAX_REGEX_MATCHES, rc == 0)) return false;
+    return rc == 0;
+}
 
-    if (eval_sv_eq_ci_lit(op, "EQUAL")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View rhs = expr_next(e);
-        lhs = sv_lookup_if_var(e->ctx, lhs);
-        rhs = sv_lookup_if_var(e->ctx, rhs);
+static bool cond_eval_binary(EvalExecContext *ctx, uint8_t cls, String_View lhs, String_View rhs) {
+    switch ((Cond_Token_Class)cls) {
+    case COND_TOK_STREQUAL:
+        return sv_eq(sv_lookup_if_var(ctx, lhs), sv_lookup_if_var(ctx, rhs));
+
+    case COND_TOK_EQUAL:
+    case COND_TOK_LESS:
+    case COND_TOK_GREATER:
+    case COND_TOK_LESS_EQUAL:
+    case COND_TOK_GREATER_EQUAL: {
+        lhs = sv_lookup_if_var(ctx, lhs);
+        rhs = sv_lookup_if_var(ctx, rhs);
         long a = 0, b = 0;
         if (!sv_is_number(lhs, &a) || !sv_is_number(rhs, &b)) return false;
-        return a == b;
-    }
-
-    if (eval_sv_eq_ci_lit(op, "LESS") || eval_sv_eq_ci_lit(op, "GREATER") ||
-        eval_sv_eq_ci_lit(op, "LESS_EQUAL") || eval_sv_eq_ci_lit(op, "GREATER_EQUAL")) {
-        bool is_less = eval_sv_eq_ci_lit(op, "LESS");
-        bool is_greater = eval_sv_eq_ci_lit(op, "GREATER");
-        bool is_le = eval_sv_eq_ci_lit(op, "LESS_EQUAL");
-        bool is_ge = eval_sv_eq_ci_lit(op, "GREATER_EQUAL");
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View rhs = expr_next(e);
-        lhs = sv_lookup_if_var(e->ctx, lhs);
-        rhs = sv_lookup_if_var(e->ctx, rhs);
-        long a = 0, b = 0;
-        if (!sv_is_number(lhs, &a) || !sv_is_number(rhs, &b)) return false;
-        if (is_less) return a < b;
-        if (is_greater) return a > b;
-        if (is_le) return a <= b;
-        if (is_ge) return a >= b;
-        return false;
+        if (cls == COND_TOK_EQUAL) return a == b;
+        if (cls == COND_TOK_LESS) return a < b;
+        if (cls == COND_TOK_GREATER) return a > b;
+        if (cls == COND_TOK_LESS_EQUAL) return a <= b;
+        return a >= b;
     }
 
-    if (eval_sv_eq_ci_lit(op, "STRLESS") || eval_sv_eq_ci_lit(op, "STRGREATER") ||
-        eval_sv_eq_ci_lit(op, "STRLESS_EQUAL") || eval_sv_eq_ci_lit(op, "STRGREATER_EQUAL")) {
-        bool is_less = eval_sv_eq_ci_lit(op, "STRLESS");
-        bool is_greater = eval_sv_eq_ci_lit(op, "STRGREATER");
-        bool is_le = eval_sv_eq_ci_lit(op, "STRLESS_EQUAL");
-        bool is_ge = eval_sv_eq_ci_lit(op, "STRGREATER_EQUAL");
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View rhs = expr_next(e);
-        int cmp = sv_lex_cmp(sv_lookup_if_var(e->ctx, lhs), sv_lookup_if_var(e->ctx, rhs));
-        if (is_less) return cmp < 0;
-        if (is_greater) return cmp > 0;
-        if (is_le) return cmp <= 0;
-        if (is_ge) return cmp >= 0;
-        return false;
+    case COND_TOK_STRLESS:
+    case COND_TOK_STRGREATER:
+    case COND_TOK_STRLESS_EQUAL:
+    case COND_TOK_STRGREATER_EQUAL: {
+        int cmp = sv_lex_cmp(sv_lookup_if_var(ctx, lhs), sv_lookup_if_var(ctx, rhs));
+        if (cls == COND_TOK_STRLESS) return cmp < 0;
+        if (cls == COND_TOK_STRGREATER) return cmp > 0;
+        if (cls == COND_TOK_STRLESS_EQUAL) return cmp <= 0;
+        return cmp >= 0;
     }
 
-    if (eval_sv_eq_ci_lit(op, "VERSION_LESS") || eval_sv_eq_ci_lit(op, "VERSION_GREATER") ||
-        eval_sv_eq_ci_lit(op, "VERSION_EQUAL") || eval_sv_eq_ci_lit(op, "VERSION_LESS_EQUAL") ||
-        eval_sv_eq_ci_lit(op, "VERSION_GREATER_EQUAL")) {
-        bool is_less = eval_sv_eq_ci_lit(op, "VERSION_LESS");
-        bool is_greater = eval_sv_eq_ci_lit(op, "VERSION_GREATER");
-        bool is_eq = eval_sv_eq_ci_lit(op, "VERSION_EQUAL");
-        bool is_le = eval_sv_eq_ci_lit(op, "VERSION_LESS_EQUAL");
-        bool is_ge = eval_sv_eq_ci_lit(op, "VERSION_GREATER_EQUAL");
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View rhs = expr_next(e);
-        int cmp = sv_version_cmp(sv_lookup_if_var(e->ctx, lhs), sv_lookup_if_var(e->ctx, rhs));
-        if (is_less) return cmp < 0;
-        if (is_greater) return cmp > 0;
-        if (is_eq) return cmp == 0;
-        if (is_le) return cmp <= 0;
-        if (is_ge) return cmp >= 0;
-        return false;
+    case COND_TOK_VERSION_LESS:
+    case COND_TOK_VERSION_GREATER:
+    case COND_TOK_VERSION_EQUAL:
+    case COND_TOK_VERSION_LESS_EQUAL:
+    case COND_TOK_VERSION_GREATER_EQUAL: {
+        int cmp = sv_version_cmp(sv_lookup_if_var(ctx, lhs), sv_lookup_if_var(ctx, rhs));
+        if (cls == COND_TOK_VERSION_LESS) return cmp < 0;
+        if (cls == COND_TOK_VERSION_GREATER) return cmp > 0;
+        if (cls == COND_TOK_VERSION_EQUAL) return cmp == 0;
+        if (cls == COND_TOK_VERSION_LESS_EQUAL) return cmp <= 0;
+        return cmp >= 0;
     }
 
-    if (eval_sv_eq_ci_lit(op, "MATCHES")) {
-        enum { MAX_REGEX_MATCHES = 10 };
-        expr_next(e);
-        if (!expr_has(e)) return false;
-
-        String_View rhs = expr_next(e);
-        rhs = sv_lookup_if_var(e->ctx, rhs);
-        lhs = sv_lookup_if_var(e->ctx, lhs);
-        char *pat = eval_sv_to_cstr_temp(e->ctx, rhs);
-        char *subj = eval_sv_to_cstr_temp(e->ctx, lhs);
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, pat, false);
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, subj, false);
-
-        regex_t re;
-        if (regcomp(&re, pat, REG_EXTENDED) != 0) return false;
-        regmatch_t matches[MAX_REGEX_MATCHES];
-        for (size_t i = 0; i < MAX_REGEX_MATCHES; i++) {
-            matches[i].rm_so = -1;
-            matches[i].rm_eo = -1;
-        }
-        int rc = regexec(&re, subj, MAX_REGEX_MATCHES, matches, 0);
-        regfree(&re);
-        if (!eval_set_regex_match_vars(e->ctx, subj, matches, MAX_REGEX_MATCHES, rc == 0)) return false;
-        return rc == 0;
-    }
-
-    if (eval_sv_eq_ci_lit(op, "IN_LIST")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View rhs = expr_next(e);
-        String_View needle = sv_lookup_if_var(e->ctx, lhs);
-        String_View list_text = sv_lookup_if_var(e->ctx, rhs);
+    case COND_TOK_MATCHES:
+        return cond_eval_matches(ctx, lhs, rhs);
+
+    case COND_TOK_IN_LIST: {
+        String_View needle = sv_lookup_if_var(ctx, lhs);
+        String_View list_text = sv_lookup_if_var(ctx, rhs);
         return sv_list_contains_item(list_text, needle);
     }
 
-    if (eval_sv_eq_ci_lit(op, "PATH_EQUAL")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        String_View rhs = expr_next(e);
-        String_View lhs_path = sv_lookup_if_var(e->ctx, lhs);
-        String_View rhs_path = sv_lookup_if_var(e->ctx, rhs);
-        lhs_path = sv_path_normalize_temp(e->ctx, lhs_path);
-        rhs_path = sv_path_normalize_temp(e->ctx, rhs_path);
-        if (eval_should_stop(e->ctx)) return false;
+    case COND_TOK_PATH_EQUAL: {
+        String_View lhs_path = sv_lookup_if_var(ctx, lhs);
+        String_View rhs_path = sv_lookup_if_var(ctx, rhs);
+        lhs_path = sv_path_normalize_temp(ctx, lhs_path);
+        rhs_path = sv_path_normalize_temp(ctx, rhs_path);
+        if (eval_should_stop(ctx)) return false;
         return sv_eq(lhs_path, rhs_path);
     }
 
-    if (eval_sv_eq_ci_lit(op, "IS_NEWER_THAN")) {
-        expr_next(e);
-        if (!expr_has(e)) return false;
-        char *lhs_path = eval_sv_to_cstr_temp(e->ctx, sv_lookup_if_var(e->ctx, lhs));
-        char *rhs_path = eval_sv_to_cstr_temp(e->ctx, sv_lookup_if_var(e->ctx, expr_next(e)));
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, lhs_path, false);
-        EVAL_OOM_RETURN_IF_NULL(e->ctx, rhs_path, false);
+    case COND_TOK_IS_NEWER_THAN: {
+        char *lhs_path = eval_sv_to_cstr_temp(ctx, sv_lookup_if_var(ctx, lhs));
+        char *rhs_path = eval_sv_to_cstr_temp(ctx, sv_lookup_if_var(ctx, rhs));
+        EVAL_OOM_RETURN_IF_NULL(ctx, lhs_path, false);
+        EVAL_OOM_RETURN_IF_NULL(ctx, rhs_path, false);
         return path_is_newer_than_cstr(lhs_path, rhs_path);
     }
 
-    return eval_truthy(e->ctx, lhs);
+    default:
+        return false;
+    }
 }
 
-static bool parse_and(Expr *e) {
-    bool lhs = parse_cmp(e);
-    while (expr_has(e) && eval_sv_eq_ci_lit(expr_peek(e), "AND")) {
-        expr_next(e);
-        bool rhs = parse_cmp(e);
-        lhs = lhs && rhs;
+static bool cond_program_run(EvalExecContext *ctx, const Cond_Program *program, const String_View *toks) {
+    Cmake_Event_Origin origin = {0};
+    bool local_stack[32];
+    bool *stack = local_stack;
+    if (program->op_count > NOB_ARRAY_LEN(local_stack)) {
+        stack = (bool*)arena_alloc(ctx->arena, program->op_count * sizeof(*stack));
+        EVAL_OOM_RETURN_IF_NULL(ctx, stack, false);
     }
-    return lhs;
-}
 
-static bool parse_expr(Expr *e) {
-    bool lhs = parse_and(e);
-    while (expr_has(e) && eval_sv_eq_ci_lit(expr_peek(e), "OR")) {
-        expr_next(e);
-        bool rhs = parse_and(e);
-        lhs = lhs || rhs;
+    size_t sp = 0;
+    for (size_t pc = 0; pc < program->op_count; pc++) {
+        const Cond_Op *op = &program->ops[pc];
+        switch ((Cond_Op_Code)op->code) {
+        case COND_OP_FALSE: stack[sp++] = false; break;
+        case COND_OP_TRUTHY: stack[sp++] = eval_truthy(ctx, toks[op->a]); break;
+        case COND_OP_UNARY: stack[sp++] = cond_eval_unary(ctx, op->cls, toks[op->a]); break;
+        case COND_OP_BINARY: stack[sp++] = cond_eval_binary(ctx, op->cls, toks[op->a], toks[op->b]); break;
+        case COND_OP_NOT: stack[sp - 1] = !stack[sp - 1]; break;
+        case COND_OP_AND: sp--; stack[sp - 1] = stack[sp - 1] && stack[sp]; break;
+        case COND_OP_OR: sp--; stack[sp - 1] = stack[sp - 1] || stack[sp]; break;
+        case COND_OP_JUMP_IF_FALSE: if (!stack[sp - 1]) pc = op->a - 1; break;
+        case COND_OP_JUMP_IF_TRUE: if (stack[sp - 1]) pc = op->a - 1; break;
+        case COND_OP_MISSING_PAREN:
+            EVAL_DIAG_EMIT_SEV(ctx, EV_DIAG_ERROR, EVAL_DIAG_MISSING_REQUIRED, nob_sv_from_cstr("eval_expr"), nob_sv_from_cstr("if"), origin, nob_sv_from_cstr("Missing ')' in expression"), nob_sv_from_cstr("Close parentheses"));
+            break;
+        case COND_OP_NOP: break;
+        }
     }
-    return lhs;
+
+    if (program->trailing_tokens) {
+        EVAL_DIAG_EMIT_SEV(ctx, EV_DIAG_ERROR, EVAL_DIAG_INVALID_VALUE, nob_sv_from_cstr("eval_expr"), nob_sv_from_cstr("if"), origin, nob_sv_from_cstr("Invalid if() syntax"), nob_sv_from_cstr("Check operators and parentheses"));
+        return false;
+    }
+    return sp > 0 && stack[sp - 1];
 }
 
-bool eval_condition(struct EvalExecContext *ctx, const Args *raw_condition) {
+bool eval_condition_cached(struct EvalExecContext *ctx, const Args *raw_condition, Condition_Cache *cache) {
     if (!ctx || !raw_condition) return false;
 
     SV_List toks = eval_resolve_args(ctx, raw_condition);
-    if (eval_should_stop(ctx) || arena_arr_len(toks) == 0) return false;
-
-    Expr e = {0};
-    e.ctx = ctx;
-    e.toks = toks;
-    e.count = arena_arr_len(toks);
-    e.pos = 0;
+    size_t count = arena_arr_len(toks);
+    if (eval_should_stop(ctx) || count == 0) return false;
 
-    bool v = parse_expr(&e);
+    uint8_t *classes = (uint8_t*)arena_alloc(ctx->arena, count);
+    EVAL_OOM_RETURN_IF_NULL(ctx, classes, false);
+    for (size_t i = 0; i < count; i++) classes[i] = cond_classify(toks[i]);
 
-    if (e.pos != e.count) {
-        EVAL_DIAG_EMIT_SEV(ctx, EV_DIAG_ERROR, EVAL_DIAG_INVALID_VALUE, nob_sv_from_cstr("eval_expr"), nob_sv_from_cstr("if"), e.origin, nob_sv_from_cstr("Invalid if() syntax"), nob_sv_from_cstr("Check operators and parentheses"));
-        return false;
-    }
+    const Cond_Program *program = cond_program_get(ctx, cache, classes, count);
+    if (!program) return false;
+    return cond_program_run(ctx, program, toks);
+}
 
-    return v;
+bool eval_condition(struct EvalExecContext *ctx, const Args *raw_condition) {
+    return eval_condition_cached(ctx, raw_condition, NULL);
 }
@@ -17,6 +17,16 @@ String_View eval_expand_vars(struct EvalExecContext *ctx, String_View input);
 // Retorna false em erro de sintaxe e emite EV_DIAGNOSTIC.
 bool eval_condition(struct EvalExecContext *ctx, const Args *raw_condition);
 
+// Um nó cuja expansão continua mudando de formato para de guardar o programa
+// depois deste número de recompilações e passa a compilar na TEMP ARENA.
+#define COND_PROGRAM_MAX_REBUILDS 4
+
+// Igual a eval_condition(), mas reaproveita o programa compilado guardado
+// em `cache` (apontado pelo nó da AST) enquanto a expansão mantiver o mesmo formato.
+bool eval_condition_cached(struct EvalExecContext *ctx,
+                           const Args *raw_condition,
+                           Condition_Cache *cache);
+
 // Lógica de "Truthiness" do CMake (v2 spec)
 // Requer o contexto pois faz fallback para lookup de variável.
 bool eval_truthy(struct EvalExecContext *ctx, String_View v);
@@ -350,6 +350,9 @@ static bool fetchcontent_push_active(EvalExecContext *ctx, String_View canonical
 static void fetchcontent_pop_active(EvalExecContext *ctx, bool pushed) {
     if (!ctx || !pushed) return;
     if (arena_arr_len(ctx->semantic_state.fetchcontent.active_makeavailable) == 0) return;
+    (void)eval_command_tx_note_slice(ctx,
+                                     EVAL_TX_SLICE_ACTIVE_MAKEAVAILABLE,
+                                     arena_arr_len(ctx->semantic_state.fetchcontent.active_makeavailable) - 1);
     arena_arr_set_len(ctx->semantic_state.fetchcontent.active_makeavailable,
                       arena_arr_len(ctx->semantic_state.fetchcontent.active_makeavailable) - 1);
 }
@@ -420,6 +423,11 @@ static bool fetchcontent_upsert_state(EvalExecContext *ctx,
     if (!ctx || dependency_name.count == 0 || canonical_name.count == 0) return false;
     Eval_FetchContent_State *state = fetchcontent_find_state(ctx, canonical_name);
     if (state) {
+        if (!eval_command_tx_note_elem(ctx,
+                                       EVAL_TX_SLICE_FETCHCONTENT_STATES,
+                                       (size_t)(state - ctx->semantic_state.fetchcontent.states))) {
+            return false;
+        }
         state->name = sv_copy_to_event_arena(ctx, dependency_name);
         state->population_processed = population_processed;
         state->populated = populated;
@@ -1233,10 +1241,8 @@ static bool fetchcontent_run_inline_command(EvalExecContext *ctx,
                                             String_View command_name,
                                             const SV_List *args) {
     if (!ctx || command_name.count == 0 || !args) return false;
-    String_View script = nob_sv_from_cstr("");
     Ast_Root ast = NULL;
-    if (!flow_build_call_script(ctx, command_name, args, &script)) return false;
-    if (!flow_parse_inline_script(ctx, script, &ast)) return false;
+    if (!flow_build_call_ast(ctx, command_name, *args, arena_arr_len(*args), 1, 1, &ast)) return false;
     Eval_Result res = eval_run_ast_inline(ctx, ast);
     return !eval_result_is_fatal(res) && !eval_result_is_soft_error(res);
 }
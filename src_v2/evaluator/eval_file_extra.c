@@ -54,7 +54,7 @@ static bool file_same_content(EvalExecContext *ctx, String_View path, String_Vie
 
 static String_View file_cache_var_get(EvalExecContext *ctx, String_View key) {
     if (!ctx || !ctx->scope_state.cache_entries || key.count == 0 || !key.data) return nob_sv_from_cstr("");
-    Eval_Cache_Entry *entry = stbds_shgetp_null(ctx->scope_state.cache_entries, nob_temp_sv_to_cstr(key));
+    Eval_Cache_Entry *entry = eval_cache_entry_find(ctx, key);
     return entry ? entry->value.data : nob_sv_from_cstr("");
 }
 
@@ -92,20 +92,17 @@ static bool handle_file_hash(EvalExecContext *ctx, const Node *node, SV_List arg
         return true;
     }
 
-    Nob_String_Builder data = {0};
-    if (!file_read_bytes(ctx, in_path, &data)) {
-        EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_IO_FAILURE, "eval_file", nob_sv_from_cstr("file(<HASH>) failed to read file"), in_path);
-        return true;
-    }
-
     String_View digest = nob_sv_from_cstr("");
-    String_View payload = nob_sv_from_parts(data.items, data.count);
-    bool ok = eval_hash_compute_hex_temp(ctx, args[0], payload, &digest);
-    nob_sb_free(data);
-    if (!ok) {
+    Eval_Hash_File_Status status = eval_hash_file_hex_temp(ctx, args[0], in_path, &digest);
+    if (eval_should_stop(ctx)) return true;
+    if (status == EVAL_HASH_FILE_UNSUPPORTED_ALGO) {
         EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_UNSUPPORTED_OPERATION, "eval_file", nob_sv_from_cstr("Unsupported hash algorithm"), args[0]);
         return true;
     }
+    if (status != EVAL_HASH_FILE_OK) {
+        EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_IO_FAILURE, "eval_file", nob_sv_from_cstr("file(<HASH>) failed to read file"), in_path);
+        return true;
+    }
 
     (void)eval_var_set_current(ctx, args[2], digest);
     return true;
@@ -583,6 +583,7 @@ bool eval_file_generate_flush(EvalExecContext *ctx) {
         (void)file_emit_replay_write_text(ctx, job->origin, job->output_path, final_content, mode_octal);
     }
 
+    if (!eval_command_tx_note_slice(ctx, EVAL_TX_SLICE_FILE_GENERATE_JOBS, 0)) return false;
     arena_arr_set_len(ctx->file_state.file_generate_jobs, 0);
     return !ctx->oom;
 }
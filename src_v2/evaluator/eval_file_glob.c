@@ -3,12 +3,17 @@
 #include "eval_expr.h"
 #include "sv_utils.h"
 #include "arena_dyn.h"
+#include "stb_ds.h"
 
 #include <ctype.h>
 #include <errno.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
 #if !defined(_WIN32)
+#include <dirent.h>
 #include <glob.h>
 #endif
 
@@ -239,11 +244,193 @@ static String_View sv_make_relative(String_View path, String_View base, bool ci)
     return nob_sv_from_parts(path.data + off, path.count - off);
 }
 
+// Directory stamps written within this many seconds may still change without
+// moving mtime, so those listings are read again instead of cached.
+#define EVAL_DIR_CACHE_RACY_SECONDS 2
+
+static bool glob_dir_stat_stamp(const char *dir_c, Eval_Dir_Snapshot *out) {
+    struct stat st;
+    if (stat(dir_c, &st) != 0) return false;
+    out->mtime_sec = (long long)st.st_mtime;
+#if defined(__APPLE__)
+    out->mtime_nsec = (long)st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    out->mtime_nsec = 0;
+#else
+    out->mtime_nsec = (long)st.st_mtim.tv_nsec;
+#endif
+    return (long long)time(NULL) - out->mtime_sec >= EVAL_DIR_CACHE_RACY_SECONDS;
+}
+
+// Classifies the current entry from the directory record when the platform
+// reports its type, and falls back to lstat() semantics otherwise.
+static bool glob_dir_entry_is_dir(Nob_Dir_Entry *dir, const char *full_c, bool *out_is_dir) {
+#if defined(_WIN32)
+    (void)full_c;
+    *out_is_dir = (dir->nob__private.win32_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    return true;
+#else
+#if defined(DT_UNKNOWN)
+    unsigned char d_type = dir->nob__private.posix_ent->d_type;
+    if (d_type != DT_UNKNOWN) {
+        *out_is_dir = d_type == DT_DIR;
+        return true;
+    }
+#else
+    (void)dir;
+#endif
+    Nob_File_Type kind = nob_get_file_type(full_c);
+    if ((int)kind < 0) return false;
+    *out_is_dir = kind == NOB_FILE_DIRECTORY;
+    return true;
+#endif
+}
+
+// Returns the entries of `dir_full`, served from the session cache when the
+// directory is unchanged. On open failure the diagnostic is emitted here and
+// false is returned with ctx->oom untouched.
+static bool glob_dir_snapshot(EvalExecContext *ctx,
+                              const Node *node,
+                              Cmake_Event_Origin origin,
+                              String_View dir_full,
+                              bool strict_failures,
+                              size_t *io_open_failures,
+                              Eval_Dir_Snapshot_Entry **out_entries) {
+    *out_entries = NULL;
+    char *dir_c = eval_sv_to_cstr_temp(ctx, dir_full);
+    EVAL_OOM_RETURN_IF_NULL(ctx, dir_c, false);
+
+    EvalSession *session = ctx->session;
+    Eval_Runtime_State *runtime = eval_runtime_slice(ctx);
+    Eval_Dir_Snapshot stamp = {0};
+    bool stamp_trusted = session && glob_dir_stat_stamp(dir_c, &stamp);
+    Eval_Dir_Cache_Entry *cached = session ? stbds_shgetp_null(session->dir_cache, dir_c) : NULL;
+    if (cached && stamp_trusted &&
+        cached->value.mtime_sec == stamp.mtime_sec &&
+        cached->value.mtime_nsec == stamp.mtime_nsec) {
+        runtime->run_report.dir_cache_hits++;
+        *out_entries = cached->value.entries;
+        return true;
+    }
+    runtime->run_report.dir_cache_misses++;
+
+    Nob_Dir_Entry dir = {0};
+    if (!nob_dir_entry_open(dir_c, &dir)) {
+        String_View cause = nob_sv_from_cstr("file(GLOB) failed to open directory");
+        if (io_open_failures) (*io_open_failures)++;
+        EVAL_DIAG_EMIT_SEV(ctx, strict_failures ? EV_DIAG_ERROR : EV_DIAG_WARNING, EVAL_DIAG_IO_FAILURE, nob_sv_from_cstr("eval_file"), node ? node->as.cmd.name : nob_sv_from_cstr("file"), origin, cause, dir_full);
+        return false;
+    }
+
+    Arena *arena = stamp_trusted ? eval_event_arena(ctx) : eval_temp_arena(ctx);
+    Eval_Dir_Snapshot_Entry *entries = NULL;
+    while (nob_dir_entry_next(&dir)) {
+        if (strcmp(dir.name, ".") == 0 || strcmp(dir.name, "..") == 0) continue;
+        String_View name = nob_sv_from_cstr(dir.name);
+        String_View full = eval_sv_path_join(eval_temp_arena(ctx), dir_full, name);
+        char *full_c = eval_sv_to_cstr_temp(ctx, full);
+        if (!full_c) {
+            nob_dir_entry_close(dir);
+            return false;
+        }
+        Eval_Dir_Snapshot_Entry entry = {0};
+        if (!glob_dir_entry_is_dir(&dir, full_c, &entry.is_dir)) continue;
+        entry.name = sv_copy_to_arena(arena, name);
+        if (!entry.name.data || !EVAL_ARR_PUSH(ctx, arena, entries, entry)) {
+            nob_dir_entry_close(dir);
+            return ctx_oom(ctx);
+        }
+    }
+
+    bool read_failed = dir.error;
+    nob_dir_entry_close(dir);
+    if (read_failed) {
+        // Keep what was read, as before, but never cache a partial listing.
+        if (io_open_failures) (*io_open_failures)++;
+        *out_entries = entries;
+        return true;
+    }
+
+    if (stamp_trusted) {
+        stamp.entries = entries;
+        if (cached) {
+            cached->value = stamp;
+        } else {
+            char *key = arena_strndup(eval_event_arena(ctx), dir_c, dir_full.count);
+            EVAL_OOM_RETURN_IF_NULL(ctx, key, false);
+            stbds_shput(session->dir_cache, key, stamp);
+        }
+    }
+    *out_entries = entries;
+    return true;
+}
+
+// A pattern prepared for matching during a shared walk. Neither `*`, `?`
+// nor a bracket class matches a path separator, so any match has exactly
+// `separators` separators; that rejects most entries cheaply and bounds how
+// deep a recursive walk needs to go.
+typedef struct {
+    String_View pattern;
+    String_View literal_tail; // bytes after the last wildcard; every match ends with them
+    size_t separators;        // SIZE_MAX when a separator sits inside a bracket
+} Glob_Compiled_Pattern;
+
+static size_t glob_count_separators(String_View sv) {
+    size_t n = 0;
+    for (size_t i = 0; i < sv.count; i++) {
+        if (svu_is_path_sep(sv.data[i])) n++;
+    }
+    return n;
+}
+
+static Glob_Compiled_Pattern glob_compile_pattern(String_View pattern) {
+    Glob_Compiled_Pattern out = {0};
+    out.pattern = pattern;
+
+    size_t tail_start = 0;
+    bool in_bracket = false;
+    for (size_t i = 0; i < pattern.count; i++) {
+        char c = pattern.data[i];
+        if (c == '*' || c == '?' || c == '[' || c == ']') tail_start = i + 1;
+        if (c == '[') in_bracket = true;
+        else if (c == ']') in_bracket = false;
+        else if (in_bracket && svu_is_path_sep(c)) out.separators = SIZE_MAX;
+    }
+    out.literal_tail = nob_sv_from_parts(pattern.data + tail_start, pattern.count - tail_start);
+    if (out.separators != SIZE_MAX) out.separators = glob_count_separators(pattern);
+    return out;
+}
+
+static bool glob_sv_ends_with(String_View s, String_View tail, bool ci) {
+    if (tail.count > s.count) return false;
+    const char *p = s.data + (s.count - tail.count);
+    for (size_t i = 0; i < tail.count; i++) {
+        char a = p[i];
+        char b = tail.data[i];
+        if (ci) {
+            a = (char)tolower((unsigned char)a);
+            b = (char)tolower((unsigned char)b);
+        }
+        if (a != b) return false;
+    }
+    return true;
+}
+
+static bool glob_compiled_match(const Glob_Compiled_Pattern *pat, String_View full, size_t full_separators, bool ci) {
+    if (pat->separators != SIZE_MAX && pat->separators != full_separators) return false;
+    if (!glob_sv_ends_with(full, pat->literal_tail, ci)) return false;
+    return eval_file_glob_match_sv(pat->pattern, full, ci);
+}
+
+// Walks `dir_full` once for every pattern sharing that base. Each pattern
+// that matches an entry contributes it, exactly as separate walks would.
 static void file_glob_walk(EvalExecContext *ctx,
                            const Node *node,
                            Cmake_Event_Origin origin,
                            String_View dir_full,
-                           String_View pat,
+                           const Glob_Compiled_Pattern *pats,
+                           size_t pat_count,
+                           size_t max_separators,
                            bool recurse,
                            bool list_dirs,
                            bool ci,
@@ -255,57 +442,29 @@ static void file_glob_walk(EvalExecContext *ctx,
     if (ctx->oom) return;
     if (dir_full.count == 0) return;
 
-    char *dir_c = (char*)arena_alloc(eval_temp_arena(ctx), dir_full.count + 1);
-    EVAL_OOM_RETURN_VOID_IF_NULL(ctx, dir_c);
-    memcpy(dir_c, dir_full.data, dir_full.count);
-    dir_c[dir_full.count] = 0;
+    Eval_Dir_Snapshot_Entry *entries = NULL;
+    if (!glob_dir_snapshot(ctx, node, origin, dir_full, strict_failures, io_open_failures, &entries)) return;
 
-    Nob_Dir_Entry dir = {0};
-    if (!nob_dir_entry_open(dir_c, &dir)) {
-        String_View cause = nob_sv_from_cstr("file(GLOB) failed to open directory");
-        if (io_open_failures) (*io_open_failures)++;
-        EVAL_DIAG_EMIT_SEV(ctx, strict_failures ? EV_DIAG_ERROR : EV_DIAG_WARNING, EVAL_DIAG_IO_FAILURE, nob_sv_from_cstr("eval_file"), node ? node->as.cmd.name : nob_sv_from_cstr("file"), origin, cause, dir_full);
-        return;
-    }
-
-    while (nob_dir_entry_next(&dir)) {
-        bool is_dir = false;
-        String_View name = {0};
-        String_View full = {0};
-        char *full_c = NULL;
-        Nob_File_Type kind = NOB_FILE_OTHER;
+    size_t child_separators = glob_count_separators(dir_full) + (svu_is_path_sep(dir_full.data[dir_full.count - 1]) ? 0 : 1);
+    for (size_t i = 0; i < arena_arr_len(entries); i++) {
+        bool is_dir = entries[i].is_dir;
+        String_View full = eval_sv_path_join(eval_temp_arena(ctx), dir_full, entries[i].name);
+        if (ctx->oom) return;
 
-        if (strcmp(dir.name, ".") == 0 || strcmp(dir.name, "..") == 0) continue;
-        name = nob_sv_from_cstr(dir.name);
-        full = eval_sv_path_join(eval_temp_arena(ctx), dir_full, name);
-        full_c = eval_sv_to_cstr_temp(ctx, full);
-        if (!full_c) {
-            nob_dir_entry_close(dir);
-            return;
-        }
-        kind = nob_get_file_type(full_c);
-        if ((int)kind < 0) continue;
-        is_dir = kind == NOB_FILE_DIRECTORY;
-
-        if (eval_file_glob_match_sv(pat, full, ci)) {
-            if (list_dirs || !is_dir) {
-                if (EVAL_ARR_PUSH(ctx, eval_temp_arena(ctx), *io_items, full)) {
-                    *io_count = arena_arr_len(*io_items);
-                    *io_cap = arena_arr_cap(*io_items);
-                } else {
-                    break;
-                }
+        if (list_dirs || !is_dir) {
+            for (size_t p = 0; p < pat_count; p++) {
+                if (!glob_compiled_match(&pats[p], full, child_separators, ci)) continue;
+                if (!EVAL_ARR_PUSH(ctx, eval_temp_arena(ctx), *io_items, full)) return;
+                *io_count = arena_arr_len(*io_items);
+                *io_cap = arena_arr_cap(*io_items);
             }
         }
 
-        if (recurse && is_dir) {
-            file_glob_walk(ctx, node, origin, full, pat, recurse, list_dirs, ci, strict_failures, io_open_failures, io_items, io_count, io_cap);
-            if (ctx->oom) break;
+        if (recurse && is_dir && child_separators < max_separators) {
+            file_glob_walk(ctx, node, origin, full, pats, pat_count, max_separators, recurse, list_dirs, ci, strict_failures, io_open_failures, io_items, io_count, io_cap);
+            if (ctx->oom) return;
         }
     }
-
-    if (dir.error && io_open_failures) (*io_open_failures)++;
-    nob_dir_entry_close(dir);
 }
 
 void eval_file_handle_glob(EvalExecContext *ctx, const Node *node, SV_List args, bool recurse) {
@@ -357,6 +516,9 @@ void eval_file_handle_glob(EvalExecContext *ctx, const Node *node, SV_List args,
         relative_base = eval_sv_path_join(eval_temp_arena(ctx), current_src, relative_base);
     }
 
+    // Patterns sharing a base directory are matched during one walk of it.
+    String_View *walk_bases = NULL;
+    Glob_Compiled_Pattern *walk_pats = NULL;
     for (size_t i = pat_idx; i < arena_arr_len(args); ++i) {
         String_View pat = args[i];
         if (!eval_sv_is_abs_path(pat)) {
@@ -372,8 +534,26 @@ void eval_file_handle_glob(EvalExecContext *ctx, const Node *node, SV_List args,
         }
 #endif
 
-        String_View base_dir = glob_base_dir(pat);
-        file_glob_walk(ctx, node, o, base_dir, pat, recurse, list_dirs, ci, glob_strict, &open_failures, &matches, &mcount, &mcap);
+        if (!EVAL_ARR_PUSH(ctx, eval_temp_arena(ctx), walk_bases, glob_base_dir(pat))) return;
+        if (!EVAL_ARR_PUSH(ctx, eval_temp_arena(ctx), walk_pats, glob_compile_pattern(pat))) return;
+    }
+
+    size_t walk_count = arena_arr_len(walk_pats);
+    bool *walked = walk_count > 0 ? arena_alloc_array_zero(eval_temp_arena(ctx), bool, walk_count) : NULL;
+    if (walk_count > 0) EVAL_OOM_RETURN_VOID_IF_NULL(ctx, walked);
+    Glob_Compiled_Pattern *group = walk_count > 0 ? arena_alloc_array(eval_temp_arena(ctx), Glob_Compiled_Pattern, walk_count) : NULL;
+    if (walk_count > 0) EVAL_OOM_RETURN_VOID_IF_NULL(ctx, group);
+    for (size_t i = 0; i < walk_count; i++) {
+        if (walked[i]) continue;
+        size_t group_count = 0;
+        size_t max_separators = 0;
+        for (size_t j = i; j < walk_count; j++) {
+            if (walked[j] || !nob_sv_eq(walk_bases[j], walk_bases[i])) continue;
+            walked[j] = true;
+            group[group_count++] = walk_pats[j];
+            if (walk_pats[j].separators > max_separators) max_separators = walk_pats[j].separators;
+        }
+        file_glob_walk(ctx, node, o, walk_bases[i], group, group_count, max_separators, recurse, list_dirs, ci, glob_strict, &open_failures, &matches, &mcount, &mcap);
         if (ctx->oom) return;
         if (eval_should_stop(ctx)) return;
     }
@@ -1,5 +1,6 @@
 #include "eval_file_internal.h"
 
+#include "eval_regex_cache.h"
 #include "sv_utils.h"
 
 #include <errno.h>
@@ -7,7 +8,6 @@
 #include <string.h>
 #include <sys/stat.h>
 #if !defined(_WIN32)
-#include <regex.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -171,17 +171,13 @@ static bool runtime_match_any_regex(EvalExecContext *ctx,
     char *val_c = eval_sv_to_cstr_temp(ctx, value);
     EVAL_OOM_RETURN_IF_NULL(ctx, val_c, false);
     for (size_t i = 0; i < arena_arr_len(regexes); i++) {
-        char *rx_c = eval_sv_to_cstr_temp(ctx, regexes[i]);
-        EVAL_OOM_RETURN_IF_NULL(ctx, rx_c, false);
-        regex_t re = {0};
-        int rc = regcomp(&re, rx_c, REG_EXTENDED);
-        if (rc != 0) {
+        const regex_t *re = eval_regex_cache_get(ctx, regexes[i], REG_EXTENDED);
+        if (!re) {
+            if (ctx->oom) return false;
             EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_INVALID_VALUE, "eval_file", nob_sv_from_cstr("file(GET_RUNTIME_DEPENDENCIES) invalid regex"), regexes[i]);
             return false;
         }
-        int m = regexec(&re, val_c, 0, NULL, 0);
-        regfree(&re);
-        if (m == 0) {
+        if (regexec(re, val_c, 0, NULL, 0) == 0) {
             *out_match = true;
             return true;
         }
@@ -1,5 +1,6 @@
 #include "eval_file_internal.h"
 #include "arena_dyn.h"
+#include "eval_regex_cache.h"
 #include "sv_utils.h"
 
 #include <pcre2posix.h>
@@ -603,17 +604,15 @@ void eval_file_handle_strings(EvalExecContext *ctx, const Node *node, SV_List ar
     const char *input_data = decoded_input.data ? decoded_input.data : "";
     input_n = decoded_input.count;
 
-    regex_t re = {0};
-    bool re_compiled = false;
+    const regex_t *re = NULL;
     if (opt.has_regex) {
-        char *regex_c = eval_sv_to_cstr_temp(ctx, opt.regex);
-        EVAL_OOM_RETURN_VOID_IF_NULL(ctx, regex_c);
-        if (regcomp(&re, regex_c, REG_EXTENDED) != 0) {
+        re = eval_regex_cache_get(ctx, opt.regex, REG_EXTENDED);
+        if (!re) {
             nob_sb_free(sb);
+            if (ctx->oom) return;
             EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_INVALID_VALUE, "eval_file", nob_sv_from_cstr("file(STRINGS) invalid REGEX"), opt.regex);
             return;
         }
-        re_compiled = true;
     }
 
     Nob_String_Builder out = {0};
@@ -641,7 +640,6 @@ void eval_file_handle_strings(EvalExecContext *ctx, const Node *node, SV_List ar
         if (has_cr) {
             char *filtered = (char*)arena_alloc(eval_temp_arena(ctx), len + 1);
             if (!filtered) {
-                if (re_compiled) regfree(&re);
                 nob_sb_free(out);
                 nob_sb_free(sb);
                 EVAL_OOM_RETURN_VOID_IF_NULL(ctx, filtered);
@@ -659,17 +657,16 @@ void eval_file_handle_strings(EvalExecContext *ctx, const Node *node, SV_List ar
         if (keep && opt.has_len_min && len < opt.len_min) keep = false;
         if (keep && opt.has_len_max && len > opt.len_max) keep = false;
 
-        if (keep && re_compiled) {
+        if (keep && re) {
             char *line_c = (char*)arena_alloc(eval_temp_arena(ctx), len + 1);
             if (!line_c) {
-                if (re_compiled) regfree(&re);
                 nob_sb_free(out);
                 nob_sb_free(sb);
                 EVAL_OOM_RETURN_VOID_IF_NULL(ctx, line_c);
             }
             memcpy(line_c, line_ptr, len);
             line_c[len] = '\0';
-            keep = regexec(&re, line_c, 0, NULL, 0) == 0;
+            keep = regexec(re, line_c, 0, NULL, 0) == 0;
         }
 
         if (keep) {
@@ -688,7 +685,6 @@ void eval_file_handle_strings(EvalExecContext *ctx, const Node *node, SV_List ar
 
     nob_sb_append_null(&out);
     String_View out_sv = out.items ? nob_sv_from_parts(out.items, out.count - 1) : nob_sv_from_cstr("");
-    if (re_compiled) regfree(&re);
     (void)eval_var_set_current(ctx, out_var, out_sv);
     nob_sb_free(out);
     nob_sb_free(sb);
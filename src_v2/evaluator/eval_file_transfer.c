@@ -343,21 +343,17 @@ static bool file_transfer_verify_download_hash(EvalExecContext *ctx,
         return true;
     }
 
-    char *dst_c = eval_sv_to_cstr_temp(ctx, dst);
-    EVAL_OOM_RETURN_IF_NULL(ctx, dst_c, false);
-    Nob_String_Builder sb = {0};
-    if (!nob_read_entire_file(dst_c, &sb)) {
-        *out_status = nob_sv_from_cstr("failed to read downloaded file for hash verification");
-        return false;
-    }
-    String_View payload = nob_sv_from_parts(sb.items, sb.count);
     String_View actual = nob_sv_from_cstr("");
-    bool ok = eval_hash_compute_hex_temp(ctx, algo, payload, &actual);
-    nob_sb_free(sb);
-    if (!ok) {
+    Eval_Hash_File_Status status = eval_hash_file_hex_temp(ctx, algo, dst, &actual);
+    if (ctx->oom) return false;
+    if (status == EVAL_HASH_FILE_UNSUPPORTED_ALGO) {
         *out_status = nob_sv_from_cstr("unsupported EXPECTED_HASH algorithm");
         return false;
     }
+    if (status != EVAL_HASH_FILE_OK) {
+        *out_status = nob_sv_from_cstr("failed to read downloaded file for hash verification");
+        return false;
+    }
 
     if (!file_transfer_sv_eq_ci(actual, expected)) {
         *out_status = nob_sv_from_cstr("download hash mismatch");
@@ -1,5 +1,8 @@
 #include "eval_flow_internal.h"
 
+#include "diagnostics.h"
+#include "stb_ds.h"
+
 #include <string.h>
 #include <time.h>
 
@@ -19,10 +22,7 @@ static bool flow_token_list_append(Arena *arena, Token_List *list, Token token)
     return arena_arr_push(arena, *list, token);
 }
 
-bool flow_parse_inline_script(EvalExecContext *ctx, String_View script, Ast_Root *out_ast) {
-    if (!ctx || !out_ast) return false;
-    *out_ast = NULL;
-
+static bool flow_lex_parse_inline_script(EvalExecContext *ctx, Arena *arena, String_View script, Ast_Root *out_ast) {
     Lexer lx = lexer_init(script);
     Token_List toks = NULL;
     for (;;) {
@@ -31,7 +31,48 @@ bool flow_parse_inline_script(EvalExecContext *ctx, String_View script, Ast_Root
         if (!flow_token_list_append(ctx->arena, &toks, t)) return ctx_oom(ctx);
     }
 
-    *out_ast = parse_tokens(ctx->arena, toks);
+    *out_ast = parse_tokens(arena, toks);
+    return true;
+}
+
+// Identical payloads parse once per session. Scripts that produced parser
+// diagnostics stay uncached so the diagnostics repeat, as for include().
+bool flow_parse_inline_script(EvalExecContext *ctx, String_View script, Ast_Root *out_ast) {
+    if (!ctx || !out_ast) return false;
+    *out_ast = NULL;
+
+    // Keys are C strings, so text with embedded NULs is never cached.
+    EvalSession *session = ctx->session;
+    if (!session || (script.count > 0 && memchr(script.data, '\0', script.count))) {
+        return flow_lex_parse_inline_script(ctx, ctx->arena, script, out_ast);
+    }
+
+    Eval_Runtime_State *runtime = eval_runtime_slice(ctx);
+    char *key = arena_strndup(ctx->arena, script.data ? script.data : "", script.count);
+    EVAL_OOM_RETURN_IF_NULL(ctx, key, false);
+    Eval_Inline_Ast_Cache_Entry *entry = stbds_shgetp_null(session->inline_ast_cache, key);
+    if (entry) {
+        runtime->run_report.inline_ast_cache_hits++;
+        *out_ast = entry->value;
+        return true;
+    }
+
+    runtime->run_report.inline_ast_cache_misses++;
+    if (session->inline_ast_cache_bytes + script.count > EVAL_INLINE_AST_CACHE_MAX_BYTES) {
+        return flow_lex_parse_inline_script(ctx, ctx->arena, script, out_ast);
+    }
+
+    Arena *persistent = eval_event_arena(ctx);
+    char *stable_key = arena_strndup(persistent, key, script.count);
+    EVAL_OOM_RETURN_IF_NULL(ctx, stable_key, false);
+    size_t diags_before = diag_error_count() + diag_warning_count();
+    Ast_Root ast = NULL;
+    if (!flow_lex_parse_inline_script(ctx, persistent, nob_sv_from_parts(stable_key, script.count), &ast)) return false;
+    *out_ast = ast;
+    if (diag_error_count() + diag_warning_count() != diags_before) return true;
+
+    stbds_shput(session->inline_ast_cache, stable_key, ast);
+    session->inline_ast_cache_bytes += script.count;
     return true;
 }
 
@@ -88,42 +129,64 @@ bool flow_append_sv(Nob_String_Builder *sb, String_View sv) {
     return true;
 }
 
-bool flow_build_call_script(EvalExecContext *ctx,
-                            String_View command_name,
-                            const SV_List *args,
-                            String_View *out_script) {
-    if (!ctx || !args || !out_script) return false;
-    *out_script = nob_sv_from_cstr("");
-
-    Nob_String_Builder sb = {0};
-    if (!flow_append_sv(&sb, command_name)) {
-        nob_sb_free(sb);
-        return ctx_oom(ctx);
-    }
-    nob_sb_append(&sb, '(');
-    for (size_t i = 0; i < arena_arr_len(*args); i++) {
-        nob_sb_append(&sb, ' ');
-        size_t eqs = flow_bracket_eq_count((*args)[i]);
-        nob_sb_append(&sb, '[');
-        for (size_t j = 0; j < eqs; j++) nob_sb_append(&sb, '=');
-        nob_sb_append(&sb, '[');
-        if (!flow_append_sv(&sb, (*args)[i])) {
-            nob_sb_free(sb);
-            return ctx_oom(ctx);
-        }
-        nob_sb_append(&sb, ']');
-        for (size_t j = 0; j < eqs; j++) nob_sb_append(&sb, '=');
-        nob_sb_append(&sb, ']');
-    }
-    nob_sb_append_cstr(&sb, ")\n");
+// Bracket-quotes `value` with the shortest `=` run that cannot close early,
+// giving the same argument text the parser would produce for it.
+static bool flow_call_arg_from_sv(EvalExecContext *ctx, String_View value, size_t line, size_t col, Arg *out_arg) {
+    size_t eqs = flow_bracket_eq_count(value);
+    size_t len = value.count + 2 * eqs + 4;
+    char *buf = (char*)arena_alloc(ctx->arena, len + 1);
+    EVAL_OOM_RETURN_IF_NULL(ctx, buf, false);
+
+    size_t off = 0;
+    buf[off++] = '[';
+    memset(buf + off, '=', eqs);
+    off += eqs;
+    buf[off++] = '[';
+    if (value.count > 0) memcpy(buf + off, value.data, value.count);
+    off += value.count;
+    buf[off++] = ']';
+    memset(buf + off, '=', eqs);
+    off += eqs;
+    buf[off++] = ']';
+    buf[off] = '\0';
 
-    char *copy = arena_strndup(ctx->arena, sb.items ? sb.items : "", sb.count);
-    nob_sb_free(sb);
-    EVAL_OOM_RETURN_IF_NULL(ctx, copy, false);
-    *out_script = nob_sv_from_parts(copy, strlen(copy));
+    Token tok = {0};
+    tok.kind = TOKEN_RAW_STRING;
+    tok.text = nob_sv_from_parts(buf, off);
+    tok.line = line;
+    tok.col = col;
+    tok.has_space_left = true;
+
+    Arg arg = {0};
+    arg.kind = ARG_BRACKET;
+    if (!EVAL_ARR_PUSH(ctx, ctx->arena, arg.items, tok)) return false;
+    *out_arg = arg;
     return true;
 }
 
+bool flow_build_call_ast(EvalExecContext *ctx,
+                         String_View command_name,
+                         const String_View *args,
+                         size_t arg_count,
+                         size_t line,
+                         size_t col,
+                         Ast_Root *out_ast) {
+    if (!ctx || (!args && arg_count > 0) || !out_ast) return false;
+    *out_ast = NULL;
+
+    Node call = {0};
+    call.kind = NODE_COMMAND;
+    call.line = line;
+    call.col = col;
+    call.as.cmd.name = command_name;
+    for (size_t i = 0; i < arg_count; i++) {
+        Arg arg = {0};
+        if (!flow_call_arg_from_sv(ctx, args[i], line, col, &arg)) return false;
+        if (!EVAL_ARR_PUSH(ctx, ctx->arena, call.as.cmd.args, arg)) return false;
+    }
+    return EVAL_ARR_PUSH(ctx, ctx->arena, *out_ast, call);
+}
+
 bool flow_sv_eq_exact(String_View a, String_View b) {
     if (a.count != b.count) return false;
     if (a.count == 0) return true;
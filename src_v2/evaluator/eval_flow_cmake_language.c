@@ -136,10 +136,19 @@ static Eval_Deferred_Call *flow_find_deferred_call(Eval_Deferred_Dir_Frame *fram
     return NULL;
 }
 
-static bool flow_remove_all_deferred_calls_with_id(Eval_Deferred_Dir_Frame *frame, String_View id) {
-    if (!frame || id.count == 0) return false;
+static bool flow_note_defer_dir_mutation(EvalExecContext *ctx, const Eval_Deferred_Dir_Frame *frame) {
+    return eval_command_tx_note_slice(ctx,
+                                      EVAL_TX_SLICE_DEFERRED_DIRS,
+                                      (size_t)(frame - ctx->file_state.deferred_dirs));
+}
+
+static bool flow_remove_all_deferred_calls_with_id(EvalExecContext *ctx,
+                                                   Eval_Deferred_Dir_Frame *frame,
+                                                   String_View id) {
+    if (!ctx || !frame || id.count == 0) return false;
     for (size_t i = arena_arr_len(frame->calls); i-- > 0;) {
         if (!flow_sv_eq_exact(frame->calls[i].id, id)) continue;
+        if (!flow_note_defer_dir_mutation(ctx, frame)) return false;
         if (!flow_deferred_call_list_remove_at(&frame->calls, i)) return false;
     }
     return true;
@@ -228,6 +237,7 @@ static bool flow_append_defer_queue(EvalExecContext *ctx,
                                     Eval_Deferred_Dir_Frame *frame,
                                     Eval_Deferred_Call call) {
     if (!ctx || !frame) return false;
+    if (!flow_note_defer_dir_mutation(ctx, frame)) return false;
     return EVAL_ARR_PUSH(ctx, ctx->event_arena, frame->calls, call);
 }
 
@@ -243,6 +253,11 @@ bool eval_defer_push_directory(EvalExecContext *ctx, String_View source_dir, Str
 bool eval_defer_pop_directory(EvalExecContext *ctx) {
     if (!ctx) return false;
     if (arena_arr_len(ctx->file_state.deferred_dirs) == 0) return true;
+    if (!eval_command_tx_note_slice(ctx,
+                                    EVAL_TX_SLICE_DEFERRED_DIRS,
+                                    arena_arr_len(ctx->file_state.deferred_dirs) - 1)) {
+        return false;
+    }
     arena_arr_set_len(ctx->file_state.deferred_dirs, arena_arr_len(ctx->file_state.deferred_dirs) - 1);
     return true;
 }
@@ -258,6 +273,7 @@ bool eval_defer_flush_current_directory(EvalExecContext *ctx) {
 
     while (arena_arr_len(frame->calls) > 0) {
         Eval_Deferred_Call call = {0};
+        if (!flow_note_defer_dir_mutation(ctx, frame)) return false;
         if (!flow_deferred_call_list_pop_front(&frame->calls, &call)) return false;
 
         Node deferred = {0};
@@ -312,20 +328,17 @@ static bool flow_run_call(EvalExecContext *ctx, const Node *node, const SV_List
         return true;
     }
 
-    const String_View *call_args = &(*args)[2];
-    size_t call_arg_count = arena_arr_len(*args) - 2;
-
-    String_View script = nob_sv_from_cstr("");
-    {
-        SV_List tmp = NULL;
-        for (size_t i = 0; i < call_arg_count; i++) {
-            if (!EVAL_ARR_PUSH(ctx, ctx->arena, tmp, call_args[i])) return false;
-        }
-        if (!flow_build_call_script(ctx, command_name, &tmp, &script)) { if (eval_should_stop(ctx)) return false; return true; }
-    }
-
     Ast_Root ast = NULL;
-    if (!flow_parse_inline_script(ctx, script, &ast)) { if (eval_should_stop(ctx)) return false; return true; }
+    if (!flow_build_call_ast(ctx,
+                             command_name,
+                             &(*args)[2],
+                             arena_arr_len(*args) - 2,
+                             node->line,
+                             node->col,
+                             &ast)) {
+        if (eval_should_stop(ctx)) return false;
+        return true;
+    }
     eval_command_tx_preserve_scope_vars_on_failure(ctx);
     Eval_Result inline_result = eval_run_ast_inline(ctx, ast);
     if (eval_result_is_fatal(inline_result)) return false;
@@ -658,7 +671,7 @@ static bool flow_handle_defer(EvalExecContext *ctx, const Node *node) {
         for (size_t k = i + 1; k < arena_arr_len(*raw); k++) {
             String_View id = flow_eval_arg_single(ctx, &(*raw)[k], true);
             if (eval_should_stop(ctx)) return false;
-            if (!flow_remove_all_deferred_calls_with_id(frame, id)) return false;
+            if (!flow_remove_all_deferred_calls_with_id(ctx, frame, id)) return false;
         }
         if (eval_should_stop(ctx)) return false;
         return true;
@@ -13,10 +13,16 @@ bool flow_parse_inline_script(EvalExecContext *ctx, String_View script, Ast_Root
 bool flow_is_valid_command_name(String_View name);
 bool flow_is_call_disallowed(String_View name);
 bool flow_append_sv(Nob_String_Builder *sb, String_View sv);
-bool flow_build_call_script(EvalExecContext *ctx,
-                            String_View command_name,
-                            const SV_List *args,
-                            String_View *out_script);
+// Builds a one-command AST calling `command_name` with each value as a
+// bracket argument, so the call runs through the regular dispatcher without
+// rendering and reparsing a script.
+bool flow_build_call_ast(EvalExecContext *ctx,
+                         String_View command_name,
+                         const String_View *args,
+                         size_t arg_count,
+                         size_t line,
+                         size_t col,
+                         Ast_Root *out_ast);
 bool flow_sv_eq_exact(String_View a, String_View b);
 bool flow_arg_exact_ci(String_View value, const char *lit);
 String_View flow_current_binary_dir(EvalExecContext *ctx);
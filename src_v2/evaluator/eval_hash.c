@@ -1,7 +1,8 @@
 #include "eval_hash.h"
 
-#include <string.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
 static uint32_t string_load_le32(const unsigned char *p) {
     return ((uint32_t)p[0]) |
@@ -123,34 +124,6 @@ static void string_md5_process_block(uint32_t state[4], const unsigned char bloc
     state[3] += d;
 }
 
-static void string_md5_compute(const unsigned char *msg, size_t len, unsigned char out[16]) {
-    uint32_t state[4] = { 0x67452301U, 0xefcdab89U, 0x98badcfeU, 0x10325476U };
-
-    size_t full = len / 64;
-    for (size_t i = 0; i < full; i++) {
-        string_md5_process_block(state, msg + (i * 64));
-    }
-
-    unsigned char tail[128] = {0};
-    size_t rem = len % 64;
-    if (rem > 0) memcpy(tail, msg + (full * 64), rem);
-    tail[rem] = 0x80;
-    size_t tail_len = (rem < 56) ? 64 : 128;
-
-    uint64_t bits = ((uint64_t)len) * 8U;
-    for (size_t i = 0; i < 8; i++) {
-        tail[tail_len - 8 + i] = (unsigned char)((bits >> (8 * i)) & 0xFFU);
-    }
-
-    string_md5_process_block(state, tail);
-    if (tail_len == 128) string_md5_process_block(state, tail + 64);
-
-    string_store_le32(out + 0, state[0]);
-    string_store_le32(out + 4, state[1]);
-    string_store_le32(out + 8, state[2]);
-    string_store_le32(out + 12, state[3]);
-}
-
 static void string_sha1_process_block(uint32_t state[5], const unsigned char block[64]) {
     uint32_t w[80];
     for (size_t i = 0; i < 16; i++) w[i] = string_load_be32(block + (i * 4));
@@ -195,45 +168,18 @@ static void string_sha1_process_block(uint32_t state[5], const unsigned char blo
     state[4] += e;
 }
 
-static void string_sha1_compute(const unsigned char *msg, size_t len, unsigned char out[20]) {
-    uint32_t state[5] = {
-        0x67452301U, 0xefcdab89U, 0x98badcfeU, 0x10325476U, 0xc3d2e1f0U
-    };
-
-    size_t full = len / 64;
-    for (size_t i = 0; i < full; i++) {
-        string_sha1_process_block(state, msg + (i * 64));
-    }
-
-    unsigned char tail[128] = {0};
-    size_t rem = len % 64;
-    if (rem > 0) memcpy(tail, msg + (full * 64), rem);
-    tail[rem] = 0x80;
-    size_t tail_len = (rem < 56) ? 64 : 128;
-
-    uint64_t bits = ((uint64_t)len) * 8U;
-    for (size_t i = 0; i < 8; i++) {
-        tail[tail_len - 1 - i] = (unsigned char)((bits >> (8 * i)) & 0xFFU);
-    }
-
-    string_sha1_process_block(state, tail);
-    if (tail_len == 128) string_sha1_process_block(state, tail + 64);
-
-    for (size_t i = 0; i < 5; i++) string_store_be32(out + (i * 4), state[i]);
-}
+static const uint32_t s_sha256_k[64] = {
+    0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
+    0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
+    0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+    0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
+    0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+    0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+    0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+    0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U
+};
 
 static void string_sha256_process_block(uint32_t state[8], const unsigned char block[64]) {
-    static const uint32_t k[64] = {
-        0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
-        0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
-        0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
-        0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
-        0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
-        0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
-        0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
-        0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U
-    };
-
     uint32_t w[64];
     for (size_t i = 0; i < 16; i++) w[i] = string_load_be32(block + (i * 4));
     for (size_t i = 16; i < 64; i++) {
@@ -254,7 +200,7 @@ static void string_sha256_process_block(uint32_t state[8], const unsigned char b
     for (size_t i = 0; i < 64; i++) {
         uint32_t S1 = string_rotr32(e, 6) ^ string_rotr32(e, 11) ^ string_rotr32(e, 25);
         uint32_t ch = (e & f) ^ ((~e) & g);
-        uint32_t temp1 = h + S1 + ch + k[i] + w[i];
+        uint32_t temp1 = h + S1 + ch + s_sha256_k[i] + w[i];
         uint32_t S0 = string_rotr32(a, 2) ^ string_rotr32(a, 13) ^ string_rotr32(a, 22);
         uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
         uint32_t temp2 = S0 + maj;
@@ -279,52 +225,134 @@ static void string_sha256_process_block(uint32_t state[8], const unsigned char b
     state[7] += h;
 }
 
-static void string_sha256_compute_state(const unsigned char *msg,
-                                        size_t len,
-                                        const uint32_t init_state[8],
-                                        uint32_t out_state[8]) {
-    uint32_t state[8];
-    for (size_t i = 0; i < 8; i++) state[i] = init_state[i];
-    size_t full = len / 64;
-    for (size_t i = 0; i < full; i++) {
-        string_sha256_process_block(state, msg + (i * 64));
-    }
-
-    unsigned char tail[128] = {0};
-    size_t rem = len % 64;
-    if (rem > 0) memcpy(tail, msg + (full * 64), rem);
-    tail[rem] = 0x80;
-    size_t tail_len = (rem < 56) ? 64 : 128;
+static void string_sha256_blocks_portable(uint32_t state[8], const unsigned char *data, size_t nblocks) {
+    for (size_t i = 0; i < nblocks; i++) string_sha256_process_block(state, data + (i * 64));
+}
 
-    uint64_t bits = ((uint64_t)len) * 8U;
-    for (size_t i = 0; i < 8; i++) {
-        tail[tail_len - 1 - i] = (unsigned char)((bits >> (8 * i)) & 0xFFU);
+// Hardware SHA-256 kernels. Both keep the message schedule in four vector
+// registers and run four rounds per step; the x86 variant additionally
+// works on the ABEF/CDGH state split that SHA-NI expects.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define EVAL_HASH_HAVE_SHA256_X86 1
+
+__attribute__((target("sha,sse4.1")))
+static void string_sha256_blocks_shani(uint32_t state[8], const unsigned char *data, size_t nblocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    while (nblocks-- > 0) {
+        __m128i abef_save = state0;
+        __m128i cdgh_save = state1;
+        __m128i w[4];
+        for (size_t i = 0; i < 4; i++) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + (i * 16))), byte_swap);
+        }
+        for (size_t g = 0; g < 16; g++) {
+            if (g >= 4) {
+                __m128i carry = _mm_alignr_epi8(w[(g - 1) & 3], w[(g - 2) & 3], 4);
+                __m128i next = _mm_add_epi32(_mm_sha256msg1_epu32(w[g & 3], w[(g - 3) & 3]), carry);
+                w[g & 3] = _mm_sha256msg2_epu32(next, w[(g - 1) & 3]);
+            }
+            __m128i msg = _mm_add_epi32(w[g & 3], _mm_loadu_si128((const __m128i*)&s_sha256_k[g * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+        }
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+        data += 64;
     }
 
-    string_sha256_process_block(state, tail);
-    if (tail_len == 128) string_sha256_process_block(state, tail + 64);
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i*)&state[0], state0);
+    _mm_storeu_si128((__m128i*)&state[4], state1);
+}
 
-    for (size_t i = 0; i < 8; i++) out_state[i] = state[i];
+static bool string_cpu_has_sha256(void) {
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    bool ssse3 = (ecx & (1u << 9)) != 0;
+    bool sse41 = (ecx & (1u << 19)) != 0;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return ssse3 && sse41 && (ebx & (1u << 29)) != 0;
 }
 
-static void string_sha256_compute(const unsigned char *msg, size_t len, unsigned char out[32]) {
-    static const uint32_t k_init[8] = {
-        0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
-        0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
-    };
-    uint32_t state[8];
-    string_sha256_compute_state(msg, len, k_init, state);
-    for (size_t i = 0; i < 8; i++) string_store_be32(out + (i * 4), state[i]);
+// ARMv8 kernels are only built when the compiler already targets the SHA-2
+// extension (e.g. -march=armv8-a+crypto or Apple silicon defaults); Linux
+// still confirms support at run time.
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#endif
+#define EVAL_HASH_HAVE_SHA256_ARMV8 1
+
+static void string_sha256_blocks_armv8(uint32_t state[8], const unsigned char *data, size_t nblocks) {
+    uint32x4_t state0 = vld1q_u32(&state[0]);
+    uint32x4_t state1 = vld1q_u32(&state[4]);
+
+    while (nblocks-- > 0) {
+        uint32x4_t abcd_save = state0;
+        uint32x4_t efgh_save = state1;
+        uint32x4_t w[4];
+        for (size_t i = 0; i < 4; i++) {
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + (i * 16))));
+        }
+        for (size_t g = 0; g < 16; g++) {
+            if (g >= 4) {
+                w[g & 3] = vsha256su1q_u32(vsha256su0q_u32(w[g & 3], w[(g - 3) & 3]),
+                                           w[(g - 2) & 3],
+                                           w[(g - 1) & 3]);
+            }
+            uint32x4_t msg = vaddq_u32(w[g & 3], vld1q_u32(&s_sha256_k[g * 4]));
+            uint32x4_t prev0 = state0;
+            state0 = vsha256hq_u32(state0, state1, msg);
+            state1 = vsha256h2q_u32(state1, prev0, msg);
+        }
+        state0 = vaddq_u32(state0, abcd_save);
+        state1 = vaddq_u32(state1, efgh_save);
+        data += 64;
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
 }
 
-static void string_sha224_compute(const unsigned char *msg, size_t len, unsigned char out[28]) {
-    static const uint32_t k_init[8] = {
-        0xc1059ed8U, 0x367cd507U, 0x3070dd17U, 0xf70e5939U,
-        0xffc00b31U, 0x68581511U, 0x64f98fa7U, 0xbefa4fa4U
-    };
-    uint32_t state[8];
-    string_sha256_compute_state(msg, len, k_init, state);
-    for (size_t i = 0; i < 7; i++) string_store_be32(out + (i * 4), state[i]);
+static bool string_cpu_has_sha256(void) {
+#if defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#else
+    return true;
+#endif
+}
+#endif
+
+typedef void (*String_Sha256_Blocks_Fn)(uint32_t state[8], const unsigned char *data, size_t nblocks);
+
+// Picks the fastest kernel on first use. Every candidate produces the same
+// state, so a racing first call at worst repeats the probe.
+static void string_sha256_blocks(uint32_t state[8], const unsigned char *data, size_t nblocks) {
+    static String_Sha256_Blocks_Fn kernel = NULL;
+    if (!kernel) {
+        String_Sha256_Blocks_Fn chosen = string_sha256_blocks_portable;
+#if defined(EVAL_HASH_HAVE_SHA256_X86)
+        if (string_cpu_has_sha256()) chosen = string_sha256_blocks_shani;
+#elif defined(EVAL_HASH_HAVE_SHA256_ARMV8)
+        if (string_cpu_has_sha256()) chosen = string_sha256_blocks_armv8;
+#endif
+        kernel = chosen;
+    }
+    kernel(state, data, nblocks);
 }
 
 static void string_sha512_process_block(uint64_t state[8], const unsigned char block[128]) {
@@ -396,59 +424,6 @@ static void string_sha512_process_block(uint64_t state[8], const unsigned char b
     state[7] += h;
 }
 
-static void string_sha512_compute_state(const unsigned char *msg,
-                                        size_t len,
-                                        const uint64_t init_state[8],
-                                        uint64_t out_state[8]) {
-    uint64_t state[8];
-    for (size_t i = 0; i < 8; i++) state[i] = init_state[i];
-
-    size_t full = len / 128;
-    for (size_t i = 0; i < full; i++) {
-        string_sha512_process_block(state, msg + (i * 128));
-    }
-
-    unsigned char tail[256] = {0};
-    size_t rem = len % 128;
-    if (rem > 0) memcpy(tail, msg + (full * 128), rem);
-    tail[rem] = 0x80;
-    size_t tail_len = (rem < 112) ? 128 : 256;
-
-    uint64_t bits_lo = ((uint64_t)len) * 8ULL;
-    uint64_t bits_hi = ((uint64_t)len >> 61);
-    string_store_be64(tail + tail_len - 16, bits_hi);
-    string_store_be64(tail + tail_len - 8, bits_lo);
-
-    string_sha512_process_block(state, tail);
-    if (tail_len == 256) string_sha512_process_block(state, tail + 128);
-
-    for (size_t i = 0; i < 8; i++) out_state[i] = state[i];
-}
-
-static void string_sha512_compute(const unsigned char *msg, size_t len, unsigned char out[64]) {
-    static const uint64_t k_init[8] = {
-        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL,
-        0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
-        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
-        0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
-    };
-    uint64_t state[8];
-    string_sha512_compute_state(msg, len, k_init, state);
-    for (size_t i = 0; i < 8; i++) string_store_be64(out + (i * 8), state[i]);
-}
-
-static void string_sha384_compute(const unsigned char *msg, size_t len, unsigned char out[48]) {
-    static const uint64_t k_init[8] = {
-        0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL,
-        0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
-        0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL,
-        0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
-    };
-    uint64_t state[8];
-    string_sha512_compute_state(msg, len, k_init, state);
-    for (size_t i = 0; i < 6; i++) string_store_be64(out + (i * 8), state[i]);
-}
-
 static void string_keccakf1600(uint64_t st[25]) {
     static const uint64_t rc[24] = {
         0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
@@ -498,38 +473,6 @@ static void string_keccakf1600(uint64_t st[25]) {
     }
 }
 
-static void string_sha3_compute(const unsigned char *msg,
-                                size_t len,
-                                unsigned char *out,
-                                size_t out_len) {
-    size_t rate = 200 - (2 * out_len);
-    uint64_t st[25] = {0};
-    unsigned char *st_bytes = (unsigned char*)st;
-
-    size_t off = 0;
-    while (off + rate <= len) {
-        for (size_t i = 0; i < rate; i++) st_bytes[i] ^= msg[off + i];
-        string_keccakf1600(st);
-        off += rate;
-    }
-
-    unsigned char block[200] = {0};
-    size_t rem = len - off;
-    for (size_t i = 0; i < rem; i++) block[i] = msg[off + i];
-    block[rem] ^= 0x06;
-    block[rate - 1] ^= 0x80;
-    for (size_t i = 0; i < rate; i++) st_bytes[i] ^= block[i];
-    string_keccakf1600(st);
-
-    size_t out_off = 0;
-    while (out_off < out_len) {
-        size_t take = (out_len - out_off < rate) ? (out_len - out_off) : rate;
-        memcpy(out + out_off, st_bytes, take);
-        out_off += take;
-        if (out_off < out_len) string_keccakf1600(st);
-    }
-}
-
 static String_View string_bytes_hex_temp(EvalExecContext *ctx, const unsigned char *bytes, size_t count, bool upper) {
     if (!ctx || !bytes) return nob_sv_from_cstr("");
     char *buf = (char*)arena_alloc(eval_temp_arena(ctx), (count * 2) + 1);
@@ -544,101 +487,232 @@ static String_View string_bytes_hex_temp(EvalExecContext *ctx, const unsigned ch
     return nob_sv_from_cstr(buf);
 }
 
-static bool __attribute__((unused))
-string_hash_compute_temp(EvalExecContext *ctx, String_View algo, String_View input, String_View *out_hash) {
-    if (!ctx || !out_hash) return false;
-    *out_hash = nob_sv_from_cstr("");
-    const unsigned char *msg = (const unsigned char*)input.data;
-    if (eval_sv_eq_ci_lit(algo, "MD5")) {
-        unsigned char d[16];
-        string_md5_compute(msg, input.count, d);
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
-        return true;
-    }
-    if (eval_sv_eq_ci_lit(algo, "SHA1")) {
-        unsigned char d[20];
-        string_sha1_compute(msg, input.count, d);
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
-        return true;
-    }
-    if (eval_sv_eq_ci_lit(algo, "SHA256")) {
-        unsigned char d[32];
-        string_sha256_compute(msg, input.count, d);
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
-        return true;
-    }
-    if (eval_sv_eq_ci_lit(algo, "SHA224")) {
-        unsigned char d[28];
-        string_sha224_compute(msg, input.count, d);
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
+typedef struct {
+    const char *name;
+    Eval_Hash_Algo algo;
+    size_t digest_size;
+    size_t block_size; // bytes consumed per compression call (the sponge rate for SHA-3)
+} Eval_Hash_Algo_Info;
+
+static const Eval_Hash_Algo_Info s_hash_algos[] = {
+    { "MD5", EVAL_HASH_MD5, 16, 64 },
+    { "SHA1", EVAL_HASH_SHA1, 20, 64 },
+    { "SHA224", EVAL_HASH_SHA224, 28, 64 },
+    { "SHA256", EVAL_HASH_SHA256, 32, 64 },
+    { "SHA384", EVAL_HASH_SHA384, 48, 128 },
+    { "SHA512", EVAL_HASH_SHA512, 64, 128 },
+    { "SHA3_224", EVAL_HASH_SHA3_224, 28, 200 - 2 * 28 },
+    { "SHA3_256", EVAL_HASH_SHA3_256, 32, 200 - 2 * 32 },
+    { "SHA3_384", EVAL_HASH_SHA3_384, 48, 200 - 2 * 48 },
+    { "SHA3_512", EVAL_HASH_SHA3_512, 64, 200 - 2 * 64 },
+};
+
+bool eval_hash_algo_from_sv(String_View algo, Eval_Hash_Algo *out_algo) {
+    for (size_t i = 0; i < NOB_ARRAY_LEN(s_hash_algos); i++) {
+        if (!eval_sv_eq_ci_lit(algo, s_hash_algos[i].name)) continue;
+        if (out_algo) *out_algo = s_hash_algos[i].algo;
         return true;
     }
-    if (eval_sv_eq_ci_lit(algo, "SHA384")) {
-        unsigned char d[48];
-        string_sha384_compute(msg, input.count, d);
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
-        return true;
+    return false;
+}
+
+size_t eval_hash_digest_size(Eval_Hash_Algo algo) {
+    return s_hash_algos[algo].digest_size;
+}
+
+void eval_hash_init(Eval_Hash_State *st, Eval_Hash_Algo algo) {
+    static const uint32_t md5_init[4] = { 0x67452301U, 0xefcdab89U, 0x98badcfeU, 0x10325476U };
+    static const uint32_t sha1_init[5] = {
+        0x67452301U, 0xefcdab89U, 0x98badcfeU, 0x10325476U, 0xc3d2e1f0U
+    };
+    static const uint32_t sha224_init[8] = {
+        0xc1059ed8U, 0x367cd507U, 0x3070dd17U, 0xf70e5939U,
+        0xffc00b31U, 0x68581511U, 0x64f98fa7U, 0xbefa4fa4U
+    };
+    static const uint32_t sha256_init[8] = {
+        0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+        0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
+    };
+    static const uint64_t sha384_init[8] = {
+        0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL,
+        0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+        0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL,
+        0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
+    };
+    static const uint64_t sha512_init[8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL,
+        0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+        0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+    };
+
+    memset(st, 0, sizeof(*st));
+    st->algo = algo;
+    switch (algo) {
+        case EVAL_HASH_MD5: memcpy(st->state.w32, md5_init, sizeof(md5_init)); break;
+        case EVAL_HASH_SHA1: memcpy(st->state.w32, sha1_init, sizeof(sha1_init)); break;
+        case EVAL_HASH_SHA224: memcpy(st->state.w32, sha224_init, sizeof(sha224_init)); break;
+        case EVAL_HASH_SHA256: memcpy(st->state.w32, sha256_init, sizeof(sha256_init)); break;
+        case EVAL_HASH_SHA384: memcpy(st->state.w64, sha384_init, sizeof(sha384_init)); break;
+        case EVAL_HASH_SHA512: memcpy(st->state.w64, sha512_init, sizeof(sha512_init)); break;
+        default: break; // SHA-3 starts from the all-zero state
     }
-    if (eval_sv_eq_ci_lit(algo, "SHA512")) {
-        unsigned char d[64];
-        string_sha512_compute(msg, input.count, d);
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
-        return true;
+}
+
+static void string_hash_blocks(Eval_Hash_State *st, const unsigned char *data, size_t nblocks) {
+    size_t block_size = s_hash_algos[st->algo].block_size;
+    switch (st->algo) {
+        case EVAL_HASH_MD5:
+            for (size_t i = 0; i < nblocks; i++) string_md5_process_block(st->state.w32, data + (i * 64));
+            break;
+        case EVAL_HASH_SHA1:
+            for (size_t i = 0; i < nblocks; i++) string_sha1_process_block(st->state.w32, data + (i * 64));
+            break;
+        case EVAL_HASH_SHA224:
+        case EVAL_HASH_SHA256:
+            string_sha256_blocks(st->state.w32, data, nblocks);
+            break;
+        case EVAL_HASH_SHA384:
+        case EVAL_HASH_SHA512:
+            for (size_t i = 0; i < nblocks; i++) string_sha512_process_block(st->state.w64, data + (i * 128));
+            break;
+        default: {
+            unsigned char *st_bytes = (unsigned char*)st->state.keccak;
+            for (size_t b = 0; b < nblocks; b++) {
+                const unsigned char *block = data + (b * block_size);
+                for (size_t i = 0; i < block_size; i++) st_bytes[i] ^= block[i];
+                string_keccakf1600(st->state.keccak);
+            }
+            break;
+        }
     }
-    if (eval_sv_eq_ci_lit(algo, "SHA3_224")) {
-        unsigned char d[28];
-        string_sha3_compute(msg, input.count, d, sizeof(d));
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
-        return true;
+}
+
+void eval_hash_update(Eval_Hash_State *st, const void *data, size_t count) {
+    const unsigned char *in = (const unsigned char*)data;
+    size_t block_size = s_hash_algos[st->algo].block_size;
+    st->total_bytes += count;
+
+    if (st->pending_count > 0) {
+        size_t take = block_size - st->pending_count;
+        if (take > count) take = count;
+        memcpy(st->pending + st->pending_count, in, take);
+        st->pending_count += take;
+        in += take;
+        count -= take;
+        if (st->pending_count < block_size) return;
+        string_hash_blocks(st, st->pending, 1);
+        st->pending_count = 0;
     }
-    if (eval_sv_eq_ci_lit(algo, "SHA3_256")) {
-        unsigned char d[32];
-        string_sha3_compute(msg, input.count, d, sizeof(d));
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
-        return true;
+
+    size_t nblocks = count / block_size;
+    if (nblocks > 0) string_hash_blocks(st, in, nblocks);
+    in += nblocks * block_size;
+    count -= nblocks * block_size;
+    if (count > 0) memcpy(st->pending, in, count);
+    st->pending_count = count;
+}
+
+size_t eval_hash_final(Eval_Hash_State *st, unsigned char out[EVAL_HASH_MAX_DIGEST_SIZE]) {
+    const Eval_Hash_Algo_Info *info = &s_hash_algos[st->algo];
+    size_t block_size = info->block_size;
+    unsigned char tail[256] = {0};
+    memcpy(tail, st->pending, st->pending_count);
+    size_t rem = st->pending_count;
+
+    if (st->algo >= EVAL_HASH_SHA3_224) {
+        tail[rem] ^= 0x06;
+        tail[block_size - 1] ^= 0x80;
+        string_hash_blocks(st, tail, 1);
+        // Every SHA-3 digest fits inside one rate-sized block of output.
+        memcpy(out, st->state.keccak, info->digest_size);
+        return info->digest_size;
     }
-    if (eval_sv_eq_ci_lit(algo, "SHA3_384")) {
-        unsigned char d[48];
-        string_sha3_compute(msg, input.count, d, sizeof(d));
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
-        return true;
+
+    // The Merkle-Damgard hashes append 0x80, zero fill and the bit length
+    // (64-bit, or 128-bit for the SHA-512 family) at the end of the block.
+    size_t length_size = block_size == 128 ? 16 : 8;
+    size_t tail_len = (rem + 1 + length_size <= block_size) ? block_size : 2 * block_size;
+    tail[rem] = 0x80;
+    uint64_t bits = st->total_bytes * 8U;
+    if (st->algo == EVAL_HASH_MD5) {
+        for (size_t i = 0; i < 8; i++) tail[tail_len - 8 + i] = (unsigned char)((bits >> (8 * i)) & 0xFFU);
+    } else {
+        if (length_size == 16) string_store_be64(tail + tail_len - 16, st->total_bytes >> 61);
+        string_store_be64(tail + tail_len - 8, bits);
     }
-    if (eval_sv_eq_ci_lit(algo, "SHA3_512")) {
-        unsigned char d[64];
-        string_sha3_compute(msg, input.count, d, sizeof(d));
-        *out_hash = string_bytes_hex_temp(ctx, d, sizeof(d), false);
-        if (eval_should_stop(ctx)) return false;
-        return true;
+    string_hash_blocks(st, tail, tail_len / block_size);
+
+    switch (st->algo) {
+        case EVAL_HASH_MD5:
+            for (size_t i = 0; i < 4; i++) string_store_le32(out + (i * 4), st->state.w32[i]);
+            break;
+        case EVAL_HASH_SHA384:
+        case EVAL_HASH_SHA512:
+            for (size_t i = 0; i < info->digest_size / 8; i++) string_store_be64(out + (i * 8), st->state.w64[i]);
+            break;
+        default:
+            for (size_t i = 0; i < info->digest_size / 4; i++) string_store_be32(out + (i * 4), st->state.w32[i]);
+            break;
     }
-    return false;
+    return info->digest_size;
 }
 
-
 bool eval_hash_compute_hex_temp(EvalExecContext *ctx,
                                 String_View algo,
                                 String_View input,
                                 String_View *out_hex) {
-    return string_hash_compute_temp(ctx, algo, input, out_hex);
+    if (!ctx || !out_hex) return false;
+    *out_hex = nob_sv_from_cstr("");
+    Eval_Hash_Algo kind;
+    if (!eval_hash_algo_from_sv(algo, &kind)) return false;
+
+    Eval_Hash_State st;
+    unsigned char digest[EVAL_HASH_MAX_DIGEST_SIZE];
+    eval_hash_init(&st, kind);
+    eval_hash_update(&st, input.data, input.count);
+    size_t digest_size = eval_hash_final(&st, digest);
+    *out_hex = string_bytes_hex_temp(ctx, digest, digest_size, false);
+    return !eval_should_stop(ctx);
+}
+
+#define EVAL_HASH_FILE_CHUNK_SIZE (64 * 1024)
+
+Eval_Hash_File_Status eval_hash_file_hex_temp(EvalExecContext *ctx,
+                                              String_View algo,
+                                              String_View path,
+                                              String_View *out_hex) {
+    if (!ctx || !out_hex) return EVAL_HASH_FILE_READ_FAILED;
+    *out_hex = nob_sv_from_cstr("");
+    Eval_Hash_Algo kind;
+    if (!eval_hash_algo_from_sv(algo, &kind)) return EVAL_HASH_FILE_UNSUPPORTED_ALGO;
+
+    char *path_c = eval_sv_to_cstr_temp(ctx, path);
+    unsigned char *chunk = (unsigned char*)arena_alloc(eval_temp_arena(ctx), EVAL_HASH_FILE_CHUNK_SIZE);
+    if (!path_c || !chunk) {
+        (void)ctx_oom(ctx);
+        return EVAL_HASH_FILE_READ_FAILED;
+    }
+
+    FILE *f = fopen(path_c, "rb");
+    if (!f) return EVAL_HASH_FILE_READ_FAILED;
+    Eval_Hash_State st;
+    eval_hash_init(&st, kind);
+    for (;;) {
+        size_t n = fread(chunk, 1, EVAL_HASH_FILE_CHUNK_SIZE, f);
+        if (n > 0) eval_hash_update(&st, chunk, n);
+        if (n < EVAL_HASH_FILE_CHUNK_SIZE) break;
+    }
+    bool read_failed = ferror(f) != 0;
+    fclose(f);
+    if (read_failed) return EVAL_HASH_FILE_READ_FAILED;
+
+    unsigned char digest[EVAL_HASH_MAX_DIGEST_SIZE];
+    size_t digest_size = eval_hash_final(&st, digest);
+    *out_hex = string_bytes_hex_temp(ctx, digest, digest_size, false);
+    return eval_should_stop(ctx) ? EVAL_HASH_FILE_READ_FAILED : EVAL_HASH_FILE_OK;
 }
 
 bool eval_hash_is_supported_algo(String_View algo) {
-    return eval_sv_eq_ci_lit(algo, "MD5") ||
-           eval_sv_eq_ci_lit(algo, "SHA1") ||
-           eval_sv_eq_ci_lit(algo, "SHA224") ||
-           eval_sv_eq_ci_lit(algo, "SHA256") ||
-           eval_sv_eq_ci_lit(algo, "SHA384") ||
-           eval_sv_eq_ci_lit(algo, "SHA512") ||
-           eval_sv_eq_ci_lit(algo, "SHA3_224") ||
-           eval_sv_eq_ci_lit(algo, "SHA3_256") ||
-           eval_sv_eq_ci_lit(algo, "SHA3_384") ||
-           eval_sv_eq_ci_lit(algo, "SHA3_512");
+    return eval_hash_algo_from_sv(algo, NULL);
 }
@@ -3,7 +3,58 @@
 
 #include "evaluator_internal.h"
 
+#include <stdint.h>
+
+typedef enum {
+    EVAL_HASH_MD5 = 0,
+    EVAL_HASH_SHA1,
+    EVAL_HASH_SHA224,
+    EVAL_HASH_SHA256,
+    EVAL_HASH_SHA384,
+    EVAL_HASH_SHA512,
+    EVAL_HASH_SHA3_224,
+    EVAL_HASH_SHA3_256,
+    EVAL_HASH_SHA3_384,
+    EVAL_HASH_SHA3_512,
+} Eval_Hash_Algo;
+
+#define EVAL_HASH_MAX_DIGEST_SIZE 64
+
+// Incremental digest: eval_hash_init(), any number of eval_hash_update()
+// calls, then eval_hash_final(). Input that does not fill a block waits in
+// `pending`, so callers may feed chunks of any size.
+typedef struct {
+    Eval_Hash_Algo algo;
+    union {
+        uint32_t w32[8];
+        uint64_t w64[8];
+        uint64_t keccak[25];
+    } state;
+    unsigned char pending[200];
+    size_t pending_count;
+    uint64_t total_bytes;
+} Eval_Hash_State;
+
+typedef enum {
+    EVAL_HASH_FILE_OK = 0,
+    EVAL_HASH_FILE_UNSUPPORTED_ALGO,
+    EVAL_HASH_FILE_READ_FAILED,
+} Eval_Hash_File_Status;
+
+bool eval_hash_algo_from_sv(String_View algo, Eval_Hash_Algo *out_algo);
+size_t eval_hash_digest_size(Eval_Hash_Algo algo);
+void eval_hash_init(Eval_Hash_State *st, Eval_Hash_Algo algo);
+void eval_hash_update(Eval_Hash_State *st, const void *data, size_t count);
+// Writes eval_hash_digest_size() bytes to `out` and returns that size.
+size_t eval_hash_final(Eval_Hash_State *st, unsigned char out[EVAL_HASH_MAX_DIGEST_SIZE]);
+
 bool eval_hash_compute_hex_temp(EvalExecContext *ctx, String_View algo, String_View input, String_View *out_hex);
+// Hashes the file at `path` in fixed-size chunks, so memory use does not
+// depend on the file size. The algorithm is validated before the file is opened.
+Eval_Hash_File_Status eval_hash_file_hex_temp(EvalExecContext *ctx,
+                                              String_View algo,
+                                              String_View path,
+                                              String_View *out_hex);
 bool eval_hash_is_supported_algo(String_View algo);
 
 #endif // EVAL_HASH_H_
@@ -593,6 +593,7 @@ static bool legacy_execute_variable_watch_request(EvalExecContext *ctx,
     for (size_t i = 0; i < arena_arr_len(commands->watched_variables); i++) {
         if (!eval_sv_key_eq(commands->watched_variables[i], req->variable)) continue;
         if (i < arena_arr_len(commands->watched_variable_commands)) {
+            if (!eval_command_tx_note_elem(ctx, EVAL_TX_SLICE_WATCHED_VARIABLE_COMMANDS, i)) return false;
             commands->watched_variable_commands[i] = sv_copy_to_event_arena(ctx, req->command);
         }
         if (eval_should_stop(ctx)) return false;
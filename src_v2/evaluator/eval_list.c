@@ -38,26 +38,10 @@ Eval_Result eval_handle_list(EvalExecContext *ctx, const Node *node) {
         String_View var = a[1];
         if (arena_arr_len(a) == 2) return eval_result_from_ctx(ctx);
 
-        String_View existing = eval_var_get_visible(ctx, var);
         String_View incoming = eval_sv_join_semi_temp(ctx, &a[2], arena_arr_len(a) - 2);
         if (eval_should_stop(ctx)) return eval_result_from_ctx(ctx);
 
-        if (existing.count == 0) {
-            (void)eval_var_set_current(ctx, var, incoming);
-            if (!(is_append ? eval_emit_list_append(ctx, o, var) : eval_emit_list_prepend(ctx, o, var))) return eval_result_fatal();
-            return eval_result_from_ctx(ctx);
-        }
-
-        String_View left = is_append ? existing : incoming;
-        String_View right = is_append ? incoming : existing;
-        size_t total = left.count + 1 + right.count;
-        char *buf = (char*)arena_alloc(eval_temp_arena(ctx), total + 1);
-        EVAL_OOM_RETURN_IF_NULL(ctx, buf, eval_result_fatal());
-        memcpy(buf, left.data, left.count);
-        buf[left.count] = ';';
-        memcpy(buf + left.count + 1, right.data, right.count);
-        buf[total] = '\0';
-        (void)eval_var_set_current(ctx, var, nob_sv_from_cstr(buf));
+        (void)eval_var_list_append_current(ctx, var, incoming, !is_append);
         if (!(is_append ? eval_emit_list_append(ctx, o, var) : eval_emit_list_prepend(ctx, o, var))) return eval_result_fatal();
         return eval_result_from_ctx(ctx);
     }
@@ -452,8 +436,8 @@ Eval_Result eval_handle_list(EvalExecContext *ctx, const Node *node) {
         if (!list_load_var_items(ctx, var, &items)) return eval_result_from_ctx(ctx);
         if (arena_arr_len(items) == 0 && !var_defined) return eval_result_from_ctx(ctx);
 
-        regex_t re;
-        if (!list_compile_regex(ctx, node, o, a[4], &re)) return eval_result_from_ctx(ctx);
+        const regex_t *re = list_compile_regex(ctx, node, o, a[4]);
+        if (!re) return eval_result_from_ctx(ctx);
 
         String_View *out_items = arena_alloc_array(eval_temp_arena(ctx), String_View, arena_arr_len(items));
         if (arena_arr_len(items) > 0) {
@@ -463,16 +447,12 @@ Eval_Result eval_handle_list(EvalExecContext *ctx, const Node *node) {
 
         for (size_t i = 0; i < arena_arr_len(items); i++) {
             char *item_c = eval_sv_to_cstr_temp(ctx, items[i]);
-            if (!item_c) {
-                regfree(&re);
-                return eval_result_from_ctx(ctx);
-            }
-            bool match = regexec(&re, item_c, 0, NULL, 0) == 0;
+            if (!item_c) return eval_result_from_ctx(ctx);
+            bool match = regexec(re, item_c, 0, NULL, 0) == 0;
             if ((include_mode && match) || (!include_mode && !match)) {
                 out_items[out_count++] = items[i];
             }
         }
-        regfree(&re);
 
         (void)list_set_var_from_items(ctx, var, out_items, out_count);
         return eval_result_from_ctx(ctx);
@@ -748,27 +728,22 @@ Eval_Result eval_handle_list(EvalExecContext *ctx, const Node *node) {
                 EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_MISSING_REQUIRED, "list", nob_sv_from_cstr("list(TRANSFORM REGEX) expects exactly one regex argument"), nob_sv_from_cstr(""));
                 return eval_result_from_ctx(ctx);
             }
-            regex_t sel_re;
-            if (!list_compile_regex(ctx, node, o, a[next + 1], &sel_re)) return eval_result_from_ctx(ctx);
+            const regex_t *sel_re = list_compile_regex(ctx, node, o, a[next + 1]);
+            if (!sel_re) return eval_result_from_ctx(ctx);
             for (size_t i = 0; i < arena_arr_len(items); i++) {
                 char *item_c = eval_sv_to_cstr_temp(ctx, items[i]);
-                if (!item_c) {
-                    regfree(&sel_re);
-                    return eval_result_from_ctx(ctx);
-                }
-                if (regexec(&sel_re, item_c, 0, NULL, 0) == 0) selected[i] = true;
+                if (!item_c) return eval_result_from_ctx(ctx);
+                if (regexec(sel_re, item_c, 0, NULL, 0) == 0) selected[i] = true;
             }
-            regfree(&sel_re);
         } else {
             EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_UNSUPPORTED_OPERATION, "list", nob_sv_from_cstr("list(TRANSFORM) received unsupported selector"), a[next]);
             return eval_result_from_ctx(ctx);
         }
 
-        regex_t replace_re;
-        bool replace_ready = false;
+        const regex_t *replace_re = NULL;
         if (action == LIST_TRANSFORM_REPLACE) {
-            if (!list_compile_regex(ctx, node, o, action_arg1, &replace_re)) return eval_result_from_ctx(ctx);
-            replace_ready = true;
+            replace_re = list_compile_regex(ctx, node, o, action_arg1);
+            if (!replace_re) return eval_result_from_ctx(ctx);
         }
 
         for (size_t i = 0; i < arena_arr_len(items); i++) {
@@ -787,19 +762,14 @@ Eval_Result eval_handle_list(EvalExecContext *ctx, const Node *node) {
             } else if (action == LIST_TRANSFORM_GENEX_STRIP) {
                 curr = list_genex_strip_temp(ctx, curr);
             } else if (action == LIST_TRANSFORM_REPLACE) {
-                if (!list_regex_replace_one_temp(ctx, &replace_re, action_arg2, curr, &curr)) {
-                    if (replace_ready) regfree(&replace_re);
+                if (!list_regex_replace_one_temp(ctx, replace_re, action_arg2, curr, &curr)) {
                     return eval_result_from_ctx(ctx);
                 }
             }
-            if (eval_should_stop(ctx)) {
-                if (replace_ready) regfree(&replace_re);
-                return eval_result_from_ctx(ctx);
-            }
+            if (eval_should_stop(ctx)) return eval_result_from_ctx(ctx);
             items[i] = curr;
         }
 
-        if (replace_ready) regfree(&replace_re);
         if (has_output_var) {
             (void)list_set_var_from_items(ctx, out_var, items, arena_arr_len(items));
             if (!eval_emit_list_transform(ctx, o, var)) return eval_result_fatal();
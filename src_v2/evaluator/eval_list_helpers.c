@@ -1,6 +1,7 @@
 #include "eval_list_internal.h"
 
 #include "arena_dyn.h"
+#include "eval_regex_cache.h"
 #include "sv_utils.h"
 
 #include <ctype.h>
@@ -152,23 +153,20 @@ String_View list_genex_strip_temp(EvalExecContext *ctx, String_View in) {
     return nob_sv_from_cstr(buf);
 }
 
-bool list_compile_regex(EvalExecContext *ctx,
-                        const Node *node,
-                        Cmake_Event_Origin o,
-                        String_View pattern,
-                        regex_t *out_re) {
-    if (!ctx || !node || !out_re) return false;
-    char *pat_c = eval_sv_to_cstr_temp(ctx, pattern);
-    if (!pat_c) return false;
-    if (regcomp(out_re, pat_c, REG_EXTENDED) != 0) {
+const regex_t *list_compile_regex(EvalExecContext *ctx,
+                                  const Node *node,
+                                  Cmake_Event_Origin o,
+                                  String_View pattern) {
+    if (!ctx || !node) return NULL;
+    const regex_t *re = eval_regex_cache_get(ctx, pattern, REG_EXTENDED);
+    if (!re && !ctx->oom) {
         EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_PARSE_ERROR, "list", nob_sv_from_cstr("Invalid regex pattern"), pattern);
-        return false;
     }
-    return true;
+    return re;
 }
 
 bool list_regex_replace_one_temp(EvalExecContext *ctx,
-                                 regex_t *re,
+                                 const regex_t *re,
                                  String_View replacement,
                                  String_View input,
                                  String_View *out) {
@@ -39,13 +39,14 @@ String_View list_concat_temp(EvalExecContext *ctx, String_View a, String_View b)
 String_View list_to_case_temp(EvalExecContext *ctx, String_View in, bool upper);
 String_View list_strip_ws_view(String_View in);
 String_View list_genex_strip_temp(EvalExecContext *ctx, String_View in);
-bool list_compile_regex(EvalExecContext *ctx,
-                        const Node *node,
-                        Cmake_Event_Origin o,
-                        String_View pattern,
-                        regex_t *out_re);
+// Returns the pattern from the session regex cache (not to be freed), or
+// NULL after reporting an invalid pattern.
+const regex_t *list_compile_regex(EvalExecContext *ctx,
+                                  const Node *node,
+                                  Cmake_Event_Origin o,
+                                  String_View pattern);
 bool list_regex_replace_one_temp(EvalExecContext *ctx,
-                                 regex_t *re,
+                                 const regex_t *re,
                                  String_View replacement,
                                  String_View input,
                                  String_View *out);
@@ -1599,6 +1599,7 @@ static bool meta_file_api_upsert_project_query(EvalExecContext *ctx,
         Eval_File_Api_Query_Record *record = &model->queries[i];
         if (!record->shared_query || record->client_query_file.count > 0) continue;
         if (!eval_sv_key_eq(record->kind_upper, request->kind_upper)) continue;
+        if (!eval_command_tx_note_elem(ctx, EVAL_TX_SLICE_FILE_API_QUERIES, i)) return false;
         record->kind_json = sv_copy_to_event_arena(ctx, request->kind_json);
         record->versions = sv_copy_to_event_arena(ctx, request->versions);
         if (eval_should_stop(ctx)) return false;
@@ -1955,7 +1956,7 @@ static bool meta_file_api_write_object_file(EvalExecContext *ctx,
     } else if (eval_sv_eq_ci_lit(object->kind_json, "cache")) {
         nob_sb_append_cstr(&sb, "  \"entries\": [");
         bool first = true;
-        ptrdiff_t n = stbds_shlen(ctx->scope_state.cache_entries);
+        ptrdiff_t n = stbds_hmlen(ctx->scope_state.cache_entries);
         for (ptrdiff_t i = 0; i < n; i++) {
             Eval_Cache_Entry *entry = &ctx->scope_state.cache_entries[i];
             if (!entry->key) continue;
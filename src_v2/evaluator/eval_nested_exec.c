@@ -3,8 +3,13 @@
 #include "eval_exec_core.h"
 #include "eval_file_internal.h"
 #include "lexer.h"
+#include "ast_cache.h"
+#include "diagnostics.h"
+#include "stb_ds.h"
 
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
 
 static String_View nested_exec_dir_from_path(String_View path) {
     for (size_t i = path.count; i-- > 0;) {
@@ -92,14 +97,128 @@ static bool eval_lex_external_tokens(EvalExecContext *ctx,
 }
 
 static bool eval_parse_external_ast(EvalExecContext *ctx,
+                                    Arena *arena,
                                     const Token_List *tokens,
                                     Ast_Root *out_ast) {
     if (!ctx || !tokens || !out_ast) return false;
-    *out_ast = parse_tokens(ctx->arena, *tokens);
+    *out_ast = parse_tokens(arena, *tokens);
     if (eval_should_stop(ctx)) return false;
     return true;
 }
 
+// Stamps written within this many seconds may still change without moving
+// mtime, so they are re-validated by content instead.
+#define EVAL_AST_CACHE_RACY_SECONDS 2
+
+static bool nested_exec_stat_stamp(const char *path_c, Eval_Ast_Cache_Value *out) {
+    struct stat st;
+    if (stat(path_c, &st) != 0) return false;
+    out->size = (size_t)st.st_size;
+    out->mtime_sec = (long long)st.st_mtime;
+#if defined(__APPLE__)
+    out->mtime_nsec = (long)st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    out->mtime_nsec = 0;
+#else
+    out->mtime_nsec = (long)st.st_mtim.tv_nsec;
+#endif
+    return (long long)time(NULL) - out->mtime_sec >= EVAL_AST_CACHE_RACY_SECONDS;
+}
+
+static bool eval_read_lex_parse_external(EvalExecContext *ctx,
+                                         const char *path_c,
+                                         String_View source_code,
+                                         Arena *ast_arena,
+                                         Ast_Root *out_ast) {
+    Token_List tokens = NULL;
+    if (!eval_lex_external_tokens(ctx, path_c, source_code, &tokens)) return false;
+    return eval_parse_external_ast(ctx, ast_arena, &tokens, out_ast);
+}
+
+// Resolves the AST for `file_path`, reusing the session cache when the file
+// is unchanged and falling back to the on-disk cache, when configured, before
+// lexing and parsing. Trees that produced parser diagnostics are not cached, so the
+// diagnostics repeat on every entry as they did before caching.
+static bool eval_load_external_ast(EvalExecContext *ctx,
+                                   String_View file_path,
+                                   char **out_path_c,
+                                   Ast_Root *out_ast) {
+    String_View source_code = {0};
+    EvalSession *session = ctx->session;
+    if (!session) {
+        if (!eval_read_external_source(ctx, file_path, out_path_c, &source_code)) return false;
+        return eval_read_lex_parse_external(ctx, *out_path_c, source_code, ctx->arena, out_ast);
+    }
+
+    Eval_Runtime_State *runtime = eval_runtime_slice(ctx);
+    Eval_Ast_Cache_Value stamp = {0};
+    char *path_c = (char*)arena_alloc(ctx->arena, file_path.count + 1);
+    EVAL_OOM_RETURN_IF_NULL(ctx, path_c, false);
+    memcpy(path_c, file_path.data, file_path.count);
+    path_c[file_path.count] = '\0';
+
+    // Virtualized filesystems only expose reads, so stat stamps apply to the
+    // host filesystem alone.
+    bool host_fs = !(ctx->services && ctx->services->fs_read_file);
+    bool stamp_trusted = host_fs && nested_exec_stat_stamp(path_c, &stamp);
+    Eval_Ast_Cache_Entry *entry = stbds_shgetp_null(session->ast_cache, path_c);
+    if (entry && stamp_trusted && entry->value.has_stamp &&
+        entry->value.size == stamp.size &&
+        entry->value.mtime_sec == stamp.mtime_sec &&
+        entry->value.mtime_nsec == stamp.mtime_nsec) {
+        runtime->run_report.ast_cache_hits++;
+        *out_path_c = path_c;
+        *out_ast = entry->value.ast;
+        return true;
+    }
+
+    if (!eval_read_external_source(ctx, file_path, out_path_c, &source_code)) return false;
+    size_t content_hash = stbds_hash_bytes((void*)source_code.data, source_code.count, 0);
+    if (entry && entry->value.size == source_code.count && entry->value.content_hash == content_hash) {
+        entry->value.has_stamp = stamp_trusted;
+        entry->value.mtime_sec = stamp.mtime_sec;
+        entry->value.mtime_nsec = stamp.mtime_nsec;
+        runtime->run_report.ast_cache_hits++;
+        *out_ast = entry->value.ast;
+        return true;
+    }
+
+    runtime->run_report.ast_cache_misses++;
+    Arena *persistent = eval_event_arena(ctx);
+    Ast_Root ast = NULL;
+    if (session->ast_cache_dir && ast_cache_load(persistent, session->ast_cache_dir, source_code, &ast)) {
+        // Token text points into the mapped entry, so the source needs no copy.
+        runtime->run_report.ast_disk_cache_hits++;
+        *out_ast = ast;
+    } else {
+        String_View stable_source = sv_copy_to_arena(persistent, source_code);
+        if (source_code.count > 0 && stable_source.count == 0) return ctx_oom(ctx);
+
+        size_t diags_before = diag_error_count() + diag_warning_count();
+        if (!eval_read_lex_parse_external(ctx, path_c, stable_source, persistent, &ast)) return false;
+        *out_ast = ast;
+        if (diag_error_count() + diag_warning_count() != diags_before) return true;
+        if (session->ast_cache_dir) (void)ast_cache_store(session->ast_cache_dir, stable_source, ast);
+    }
+
+    Eval_Ast_Cache_Value value = {
+        .ast = ast,
+        .size = source_code.count,
+        .content_hash = content_hash,
+        .mtime_sec = stamp.mtime_sec,
+        .mtime_nsec = stamp.mtime_nsec,
+        .has_stamp = stamp_trusted,
+    };
+    if (entry) {
+        entry->value = value;
+        return true;
+    }
+    char *stable_key = arena_strndup(persistent, path_c, file_path.count);
+    EVAL_OOM_RETURN_IF_NULL(ctx, stable_key, false);
+    stbds_shput(session->ast_cache, stable_key, value);
+    return true;
+}
+
 static bool eval_push_external_context(EvalExecContext *ctx,
                                        String_View file_path,
                                        const char *path_c,
@@ -168,14 +287,10 @@ Eval_Result eval_execute_file(EvalExecContext *ctx,
     Eval_Result result = eval_result_fatal();
     size_t entered_file_depth = 0;
     char *path_c = NULL;
-    String_View source_code = {0};
-    Token_List tokens = NULL;
     Ast_Root new_ast = NULL;
     External_Eval_State state = {0};
 
-    if (!eval_read_external_source(ctx, file_path, &path_c, &source_code)) goto cleanup;
-    if (!eval_lex_external_tokens(ctx, path_c, source_code, &tokens)) goto cleanup;
-    if (!eval_parse_external_ast(ctx, &tokens, &new_ast)) goto cleanup;
+    if (!eval_load_external_ast(ctx, file_path, &path_c, &new_ast)) goto cleanup;
     if (!eval_push_external_context(ctx, file_path, path_c, is_add_subdirectory, explicit_bin_dir, &state)) goto cleanup;
     entered_file_depth = ctx->file_eval_depth;
     if (is_add_subdirectory) {
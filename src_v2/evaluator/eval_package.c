@@ -13,28 +13,32 @@ static bool package_list_append_unique(EvalExecContext *ctx, SV_List *list, Stri
     return EVAL_ARR_PUSH(ctx, ctx->event_arena, *list, name);
 }
 
-static void package_list_remove(SV_List *list, String_View name) {
-    if (!list) return;
+static bool package_list_remove(EvalExecContext *ctx, Eval_Tx_Slice slice, SV_List *list, String_View name) {
+    if (!list) return true;
     for (size_t i = 0; i < arena_arr_len(*list); i++) {
         if (!eval_sv_key_eq((*list)[i], name)) continue;
+        if (!eval_command_tx_note_slice(ctx, slice, i)) return false;
         size_t count = arena_arr_len(*list);
         if (i + 1 < count) {
             memmove(&(*list)[i], &(*list)[i + 1], (count - (i + 1)) * sizeof((*list)[0]));
         }
         arena_arr_set_len(*list, count - 1);
-        return;
+        return true;
     }
+    return true;
 }
 
 static bool package_record_find_result(EvalExecContext *ctx, String_View package_name, bool found) {
     if (!ctx || package_name.count == 0) return false;
     Eval_Package_Model *model = &ctx->semantic_state.package;
     if (found) {
-        package_list_remove(&model->not_found_packages, package_name);
+        if (!package_list_remove(ctx, EVAL_TX_SLICE_NOT_FOUND_PACKAGES, &model->not_found_packages, package_name)) {
+            return false;
+        }
         return package_list_append_unique(ctx, &model->found_packages, package_name);
     }
 
-    package_list_remove(&model->found_packages, package_name);
+    if (!package_list_remove(ctx, EVAL_TX_SLICE_FOUND_PACKAGES, &model->found_packages, package_name)) return false;
     return package_list_append_unique(ctx, &model->not_found_packages, package_name);
 }
 
@@ -1267,6 +1271,9 @@ static bool find_package_execute_resolved_artifacts(EvalExecContext *ctx,
     }
 
     if (pushed_pkg && arena_arr_len(ctx->semantic_state.package.active_find_packages) > 0) {
+        (void)eval_command_tx_note_slice(ctx,
+                                         EVAL_TX_SLICE_ACTIVE_FIND_PACKAGES,
+                                         arena_arr_len(ctx->semantic_state.package.active_find_packages) - 1);
         arena_arr_set_len(ctx->semantic_state.package.active_find_packages,
                           arena_arr_len(ctx->semantic_state.package.active_find_packages) - 1);
     }
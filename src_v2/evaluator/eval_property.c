@@ -6,6 +6,7 @@
 #include "sv_utils.h"
 
 #include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *k_global_defs_var = "NOBIFY_GLOBAL_COMPILE_DEFINITIONS";
@@ -1093,11 +1094,15 @@ static bool property_source_generated_set_temp(EvalExecContext *ctx,
     if (out_set) *out_set = false;
     if (!ctx) return false;
 
-    Eval_Property_Engine *engine = &ctx->semantic_state.properties;
-    for (size_t i = 0; i < arena_arr_len(engine->records); i++) {
-        const Eval_Property_Record *record = &engine->records[i];
-        if (!eval_sv_eq_ci_lit(record->scope_upper, "SOURCE")) continue;
-        if (!eval_sv_eq_ci_lit(record->property_upper, "GENERATED")) continue;
+    size_t *family = NULL;
+    if (!eval_property_engine_collect_family(ctx,
+                                             nob_sv_from_cstr("SOURCE"),
+                                             nob_sv_from_cstr("GENERATED"),
+                                             &family)) {
+        return false;
+    }
+    for (size_t i = 0; i < arena_arr_len(family); i++) {
+        const Eval_Property_Record *record = &ctx->semantic_state.properties.records[family[i]];
 
         Property_Directory_Scoped_Object parts = {0};
         if (!property_parse_directory_scoped_object(record->object_id, &parts)) return false;
@@ -1409,22 +1414,318 @@ static String_View eval_property_store_key_temp(EvalExecContext *ctx,
     return nob_sv_from_cstr(buf);
 }
 
+// Property index: open-addressed slots over the record and definition lists.
+// Records are keyed by (scope, object, property); a second table keyed by
+// (scope, property) points at the newest record of that family, and
+// family_prev links each record to the previous one, so family scans only
+// touch matching records.
+
+typedef struct {
+    String_View scope_upper;
+    String_View object_id;
+    String_View property_upper;
+} Property_Index_Key;
+
+typedef Property_Index_Key (*Property_Index_Key_Fn)(const EvalExecContext *ctx, size_t index);
+
+static size_t property_index_hash_part(size_t hash, String_View part) {
+    for (size_t i = 0; i < part.count; i++) {
+        hash ^= (unsigned char)part.data[i];
+        hash *= (size_t)1099511628211ull;
+    }
+    // A separator keeps ("AB", "C") and ("A", "BC") apart.
+    hash ^= 0xff;
+    hash *= (size_t)1099511628211ull;
+    return hash;
+}
+
+static size_t property_index_hash(Property_Index_Key key) {
+    size_t hash = (size_t)14695981039346656037ull;
+    hash = property_index_hash_part(hash, key.scope_upper);
+    hash = property_index_hash_part(hash, key.object_id);
+    return property_index_hash_part(hash, key.property_upper);
+}
+
+static bool property_index_key_eq(Property_Index_Key a, Property_Index_Key b) {
+    return eval_sv_key_eq(a.scope_upper, b.scope_upper) &&
+           eval_sv_key_eq(a.object_id, b.object_id) &&
+           eval_sv_key_eq(a.property_upper, b.property_upper);
+}
+
+static Property_Index_Key property_record_key(const EvalExecContext *ctx, size_t index) {
+    const Eval_Property_Record *record = &ctx->semantic_state.properties.records[index];
+    return (Property_Index_Key){record->scope_upper, record->object_id, record->property_upper};
+}
+
+static Property_Index_Key property_family_key(const EvalExecContext *ctx, size_t index) {
+    const Eval_Property_Record *record = &ctx->semantic_state.properties.records[index];
+    return (Property_Index_Key){record->scope_upper, nob_sv_from_cstr(""), record->property_upper};
+}
+
+static Property_Index_Key property_definition_key(const EvalExecContext *ctx, size_t index) {
+    const Eval_Property_Definition *def = &ctx->property_definitions[index];
+    return (Property_Index_Key){def->scope_upper, nob_sv_from_cstr(""), def->property_upper};
+}
+
+static size_t property_index_probe(const EvalExecContext *ctx,
+                                   const Eval_Property_Slot *slots,
+                                   size_t capacity,
+                                   Property_Index_Key key,
+                                   size_t hash,
+                                   Property_Index_Key_Fn key_at) {
+    size_t mask = capacity - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        if (slots[slot].index == SIZE_MAX) return slot;
+        if (slots[slot].hash == hash && property_index_key_eq(key_at(ctx, slots[slot].index), key)) return slot;
+    }
+}
+
+static void property_index_remove_slot(Eval_Property_Slot *slots, size_t capacity, size_t hole) {
+    size_t mask = capacity - 1;
+    for (size_t j = (hole + 1) & mask; slots[j].index != SIZE_MAX; j = (j + 1) & mask) {
+        size_t home = slots[j].hash & mask;
+        bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (stays) continue;
+        slots[hole] = slots[j];
+        hole = j;
+    }
+    slots[hole].hash = 0;
+    slots[hole].index = SIZE_MAX;
+}
+
+// Keeps the table at most half full. Entries carry their hash, so growing
+// re-places them without looking at keys.
+static bool property_index_reserve(Eval_Property_Slot **slots, size_t *capacity, size_t entries) {
+    if (*slots && entries * 2 <= *capacity) return true;
+    size_t new_capacity = *capacity ? *capacity : 64;
+    while (new_capacity < entries * 2) new_capacity <<= 1;
+
+    Eval_Property_Slot *grown = malloc(new_capacity * sizeof(*grown));
+    if (!grown) return false;
+    for (size_t i = 0; i < new_capacity; i++) {
+        grown[i].hash = 0;
+        grown[i].index = SIZE_MAX;
+    }
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; *slots && i < *capacity; i++) {
+        if ((*slots)[i].index == SIZE_MAX) continue;
+        size_t at = (*slots)[i].hash & mask;
+        while (grown[at].index != SIZE_MAX) at = (at + 1) & mask;
+        grown[at] = (*slots)[i];
+    }
+    free(*slots);
+    *slots = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+static bool property_index_add_record(EvalExecContext *ctx, size_t index) {
+    Eval_Property_Engine *engine = &ctx->semantic_state.properties;
+    if (!property_index_reserve(&engine->record_slots, &engine->record_slot_capacity, index + 1) ||
+        !property_index_reserve(&engine->family_slots, &engine->family_slot_capacity, index + 1)) {
+        return false;
+    }
+    if (index >= engine->family_prev_capacity) {
+        size_t capacity = engine->family_prev_capacity ? engine->family_prev_capacity * 2 : 64;
+        while (capacity <= index) capacity *= 2;
+        size_t *grown = realloc(engine->family_prev, capacity * sizeof(*grown));
+        if (!grown) return false;
+        engine->family_prev = grown;
+        engine->family_prev_capacity = capacity;
+    }
+
+    Property_Index_Key key = property_record_key(ctx, index);
+    size_t hash = property_index_hash(key);
+    size_t slot = property_index_probe(ctx, engine->record_slots, engine->record_slot_capacity, key, hash, property_record_key);
+    if (engine->record_slots[slot].index == SIZE_MAX) {
+        engine->record_slots[slot].hash = hash;
+        engine->record_slots[slot].index = index;
+    }
+
+    key = property_family_key(ctx, index);
+    hash = property_index_hash(key);
+    slot = property_index_probe(ctx, engine->family_slots, engine->family_slot_capacity, key, hash, property_family_key);
+    engine->family_prev[index] = engine->family_slots[slot].index;
+    engine->family_slots[slot].hash = hash;
+    engine->family_slots[slot].index = index;
+    return true;
+}
+
+static bool property_index_add_definition(EvalExecContext *ctx, size_t index) {
+    Eval_Property_Engine *engine = &ctx->semantic_state.properties;
+    if (!property_index_reserve(&engine->definition_slots, &engine->definition_slot_capacity, index + 1)) {
+        return false;
+    }
+    Property_Index_Key key = property_definition_key(ctx, index);
+    size_t hash = property_index_hash(key);
+    size_t slot = property_index_probe(ctx,
+                                       engine->definition_slots,
+                                       engine->definition_slot_capacity,
+                                       key,
+                                       hash,
+                                       property_definition_key);
+    // Definitions are first-wins, so an existing entry is kept.
+    if (engine->definition_slots[slot].index != SIZE_MAX) return true;
+    engine->definition_slots[slot].hash = hash;
+    engine->definition_slots[slot].index = index;
+    return true;
+}
+
+// Brings the indexes up to date with records and definitions pushed since
+// the last lookup. Returns false when lookups must fall back to scanning.
+static bool property_index_sync(EvalExecContext *ctx) {
+    Eval_Property_Engine *engine = &ctx->semantic_state.properties;
+    if (engine->index_broken) return false;
+    size_t record_count = arena_arr_len(engine->records);
+    size_t definition_count = arena_arr_len(ctx->property_definitions);
+    if (!property_index_reserve(&engine->record_slots, &engine->record_slot_capacity, 0) ||
+        !property_index_reserve(&engine->family_slots, &engine->family_slot_capacity, 0) ||
+        !property_index_reserve(&engine->definition_slots, &engine->definition_slot_capacity, 0)) {
+        engine->index_broken = true;
+        return false;
+    }
+    if (engine->indexed_record_count > record_count || engine->indexed_definition_count > definition_count) {
+        eval_property_engine_truncate(ctx, record_count, definition_count);
+    }
+    while (engine->indexed_record_count < record_count) {
+        if (!property_index_add_record(ctx, engine->indexed_record_count)) {
+            engine->index_broken = true;
+            return false;
+        }
+        engine->indexed_record_count++;
+    }
+    while (engine->indexed_definition_count < definition_count) {
+        if (!property_index_add_definition(ctx, engine->indexed_definition_count)) {
+            engine->index_broken = true;
+            return false;
+        }
+        engine->indexed_definition_count++;
+    }
+    return true;
+}
+
+void eval_property_engine_truncate(EvalExecContext *ctx, size_t record_count, size_t definition_count) {
+    if (!ctx) return;
+    Eval_Property_Engine *engine = &ctx->semantic_state.properties;
+    if (engine->index_broken) return;
+    // Newest first, so each removed record is still the head of its family.
+    while (engine->indexed_record_count > record_count) {
+        size_t index = --engine->indexed_record_count;
+        Property_Index_Key key = property_record_key(ctx, index);
+        size_t slot = property_index_probe(ctx,
+                                           engine->record_slots,
+                                           engine->record_slot_capacity,
+                                           key,
+                                           property_index_hash(key),
+                                           property_record_key);
+        if (engine->record_slots[slot].index == index) {
+            property_index_remove_slot(engine->record_slots, engine->record_slot_capacity, slot);
+        }
+
+        key = property_family_key(ctx, index);
+        slot = property_index_probe(ctx,
+                                    engine->family_slots,
+                                    engine->family_slot_capacity,
+                                    key,
+                                    property_index_hash(key),
+                                    property_family_key);
+        if (engine->family_slots[slot].index != index) continue;
+        if (engine->family_prev[index] == SIZE_MAX) {
+            property_index_remove_slot(engine->family_slots, engine->family_slot_capacity, slot);
+        } else {
+            engine->family_slots[slot].index = engine->family_prev[index];
+        }
+    }
+    while (engine->indexed_definition_count > definition_count) {
+        size_t index = --engine->indexed_definition_count;
+        Property_Index_Key key = property_definition_key(ctx, index);
+        size_t slot = property_index_probe(ctx,
+                                           engine->definition_slots,
+                                           engine->definition_slot_capacity,
+                                           key,
+                                           property_index_hash(key),
+                                           property_definition_key);
+        if (engine->definition_slots[slot].index == index) {
+            property_index_remove_slot(engine->definition_slots, engine->definition_slot_capacity, slot);
+        }
+    }
+}
+
+void eval_property_engine_free(Eval_Property_Engine *engine) {
+    if (!engine) return;
+    free(engine->record_slots);
+    free(engine->family_slots);
+    free(engine->family_prev);
+    free(engine->definition_slots);
+    engine->record_slots = NULL;
+    engine->family_slots = NULL;
+    engine->family_prev = NULL;
+    engine->definition_slots = NULL;
+    engine->record_slot_capacity = 0;
+    engine->family_slot_capacity = 0;
+    engine->family_prev_capacity = 0;
+    engine->definition_slot_capacity = 0;
+    engine->indexed_record_count = 0;
+    engine->indexed_definition_count = 0;
+    engine->index_broken = false;
+}
+
 static Eval_Property_Record *property_engine_record(EvalExecContext *ctx,
                                                     String_View scope_upper,
                                                     String_View object_id,
                                                     String_View property_upper) {
     if (!ctx || scope_upper.count == 0 || property_upper.count == 0) return NULL;
     Eval_Property_Engine *engine = &ctx->semantic_state.properties;
+    Property_Index_Key key = {scope_upper, object_id, property_upper};
+    if (property_index_sync(ctx)) {
+        size_t slot = property_index_probe(ctx,
+                                           engine->record_slots,
+                                           engine->record_slot_capacity,
+                                           key,
+                                           property_index_hash(key),
+                                           property_record_key);
+        size_t index = engine->record_slots[slot].index;
+        return index == SIZE_MAX ? NULL : &engine->records[index];
+    }
     for (size_t i = 0; i < arena_arr_len(engine->records); i++) {
-        Eval_Property_Record *record = &engine->records[i];
-        if (!eval_sv_key_eq(record->scope_upper, scope_upper)) continue;
-        if (!eval_sv_key_eq(record->object_id, object_id)) continue;
-        if (!eval_sv_key_eq(record->property_upper, property_upper)) continue;
-        return record;
+        if (property_index_key_eq(property_record_key(ctx, i), key)) return &engine->records[i];
     }
     return NULL;
 }
 
+bool eval_property_engine_collect_family(EvalExecContext *ctx,
+                                         String_View scope_upper,
+                                         String_View property_upper,
+                                         size_t **out_indexes) {
+    if (!ctx || !out_indexes) return false;
+    *out_indexes = NULL;
+    Eval_Property_Engine *engine = &ctx->semantic_state.properties;
+    Property_Index_Key key = {scope_upper, nob_sv_from_cstr(""), property_upper};
+    if (!property_index_sync(ctx)) {
+        for (size_t i = 0; i < arena_arr_len(engine->records); i++) {
+            if (!property_index_key_eq(property_family_key(ctx, i), key)) continue;
+            if (!EVAL_ARR_PUSH(ctx, eval_temp_arena(ctx), *out_indexes, i)) return false;
+        }
+        return true;
+    }
+
+    size_t slot = property_index_probe(ctx,
+                                       engine->family_slots,
+                                       engine->family_slot_capacity,
+                                       key,
+                                       property_index_hash(key),
+                                       property_family_key);
+    size_t count = 0;
+    for (size_t i = engine->family_slots[slot].index; i != SIZE_MAX; i = engine->family_prev[i]) count++;
+    if (count == 0) return true;
+    size_t *indexes = arena_arr_push_n(eval_temp_arena(ctx), *out_indexes, count);
+    EVAL_OOM_RETURN_IF_NULL(ctx, indexes, false);
+    for (size_t i = engine->family_slots[slot].index; i != SIZE_MAX; i = engine->family_prev[i]) {
+        indexes[--count] = i;
+    }
+    return true;
+}
+
 bool eval_property_engine_set(EvalExecContext *ctx,
                               String_View scope_upper,
                               String_View object_id,
@@ -1437,6 +1738,11 @@ bool eval_property_engine_set(EvalExecContext *ctx,
 
     Eval_Property_Record *record = property_engine_record(ctx, scope_upper, object_id, property_upper);
     if (record) {
+        if (!eval_command_tx_note_elem(ctx,
+                                       EVAL_TX_SLICE_PROPERTY_RECORDS,
+                                       (size_t)(record - ctx->semantic_state.properties.records))) {
+            return false;
+        }
         record->value = stable_value;
         return true;
     }
@@ -1471,11 +1777,20 @@ static const Eval_Property_Definition *eval_property_definition_find_impl(EvalEx
                                                                           String_View scope_upper,
                                                                           String_View property_upper) {
     if (!ctx) return NULL;
+    Property_Index_Key key = {scope_upper, nob_sv_from_cstr(""), property_upper};
+    if (property_index_sync(ctx)) {
+        Eval_Property_Engine *engine = &ctx->semantic_state.properties;
+        size_t slot = property_index_probe(ctx,
+                                           engine->definition_slots,
+                                           engine->definition_slot_capacity,
+                                           key,
+                                           property_index_hash(key),
+                                           property_definition_key);
+        size_t index = engine->definition_slots[slot].index;
+        return index == SIZE_MAX ? NULL : &ctx->property_definitions[index];
+    }
     for (size_t i = 0; i < arena_arr_len(ctx->property_definitions); i++) {
-        const Eval_Property_Definition *def = &ctx->property_definitions[i];
-        if (!eval_sv_key_eq(def->scope_upper, scope_upper)) continue;
-        if (!eval_sv_key_eq(def->property_upper, property_upper)) continue;
-        return def;
+        if (property_index_key_eq(property_definition_key(ctx, i), key)) return &ctx->property_definitions[i];
     }
     return NULL;
 }
@@ -1949,7 +2264,7 @@ bool eval_property_query_cmake(EvalExecContext *ctx,
     }
 
     if (eval_sv_eq_ci_lit(property_name, "CACHE_VARIABLES")) {
-        ptrdiff_t n = stbds_shlen(ctx->scope_state.cache_entries);
+        ptrdiff_t n = stbds_hmlen(ctx->scope_state.cache_entries);
         for (ptrdiff_t i = 0; i < n; i++) {
             if (!ctx->scope_state.cache_entries[i].key) continue;
             if (!property_append_unique_temp(ctx,
@@ -0,0 +1,116 @@
+#include "eval_regex_cache.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// REG_UNGREEDY only exists in the PCRE2 POSIX wrapper, whose regex_t exposes
+// the native pattern. The vendored Windows build ships without the JIT
+// sources, so patterns there stay interpreted.
+#if defined(REG_UNGREEDY) && !defined(_WIN32)
+#include <pcre2.h>
+#define EVAL_REGEX_CACHE_JIT 1
+#endif
+
+typedef struct {
+    char *pattern; // NUL-terminated copy of the key; NULL for a free slot
+    size_t pattern_len;
+    size_t hash;
+    int cflags;
+    uint64_t last_used;
+    regex_t re;
+} Eval_Regex_Cache_Entry;
+
+struct Eval_Regex_Cache {
+    Eval_Regex_Cache_Entry entries[EVAL_REGEX_CACHE_CAPACITY];
+    size_t count;
+    uint64_t clock;
+};
+
+static size_t regex_cache_hash(String_View pattern, int cflags) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < pattern.count; i++) {
+        h ^= (unsigned char)pattern.data[i];
+        h *= 1099511628211ULL;
+    }
+    h ^= (uint64_t)(unsigned)cflags;
+    h *= 1099511628211ULL;
+    return (size_t)h;
+}
+
+static void regex_cache_entry_release(Eval_Regex_Cache_Entry *entry) {
+    regfree(&entry->re);
+    free(entry->pattern);
+    memset(entry, 0, sizeof(*entry));
+}
+
+const regex_t *eval_regex_cache_get(EvalExecContext *ctx, String_View pattern, int cflags) {
+    if (!ctx || !ctx->session) return NULL;
+    EvalSession *session = ctx->session;
+    Eval_Regex_Cache *cache = session->regex_cache;
+    if (!cache) {
+        cache = (Eval_Regex_Cache*)calloc(1, sizeof(*cache));
+        EVAL_OOM_RETURN_IF_NULL(ctx, cache, NULL);
+        session->regex_cache = cache;
+    }
+
+    Eval_Runtime_State *runtime = eval_runtime_slice(ctx);
+    size_t hash = regex_cache_hash(pattern, cflags);
+    cache->clock++;
+    for (size_t i = 0; i < cache->count; i++) {
+        Eval_Regex_Cache_Entry *entry = &cache->entries[i];
+        if (!entry->pattern || entry->hash != hash || entry->cflags != cflags || entry->pattern_len != pattern.count) continue;
+        if (pattern.count > 0 && memcmp(entry->pattern, pattern.data, pattern.count) != 0) continue;
+        entry->last_used = cache->clock;
+        runtime->run_report.regex_cache_hits++;
+        return &entry->re;
+    }
+    runtime->run_report.regex_cache_misses++;
+
+    char *pattern_c = (char*)malloc(pattern.count + 1);
+    EVAL_OOM_RETURN_IF_NULL(ctx, pattern_c, NULL);
+    if (pattern.count > 0) memcpy(pattern_c, pattern.data, pattern.count);
+    pattern_c[pattern.count] = '\0';
+
+    // Compile in place: the POSIX wrappers do not promise that a regex_t
+    // survives being copied.
+    Eval_Regex_Cache_Entry *slot = NULL;
+    if (cache->count < EVAL_REGEX_CACHE_CAPACITY) {
+        slot = &cache->entries[cache->count];
+    } else {
+        slot = &cache->entries[0];
+        for (size_t i = 1; i < cache->count; i++) {
+            if (cache->entries[i].last_used < slot->last_used) slot = &cache->entries[i];
+        }
+        if (slot->pattern) regex_cache_entry_release(slot);
+    }
+
+    if (regcomp(&slot->re, pattern_c, cflags) != 0) {
+        free(pattern_c);
+        memset(slot, 0, sizeof(*slot));
+        return NULL;
+    }
+#ifdef EVAL_REGEX_CACHE_JIT
+    // regexec() matches through pcre2_match(), which picks up JIT code when
+    // it exists. Failure (no JIT support on this host) keeps the interpreter.
+    (void)pcre2_jit_compile((pcre2_code*)slot->re.re_pcre2_code, PCRE2_JIT_COMPLETE);
+#endif
+
+    if (slot == &cache->entries[cache->count]) cache->count++;
+    slot->pattern = pattern_c;
+    slot->pattern_len = pattern.count;
+    slot->hash = hash;
+    slot->cflags = cflags;
+    slot->last_used = cache->clock;
+    return &slot->re;
+}
+
+void eval_regex_cache_free(EvalSession *session) {
+    if (!session || !session->regex_cache) return;
+    Eval_Regex_Cache *cache = session->regex_cache;
+    for (size_t i = 0; i < cache->count; i++) {
+        if (cache->entries[i].pattern) regex_cache_entry_release(&cache->entries[i]);
+    }
+    free(cache);
+    session->regex_cache = NULL;
+}
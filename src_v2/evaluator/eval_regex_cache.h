@@ -0,0 +1,18 @@
+#ifndef EVAL_REGEX_CACHE_H_
+#define EVAL_REGEX_CACHE_H_
+
+#include "evaluator_internal.h"
+
+#include <pcre2posix.h>
+
+// Returns the compiled form of `pattern` from the session regex cache, keyed
+// by pattern text and regcomp() flags. The cache owns the result (do not
+// regfree() it); eviction is least-recently-used, so a pattern stays valid
+// across at least EVAL_REGEX_CACHE_CAPACITY - 1 further lookups. Returns NULL
+// when the pattern does not compile, or on OOM with ctx->oom set.
+const regex_t *eval_regex_cache_get(EvalExecContext *ctx, String_View pattern, int cflags);
+
+// Frees every cached pattern.
+void eval_regex_cache_free(EvalSession *session);
+
+#endif // EVAL_REGEX_CACHE_H_
@@ -109,6 +109,7 @@ bool eval_process_env_set(EvalExecContext *ctx, String_View name, String_View va
     Eval_Process_Env_Entry *entry = eval_process_env_find_sv(ctx, name);
     if (eval_should_stop(ctx)) return false;
     if (entry) {
+        if (!eval_command_tx_note_env(ctx, entry->key, entry)) return false;
         entry->value.text = sv_copy_to_event_arena(ctx, value);
         entry->value.is_set = true;
         if (eval_should_stop(ctx)) return false;
@@ -117,6 +118,7 @@ bool eval_process_env_set(EvalExecContext *ctx, String_View name, String_View va
 
     String_View stable_key = eval_process_env_key_sv_event(ctx, name);
     if (eval_should_stop(ctx)) return false;
+    if (!eval_command_tx_note_env(ctx, (char*)stable_key.data, NULL)) return false;
 
     Eval_Process_Env_Value stored = {
         .text = sv_copy_to_event_arena(ctx, value),
@@ -137,6 +139,7 @@ bool eval_process_env_unset(EvalExecContext *ctx, String_View name) {
     Eval_Process_Env_Entry *entry = eval_process_env_find_sv(ctx, name);
     if (eval_should_stop(ctx)) return false;
     if (entry) {
+        if (!eval_command_tx_note_env(ctx, entry->key, entry)) return false;
         entry->value.text = nob_sv_from_cstr("");
         entry->value.is_set = false;
         return true;
@@ -144,6 +147,7 @@ bool eval_process_env_unset(EvalExecContext *ctx, String_View name) {
 
     String_View stable_key = eval_process_env_key_sv_event(ctx, name);
     if (eval_should_stop(ctx)) return false;
+    if (!eval_command_tx_note_env(ctx, (char*)stable_key.data, NULL)) return false;
 
     Eval_Process_Env_Value stored = {
         .text = nob_sv_from_cstr(""),
@@ -1,5 +1,7 @@
 #include "eval_string_internal.h"
 
+#include "eval_regex_cache.h"
+
 #include <pcre2posix.h>
 
 static String_View string_regex_unescape_replacement_temp(EvalExecContext *ctx, String_View in) {
@@ -44,18 +46,14 @@ Eval_Result eval_string_handle_regex(EvalExecContext *ctx, const Node *node, Cma
         String_View input = (arena_arr_len(a) > 4) ? eval_sv_join_semi_temp(ctx, &a[4], arena_arr_len(a) - 4) : nob_sv_from_cstr("");
         if (eval_should_stop(ctx)) return eval_result_from_ctx(ctx);
 
-        char *pat_buf = (char*)arena_alloc(eval_temp_arena(ctx), pattern.count + 1);
-        EVAL_OOM_RETURN_IF_NULL(ctx, pat_buf, eval_result_fatal());
-        memcpy(pat_buf, pattern.data, pattern.count);
-        pat_buf[pattern.count] = '\0';
-
         char *in_buf = (char*)arena_alloc(eval_temp_arena(ctx), input.count + 1);
         EVAL_OOM_RETURN_IF_NULL(ctx, in_buf, eval_result_fatal());
         memcpy(in_buf, input.data, input.count);
         in_buf[input.count] = '\0';
 
-        regex_t re;
-        if (regcomp(&re, pat_buf, REG_EXTENDED) != 0) {
+        const regex_t *re = eval_regex_cache_get(ctx, pattern, REG_EXTENDED);
+        if (!re) {
+            if (ctx->oom) return eval_result_fatal();
             EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_PARSE_ERROR, "string", nob_sv_from_cstr("Invalid regex pattern"), pattern);
             return eval_result_from_ctx(ctx);
         }
@@ -63,8 +61,7 @@ Eval_Result eval_string_handle_regex(EvalExecContext *ctx, const Node *node, Cma
         regmatch_t m[1];
         m[0].rm_so = -1;
         m[0].rm_eo = -1;
-        int rc = regexec(&re, in_buf, 1, m, 0);
-        regfree(&re);
+        int rc = regexec(re, in_buf, 1, m, 0);
 
         if (rc == 0 && m[0].rm_so >= 0 && m[0].rm_eo >= m[0].rm_so) {
             size_t mlen = (size_t)(m[0].rm_eo - m[0].rm_so);
@@ -88,18 +85,14 @@ Eval_Result eval_string_handle_regex(EvalExecContext *ctx, const Node *node, Cma
         String_View input = (arena_arr_len(a) > 5) ? eval_sv_join_semi_temp(ctx, &a[5], arena_arr_len(a) - 5) : nob_sv_from_cstr("");
         if (eval_should_stop(ctx)) return eval_result_from_ctx(ctx);
 
-        char *pat_buf = (char*)arena_alloc(eval_temp_arena(ctx), pattern.count + 1);
-        EVAL_OOM_RETURN_IF_NULL(ctx, pat_buf, eval_result_fatal());
-        memcpy(pat_buf, pattern.data, pattern.count);
-        pat_buf[pattern.count] = '\0';
-
         char *in_buf = (char*)arena_alloc(eval_temp_arena(ctx), input.count + 1);
         EVAL_OOM_RETURN_IF_NULL(ctx, in_buf, eval_result_fatal());
         memcpy(in_buf, input.data, input.count);
         in_buf[input.count] = '\0';
 
-        regex_t re;
-        if (regcomp(&re, pat_buf, REG_EXTENDED) != 0) {
+        const regex_t *re = eval_regex_cache_get(ctx, pattern, REG_EXTENDED);
+        if (!re) {
+            if (ctx->oom) return eval_result_fatal();
             EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_PARSE_ERROR, "string", nob_sv_from_cstr("Invalid regex pattern"), pattern);
             return eval_result_from_ctx(ctx);
         }
@@ -114,7 +107,7 @@ Eval_Result eval_string_handle_regex(EvalExecContext *ctx, const Node *node, Cma
                 m[i].rm_so = -1;
                 m[i].rm_eo = -1;
             }
-            int rc = regexec(&re, cursor, MAX_GROUPS, m, 0);
+            int rc = regexec(re, cursor, MAX_GROUPS, m, 0);
             if (rc != 0 || m[0].rm_so < 0 || m[0].rm_eo < m[0].rm_so) {
                 nob_sb_append_cstr(&sb, cursor);
                 break;
@@ -151,7 +144,6 @@ Eval_Result eval_string_handle_regex(EvalExecContext *ctx, const Node *node, Cma
             }
         }
 
-        regfree(&re);
         char *out_buf = (char*)arena_alloc(eval_temp_arena(ctx), sb.count + 1);
         if (!out_buf) {
             nob_sb_free(sb);
@@ -171,18 +163,14 @@ Eval_Result eval_string_handle_regex(EvalExecContext *ctx, const Node *node, Cma
         String_View input = (arena_arr_len(a) > 4) ? eval_string_join_no_sep_temp(ctx, &a[4], arena_arr_len(a) - 4) : nob_sv_from_cstr("");
         if (eval_should_stop(ctx)) return eval_result_from_ctx(ctx);
 
-        char *pat_buf = (char*)arena_alloc(eval_temp_arena(ctx), pattern.count + 1);
-        EVAL_OOM_RETURN_IF_NULL(ctx, pat_buf, eval_result_fatal());
-        memcpy(pat_buf, pattern.data, pattern.count);
-        pat_buf[pattern.count] = '\0';
-
         char *in_buf = (char*)arena_alloc(eval_temp_arena(ctx), input.count + 1);
         EVAL_OOM_RETURN_IF_NULL(ctx, in_buf, eval_result_fatal());
         memcpy(in_buf, input.data, input.count);
         in_buf[input.count] = '\0';
 
-        regex_t re;
-        if (regcomp(&re, pat_buf, REG_EXTENDED) != 0) {
+        const regex_t *re = eval_regex_cache_get(ctx, pattern, REG_EXTENDED);
+        if (!re) {
+            if (ctx->oom) return eval_result_fatal();
             EVAL_NODE_ORIGIN_DIAG_EMIT_SEV(ctx, node, o, EV_DIAG_ERROR, EVAL_DIAG_PARSE_ERROR, "string", nob_sv_from_cstr("Invalid regex pattern"), pattern);
             return eval_result_from_ctx(ctx);
         }
@@ -193,14 +181,11 @@ Eval_Result eval_string_handle_regex(EvalExecContext *ctx, const Node *node, Cma
             regmatch_t m[1];
             m[0].rm_so = -1;
             m[0].rm_eo = -1;
-            int rc = regexec(&re, cursor, 1, m, 0);
+            int rc = regexec(re, cursor, 1, m, 0);
             if (rc != 0 || m[0].rm_so < 0 || m[0].rm_eo < m[0].rm_so) break;
 
             String_View hit = nob_sv_from_parts(cursor + m[0].rm_so, (size_t)(m[0].rm_eo - m[0].rm_so));
-            if (!svu_list_push_temp(ctx, &matches, hit)) {
-                regfree(&re);
-                return eval_result_from_ctx(ctx);
-            }
+            if (!svu_list_push_temp(ctx, &matches, hit)) return eval_result_from_ctx(ctx);
 
             if (m[0].rm_eo == 0) {
                 if (*cursor == '\0') break;
@@ -209,7 +194,6 @@ Eval_Result eval_string_handle_regex(EvalExecContext *ctx, const Node *node, Cma
                 cursor += m[0].rm_eo;
             }
         }
-        regfree(&re);
 
         String_View out = (arena_arr_len(matches) > 0) ? eval_sv_join_semi_temp(ctx, matches, arena_arr_len(matches)) : nob_sv_from_cstr("");
         (void)eval_var_set_current(ctx, out_var, out);
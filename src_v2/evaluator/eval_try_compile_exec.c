@@ -59,9 +59,10 @@ static bool try_compile_emit_probe_replay(EvalExecContext *ctx,
 
 static bool try_compile_cache_upsert(EvalExecContext *ctx, String_View key, String_View value) {
     if (!ctx) return false;
-    Eval_Cache_Entry *entry = NULL;
-    if (ctx->scope_state.cache_entries) entry = stbds_shgetp_null(ctx->scope_state.cache_entries, nob_temp_sv_to_cstr(key));
+    eval_compat_note_var_write(ctx, key);
+    Eval_Cache_Entry *entry = eval_cache_entry_find(ctx, key);
     if (entry) {
+        if (!eval_command_tx_note_cache(ctx, entry->key, entry)) return false;
         entry->value.data = sv_copy_to_event_arena(ctx, value);
         entry->value.type = sv_copy_to_event_arena(ctx, nob_sv_from_cstr("INTERNAL"));
         entry->value.doc = sv_copy_to_event_arena(ctx, nob_sv_from_cstr("try_compile result"));
@@ -69,10 +70,9 @@ static bool try_compile_cache_upsert(EvalExecContext *ctx, String_View key, Stri
         return true;
     }
 
-    char *stable_key = (char*)arena_alloc(eval_event_arena(ctx), key.count + 1);
-    EVAL_OOM_RETURN_IF_NULL(ctx, stable_key, false);
-    if (key.count > 0) memcpy(stable_key, key.data, key.count);
-    stable_key[key.count] = '\0';
+    char *stable_key = eval_symbol_intern(ctx, key);
+    if (!stable_key) return false;
+    if (!eval_command_tx_note_cache(ctx, stable_key, NULL)) return false;
 
     Eval_Cache_Value cv = {0};
     cv.data = sv_copy_to_event_arena(ctx, value);
@@ -81,7 +81,7 @@ static bool try_compile_cache_upsert(EvalExecContext *ctx, String_View key, Stri
     if (eval_should_stop(ctx)) return false;
 
     Eval_Cache_Entry *entries = ctx->scope_state.cache_entries;
-    stbds_shput(entries, stable_key, cv);
+    EVAL_SYMBOL_MAP_PUT(entries, stable_key, cv);
     ctx->scope_state.cache_entries = entries;
     return true;
 }
@@ -59,7 +59,7 @@ static bool try_run_result_uses_cache(const Try_Run_Request *req) {
 
 static String_View try_run_cache_get(EvalExecContext *ctx, String_View key) {
     if (!ctx || key.count == 0 || !ctx->scope_state.cache_entries) return nob_sv_from_cstr("");
-    Eval_Cache_Entry *entry = stbds_shgetp_null(ctx->scope_state.cache_entries, nob_temp_sv_to_cstr(key));
+    Eval_Cache_Entry *entry = eval_cache_entry_find(ctx, key);
     if (!entry) return nob_sv_from_cstr("");
     return entry->value.data;
 }
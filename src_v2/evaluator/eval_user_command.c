@@ -15,14 +15,99 @@ static bool user_cmd_sv_eq_ci(String_View a, String_View b) {
     return true;
 }
 
+// User command index: open-addressed, case-insensitive slots mapping a name
+// to its latest definition. Older definitions stay reachable through
+// shadowed_index, which is what lets rollback unwind in O(removed) and
+// serves CMake's `_name` alias for the previous definition.
+
+static bool user_cmd_index_valid(const Eval_Command_State *commands) {
+    return commands->user_command_index &&
+           commands->user_command_index_generation == commands->user_commands_generation &&
+           commands->user_command_index_count == arena_arr_len(commands->user_commands);
+}
+
+static size_t user_cmd_index_probe(const Eval_Command_State *commands, String_View name, size_t hash) {
+    size_t mask = commands->user_command_index_capacity - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const Eval_Command_Name_Slot *entry = &commands->user_command_index[slot];
+        if (entry->command_index == SIZE_MAX) return slot;
+        if (entry->hash == hash &&
+            user_cmd_sv_eq_ci(commands->user_commands[entry->command_index].name, name)) {
+            return slot;
+        }
+    }
+}
+
+static void user_cmd_index_remove_slot(Eval_Command_State *commands, size_t hole) {
+    size_t mask = commands->user_command_index_capacity - 1;
+    Eval_Command_Name_Slot *slots = commands->user_command_index;
+    for (size_t j = (hole + 1) & mask; slots[j].command_index != SIZE_MAX; j = (j + 1) & mask) {
+        size_t home = slots[j].hash & mask;
+        bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (stays) continue;
+        slots[hole] = slots[j];
+        hole = j;
+    }
+    slots[hole].hash = 0;
+    slots[hole].command_index = SIZE_MAX;
+}
+
+// Indexes user_commands[index], returning the definition it replaces.
+static size_t user_cmd_index_insert(Eval_Command_State *commands, size_t index) {
+    String_View name = commands->user_commands[index].name;
+    size_t hash = eval_command_name_hash_ci(name);
+    size_t slot = user_cmd_index_probe(commands, name, hash);
+    size_t previous = commands->user_command_index[slot].command_index;
+    commands->user_command_index[slot].hash = hash;
+    commands->user_command_index[slot].command_index = index;
+    return previous;
+}
+
+static bool user_cmd_index_rebuild(Eval_Command_State *commands, size_t min_entries) {
+    size_t count = arena_arr_len(commands->user_commands);
+    if (min_entries < count) min_entries = count;
+    size_t capacity = commands->user_command_index_capacity;
+    if (capacity < 32) capacity = 32;
+    while (capacity < min_entries * 2) capacity <<= 1;
+
+    if (!commands->user_command_index || capacity > commands->user_command_index_capacity) {
+        Eval_Command_Name_Slot *slots =
+            (Eval_Command_Name_Slot*)arena_alloc(commands->user_commands_arena, capacity * sizeof(*slots));
+        if (!slots) return false;
+        commands->user_command_index = slots;
+        commands->user_command_index_capacity = capacity;
+    }
+    for (size_t i = 0; i < commands->user_command_index_capacity; i++) {
+        commands->user_command_index[i].hash = 0;
+        commands->user_command_index[i].command_index = SIZE_MAX;
+    }
+    for (size_t i = 0; i < count; i++) {
+        commands->user_commands[i].shadowed_index = user_cmd_index_insert(commands, i);
+    }
+    commands->user_command_index_count = count;
+    commands->user_command_index_generation = commands->user_commands_generation;
+    return true;
+}
+
+static bool user_cmd_index_ensure(Eval_Command_State *commands, size_t min_entries) {
+    if (user_cmd_index_valid(commands) &&
+        min_entries * 2 <= commands->user_command_index_capacity) {
+        return true;
+    }
+    return user_cmd_index_rebuild(commands, min_entries);
+}
+
 static bool clone_args_to_event(EvalExecContext *ctx, const Args *src, Args *dst) {
     if (!ctx || !src || !dst) return false;
     *dst = NULL;
     if (arena_arr_len(*src) == 0) return true;
 
+    Arg_Cache *caches = arena_alloc_zero(ctx->event_arena, arena_arr_len(*src) * sizeof(*caches));
+    EVAL_OOM_RETURN_IF_NULL(ctx, caches, false);
     for (size_t i = 0; i < arena_arr_len(*src); i++) {
         Arg copy = {0};
         copy.kind = (*src)[i].kind;
+        copy.cache = &caches[i];
 
         for (size_t k = 0; k < arena_arr_len((*src)[i].items); k++) {
             Token t = (*src)[i].items[k];
@@ -52,8 +137,12 @@ static bool clone_node_to_event(EvalExecContext *ctx, const Node *src, Node *dst
         case NODE_COMMAND:
             dst->as.cmd.name = sv_copy_to_event_arena(ctx, src->as.cmd.name);
             if (eval_should_stop(ctx)) return false;
+            dst->as.cmd.dispatch_cache = arena_alloc_zero(ctx->event_arena, sizeof(*dst->as.cmd.dispatch_cache));
+            EVAL_OOM_RETURN_IF_NULL(ctx, dst->as.cmd.dispatch_cache, false);
             return clone_args_to_event(ctx, &src->as.cmd.args, &dst->as.cmd.args);
         case NODE_IF:
+            dst->as.if_stmt.condition_cache = arena_alloc_zero(ctx->event_arena, sizeof(*dst->as.if_stmt.condition_cache));
+            EVAL_OOM_RETURN_IF_NULL(ctx, dst->as.if_stmt.condition_cache, false);
             if (!clone_args_to_event(ctx, &src->as.if_stmt.condition, &dst->as.if_stmt.condition)) return false;
             if (!clone_node_list_to_event(ctx, &src->as.if_stmt.then_block, &dst->as.if_stmt.then_block)) return false;
             if (!clone_elseif_list_to_event(ctx, &src->as.if_stmt.elseif_clauses, &dst->as.if_stmt.elseif_clauses)) return false;
@@ -64,6 +153,8 @@ static bool clone_node_to_event(EvalExecContext *ctx, const Node *src, Node *dst
             if (!clone_node_list_to_event(ctx, &src->as.foreach_stmt.body, &dst->as.foreach_stmt.body)) return false;
             return true;
         case NODE_WHILE:
+            dst->as.while_stmt.condition_cache = arena_alloc_zero(ctx->event_arena, sizeof(*dst->as.while_stmt.condition_cache));
+            EVAL_OOM_RETURN_IF_NULL(ctx, dst->as.while_stmt.condition_cache, false);
             if (!clone_args_to_event(ctx, &src->as.while_stmt.condition, &dst->as.while_stmt.condition)) return false;
             if (!clone_node_list_to_event(ctx, &src->as.while_stmt.body, &dst->as.while_stmt.body)) return false;
             return true;
@@ -84,6 +175,8 @@ static bool clone_elseif_list_to_event(EvalExecContext *ctx, const ElseIf_Clause
     *dst = NULL;
     for (size_t i = 0; i < arena_arr_len(*src); i++) {
         ElseIf_Clause copy = {0};
+        copy.condition_cache = arena_alloc_zero(ctx->event_arena, sizeof(*copy.condition_cache));
+        EVAL_OOM_RETURN_IF_NULL(ctx, copy.condition_cache, false);
         if (!clone_args_to_event(ctx, &(*src)[i].condition, &copy.condition)) return false;
         if (!clone_node_list_to_event(ctx, &(*src)[i].block, &copy.block)) return false;
         if (!EVAL_ARR_PUSH(ctx, ctx->event_arena, *dst, copy)) return false;
@@ -131,13 +224,53 @@ bool eval_user_cmd_register(EvalExecContext *ctx, const Node *node) {
     cmd.params = params;
     cmd.body = body;
 
+    cmd.shadowed_index = SIZE_MAX;
+
     Eval_Command_State *commands = eval_command_slice(ctx);
-    return EVAL_ARR_PUSH(ctx, commands->user_commands_arena, commands->user_commands, cmd);
+    size_t index = arena_arr_len(commands->user_commands);
+    if (!user_cmd_index_ensure(commands, index + 1)) return ctx_oom(ctx);
+    if (!EVAL_ARR_PUSH(ctx, commands->user_commands_arena, commands->user_commands, cmd)) return false;
+    commands->user_commands[index].shadowed_index = user_cmd_index_insert(commands, index);
+    commands->user_command_index_count = index + 1;
+    eval_user_cmd_note_changed(ctx);
+    commands->user_command_index_generation = commands->user_commands_generation;
+    return true;
 }
 
-User_Command *eval_user_cmd_find(EvalExecContext *ctx, String_View name) {
-    if (!ctx) return NULL;
+// Any change to the user command list (definition, truncation, rollback)
+// must invalidate per-node dispatch caches, since they hold raw pointers into
+// the list. Changes that do not go through register/truncate also leave the
+// name index stale, and the next lookup rebuilds it.
+void eval_user_cmd_note_changed(EvalExecContext *ctx) {
+    if (!ctx) return;
+    ctx->command_state.user_commands_generation = eval_dispatch_generation_next();
+}
+
+void eval_user_cmd_truncate(EvalExecContext *ctx, size_t count) {
+    if (!ctx) return;
     Eval_Command_State *commands = eval_command_slice(ctx);
+    size_t len = arena_arr_len(commands->user_commands);
+    if (count >= len) return;
+
+    bool index_valid = user_cmd_index_valid(commands);
+    for (size_t i = len; index_valid && i-- > count;) {
+        const User_Command *cmd = &commands->user_commands[i];
+        size_t slot = user_cmd_index_probe(commands, cmd->name, eval_command_name_hash_ci(cmd->name));
+        if (cmd->shadowed_index != SIZE_MAX) {
+            commands->user_command_index[slot].command_index = cmd->shadowed_index;
+        } else {
+            user_cmd_index_remove_slot(commands, slot);
+        }
+    }
+    arena_arr_set_len(commands->user_commands, count);
+    eval_user_cmd_note_changed(ctx);
+    if (index_valid) {
+        commands->user_command_index_count = count;
+        commands->user_command_index_generation = commands->user_commands_generation;
+    }
+}
+
+static User_Command *user_cmd_find_linear(Eval_Command_State *commands, String_View name) {
     for (size_t i = arena_arr_len(commands->user_commands); i-- > 0;) {
         if (user_cmd_sv_eq_ci(commands->user_commands[i].name, name)) {
             return &commands->user_commands[i];
@@ -146,10 +279,40 @@ User_Command *eval_user_cmd_find(EvalExecContext *ctx, String_View name) {
     return NULL;
 }
 
+static User_Command *user_cmd_find_indexed(Eval_Command_State *commands, String_View name) {
+    size_t slot = user_cmd_index_probe(commands, name, eval_command_name_hash_ci(name));
+    size_t index = commands->user_command_index[slot].command_index;
+    return index == SIZE_MAX ? NULL : &commands->user_commands[index];
+}
+
+User_Command *eval_user_cmd_find(EvalExecContext *ctx, String_View name) {
+    if (!ctx || !name.data || name.count == 0) return NULL;
+    Eval_Command_State *commands = eval_command_slice(ctx);
+    if (arena_arr_len(commands->user_commands) == 0) return NULL;
+    if (!user_cmd_index_ensure(commands, 0)) return user_cmd_find_linear(commands, name);
+
+    User_Command *direct = user_cmd_find_indexed(commands, name);
+    if (name.count < 2 || name.data[0] != '_') return direct;
+
+    // Redefining `name` exposes the definition it replaced as `_name`, unless
+    // `_name` itself was defined after that redefinition.
+    User_Command *overridden = user_cmd_find_indexed(commands, nob_sv_from_parts(name.data + 1, name.count - 1));
+    if (!overridden || overridden->shadowed_index == SIZE_MAX) return direct;
+    if (direct && direct > overridden) return direct;
+    return &commands->user_commands[overridden->shadowed_index];
+}
+
 bool eval_user_cmd_invoke(EvalExecContext *ctx, String_View name, const SV_List *args, Cmake_Event_Origin origin) {
     if (eval_should_stop(ctx)) return false;
+    return eval_user_cmd_invoke_resolved(ctx, eval_user_cmd_find(ctx, name), name, args, origin);
+}
 
-    User_Command *cmd = eval_user_cmd_find(ctx, name);
+bool eval_user_cmd_invoke_resolved(EvalExecContext *ctx,
+                                   const User_Command *cmd,
+                                   String_View name,
+                                   const SV_List *args,
+                                   Cmake_Event_Origin origin) {
+    if (eval_should_stop(ctx)) return false;
     if (!cmd) return false;
 
     bool is_function = (cmd->kind == USER_CMD_FUNCTION);
@@ -5,6 +5,7 @@
 #include <ctype.h>
 #include <limits.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -154,6 +155,11 @@ bool eval_directory_register_node(EvalExecContext *ctx,
 
     Eval_Directory_Node *existing = eval_directory_find_node(ctx, normalized_source);
     if (existing) {
+        if (!eval_command_tx_note_elem(ctx,
+                                       EVAL_TX_SLICE_DIRECTORY_NODES,
+                                       (size_t)(existing - ctx->semantic_state.directories.nodes))) {
+            return false;
+        }
         if (existing->binary_dir.count == 0 && normalized_binary.count > 0) {
             existing->binary_dir = sv_copy_to_event_arena(ctx, normalized_binary);
             if (eval_should_stop(ctx)) return false;
@@ -277,6 +283,12 @@ bool eval_directory_note_target(EvalExecContext *ctx, String_View source_dir, St
     if (eval_should_stop(ctx)) return false;
     Eval_Directory_Node *node = eval_directory_find_node(ctx, normalized);
     if (!node) return false;
+    if (!eval_command_tx_note_nested(ctx,
+                                     EVAL_TX_SLICE_DIRECTORY_NODES,
+                                     (size_t)(node - ctx->semantic_state.directories.nodes),
+                                     offsetof(Eval_Directory_Node, declared_targets))) {
+        return false;
+    }
     return eval_directory_list_append_unique(ctx, &node->declared_targets, target_name);
 }
 
@@ -287,6 +299,12 @@ bool eval_directory_note_test(EvalExecContext *ctx, String_View source_dir, Stri
     if (eval_should_stop(ctx)) return false;
     Eval_Directory_Node *node = eval_directory_find_node(ctx, normalized);
     if (!node) return false;
+    if (!eval_command_tx_note_nested(ctx,
+                                     EVAL_TX_SLICE_DIRECTORY_NODES,
+                                     (size_t)(node - ctx->semantic_state.directories.nodes),
+                                     offsetof(Eval_Directory_Node, declared_tests))) {
+        return false;
+    }
     return eval_directory_list_append_unique(ctx, &node->declared_tests, test_name);
 }
 
@@ -306,7 +324,7 @@ bool eval_directory_capture_current_scope(EvalExecContext *ctx) {
     Eval_Scope_State *scope_state = eval_scope_slice(ctx);
     for (size_t depth = 0; depth < eval_scope_visible_depth(ctx); depth++) {
         Var_Scope *scope = &scope_state->scopes[depth];
-        ptrdiff_t n = stbds_shlen(scope->vars);
+        ptrdiff_t n = stbds_hmlen(scope->vars);
         for (ptrdiff_t i = 0; i < n; i++) {
             if (!scope->vars[i].key) continue;
             if (!eval_directory_binding_upsert(ctx,
@@ -341,6 +359,11 @@ bool eval_directory_capture_current_scope(EvalExecContext *ctx) {
         }
     }
 
+    if (!eval_command_tx_note_elem(ctx,
+                                   EVAL_TX_SLICE_DIRECTORY_NODES,
+                                   (size_t)(node - ctx->semantic_state.directories.nodes))) {
+        return false;
+    }
     node->definition_bindings = definitions;
     node->macro_names = macro_names;
     node->listfile_stack = listfile_stack;
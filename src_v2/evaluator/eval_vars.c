@@ -425,38 +425,36 @@ static bool cache_promote_untyped_path_value_if_needed(EvalExecContext *ctx,
     if (entry->value.data.count > 0 && abs.count == 0) return ctx_oom(ctx);
     entry->value.data = abs;
     if (eval_should_stop(ctx)) return false;
+    eval_compat_note_var_write(ctx, nob_sv_from_cstr(entry->key));
     return true;
 }
 
 static Eval_Cache_Entry *cache_find(EvalExecContext *ctx, String_View key) {
-    if (!ctx || !ctx->scope_state.cache_entries) return NULL;
-    return stbds_shgetp_null(ctx->scope_state.cache_entries, nob_temp_sv_to_cstr(key));
+    return eval_cache_entry_find(ctx, key);
 }
 
 static bool cache_remove(EvalExecContext *ctx, String_View key) {
     if (!ctx || !ctx->scope_state.cache_entries) return true;
-    (void)stbds_shdel(ctx->scope_state.cache_entries, nob_temp_sv_to_cstr(key));
+    Eval_Cache_Entry *entry = cache_find(ctx, key);
+    if (!entry) return true;
+    char *symbol = entry->key;
+    if (!eval_command_tx_note_cache(ctx, symbol, entry)) return false;
+    EVAL_SYMBOL_MAP_DEL(ctx->scope_state.cache_entries, symbol);
+    eval_compat_note_var_write(ctx, key);
     return true;
 }
 
-static char *cache_copy_key_cstr(EvalExecContext *ctx, String_View key) {
-    if (!ctx) return NULL;
-    char *buf = (char*)arena_alloc(eval_event_arena(ctx), key.count + 1);
-    EVAL_OOM_RETURN_IF_NULL(ctx, buf, NULL);
-    if (key.count > 0) memcpy(buf, key.data, key.count);
-    buf[key.count] = '\0';
-    return buf;
-}
-
 static bool cache_upsert(EvalExecContext *ctx,
                          String_View key,
                          String_View value,
                          String_View type,
                          String_View doc) {
     if (!ctx) return false;
+    eval_compat_note_var_write(ctx, key);
 
     Eval_Cache_Entry *entry = cache_find(ctx, key);
     if (entry) {
+        if (!eval_command_tx_note_cache(ctx, entry->key, entry)) return false;
         entry->value.data = sv_copy_to_event_arena(ctx, value);
         entry->value.type = sv_copy_to_event_arena(ctx, type);
         entry->value.doc = sv_copy_to_event_arena(ctx, doc);
@@ -464,8 +462,9 @@ static bool cache_upsert(EvalExecContext *ctx,
         return true;
     }
 
-    char *stable_key = cache_copy_key_cstr(ctx, key);
-    EVAL_OOM_RETURN_IF_NULL(ctx, stable_key, false);
+    char *stable_key = eval_symbol_intern(ctx, key);
+    if (!stable_key) return false;
+    if (!eval_command_tx_note_cache(ctx, stable_key, NULL)) return false;
     Eval_Cache_Value cv = {0};
     cv.data = sv_copy_to_event_arena(ctx, value);
     cv.type = sv_copy_to_event_arena(ctx, type);
@@ -473,28 +472,35 @@ static bool cache_upsert(EvalExecContext *ctx,
     if (eval_should_stop(ctx)) return false;
 
     Eval_Cache_Entry *entries = ctx->scope_state.cache_entries;
-    stbds_shput(entries, stable_key, cv);
+    EVAL_SYMBOL_MAP_PUT(entries, stable_key, cv);
     ctx->scope_state.cache_entries = entries;
     return true;
 }
 
 static bool visible_scope_has_normal_binding(EvalExecContext *ctx, String_View key) {
     if (eval_scope_visible_depth(ctx) == 0 || key.count == 0) return false;
+    char *symbol = eval_symbol_find(ctx, key);
+    if (!symbol) return false;
     for (size_t depth = eval_scope_visible_depth(ctx); depth-- > 0;) {
         Var_Scope *scope = &ctx->scope_state.scopes[depth];
         if (!scope->vars) continue;
-        if (stbds_shgetp_null(scope->vars, nob_temp_sv_to_cstr(key)) != NULL) return true;
+        if (EVAL_SYMBOL_MAP_GETP(scope->vars, symbol) != NULL) return true;
     }
     return false;
 }
 
 static bool unset_visible_normal_binding(EvalExecContext *ctx, String_View key) {
     if (eval_scope_visible_depth(ctx) == 0 || key.count == 0) return false;
+    char *symbol = eval_symbol_find(ctx, key);
+    if (!symbol) return true;
     for (size_t depth = eval_scope_visible_depth(ctx); depth-- > 0;) {
         Var_Scope *scope = &ctx->scope_state.scopes[depth];
         if (!scope->vars) continue;
-        if (stbds_shgetp_null(scope->vars, nob_temp_sv_to_cstr(key)) == NULL) continue;
-        (void)stbds_shdel(scope->vars, nob_temp_sv_to_cstr(key));
+        Eval_Var_Entry *entry = EVAL_SYMBOL_MAP_GETP(scope->vars, symbol);
+        if (!entry) continue;
+        if (!eval_command_tx_note_var(ctx, depth, entry->key, entry)) return false;
+        EVAL_SYMBOL_MAP_DEL(scope->vars, symbol);
+        eval_compat_note_var_write(ctx, key);
         return true;
     }
     return true;
@@ -700,6 +706,7 @@ static bool set_execute_cache_request(EvalExecContext *ctx,
         if (!cache_upsert(ctx, req->var, req->cache_value, req->cache_type, req->cache_doc)) return false;
         if (!eval_emit_var_set_cache(ctx, o, req->var, req->cache_value)) return false;
     } else if (existing->value.type.count == 0) {
+        if (!eval_command_tx_note_cache(ctx, existing->key, existing)) return false;
         if (!cache_promote_untyped_path_value_if_needed(ctx, existing, req->cache_type)) return false;
         existing->value.type = sv_copy_to_event_arena(ctx, req->cache_type);
         existing->value.doc = sv_copy_to_event_arena(ctx, req->cache_doc);
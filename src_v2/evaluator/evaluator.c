@@ -7,6 +7,7 @@
 #include "eval_meta.h"
 #include "eval_compat.h"
 #include "eval_diag_classify.h"
+#include "eval_regex_cache.h"
 #include "eval_report.h"
 #include "arena_dyn.h"
 #include "diagnostics.h"
@@ -559,6 +560,7 @@ bool eval_should_stop(EvalExecContext *ctx) {
 
 static bool eval_emit_event_direct(EvalExecContext *ctx, Event ev) {
     if (!ctx || !ctx->stream) return false;
+    if (!event_stream_wants(ctx->stream, ev.h.kind)) return true;
     if (ev.h.scope_depth == 0) {
         ev.h.scope_depth = (uint32_t)eval_scope_visible_depth(ctx);
     }
@@ -590,41 +592,17 @@ static bool eval_tx_snapshot_bytes(EvalExecContext *ctx,
     if (!ctx || !out_copy) return false;
     if (!src || count == 0 || elem_size == 0) return true;
 
-    void *copy = arena_alloc(eval_tx_arena(ctx), elem_size * count);
+    void *copy = arena_alloc(ctx->transaction_undo_arena, elem_size * count);
     EVAL_OOM_RETURN_IF_NULL(ctx, copy, false);
     memcpy(copy, src, elem_size * count);
+    eval_runtime_slice(ctx)->run_report.tx_snapshot_bytes += elem_size * count;
     *out_copy = copy;
     return true;
 }
 
-static bool eval_tx_snapshot_sv_array(EvalExecContext *ctx,
-                                      const String_View *src,
-                                      size_t count,
-                                      String_View **out_copy) {
-    return eval_tx_snapshot_bytes(ctx, src, sizeof(*src), count, (void**)out_copy);
-}
-
 static size_t eval_tx_hash_entry_count_var(Eval_Var_Entry *entries) {
     size_t count = 0;
-    ptrdiff_t n = stbds_shlen(entries);
-    for (ptrdiff_t i = 0; i < n; i++) {
-        if (entries[i].key) count++;
-    }
-    return count;
-}
-
-static size_t eval_tx_hash_entry_count_cache(Eval_Cache_Entry *entries) {
-    size_t count = 0;
-    ptrdiff_t n = stbds_shlen(entries);
-    for (ptrdiff_t i = 0; i < n; i++) {
-        if (entries[i].key) count++;
-    }
-    return count;
-}
-
-static size_t eval_tx_hash_entry_count_env(Eval_Process_Env_Entry *entries) {
-    size_t count = 0;
-    ptrdiff_t n = stbds_shlen(entries);
+    ptrdiff_t n = stbds_hmlen(entries);
     for (ptrdiff_t i = 0; i < n; i++) {
         if (entries[i].key) count++;
     }
@@ -642,57 +620,12 @@ static bool eval_tx_snapshot_var_table(EvalExecContext *ctx,
     out->count = eval_tx_hash_entry_count_var(entries);
     if (out->count == 0) return true;
 
-    out->entries = arena_alloc(eval_tx_arena(ctx), sizeof(*out->entries) * out->count);
-    EVAL_OOM_RETURN_IF_NULL(ctx, out->entries, false);
-
-    size_t at = 0;
-    ptrdiff_t n = stbds_shlen(entries);
-    for (ptrdiff_t i = 0; i < n; i++) {
-        if (!entries[i].key) continue;
-        out->entries[at++] = entries[i];
-    }
-    return true;
-}
-
-static bool eval_tx_snapshot_cache_table(EvalExecContext *ctx,
-                                         Eval_Cache_Entry *entries,
-                                         Eval_Cache_Table_Snapshot *out) {
-    if (!out) return false;
-    out->entries = NULL;
-    out->count = 0;
-    if (!ctx || !entries) return true;
-
-    out->count = eval_tx_hash_entry_count_cache(entries);
-    if (out->count == 0) return true;
-
-    out->entries = arena_alloc(eval_tx_arena(ctx), sizeof(*out->entries) * out->count);
-    EVAL_OOM_RETURN_IF_NULL(ctx, out->entries, false);
-
-    size_t at = 0;
-    ptrdiff_t n = stbds_shlen(entries);
-    for (ptrdiff_t i = 0; i < n; i++) {
-        if (!entries[i].key) continue;
-        out->entries[at++] = entries[i];
-    }
-    return true;
-}
-
-static bool eval_tx_snapshot_env_table(EvalExecContext *ctx,
-                                       Eval_Process_Env_Entry *entries,
-                                       Eval_Process_Env_Table_Snapshot *out) {
-    if (!out) return false;
-    out->entries = NULL;
-    out->count = 0;
-    if (!ctx || !entries) return true;
-
-    out->count = eval_tx_hash_entry_count_env(entries);
-    if (out->count == 0) return true;
-
-    out->entries = arena_alloc(eval_tx_arena(ctx), sizeof(*out->entries) * out->count);
+    out->entries = arena_alloc(ctx->transaction_undo_arena, sizeof(*out->entries) * out->count);
     EVAL_OOM_RETURN_IF_NULL(ctx, out->entries, false);
+    eval_runtime_slice(ctx)->run_report.tx_snapshot_bytes += sizeof(*out->entries) * out->count;
 
     size_t at = 0;
-    ptrdiff_t n = stbds_shlen(entries);
+    ptrdiff_t n = stbds_hmlen(entries);
     for (ptrdiff_t i = 0; i < n; i++) {
         if (!entries[i].key) continue;
         out->entries[at++] = entries[i];
@@ -704,106 +637,17 @@ static bool eval_tx_restore_var_table(Eval_Var_Entry **io_entries,
                                       const Eval_Var_Table_Snapshot *snapshot) {
     if (!io_entries || !snapshot) return false;
     if (*io_entries) {
-        stbds_shfree(*io_entries);
+        stbds_hmfree(*io_entries);
         *io_entries = NULL;
     }
     for (size_t i = 0; i < snapshot->count; i++) {
         Eval_Var_Entry *entries = *io_entries;
-        stbds_shput(entries, snapshot->entries[i].key, snapshot->entries[i].value);
+        EVAL_SYMBOL_MAP_PUT(entries, snapshot->entries[i].key, snapshot->entries[i].value);
         *io_entries = entries;
     }
     return true;
 }
 
-static bool eval_tx_restore_cache_table(Eval_Cache_Entry **io_entries,
-                                        const Eval_Cache_Table_Snapshot *snapshot) {
-    if (!io_entries || !snapshot) return false;
-    if (*io_entries) {
-        stbds_shfree(*io_entries);
-        *io_entries = NULL;
-    }
-    for (size_t i = 0; i < snapshot->count; i++) {
-        Eval_Cache_Entry *entries = *io_entries;
-        stbds_shput(entries, snapshot->entries[i].key, snapshot->entries[i].value);
-        *io_entries = entries;
-    }
-    return true;
-}
-
-static bool eval_tx_restore_env_table(Eval_Process_Env_Entry **io_entries,
-                                      const Eval_Process_Env_Table_Snapshot *snapshot) {
-    if (!io_entries || !snapshot) return false;
-    if (*io_entries) {
-        stbds_shfree(*io_entries);
-        *io_entries = NULL;
-    }
-    for (size_t i = 0; i < snapshot->count; i++) {
-        Eval_Process_Env_Entry *entries = *io_entries;
-        stbds_shput(entries, snapshot->entries[i].key, snapshot->entries[i].value);
-        *io_entries = entries;
-    }
-    return true;
-}
-
-static bool eval_tx_snapshot_directory_nodes(EvalExecContext *ctx,
-                                             Eval_Directory_Node *nodes,
-                                             size_t count,
-                                             Eval_Directory_Node_Snapshot **out_copy) {
-    if (out_copy) *out_copy = NULL;
-    if (!ctx || !out_copy) return false;
-    if (!nodes || count == 0) return true;
-
-    Eval_Directory_Node_Snapshot *copy = arena_alloc(eval_tx_arena(ctx), sizeof(*copy) * count);
-    EVAL_OOM_RETURN_IF_NULL(ctx, copy, false);
-    memset(copy, 0, sizeof(*copy) * count);
-
-    for (size_t i = 0; i < count; i++) {
-        copy[i].source_dir = nodes[i].source_dir;
-        copy[i].binary_dir = nodes[i].binary_dir;
-        copy[i].parent_source_dir = nodes[i].parent_source_dir;
-        copy[i].parent_binary_dir = nodes[i].parent_binary_dir;
-        copy[i].declared_target_count = arena_arr_len(nodes[i].declared_targets);
-        copy[i].declared_test_count = arena_arr_len(nodes[i].declared_tests);
-        copy[i].definition_binding_count = arena_arr_len(nodes[i].definition_bindings);
-        copy[i].macro_name_count = arena_arr_len(nodes[i].macro_names);
-        copy[i].listfile_stack_count = arena_arr_len(nodes[i].listfile_stack);
-        if (!eval_tx_snapshot_sv_array(ctx,
-                                       nodes[i].declared_targets,
-                                       copy[i].declared_target_count,
-                                       &copy[i].declared_targets)) {
-            return false;
-        }
-        if (!eval_tx_snapshot_sv_array(ctx,
-                                       nodes[i].declared_tests,
-                                       copy[i].declared_test_count,
-                                       &copy[i].declared_tests)) {
-            return false;
-        }
-        if (!eval_tx_snapshot_bytes(ctx,
-                                    nodes[i].definition_bindings,
-                                    sizeof(*nodes[i].definition_bindings),
-                                    copy[i].definition_binding_count,
-                                    (void**)&copy[i].definition_bindings)) {
-            return false;
-        }
-        if (!eval_tx_snapshot_sv_array(ctx,
-                                       nodes[i].macro_names,
-                                       copy[i].macro_name_count,
-                                       &copy[i].macro_names)) {
-            return false;
-        }
-        if (!eval_tx_snapshot_sv_array(ctx,
-                                       nodes[i].listfile_stack,
-                                       copy[i].listfile_stack_count,
-                                       &copy[i].listfile_stack)) {
-            return false;
-        }
-    }
-
-    *out_copy = copy;
-    return true;
-}
-
 static bool eval_tx_snapshot_deferred_dirs(EvalExecContext *ctx,
                                            Eval_Deferred_Dir_Frame *frames,
                                            size_t count,
@@ -812,9 +656,10 @@ static bool eval_tx_snapshot_deferred_dirs(EvalExecContext *ctx,
     if (!ctx || !out_copy) return false;
     if (!frames || count == 0) return true;
 
-    Eval_Deferred_Dir_Frame_Snapshot *copy = arena_alloc(eval_tx_arena(ctx), sizeof(*copy) * count);
+    Eval_Deferred_Dir_Frame_Snapshot *copy = arena_alloc(ctx->transaction_undo_arena, sizeof(*copy) * count);
     EVAL_OOM_RETURN_IF_NULL(ctx, copy, false);
     memset(copy, 0, sizeof(*copy) * count);
+    eval_runtime_slice(ctx)->run_report.tx_snapshot_bytes += sizeof(*copy) * count;
 
     for (size_t i = 0; i < count; i++) {
         copy[i].source_dir = frames[i].source_dir;
@@ -833,76 +678,17 @@ static bool eval_tx_snapshot_deferred_dirs(EvalExecContext *ctx,
     return true;
 }
 
-static bool eval_tx_restore_directory_nodes(EvalExecContext *ctx,
-                                            Eval_Directory_Node_List *io_nodes,
-                                            const Eval_Directory_Node_Snapshot *snapshot,
-                                            size_t count) {
-    if (!ctx || !io_nodes) return false;
-
-    arena_arr_set_len(*io_nodes, count);
-    if (count > 0 && !*io_nodes) return ctx_oom(ctx);
-
-    for (size_t i = 0; i < count; i++) {
-        Eval_Directory_Node *node = &(*io_nodes)[i];
-        memset(node, 0, sizeof(*node));
-
-        node->source_dir = snapshot[i].source_dir;
-        node->binary_dir = snapshot[i].binary_dir;
-        node->parent_source_dir = snapshot[i].parent_source_dir;
-        node->parent_binary_dir = snapshot[i].parent_binary_dir;
-        for (size_t j = 0; j < snapshot[i].declared_target_count; j++) {
-            if (!EVAL_ARR_PUSH(ctx,
-                               ctx->event_arena,
-                               node->declared_targets,
-                               snapshot[i].declared_targets[j])) {
-                return false;
-            }
-        }
-        for (size_t j = 0; j < snapshot[i].declared_test_count; j++) {
-            if (!EVAL_ARR_PUSH(ctx,
-                               ctx->event_arena,
-                               node->declared_tests,
-                               snapshot[i].declared_tests[j])) {
-                return false;
-            }
-        }
-        for (size_t j = 0; j < snapshot[i].definition_binding_count; j++) {
-            if (!EVAL_ARR_PUSH(ctx,
-                               ctx->event_arena,
-                               node->definition_bindings,
-                               snapshot[i].definition_bindings[j])) {
-                return false;
-            }
-        }
-        for (size_t j = 0; j < snapshot[i].macro_name_count; j++) {
-            if (!EVAL_ARR_PUSH(ctx,
-                               ctx->event_arena,
-                               node->macro_names,
-                               snapshot[i].macro_names[j])) {
-                return false;
-            }
-        }
-        for (size_t j = 0; j < snapshot[i].listfile_stack_count; j++) {
-            if (!EVAL_ARR_PUSH(ctx,
-                               ctx->event_arena,
-                               node->listfile_stack,
-                               snapshot[i].listfile_stack[j])) {
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
-
 static bool eval_tx_restore_deferred_dirs(EvalExecContext *ctx,
                                           Eval_Deferred_Dir_Frame_Stack *io_frames,
                                           const Eval_Deferred_Dir_Frame_Snapshot *snapshot,
                                           size_t count) {
     if (!ctx || !io_frames) return false;
 
+    if (count > arena_arr_cap(*io_frames) && !arena_arr_reserve(ctx->event_arena, *io_frames, count)) {
+        return ctx_oom(ctx);
+    }
+    if (!*io_frames) return true;
     arena_arr_set_len(*io_frames, count);
-    if (count > 0 && !*io_frames) return ctx_oom(ctx);
 
     for (size_t i = 0; i < count; i++) {
         Eval_Deferred_Dir_Frame *frame = &(*io_frames)[i];
@@ -920,6 +706,356 @@ static bool eval_tx_restore_deferred_dirs(EvalExecContext *ctx,
     return true;
 }
 
+// -----------------------------------------------------------------------------
+// Command transaction undo journal
+//
+// A transaction records only array lengths and a few scalars at begin. Every
+// mutation of state that predates the innermost active transaction appends an
+// undo entry first; rollback replays the entries newest-first and truncates
+// each slice back to its begin length. Committed child entries stay in the
+// journal so an enclosing rollback still sees them.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    void **items;
+    size_t elem_size;
+    Arena *arena;
+} Eval_Tx_Slice_Ref;
+
+static Eval_Tx_Slice_Ref eval_tx_slice_ref(EvalExecContext *ctx, Eval_Tx_Slice slice) {
+#define EVAL_TX_SLICE_REF(field, owner) \
+    ((Eval_Tx_Slice_Ref){ .items = (void**)&(field), .elem_size = sizeof(*(field)), .arena = (owner) })
+    switch (slice) {
+    case EVAL_TX_SLICE_MESSAGE_CHECK:
+        return EVAL_TX_SLICE_REF(ctx->message_check_stack, ctx->event_arena);
+    case EVAL_TX_SLICE_DIRECTORY_NODES:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.directories.nodes, ctx->event_arena);
+    case EVAL_TX_SLICE_PROPERTY_RECORDS:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.properties.records, ctx->event_arena);
+    case EVAL_TX_SLICE_TARGET_RECORDS:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.targets.records, ctx->semantic_state.targets.arena);
+    case EVAL_TX_SLICE_TARGET_ALIASES:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.targets.aliases, ctx->semantic_state.targets.arena);
+    case EVAL_TX_SLICE_TEST_RECORDS:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.tests.records, ctx->semantic_state.tests.arena);
+    case EVAL_TX_SLICE_INSTALL_COMPONENTS:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.install.components, ctx->event_arena);
+    case EVAL_TX_SLICE_EXPORTS:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.export_state.exports, ctx->event_arena);
+    case EVAL_TX_SLICE_ACTIVE_FIND_PACKAGES:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.package.active_find_packages, ctx->event_arena);
+    case EVAL_TX_SLICE_FOUND_PACKAGES:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.package.found_packages, ctx->event_arena);
+    case EVAL_TX_SLICE_NOT_FOUND_PACKAGES:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.package.not_found_packages, ctx->event_arena);
+    case EVAL_TX_SLICE_PACKAGE_REGISTRY:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.package.registry_entries, ctx->event_arena);
+    case EVAL_TX_SLICE_FILE_API_QUERIES:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.file_api.queries, ctx->event_arena);
+    case EVAL_TX_SLICE_FETCHCONTENT_DECLARATIONS:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.fetchcontent.declarations, ctx->event_arena);
+    case EVAL_TX_SLICE_FETCHCONTENT_STATES:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.fetchcontent.states, ctx->event_arena);
+    case EVAL_TX_SLICE_ACTIVE_MAKEAVAILABLE:
+        return EVAL_TX_SLICE_REF(ctx->semantic_state.fetchcontent.active_makeavailable, ctx->event_arena);
+    case EVAL_TX_SLICE_USER_COMMANDS:
+        return EVAL_TX_SLICE_REF(ctx->command_state.user_commands, ctx->command_state.user_commands_arena);
+    case EVAL_TX_SLICE_WATCHED_VARIABLES:
+        return EVAL_TX_SLICE_REF(ctx->command_state.watched_variables, ctx->command_state.user_commands_arena);
+    case EVAL_TX_SLICE_WATCHED_VARIABLE_COMMANDS:
+        return EVAL_TX_SLICE_REF(ctx->command_state.watched_variable_commands,
+                                 ctx->command_state.user_commands_arena);
+    case EVAL_TX_SLICE_PROPERTY_DEFINITIONS:
+        return EVAL_TX_SLICE_REF(ctx->property_definitions, ctx->event_arena);
+    case EVAL_TX_SLICE_FILE_GENERATE_JOBS:
+        return EVAL_TX_SLICE_REF(ctx->file_state.file_generate_jobs, ctx->event_arena);
+    case EVAL_TX_SLICE_DEFERRED_DIRS:
+        return EVAL_TX_SLICE_REF(ctx->file_state.deferred_dirs, ctx->event_arena);
+    case EVAL_TX_SLICE_GENERATED_DEFERRED_IDS:
+        return EVAL_TX_SLICE_REF(ctx->file_state.generated_deferred_ids, ctx->event_arena);
+    case EVAL_TX_SLICE_CUSTOM_COMMAND_OUTPUT_STEPS:
+        return EVAL_TX_SLICE_REF(ctx->file_state.custom_command_output_steps, ctx->event_arena);
+    case EVAL_TX_SLICE_CANONICAL_ARTIFACTS:
+        return EVAL_TX_SLICE_REF(ctx->canonical_state.artifacts, ctx->event_arena);
+    case EVAL_TX_SLICE_CTEST_STEPS:
+        return EVAL_TX_SLICE_REF(ctx->canonical_state.ctest_steps, ctx->event_arena);
+    case EVAL_TX_SLICE_COUNT:
+        break;
+    }
+    return (Eval_Tx_Slice_Ref){0};
+#undef EVAL_TX_SLICE_REF
+}
+
+static bool eval_tx_undo_push(EvalExecContext *ctx, const Eval_Tx_Undo_Entry *entry) {
+    if (!EVAL_ARR_PUSH(ctx, ctx->transaction_undo_arena, ctx->tx_undo_log, *entry)) return false;
+    eval_runtime_slice(ctx)->run_report.tx_undo_entries++;
+    return true;
+}
+
+// Elements appended after the innermost tx began are dropped by truncation,
+// and a slice already copied whole by this tx needs no finer-grained entries.
+static bool eval_tx_elem_needs_undo(const Eval_Command_Transaction *tx, Eval_Tx_Slice slice, size_t index) {
+    if (!tx || slice >= EVAL_TX_SLICE_COUNT) return false;
+    if (tx->journaled_slices & (UINT32_C(1) << slice)) return false;
+    return index < tx->slice_counts[slice];
+}
+
+bool eval_command_tx_note_var(EvalExecContext *ctx, size_t depth, char *key, const Eval_Var_Entry *existing) {
+    if (!ctx || !ctx->active_transaction || !key) return true;
+    // Scopes pushed inside the transaction are discarded wholesale on rollback.
+    if (depth >= ctx->active_transaction->visible_scope_depth) return true;
+    Eval_Tx_Undo_Entry entry = {
+        .kind = EVAL_TX_UNDO_VAR,
+        .had_old = existing != NULL,
+        .index = depth,
+        .key = key,
+    };
+    if (existing) entry.as.var_value = existing->value;
+    return eval_tx_undo_push(ctx, &entry);
+}
+
+bool eval_command_tx_note_cache(EvalExecContext *ctx, char *key, const Eval_Cache_Entry *existing) {
+    if (!ctx || !ctx->active_transaction || !key) return true;
+    Eval_Tx_Undo_Entry entry = {
+        .kind = EVAL_TX_UNDO_CACHE,
+        .had_old = existing != NULL,
+        .key = key,
+    };
+    if (existing) entry.as.cache_value = existing->value;
+    return eval_tx_undo_push(ctx, &entry);
+}
+
+bool eval_command_tx_note_env(EvalExecContext *ctx, char *key, const Eval_Process_Env_Entry *existing) {
+    if (!ctx || !ctx->active_transaction || !key) return true;
+    Eval_Tx_Undo_Entry entry = {
+        .kind = EVAL_TX_UNDO_ENV,
+        .had_old = existing != NULL,
+        .key = key,
+    };
+    if (existing) entry.as.env_value = existing->value;
+    return eval_tx_undo_push(ctx, &entry);
+}
+
+bool eval_command_tx_note_elem(EvalExecContext *ctx, Eval_Tx_Slice slice, size_t index) {
+    if (!ctx || !eval_tx_elem_needs_undo(ctx->active_transaction, slice, index)) return true;
+    Eval_Tx_Slice_Ref ref = eval_tx_slice_ref(ctx, slice);
+    if (!ref.items || index >= arena_arr_len(*ref.items)) return true;
+
+    Eval_Tx_Undo_Entry entry = {
+        .kind = EVAL_TX_UNDO_ELEM,
+        .slice = slice,
+        .index = index,
+    };
+    if (!eval_tx_snapshot_bytes(ctx,
+                                (const unsigned char*)*ref.items + (index * ref.elem_size),
+                                ref.elem_size,
+                                1,
+                                &entry.as.bytes.items)) {
+        return false;
+    }
+    entry.as.bytes.count = 1;
+    return eval_tx_undo_push(ctx, &entry);
+}
+
+bool eval_command_tx_note_nested(EvalExecContext *ctx, Eval_Tx_Slice slice, size_t index, size_t field_offset) {
+    if (!ctx || !eval_tx_elem_needs_undo(ctx->active_transaction, slice, index)) return true;
+    Eval_Tx_Slice_Ref ref = eval_tx_slice_ref(ctx, slice);
+    if (!ref.items || index >= arena_arr_len(*ref.items)) return true;
+
+    void **field = (void**)((unsigned char*)*ref.items + (index * ref.elem_size) + field_offset);
+    Eval_Tx_Undo_Entry entry = {
+        .kind = EVAL_TX_UNDO_NESTED,
+        .slice = slice,
+        .index = index,
+        .field_offset = field_offset,
+    };
+    entry.as.bytes.items = *field;
+    entry.as.bytes.count = arena_arr_len(*field);
+    return eval_tx_undo_push(ctx, &entry);
+}
+
+bool eval_command_tx_note_slice(EvalExecContext *ctx, Eval_Tx_Slice slice, size_t first_index) {
+    if (!ctx || !eval_tx_elem_needs_undo(ctx->active_transaction, slice, first_index)) return true;
+    Eval_Tx_Slice_Ref ref = eval_tx_slice_ref(ctx, slice);
+    if (!ref.items) return true;
+
+    Eval_Tx_Undo_Entry entry = {
+        .kind = EVAL_TX_UNDO_SLICE,
+        .slice = slice,
+    };
+    size_t count = arena_arr_len(*ref.items);
+    if (slice == EVAL_TX_SLICE_DEFERRED_DIRS) {
+        entry.as.deferred_dirs.count = count;
+        if (!eval_tx_snapshot_deferred_dirs(ctx,
+                                            ctx->file_state.deferred_dirs,
+                                            count,
+                                            &entry.as.deferred_dirs.frames)) {
+            return false;
+        }
+    } else {
+        entry.as.bytes.count = count;
+        if (!eval_tx_snapshot_bytes(ctx, *ref.items, ref.elem_size, count, &entry.as.bytes.items)) return false;
+    }
+    if (!eval_tx_undo_push(ctx, &entry)) return false;
+    ctx->active_transaction->journaled_slices |= (UINT32_C(1) << slice);
+    return true;
+}
+
+static bool eval_command_tx_note_scope_table(EvalExecContext *ctx, size_t depth) {
+    if (!ctx || !ctx->active_transaction) return true;
+    if (depth >= ctx->active_transaction->visible_scope_depth) return true;
+    if (depth >= arena_arr_len(ctx->scope_state.scopes)) return true;
+
+    Eval_Tx_Undo_Entry entry = {
+        .kind = EVAL_TX_UNDO_SCOPE_TABLE,
+        .index = depth,
+    };
+    if (!eval_tx_snapshot_var_table(ctx, ctx->scope_state.scopes[depth].vars, &entry.as.scope_table)) return false;
+    return eval_tx_undo_push(ctx, &entry);
+}
+
+static bool eval_tx_undo_apply(EvalExecContext *ctx, const Eval_Tx_Undo_Entry *entry) {
+    switch (entry->kind) {
+    case EVAL_TX_UNDO_VAR: {
+        if (entry->index >= arena_arr_len(ctx->scope_state.scopes)) return true;
+        Var_Scope *scope = &ctx->scope_state.scopes[entry->index];
+        Eval_Var_Entry *vars = scope->vars;
+        if (entry->had_old) {
+            EVAL_SYMBOL_MAP_PUT(vars, entry->key, entry->as.var_value);
+        } else if (vars) {
+            EVAL_SYMBOL_MAP_DEL(vars, entry->key);
+        }
+        scope->vars = vars;
+        return true;
+    }
+    case EVAL_TX_UNDO_SCOPE_TABLE:
+        if (entry->index >= arena_arr_len(ctx->scope_state.scopes)) return true;
+        return eval_tx_restore_var_table(&ctx->scope_state.scopes[entry->index].vars, &entry->as.scope_table);
+    case EVAL_TX_UNDO_CACHE: {
+        Eval_Cache_Entry *entries = ctx->scope_state.cache_entries;
+        if (entry->had_old) {
+            EVAL_SYMBOL_MAP_PUT(entries, entry->key, entry->as.cache_value);
+        } else if (entries) {
+            EVAL_SYMBOL_MAP_DEL(entries, entry->key);
+        }
+        ctx->scope_state.cache_entries = entries;
+        return true;
+    }
+    case EVAL_TX_UNDO_ENV: {
+        Eval_Process_Env_Table entries = ctx->process_state.env_overrides;
+        if (entry->had_old) {
+            stbds_shput(entries, entry->key, entry->as.env_value);
+        } else if (entries) {
+            (void)stbds_shdel(entries, entry->key);
+        }
+        ctx->process_state.env_overrides = entries;
+        return true;
+    }
+    case EVAL_TX_UNDO_ELEM: {
+        Eval_Tx_Slice_Ref ref = eval_tx_slice_ref(ctx, entry->slice);
+        if (!ref.items || entry->index >= arena_arr_len(*ref.items)) return true;
+        memcpy((unsigned char*)*ref.items + (entry->index * ref.elem_size), entry->as.bytes.items, ref.elem_size);
+        return true;
+    }
+    case EVAL_TX_UNDO_NESTED: {
+        Eval_Tx_Slice_Ref ref = eval_tx_slice_ref(ctx, entry->slice);
+        if (!ref.items || entry->index >= arena_arr_len(*ref.items)) return true;
+        void **field = (void**)((unsigned char*)*ref.items + (entry->index * ref.elem_size) + entry->field_offset);
+        *field = entry->as.bytes.items;
+        if (*field) arena_arr_set_len(*field, entry->as.bytes.count);
+        return true;
+    }
+    case EVAL_TX_UNDO_SLICE: {
+        if (entry->slice == EVAL_TX_SLICE_DEFERRED_DIRS) {
+            return eval_tx_restore_deferred_dirs(ctx,
+                                                 &ctx->file_state.deferred_dirs,
+                                                 entry->as.deferred_dirs.frames,
+                                                 entry->as.deferred_dirs.count);
+        }
+        Eval_Tx_Slice_Ref ref = eval_tx_slice_ref(ctx, entry->slice);
+        if (!ref.items) return true;
+        size_t count = entry->as.bytes.count;
+        if (count > arena_arr_cap(*ref.items) &&
+            !arena_arr__grow(ref.arena, ref.items, ref.elem_size, count)) {
+            return ctx_oom(ctx);
+        }
+        if (!*ref.items) return true;
+        arena_arr_set_len(*ref.items, count);
+        if (count > 0) memcpy(*ref.items, entry->as.bytes.items, ref.elem_size * count);
+        if (entry->slice == EVAL_TX_SLICE_USER_COMMANDS) eval_user_cmd_note_changed(ctx);
+        return true;
+    }
+    }
+    return true;
+}
+
+static bool eval_tx_undo_is_scope_var(const Eval_Tx_Undo_Entry *entry) {
+    return entry->kind == EVAL_TX_UNDO_VAR || entry->kind == EVAL_TX_UNDO_SCOPE_TABLE;
+}
+
+static bool eval_tx_rollback(EvalExecContext *ctx, Eval_Command_Transaction *tx) {
+    bool ok = true;
+    for (size_t i = arena_arr_len(ctx->tx_undo_log); i-- > tx->undo_start;) {
+        const Eval_Tx_Undo_Entry *entry = &ctx->tx_undo_log[i];
+        if (tx->preserve_scope_vars_on_failure && eval_tx_undo_is_scope_var(entry)) continue;
+        ok = eval_tx_undo_apply(ctx, entry) && ok;
+    }
+
+    if (arena_arr_len(ctx->scope_state.scopes) > tx->scope_count) {
+        arena_arr_set_len(ctx->scope_state.scopes, tx->scope_count);
+    }
+    ctx->scope_state.visible_scope_depth = tx->visible_scope_depth;
+    ctx->runtime_state.compat_dirty = true;
+
+    // User commands, properties and targets unwind through their indexes
+    // before the generic truncation below sees the slices.
+    eval_user_cmd_truncate(ctx, tx->slice_counts[EVAL_TX_SLICE_USER_COMMANDS]);
+    eval_property_engine_truncate(ctx,
+                                  tx->slice_counts[EVAL_TX_SLICE_PROPERTY_RECORDS],
+                                  tx->slice_counts[EVAL_TX_SLICE_PROPERTY_DEFINITIONS]);
+    eval_target_truncate(ctx,
+                         tx->slice_counts[EVAL_TX_SLICE_TARGET_RECORDS],
+                         tx->slice_counts[EVAL_TX_SLICE_TARGET_ALIASES]);
+    for (size_t i = 0; i < EVAL_TX_SLICE_COUNT; i++) {
+        Eval_Tx_Slice_Ref ref = eval_tx_slice_ref(ctx, (Eval_Tx_Slice)i);
+        if (ref.items && arena_arr_len(*ref.items) > tx->slice_counts[i]) {
+            arena_arr_set_len(*ref.items, tx->slice_counts[i]);
+        }
+    }
+
+    ctx->semantic_state.package.dependency_provider = tx->dependency_provider;
+    ctx->semantic_state.file_api.next_reply_nonce = tx->file_api_next_reply_nonce;
+    ctx->file_state.next_deferred_call_id = tx->next_deferred_call_id;
+    ctx->cpack_module_loaded = tx->cpack_module_loaded;
+    ctx->cpack_component_module_loaded = tx->cpack_component_module_loaded;
+    ctx->fetchcontent_module_loaded = tx->fetchcontent_module_loaded;
+    return ok;
+}
+
+static void eval_tx_release_undo(EvalExecContext *ctx, Eval_Command_Transaction *tx, bool committed) {
+    if (!tx->parent) {
+        ctx->tx_undo_log = NULL;
+        arena_reset(ctx->transaction_undo_arena);
+        return;
+    }
+
+    if (committed) {
+        tx->parent->journaled_slices |= tx->journaled_slices;
+        return;
+    }
+
+    // Variable writes survive a preserve-vars rollback, so the enclosing
+    // transaction still needs their undo entries.
+    size_t kept = tx->undo_start;
+    if (tx->preserve_scope_vars_on_failure) {
+        for (size_t i = tx->undo_start; i < arena_arr_len(ctx->tx_undo_log); i++) {
+            if (!eval_tx_undo_is_scope_var(&ctx->tx_undo_log[i])) continue;
+            ctx->tx_undo_log[kept++] = ctx->tx_undo_log[i];
+        }
+    }
+    if (ctx->tx_undo_log) arena_arr_set_len(ctx->tx_undo_log, kept);
+}
+
 static bool eval_tx_projection_append(EvalExecContext *ctx, const Eval_Tx_Projection *projection) {
     if (!ctx || !projection) return false;
     Eval_Command_Transaction *tx = ctx->active_transaction;
@@ -992,6 +1128,8 @@ bool eval_command_tx_push_event(EvalExecContext *ctx, const Event *ev, bool allo
     if (!ctx || !ev) return false;
     if (!allow_stopped && eval_should_stop(ctx)) return false;
     if (allow_stopped && (ctx->oom || !ctx->stream)) return false;
+    // Unsubscribed events are dropped before they are buffered.
+    if (!event_stream_wants(ctx->stream, ev->h.kind)) return true;
 
     Event buffered = *ev;
     buffered.h.scope_depth = (uint32_t)eval_scope_visible_depth(ctx);
@@ -1064,228 +1202,25 @@ bool eval_command_tx_push_diag(EvalExecContext *ctx,
 }
 
 bool eval_command_tx_begin(EvalExecContext *ctx, Eval_Command_Transaction *tx) {
-    if (!ctx || !tx || !eval_tx_arena(ctx)) return false;
+    if (!ctx || !tx || !eval_tx_arena(ctx) || !ctx->transaction_undo_arena) return false;
     memset(tx, 0, sizeof(*tx));
     tx->parent = ctx->active_transaction;
     tx->mark = arena_mark(eval_tx_arena(ctx));
     tx->active = true;
-    tx->scope_var_count = arena_arr_len(ctx->scope_state.scopes);
+    tx->undo_start = arena_arr_len(ctx->tx_undo_log);
+    tx->scope_count = arena_arr_len(ctx->scope_state.scopes);
     tx->visible_scope_depth = ctx->scope_state.visible_scope_depth;
+    for (size_t i = 0; i < EVAL_TX_SLICE_COUNT; i++) {
+        Eval_Tx_Slice_Ref ref = eval_tx_slice_ref(ctx, (Eval_Tx_Slice)i);
+        tx->slice_counts[i] = ref.items ? arena_arr_len(*ref.items) : 0;
+    }
     tx->dependency_provider = ctx->semantic_state.package.dependency_provider;
+    tx->file_api_next_reply_nonce = ctx->semantic_state.file_api.next_reply_nonce;
     tx->next_deferred_call_id = ctx->file_state.next_deferred_call_id;
     tx->cpack_module_loaded = ctx->cpack_module_loaded;
     tx->cpack_component_module_loaded = ctx->cpack_component_module_loaded;
     tx->fetchcontent_module_loaded = ctx->fetchcontent_module_loaded;
 
-    if (tx->scope_var_count > 0) {
-        tx->scope_vars = arena_alloc(eval_tx_arena(ctx), sizeof(*tx->scope_vars) * tx->scope_var_count);
-        EVAL_OOM_RETURN_IF_NULL(ctx, tx->scope_vars, false);
-        memset(tx->scope_vars, 0, sizeof(*tx->scope_vars) * tx->scope_var_count);
-        for (size_t i = 0; i < tx->scope_var_count; i++) {
-            if (!eval_tx_snapshot_var_table(ctx, ctx->scope_state.scopes[i].vars, &tx->scope_vars[i])) return false;
-        }
-    }
-
-    if (!eval_tx_snapshot_cache_table(ctx, ctx->scope_state.cache_entries, &tx->cache_entries)) return false;
-    if (!eval_tx_snapshot_env_table(ctx, ctx->process_state.env_overrides, &tx->env_overrides)) return false;
-
-    tx->message_check_count = arena_arr_len(ctx->message_check_stack);
-    if (!eval_tx_snapshot_sv_array(ctx, ctx->message_check_stack, tx->message_check_count, &tx->message_check_stack)) return false;
-
-    tx->directory_node_count = arena_arr_len(ctx->semantic_state.directories.nodes);
-    if (!eval_tx_snapshot_directory_nodes(ctx,
-                                          ctx->semantic_state.directories.nodes,
-                                          tx->directory_node_count,
-                                          &tx->directory_nodes)) {
-        return false;
-    }
-
-    tx->property_record_count = arena_arr_len(ctx->semantic_state.properties.records);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->semantic_state.properties.records,
-                                sizeof(*ctx->semantic_state.properties.records),
-                                tx->property_record_count,
-                                (void**)&tx->property_records)) {
-        return false;
-    }
-
-    tx->target_record_count = arena_arr_len(ctx->semantic_state.targets.records);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->semantic_state.targets.records,
-                                sizeof(*ctx->semantic_state.targets.records),
-                                tx->target_record_count,
-                                (void**)&tx->target_records)) {
-        return false;
-    }
-    tx->target_alias_count = arena_arr_len(ctx->semantic_state.targets.aliases);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->semantic_state.targets.aliases,
-                                   tx->target_alias_count,
-                                   &tx->target_aliases)) {
-        return false;
-    }
-    tx->test_record_count = arena_arr_len(ctx->semantic_state.tests.records);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->semantic_state.tests.records,
-                                sizeof(*ctx->semantic_state.tests.records),
-                                tx->test_record_count,
-                                (void**)&tx->test_records)) {
-        return false;
-    }
-    tx->install_component_count = arena_arr_len(ctx->semantic_state.install.components);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->semantic_state.install.components,
-                                   tx->install_component_count,
-                                   &tx->install_components)) {
-        return false;
-    }
-    tx->export_count = arena_arr_len(ctx->semantic_state.export_state.exports);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->semantic_state.export_state.exports,
-                                   tx->export_count,
-                                   &tx->export_entries)) {
-        return false;
-    }
-    tx->active_find_package_count = arena_arr_len(ctx->semantic_state.package.active_find_packages);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->semantic_state.package.active_find_packages,
-                                   tx->active_find_package_count,
-                                   &tx->active_find_packages)) {
-        return false;
-    }
-    tx->found_package_count = arena_arr_len(ctx->semantic_state.package.found_packages);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->semantic_state.package.found_packages,
-                                   tx->found_package_count,
-                                   &tx->found_packages)) {
-        return false;
-    }
-    tx->not_found_package_count = arena_arr_len(ctx->semantic_state.package.not_found_packages);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->semantic_state.package.not_found_packages,
-                                   tx->not_found_package_count,
-                                   &tx->not_found_packages)) {
-        return false;
-    }
-    tx->package_registry_entry_count = arena_arr_len(ctx->semantic_state.package.registry_entries);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->semantic_state.package.registry_entries,
-                                sizeof(*ctx->semantic_state.package.registry_entries),
-                                tx->package_registry_entry_count,
-                                (void**)&tx->package_registry_entries)) {
-        return false;
-    }
-    tx->file_api_next_reply_nonce = ctx->semantic_state.file_api.next_reply_nonce;
-    tx->file_api_query_count = arena_arr_len(ctx->semantic_state.file_api.queries);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->semantic_state.file_api.queries,
-                                sizeof(*ctx->semantic_state.file_api.queries),
-                                tx->file_api_query_count,
-                                (void**)&tx->file_api_queries)) {
-        return false;
-    }
-    tx->fetchcontent_declaration_count = arena_arr_len(ctx->semantic_state.fetchcontent.declarations);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->semantic_state.fetchcontent.declarations,
-                                sizeof(*ctx->semantic_state.fetchcontent.declarations),
-                                tx->fetchcontent_declaration_count,
-                                (void**)&tx->fetchcontent_declarations)) {
-        return false;
-    }
-    tx->fetchcontent_state_count = arena_arr_len(ctx->semantic_state.fetchcontent.states);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->semantic_state.fetchcontent.states,
-                                sizeof(*ctx->semantic_state.fetchcontent.states),
-                                tx->fetchcontent_state_count,
-                                (void**)&tx->fetchcontent_states)) {
-        return false;
-    }
-    tx->active_makeavailable_count = arena_arr_len(ctx->semantic_state.fetchcontent.active_makeavailable);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->semantic_state.fetchcontent.active_makeavailable,
-                                   tx->active_makeavailable_count,
-                                   &tx->active_makeavailable)) {
-        return false;
-    }
-
-    tx->user_command_count = arena_arr_len(ctx->command_state.user_commands);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->command_state.user_commands,
-                                sizeof(*ctx->command_state.user_commands),
-                                tx->user_command_count,
-                                (void**)&tx->user_commands)) {
-        return false;
-    }
-    tx->watched_variable_count = arena_arr_len(ctx->command_state.watched_variables);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->command_state.watched_variables,
-                                   tx->watched_variable_count,
-                                   &tx->watched_variables)) {
-        return false;
-    }
-    tx->watched_variable_command_count = arena_arr_len(ctx->command_state.watched_variable_commands);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->command_state.watched_variable_commands,
-                                   tx->watched_variable_command_count,
-                                   &tx->watched_variable_commands)) {
-        return false;
-    }
-    tx->property_definition_count = arena_arr_len(ctx->property_definitions);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->property_definitions,
-                                sizeof(*ctx->property_definitions),
-                                tx->property_definition_count,
-                                (void**)&tx->property_definitions)) {
-        return false;
-    }
-
-    tx->file_generate_job_count = arena_arr_len(ctx->file_state.file_generate_jobs);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->file_state.file_generate_jobs,
-                                sizeof(*ctx->file_state.file_generate_jobs),
-                                tx->file_generate_job_count,
-                                (void**)&tx->file_generate_jobs)) {
-        return false;
-    }
-    tx->deferred_dir_count = arena_arr_len(ctx->file_state.deferred_dirs);
-    if (!eval_tx_snapshot_deferred_dirs(ctx,
-                                        ctx->file_state.deferred_dirs,
-                                        tx->deferred_dir_count,
-                                        &tx->deferred_dirs)) {
-        return false;
-    }
-    tx->generated_deferred_id_count = arena_arr_len(ctx->file_state.generated_deferred_ids);
-    if (!eval_tx_snapshot_sv_array(ctx,
-                                   ctx->file_state.generated_deferred_ids,
-                                   tx->generated_deferred_id_count,
-                                   &tx->generated_deferred_ids)) {
-        return false;
-    }
-    tx->custom_command_output_step_count = arena_arr_len(ctx->file_state.custom_command_output_steps);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->file_state.custom_command_output_steps,
-                                sizeof(*ctx->file_state.custom_command_output_steps),
-                                tx->custom_command_output_step_count,
-                                (void**)&tx->custom_command_output_steps)) {
-        return false;
-    }
-    tx->canonical_artifact_count = arena_arr_len(ctx->canonical_state.artifacts);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->canonical_state.artifacts,
-                                sizeof(*ctx->canonical_state.artifacts),
-                                tx->canonical_artifact_count,
-                                (void**)&tx->canonical_artifacts)) {
-        return false;
-    }
-    tx->ctest_step_count = arena_arr_len(ctx->canonical_state.ctest_steps);
-    if (!eval_tx_snapshot_bytes(ctx,
-                                ctx->canonical_state.ctest_steps,
-                                sizeof(*ctx->canonical_state.ctest_steps),
-                                tx->ctest_step_count,
-                                (void**)&tx->ctest_steps)) {
-        return false;
-    }
-
     ctx->active_transaction = tx;
     return true;
 }
@@ -1298,158 +1233,12 @@ void eval_command_tx_preserve_scope_vars_on_failure(EvalExecContext *ctx) {
 bool eval_command_tx_finish(EvalExecContext *ctx, Eval_Command_Transaction *tx, bool commit_state) {
     if (!ctx || !tx || ctx->active_transaction != tx) return false;
 
-#define EVAL_TX_RESTORE_ARRAY(arena_expr, dst, snap_items, snap_count)                                \
-    do {                                                                                               \
-        if ((dst) || (snap_count) > 0) {                                                               \
-            arena_arr_set_len((dst), (snap_count));                                                    \
-            if ((snap_count) > 0) memcpy((dst), (snap_items), sizeof(*(dst)) * (snap_count));         \
-        }                                                                                              \
-    } while (0)
-
-    if (!commit_state) {
-        if (arena_arr_len(ctx->scope_state.scopes) > tx->scope_var_count) {
-            arena_arr_set_len(ctx->scope_state.scopes, tx->scope_var_count);
-        }
-        ctx->scope_state.visible_scope_depth = tx->visible_scope_depth;
-        if (!tx->preserve_scope_vars_on_failure) {
-            for (size_t i = 0; i < tx->scope_var_count; i++) {
-                if (!eval_tx_restore_var_table(&ctx->scope_state.scopes[i].vars, &tx->scope_vars[i])) {
-                    ctx->active_transaction = tx->parent;
-                    arena_rewind(eval_tx_arena(ctx), tx->mark);
-                    return false;
-                }
-            }
-        }
-        if (!eval_tx_restore_cache_table(&ctx->scope_state.cache_entries, &tx->cache_entries)) {
-            ctx->active_transaction = tx->parent;
-            arena_rewind(eval_tx_arena(ctx), tx->mark);
-            return false;
-        }
-        if (!eval_tx_restore_env_table(&ctx->process_state.env_overrides, &tx->env_overrides)) {
-            ctx->active_transaction = tx->parent;
-            arena_rewind(eval_tx_arena(ctx), tx->mark);
-            return false;
-        }
-
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena, ctx->message_check_stack, tx->message_check_stack, tx->message_check_count);
-
-        if (!eval_tx_restore_directory_nodes(ctx,
-                                             &ctx->semantic_state.directories.nodes,
-                                             tx->directory_nodes,
-                                             tx->directory_node_count)) {
-            ctx->active_transaction = tx->parent;
-            arena_rewind(eval_tx_arena(ctx), tx->mark);
-            return false;
-        }
-
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.properties.records,
-                              tx->property_records,
-                              tx->property_record_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->semantic_state.targets.arena,
-                              ctx->semantic_state.targets.records,
-                              tx->target_records,
-                              tx->target_record_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->semantic_state.targets.arena,
-                              ctx->semantic_state.targets.aliases,
-                              tx->target_aliases,
-                              tx->target_alias_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->semantic_state.tests.arena,
-                              ctx->semantic_state.tests.records,
-                              tx->test_records,
-                              tx->test_record_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.install.components,
-                              tx->install_components,
-                              tx->install_component_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.export_state.exports,
-                              tx->export_entries,
-                              tx->export_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.package.active_find_packages,
-                              tx->active_find_packages,
-                              tx->active_find_package_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.package.found_packages,
-                              tx->found_packages,
-                              tx->found_package_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.package.not_found_packages,
-                              tx->not_found_packages,
-                              tx->not_found_package_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.package.registry_entries,
-                              tx->package_registry_entries,
-                              tx->package_registry_entry_count);
-        ctx->semantic_state.package.dependency_provider = tx->dependency_provider;
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.file_api.queries,
-                              tx->file_api_queries,
-                              tx->file_api_query_count);
-        ctx->semantic_state.file_api.next_reply_nonce = tx->file_api_next_reply_nonce;
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.fetchcontent.declarations,
-                              tx->fetchcontent_declarations,
-                              tx->fetchcontent_declaration_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.fetchcontent.states,
-                              tx->fetchcontent_states,
-                              tx->fetchcontent_state_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->semantic_state.fetchcontent.active_makeavailable,
-                              tx->active_makeavailable,
-                              tx->active_makeavailable_count);
-
-        EVAL_TX_RESTORE_ARRAY(ctx->command_state.user_commands_arena,
-                              ctx->command_state.user_commands,
-                              tx->user_commands,
-                              tx->user_command_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->command_state.user_commands_arena,
-                              ctx->command_state.watched_variables,
-                              tx->watched_variables,
-                              tx->watched_variable_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->command_state.user_commands_arena,
-                              ctx->command_state.watched_variable_commands,
-                              tx->watched_variable_commands,
-                              tx->watched_variable_command_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->property_definitions,
-                              tx->property_definitions,
-                              tx->property_definition_count);
-
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->file_state.file_generate_jobs,
-                              tx->file_generate_jobs,
-                              tx->file_generate_job_count);
-        if (!eval_tx_restore_deferred_dirs(ctx,
-                                           &ctx->file_state.deferred_dirs,
-                                           tx->deferred_dirs,
-                                           tx->deferred_dir_count)) {
-            ctx->active_transaction = tx->parent;
-            arena_rewind(eval_tx_arena(ctx), tx->mark);
-            return false;
-        }
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->file_state.generated_deferred_ids,
-                              tx->generated_deferred_ids,
-                              tx->generated_deferred_id_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->file_state.custom_command_output_steps,
-                              tx->custom_command_output_steps,
-                              tx->custom_command_output_step_count);
-        ctx->file_state.next_deferred_call_id = tx->next_deferred_call_id;
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->canonical_state.artifacts,
-                              tx->canonical_artifacts,
-                              tx->canonical_artifact_count);
-        EVAL_TX_RESTORE_ARRAY(ctx->event_arena,
-                              ctx->canonical_state.ctest_steps,
-                              tx->ctest_steps,
-                              tx->ctest_step_count);
-        ctx->cpack_module_loaded = tx->cpack_module_loaded;
-        ctx->cpack_component_module_loaded = tx->cpack_component_module_loaded;
-        ctx->fetchcontent_module_loaded = tx->fetchcontent_module_loaded;
+    bool restore_ok = commit_state || eval_tx_rollback(ctx, tx);
+    eval_tx_release_undo(ctx, tx, commit_state);
+    if (!restore_ok) {
+        ctx->active_transaction = tx->parent;
+        arena_rewind(eval_tx_arena(ctx), tx->mark);
+        return false;
     }
 
     bool flush_ok = true;
@@ -1466,8 +1255,6 @@ bool eval_command_tx_finish(EvalExecContext *ctx, Eval_Command_Transaction *tx,
     ctx->active_transaction = tx->parent;
     arena_rewind(eval_tx_arena(ctx), tx->mark);
     return flush_ok;
-
-#undef EVAL_TX_RESTORE_ARRAY
 }
 
 // -----------------------------------------------------------------------------
@@ -1548,14 +1335,38 @@ Eval_Result eval_emit_diag_with_severity(EvalExecContext *ctx,
 // -----------------------------------------------------------------------------
 // Variable scopes
 // -----------------------------------------------------------------------------
-static Eval_Var_Entry *eval_scope_var_find(Eval_Var_Entry *vars, String_View key) {
-    if (!vars || !key.data) return NULL;
-    return stbds_shgetp_null(vars, nob_temp_sv_to_cstr(key));
+static size_t eval_symbol_hash(String_View name) {
+    if (name.count == 0) return 0;
+    return stbds_hash_bytes((void*)name.data, name.count, 0);
+}
+
+static Eval_Symbol *eval_symbol_probe(const Eval_Symbol_Table *table, String_View name, size_t hash) {
+    size_t mask = table->capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Eval_Symbol *slot = &table->slots[i];
+        if (!slot->name) return slot;
+        if (slot->hash != hash || slot->len != name.count) continue;
+        if (name.count == 0 || memcmp(slot->name, name.data, name.count) == 0) return slot;
+    }
 }
 
-static Eval_Cache_Entry *eval_cache_var_find(Eval_Cache_Entry *entries, String_View key) {
-    if (!entries || !key.data) return NULL;
-    return stbds_shgetp_null(entries, nob_temp_sv_to_cstr(key));
+static bool eval_symbol_table_grow(EvalExecContext *ctx, Eval_Symbol_Table *table) {
+    size_t capacity = table->capacity ? table->capacity * 2 : 256;
+    Eval_Symbol *slots = calloc(capacity, sizeof(*slots));
+    EVAL_OOM_RETURN_IF_NULL(ctx, slots, false);
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        const Eval_Symbol *old = &table->slots[i];
+        if (!old->name) continue;
+        size_t at = old->hash & (capacity - 1);
+        while (slots[at].name) at = (at + 1) & (capacity - 1);
+        slots[at] = *old;
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->capacity = capacity;
+    return true;
 }
 
 static char *eval_copy_key_cstr_event(EvalExecContext *ctx, String_View key) {
@@ -1567,15 +1378,68 @@ static char *eval_copy_key_cstr_event(EvalExecContext *ctx, String_View key) {
     return buf;
 }
 
+char *eval_symbol_find(EvalExecContext *ctx, String_View name) {
+    if (!ctx || !name.data) return NULL;
+    const Eval_Symbol_Table *table = &ctx->scope_state.symbols;
+    if (table->count == 0) return NULL;
+    return eval_symbol_probe(table, name, eval_symbol_hash(name))->name;
+}
+
+char *eval_symbol_intern(EvalExecContext *ctx, String_View name) {
+    if (!ctx) return NULL;
+    if (!name.data) name = nob_sv_from_cstr("");
+    Eval_Symbol_Table *table = &ctx->scope_state.symbols;
+    if ((table->count + 1) * 4 > table->capacity * 3 && !eval_symbol_table_grow(ctx, table)) return NULL;
+
+    size_t hash = eval_symbol_hash(name);
+    Eval_Symbol *slot = eval_symbol_probe(table, name, hash);
+    if (slot->name) return slot->name;
+
+    char *stable = eval_copy_key_cstr_event(ctx, name);
+    if (!stable) return NULL;
+    slot->name = stable;
+    slot->len = name.count;
+    slot->hash = hash;
+    table->count++;
+    return stable;
+}
+
+static Eval_Var_Entry *eval_scope_var_find(Eval_Var_Entry *vars, char *symbol) {
+    if (!vars || !symbol) return NULL;
+    return EVAL_SYMBOL_MAP_GETP(vars, symbol);
+}
+
+static Eval_Cache_Entry *eval_cache_var_find(Eval_Cache_Entry *entries, char *symbol) {
+    if (!entries || !symbol) return NULL;
+    return EVAL_SYMBOL_MAP_GETP(entries, symbol);
+}
+
+Eval_Cache_Entry *eval_cache_entry_find(EvalExecContext *ctx, String_View key) {
+    if (!ctx) return NULL;
+    return eval_cache_var_find(ctx->scope_state.cache_entries, eval_symbol_find(ctx, key));
+}
+
+// CMAKE_CURRENT_LIST_LINE is formatted on read instead of being stored before
+// every statement.
+static String_View eval_current_list_line_temp(EvalExecContext *ctx) {
+    char buf[32];
+    int n = snprintf(buf, sizeof(buf), "%zu", ctx->current_list_line);
+    if (n < 0 || (size_t)n >= sizeof(buf)) return nob_sv_from_cstr("");
+    return sv_copy_to_temp_arena(ctx, nob_sv_from_parts(buf, (size_t)n));
+}
+
 String_View eval_var_get_visible(EvalExecContext *ctx, String_View key) {
     if (!ctx || eval_scope_visible_depth(ctx) == 0) return nob_sv_from_cstr("");
+    char *symbol = eval_symbol_find(ctx, key);
+    if (!symbol) return nob_sv_from_cstr("");
+    if (symbol == ctx->scope_state.current_list_line_symbol) return eval_current_list_line_temp(ctx);
     Eval_Scope_State *scope = eval_scope_slice(ctx);
     for (size_t d = eval_scope_visible_depth(ctx); d-- > 0;) {
         Var_Scope *s = &scope->scopes[d];
-        Eval_Var_Entry *b = eval_scope_var_find(s->vars, key);
+        Eval_Var_Entry *b = eval_scope_var_find(s->vars, symbol);
         if (b) return b->value;
     }
-    Eval_Cache_Entry *ce = eval_cache_var_find(scope->cache_entries, key);
+    Eval_Cache_Entry *ce = eval_cache_var_find(scope->cache_entries, symbol);
     if (ce) return ce->value.data;
     return nob_sv_from_cstr("");
 }
@@ -1619,45 +1483,153 @@ static bool eval_variable_watch_notify(EvalExecContext *ctx,
 bool eval_var_set_current(EvalExecContext *ctx, String_View key, String_View value) {
     if (!ctx || eval_scope_visible_depth(ctx) == 0 || eval_should_stop(ctx)) return false;
     Eval_Scope_State *scope = eval_scope_slice(ctx);
-    Var_Scope *s = &scope->scopes[eval_scope_visible_depth(ctx) - 1];
-    Eval_Var_Entry *b = eval_scope_var_find(s->vars, key);
+    size_t depth = eval_scope_visible_depth(ctx) - 1;
+    Var_Scope *s = &scope->scopes[depth];
+    char *symbol = eval_symbol_intern(ctx, key);
+    if (!symbol) return false;
+    eval_compat_note_var_write(ctx, key);
+    Eval_Var_Entry *b = eval_scope_var_find(s->vars, symbol);
     if (b) {
+        if (!eval_command_tx_note_var(ctx, depth, b->key, b)) return false;
         b->value = sv_copy_to_event_arena(ctx, value);
         if (eval_should_stop(ctx)) return false;
         return eval_variable_watch_notify(ctx, key, nob_sv_from_cstr("SET"), value);
     }
 
-    char *stable_key = eval_copy_key_cstr_event(ctx, key);
-    if (!stable_key) return false;
+    if (!eval_command_tx_note_var(ctx, depth, symbol, NULL)) return false;
     String_View stable_value = sv_copy_to_event_arena(ctx, value);
     if (eval_should_stop(ctx)) return false;
 
     Eval_Var_Entry *vars = s->vars;
-    stbds_shput(vars, stable_key, stable_value);
+    EVAL_SYMBOL_MAP_PUT(vars, symbol, stable_value);
     s->vars = vars;
     return eval_variable_watch_notify(ctx, key, nob_sv_from_cstr("SET"), value);
 }
 
+static Eval_List_Buffer *eval_list_buffer_find(EvalExecContext *ctx, String_View value) {
+    Eval_List_Buffer_Entry *buffers = ctx->scope_state.list_buffers;
+    if (!buffers || !value.data) return NULL;
+    char *key = (char*)value.data;
+    Eval_List_Buffer_Entry *entry = EVAL_SYMBOL_MAP_GETP(buffers, key);
+    ctx->scope_state.list_buffers = buffers;
+    return entry ? entry->value : NULL;
+}
+
+static bool eval_list_buffer_track(EvalExecContext *ctx, char *start, Eval_List_Buffer *buffer) {
+    Eval_List_Buffer_Entry *buffers = ctx->scope_state.list_buffers;
+    EVAL_SYMBOL_MAP_PUT(buffers, start, buffer);
+    ctx->scope_state.list_buffers = buffers;
+    return true;
+}
+
+// Copies `left;right` into a fresh buffer with as much slack as content, on
+// the side the caller grows, which keeps repeated growth amortized O(1).
+static bool eval_list_buffer_create(EvalExecContext *ctx,
+                                    String_View left,
+                                    String_View right,
+                                    bool grow_front,
+                                    String_View *out_value) {
+    size_t total = left.count + 1 + right.count;
+    size_t capacity = total * 2 + 32;
+    Eval_List_Buffer *buffer = arena_alloc(ctx->event_arena, sizeof(*buffer));
+    EVAL_OOM_RETURN_IF_NULL(ctx, buffer, false);
+    buffer->base = arena_alloc(ctx->event_arena, capacity + 1);
+    EVAL_OOM_RETURN_IF_NULL(ctx, buffer->base, false);
+    buffer->capacity = capacity;
+    buffer->lo = grow_front ? capacity - total : 0;
+    buffer->hi = buffer->lo + total;
+
+    char *start = buffer->base + buffer->lo;
+    memcpy(start, left.data, left.count);
+    start[left.count] = ';';
+    memcpy(start + left.count + 1, right.data, right.count);
+    buffer->base[buffer->hi] = '\0';
+    if (!eval_list_buffer_track(ctx, start, buffer)) return false;
+    *out_value = nob_sv_from_parts(start, total);
+    return true;
+}
+
+bool eval_var_list_append_current(EvalExecContext *ctx, String_View key, String_View items, bool prepend) {
+    if (!ctx || eval_scope_visible_depth(ctx) == 0 || eval_should_stop(ctx)) return false;
+    Eval_Scope_State *scope = eval_scope_slice(ctx);
+    size_t depth = eval_scope_visible_depth(ctx) - 1;
+    Var_Scope *s = &scope->scopes[depth];
+    char *symbol = eval_symbol_intern(ctx, key);
+    if (!symbol) return false;
+    eval_compat_note_var_write(ctx, key);
+    Eval_Var_Entry *b = eval_scope_var_find(s->vars, symbol);
+    String_View existing = b ? b->value : eval_var_get_visible(ctx, key);
+    if (existing.count == 0) return eval_var_set_current(ctx, key, items);
+
+    // Only a binding of this scope may grow its buffer in place; values seen
+    // through a parent scope or the cache are copied as set() would.
+    if (!eval_command_tx_note_var(ctx, depth, b ? b->key : symbol, b)) return false;
+    String_View value = {0};
+    Eval_List_Buffer *buffer = b ? eval_list_buffer_find(ctx, existing) : NULL;
+    char *buffer_lo = buffer ? buffer->base + buffer->lo : NULL;
+    char *buffer_hi = buffer ? buffer->base + buffer->hi : NULL;
+    if (buffer && !prepend &&
+        existing.data + existing.count == buffer_hi &&
+        buffer->capacity - buffer->hi >= items.count + 1) {
+        buffer_hi[0] = ';';
+        memcpy(buffer_hi + 1, items.data, items.count);
+        buffer->hi += items.count + 1;
+        buffer->base[buffer->hi] = '\0';
+        value = nob_sv_from_parts(existing.data, existing.count + items.count + 1);
+    } else if (buffer && prepend &&
+               existing.data == buffer_lo &&
+               buffer->lo >= items.count + 1) {
+        buffer->lo -= items.count + 1;
+        char *start = buffer->base + buffer->lo;
+        memcpy(start, items.data, items.count);
+        start[items.count] = ';';
+        if (!eval_list_buffer_track(ctx, start, buffer)) return false;
+        value = nob_sv_from_parts(start, existing.count + items.count + 1);
+    } else if (!eval_list_buffer_create(ctx,
+                                        prepend ? items : existing,
+                                        prepend ? existing : items,
+                                        prepend,
+                                        &value)) {
+        return false;
+    }
+
+    if (b) {
+        b->value = value;
+    } else {
+        Eval_Var_Entry *vars = s->vars;
+        EVAL_SYMBOL_MAP_PUT(vars, symbol, value);
+        s->vars = vars;
+    }
+    return eval_variable_watch_notify(ctx, key, nob_sv_from_cstr("SET"), value);
+}
+
 bool eval_var_unset_current(EvalExecContext *ctx, String_View key) {
     if (!ctx || eval_scope_visible_depth(ctx) == 0 || eval_should_stop(ctx)) return false;
     Eval_Scope_State *scope = eval_scope_slice(ctx);
-    Var_Scope *s = &scope->scopes[eval_scope_visible_depth(ctx) - 1];
+    size_t depth = eval_scope_visible_depth(ctx) - 1;
+    Var_Scope *s = &scope->scopes[depth];
     String_View old_value = eval_var_get_visible(ctx, key);
-    if (s->vars) {
-        (void)stbds_shdel(s->vars, nob_temp_sv_to_cstr(key));
+    char *symbol = eval_symbol_find(ctx, key);
+    Eval_Var_Entry *b = eval_scope_var_find(s->vars, symbol);
+    if (b) {
+        if (!eval_command_tx_note_var(ctx, depth, b->key, b)) return false;
+        EVAL_SYMBOL_MAP_DEL(s->vars, symbol);
+        eval_compat_note_var_write(ctx, key);
     }
     return eval_variable_watch_notify(ctx, key, nob_sv_from_cstr("UNSET"), old_value);
 }
 
 bool eval_var_defined_visible(EvalExecContext *ctx, String_View key) {
     if (!ctx || eval_scope_visible_depth(ctx) == 0) return false;
+    char *symbol = eval_symbol_find(ctx, key);
+    if (!symbol) return false;
     Eval_Scope_State *scope = eval_scope_slice(ctx);
     for (size_t d = eval_scope_visible_depth(ctx); d-- > 0;) {
         Var_Scope *s = &scope->scopes[d];
-        Eval_Var_Entry *b = eval_scope_var_find(s->vars, key);
+        Eval_Var_Entry *b = eval_scope_var_find(s->vars, symbol);
         if (b) return true;
     }
-    if (eval_cache_var_find(scope->cache_entries, key)) return true;
+    if (eval_cache_var_find(scope->cache_entries, symbol)) return true;
     return false;
 }
 
@@ -1665,7 +1637,7 @@ bool eval_var_defined_current(EvalExecContext *ctx, String_View key) {
     if (!ctx || eval_scope_visible_depth(ctx) == 0) return false;
     Eval_Scope_State *scope = eval_scope_slice(ctx);
     Var_Scope *s = &scope->scopes[eval_scope_visible_depth(ctx) - 1];
-    Eval_Var_Entry *b = eval_scope_var_find(s->vars, key);
+    Eval_Var_Entry *b = eval_scope_var_find(s->vars, eval_symbol_find(ctx, key));
     return b != NULL;
 }
 
@@ -1676,7 +1648,7 @@ bool eval_var_collect_visible_names(EvalExecContext *ctx, SV_List *out_names) {
     Eval_Scope_State *scope_state = eval_scope_slice(ctx);
     for (size_t depth = 0; depth < eval_scope_visible_depth(ctx); depth++) {
         Var_Scope *scope = &scope_state->scopes[depth];
-        ptrdiff_t n = stbds_shlen(scope->vars);
+        ptrdiff_t n = stbds_hmlen(scope->vars);
         for (ptrdiff_t i = 0; i < n; i++) {
             if (!scope->vars[i].key) continue;
             if (!eval_sv_arr_push_temp(ctx, out_names, nob_sv_from_cstr(scope->vars[i].key))) return false;
@@ -1688,7 +1660,7 @@ bool eval_var_collect_visible_names(EvalExecContext *ctx, SV_List *out_names) {
 
 bool eval_cache_defined(EvalExecContext *ctx, String_View key) {
     if (!ctx || key.count == 0) return false;
-    return eval_cache_var_find(ctx->scope_state.cache_entries, key) != NULL;
+    return eval_cache_entry_find(ctx, key) != NULL;
 }
 
 bool eval_cache_set(EvalExecContext *ctx,
@@ -1699,8 +1671,12 @@ bool eval_cache_set(EvalExecContext *ctx,
     if (!ctx || key.count == 0 || eval_should_stop(ctx)) return false;
 
     Eval_Scope_State *scope = eval_scope_slice(ctx);
-    Eval_Cache_Entry *entry = eval_cache_var_find(scope->cache_entries, key);
+    char *symbol = eval_symbol_intern(ctx, key);
+    if (!symbol) return false;
+    eval_compat_note_var_write(ctx, key);
+    Eval_Cache_Entry *entry = eval_cache_var_find(scope->cache_entries, symbol);
     if (entry) {
+        if (!eval_command_tx_note_cache(ctx, entry->key, entry)) return false;
         entry->value.data = sv_copy_to_event_arena(ctx, value);
         if (eval_should_stop(ctx)) return false;
         entry->value.type = sv_copy_to_event_arena(ctx, type);
@@ -1710,8 +1686,7 @@ bool eval_cache_set(EvalExecContext *ctx,
         return true;
     }
 
-    char *stable_key = eval_copy_key_cstr_event(ctx, key);
-    if (!stable_key) return false;
+    if (!eval_command_tx_note_cache(ctx, symbol, NULL)) return false;
 
     Eval_Cache_Entry *entries = scope->cache_entries;
     Eval_Cache_Value cache_value = {
@@ -1720,73 +1695,272 @@ bool eval_cache_set(EvalExecContext *ctx,
         .doc = sv_copy_to_event_arena(ctx, doc),
     };
     if (eval_should_stop(ctx)) return false;
-    stbds_shput(entries, stable_key, cache_value);
+    EVAL_SYMBOL_MAP_PUT(entries, symbol, cache_value);
     scope->cache_entries = entries;
     return true;
 }
 
+#define EVAL_MACRO_MIN_BUCKETS 32
+
+static size_t eval_macro_key_hash(String_View key) {
+    size_t h = (size_t)2166136261u;
+    for (size_t i = 0; i < key.count; i++) {
+        h ^= (unsigned char)key.data[i];
+        h *= (size_t)16777619u;
+    }
+    return h;
+}
+
+static bool eval_macro_buckets_rebuild(EvalExecContext *ctx, size_t bucket_count) {
+    Eval_Scope_State *scope = &ctx->scope_state;
+    size_t *buckets = arena_alloc_array_zero(ctx->event_arena, size_t, bucket_count);
+    EVAL_OOM_RETURN_IF_NULL(ctx, buckets, false);
+
+    // Oldest first, so every chain ends up ordered newest-first again.
+    for (size_t i = 0; i < arena_arr_len(scope->macro_bindings); i++) {
+        Macro_Binding *b = &scope->macro_bindings[i];
+        size_t slot = b->hash & (bucket_count - 1);
+        b->next = buckets[slot];
+        buckets[slot] = i + 1;
+    }
+    scope->macro_buckets = buckets;
+    scope->macro_bucket_count = bucket_count;
+    return true;
+}
+
 bool eval_macro_frame_push(EvalExecContext *ctx) {
     if (!ctx) return false;
     Macro_Frame frame = {0};
+    frame.first_binding = arena_arr_len(ctx->scope_state.macro_bindings);
     return EVAL_ARR_PUSH(ctx, ctx->event_arena, ctx->scope_state.macro_frames, frame);
 }
 
 void eval_macro_frame_pop(EvalExecContext *ctx) {
     if (!ctx || arena_arr_len(ctx->scope_state.macro_frames) == 0) return;
-    arena_arr_set_len(ctx->scope_state.macro_frames, arena_arr_len(ctx->scope_state.macro_frames) - 1);
+    Eval_Scope_State *scope = &ctx->scope_state;
+    size_t frame_count = arena_arr_len(scope->macro_frames);
+    size_t first = scope->macro_frames[frame_count - 1].first_binding;
+
+    for (size_t i = arena_arr_len(scope->macro_bindings); i-- > first;) {
+        const Macro_Binding *b = &scope->macro_bindings[i];
+        scope->macro_buckets[b->hash & (scope->macro_bucket_count - 1)] = b->next;
+    }
+    if (scope->macro_bindings) arena_arr_set_len(scope->macro_bindings, first);
+    arena_arr_set_len(scope->macro_frames, frame_count - 1);
 }
 
 bool eval_macro_bind_set(EvalExecContext *ctx, String_View key, String_View value) {
     if (!ctx || arena_arr_len(ctx->scope_state.macro_frames) == 0) return false;
 
-    Macro_Frame *top = &ctx->scope_state.macro_frames[arena_arr_len(ctx->scope_state.macro_frames) - 1];
+    Eval_Scope_State *scope = &ctx->scope_state;
+    size_t first = scope->macro_frames[arena_arr_len(scope->macro_frames) - 1].first_binding;
     key = sv_copy_to_event_arena(ctx, key);
     value = sv_copy_to_event_arena(ctx, value);
     if (eval_should_stop(ctx)) return false;
 
-    for (size_t i = arena_arr_len(top->bindings); i-- > 0;) {
-        if (eval_sv_key_eq(top->bindings[i].key, key)) {
-            top->bindings[i].value = value;
+    if (scope->macro_bucket_count == 0 &&
+        !eval_macro_buckets_rebuild(ctx, EVAL_MACRO_MIN_BUCKETS)) {
+        return false;
+    }
+
+    size_t hash = eval_macro_key_hash(key);
+    size_t slot = hash & (scope->macro_bucket_count - 1);
+    // Chains run newest-first, so the walk can stop at the first binding that
+    // belongs to an enclosing frame.
+    for (size_t idx = scope->macro_buckets[slot]; idx > first; idx = scope->macro_bindings[idx - 1].next) {
+        Macro_Binding *b = &scope->macro_bindings[idx - 1];
+        if (b->hash == hash && eval_sv_key_eq(b->key, key)) {
+            b->value = value;
             return true;
         }
     }
 
-    Var_Binding b = {0};
+    Macro_Binding b = {0};
     b.key = key;
     b.value = value;
-    return EVAL_ARR_PUSH(ctx, ctx->event_arena, top->bindings, b);
+    b.hash = hash;
+    b.next = scope->macro_buckets[slot];
+    if (!EVAL_ARR_PUSH(ctx, ctx->event_arena, scope->macro_bindings, b)) return false;
+    size_t count = arena_arr_len(scope->macro_bindings);
+    scope->macro_buckets[slot] = count;
+
+    if (count > scope->macro_bucket_count * 2) {
+        return eval_macro_buckets_rebuild(ctx, scope->macro_bucket_count * 2);
+    }
+    return true;
 }
 
-bool eval_macro_bind_get(EvalExecContext *ctx, String_View key, String_View *out_value) {
-    if (!ctx || !out_value) return false;
-    for (size_t fi = arena_arr_len(ctx->scope_state.macro_frames); fi-- > 0;) {
-        const Macro_Frame *f = &ctx->scope_state.macro_frames[fi];
-        for (size_t i = arena_arr_len(f->bindings); i-- > 0;) {
-            if (eval_sv_key_eq(f->bindings[i].key, key)) {
-                *out_value = f->bindings[i].value;
-                return true;
-            }
+bool eval_macro_bind_lookup(EvalExecContext *ctx, String_View key, String_View *out_value) {
+    if (!ctx || !out_value || ctx->scope_state.macro_bucket_count == 0) return false;
+    const Eval_Scope_State *scope = &ctx->scope_state;
+    size_t hash = eval_macro_key_hash(key);
+    size_t slot = hash & (scope->macro_bucket_count - 1);
+    for (size_t idx = scope->macro_buckets[slot]; idx > 0; idx = scope->macro_bindings[idx - 1].next) {
+        const Macro_Binding *b = &scope->macro_bindings[idx - 1];
+        if (b->hash == hash && eval_sv_key_eq(b->key, key)) {
+            *out_value = b->value;
+            return true;
         }
     }
     return false;
 }
 
-bool eval_target_known(EvalExecContext *ctx, String_View name) {
-    if (!ctx) return false;
+// Target name index: open-addressed slots over target records and alias
+// names, synced lazily as the lists grow and unwound by eval_target_truncate.
+// Both lists are append-only outside truncation and hold unique names.
+
+static size_t eval_target_name_hash(String_View name) {
+    size_t hash = (size_t)14695981039346656037ull;
+    for (size_t i = 0; i < name.count; i++) {
+        hash ^= (unsigned char)name.data[i];
+        hash *= (size_t)1099511628211ull;
+    }
+    return hash;
+}
+
+static String_View eval_target_slot_name(const Eval_Target_Model *targets, const Eval_Target_Name_Slot *slot) {
+    return slot->record_index != SIZE_MAX ? targets->records[slot->record_index].name
+                                          : targets->aliases[slot->alias_index];
+}
+
+static size_t eval_target_index_probe(const Eval_Target_Model *targets, String_View name, size_t hash) {
+    size_t mask = targets->name_index_capacity - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const Eval_Target_Name_Slot *entry = &targets->name_index[slot];
+        if (entry->record_index == SIZE_MAX && entry->alias_index == SIZE_MAX) return slot;
+        if (entry->hash == hash && eval_sv_key_eq(eval_target_slot_name(targets, entry), name)) return slot;
+    }
+}
+
+static void eval_target_index_remove_slot(Eval_Target_Model *targets, size_t hole) {
+    size_t mask = targets->name_index_capacity - 1;
+    Eval_Target_Name_Slot *slots = targets->name_index;
+    for (size_t j = (hole + 1) & mask;
+         slots[j].record_index != SIZE_MAX || slots[j].alias_index != SIZE_MAX;
+         j = (j + 1) & mask) {
+        size_t home = slots[j].hash & mask;
+        bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (stays) continue;
+        slots[hole] = slots[j];
+        hole = j;
+    }
+    slots[hole].hash = 0;
+    slots[hole].record_index = SIZE_MAX;
+    slots[hole].alias_index = SIZE_MAX;
+    targets->name_index_entries--;
+}
+
+static bool eval_target_index_reserve(Eval_Target_Model *targets, size_t entries) {
+    if (targets->name_index && entries * 2 <= targets->name_index_capacity) return true;
+    size_t capacity = targets->name_index_capacity ? targets->name_index_capacity : 64;
+    while (capacity < entries * 2) capacity <<= 1;
+
+    Eval_Target_Name_Slot *slots =
+        (Eval_Target_Name_Slot*)arena_alloc(targets->arena, capacity * sizeof(*slots));
+    if (!slots) return false;
+    for (size_t i = 0; i < capacity; i++) {
+        slots[i].hash = 0;
+        slots[i].record_index = SIZE_MAX;
+        slots[i].alias_index = SIZE_MAX;
+    }
+    size_t mask = capacity - 1;
+    for (size_t i = 0; targets->name_index && i < targets->name_index_capacity; i++) {
+        const Eval_Target_Name_Slot *entry = &targets->name_index[i];
+        if (entry->record_index == SIZE_MAX && entry->alias_index == SIZE_MAX) continue;
+        size_t at = entry->hash & mask;
+        while (slots[at].record_index != SIZE_MAX || slots[at].alias_index != SIZE_MAX) at = (at + 1) & mask;
+        slots[at] = *entry;
+    }
+    targets->name_index = slots;
+    targets->name_index_capacity = capacity;
+    return true;
+}
+
+// Returns the slot for `name`, creating an empty-keyed one if needed.
+static Eval_Target_Name_Slot *eval_target_index_upsert(Eval_Target_Model *targets, String_View name) {
+    if (!eval_target_index_reserve(targets, targets->name_index_entries + 1)) return NULL;
+    size_t hash = eval_target_name_hash(name);
+    Eval_Target_Name_Slot *slot = &targets->name_index[eval_target_index_probe(targets, name, hash)];
+    if (slot->record_index == SIZE_MAX && slot->alias_index == SIZE_MAX) {
+        slot->hash = hash;
+        targets->name_index_entries++;
+    }
+    return slot;
+}
+
+static bool eval_target_index_sync(EvalExecContext *ctx) {
     Eval_Target_Model *targets = &ctx->semantic_state.targets;
-    for (size_t i = 0; i < arena_arr_len(targets->records); i++) {
-        if (eval_sv_key_eq(targets->records[i].name, name)) return true;
+    size_t record_count = arena_arr_len(targets->records);
+    size_t alias_count = arena_arr_len(targets->aliases);
+    if (!eval_target_index_reserve(targets, 0)) return ctx_oom(ctx);
+    if (targets->indexed_record_count > record_count || targets->indexed_alias_count > alias_count) {
+        eval_target_truncate(ctx, record_count, alias_count);
+    }
+    while (targets->indexed_record_count < record_count) {
+        size_t index = targets->indexed_record_count;
+        Eval_Target_Name_Slot *slot = eval_target_index_upsert(targets, targets->records[index].name);
+        if (!slot) return ctx_oom(ctx);
+        if (slot->record_index == SIZE_MAX) slot->record_index = index;
+        targets->indexed_record_count++;
+    }
+    while (targets->indexed_alias_count < alias_count) {
+        size_t index = targets->indexed_alias_count;
+        Eval_Target_Name_Slot *slot = eval_target_index_upsert(targets, targets->aliases[index]);
+        if (!slot) return ctx_oom(ctx);
+        if (slot->alias_index == SIZE_MAX) slot->alias_index = index;
+        targets->indexed_alias_count++;
     }
-    return false;
+    return true;
 }
 
-static Eval_Target_Record *eval_target_find_record(EvalExecContext *ctx, String_View name) {
-    if (!ctx) return NULL;
+static const Eval_Target_Name_Slot *eval_target_index_lookup(EvalExecContext *ctx, String_View name) {
+    if (!ctx || !eval_target_index_sync(ctx)) return NULL;
+    const Eval_Target_Model *targets = &ctx->semantic_state.targets;
+    const Eval_Target_Name_Slot *slot =
+        &targets->name_index[eval_target_index_probe(targets, name, eval_target_name_hash(name))];
+    if (slot->record_index == SIZE_MAX && slot->alias_index == SIZE_MAX) return NULL;
+    return slot;
+}
+
+void eval_target_truncate(EvalExecContext *ctx, size_t record_count, size_t alias_count) {
+    if (!ctx) return;
     Eval_Target_Model *targets = &ctx->semantic_state.targets;
-    for (size_t i = 0; i < arena_arr_len(targets->records); i++) {
-        if (eval_sv_key_eq(targets->records[i].name, name)) return &targets->records[i];
+    // Entries are unwound newest first while their names are still readable.
+    while (targets->indexed_alias_count > alias_count) {
+        size_t index = --targets->indexed_alias_count;
+        String_View name = targets->aliases[index];
+        size_t slot = eval_target_index_probe(targets, name, eval_target_name_hash(name));
+        Eval_Target_Name_Slot *entry = &targets->name_index[slot];
+        if (entry->alias_index != index) continue;
+        entry->alias_index = SIZE_MAX;
+        if (entry->record_index == SIZE_MAX) eval_target_index_remove_slot(targets, slot);
     }
-    return NULL;
+    while (targets->indexed_record_count > record_count) {
+        size_t index = --targets->indexed_record_count;
+        String_View name = targets->records[index].name;
+        size_t slot = eval_target_index_probe(targets, name, eval_target_name_hash(name));
+        Eval_Target_Name_Slot *entry = &targets->name_index[slot];
+        if (entry->record_index != index) continue;
+        entry->record_index = SIZE_MAX;
+        if (entry->alias_index == SIZE_MAX) eval_target_index_remove_slot(targets, slot);
+    }
+    if (targets->records && arena_arr_len(targets->records) > record_count) {
+        arena_arr_set_len(targets->records, record_count);
+    }
+    if (targets->aliases && arena_arr_len(targets->aliases) > alias_count) {
+        arena_arr_set_len(targets->aliases, alias_count);
+    }
+}
+
+bool eval_target_known(EvalExecContext *ctx, String_View name) {
+    const Eval_Target_Name_Slot *slot = eval_target_index_lookup(ctx, name);
+    return slot && slot->record_index != SIZE_MAX;
+}
+
+static Eval_Target_Record *eval_target_find_record(EvalExecContext *ctx, String_View name) {
+    const Eval_Target_Name_Slot *slot = eval_target_index_lookup(ctx, name);
+    if (!slot || slot->record_index == SIZE_MAX) return NULL;
+    return &ctx->semantic_state.targets.records[slot->record_index];
 }
 
 static bool eval_directory_is_same_or_descendant(EvalExecContext *ctx,
@@ -1856,9 +2030,16 @@ bool eval_target_register(EvalExecContext *ctx, String_View name) {
     return eval_directory_note_target(ctx, declared_dir, record.name);
 }
 
+static bool eval_target_note_record(EvalExecContext *ctx, const Eval_Target_Record *record) {
+    return eval_command_tx_note_elem(ctx,
+                                     EVAL_TX_SLICE_TARGET_RECORDS,
+                                     (size_t)(record - ctx->semantic_state.targets.records));
+}
+
 bool eval_target_set_type(EvalExecContext *ctx, String_View name, Cmake_Target_Type target_type) {
     Eval_Target_Record *record = eval_target_find_record(ctx, name);
     if (!record) return false;
+    if (!eval_target_note_record(ctx, record)) return false;
     record->target_type = target_type;
     return true;
 }
@@ -1874,6 +2055,7 @@ bool eval_target_get_type(EvalExecContext *ctx, String_View name, Cmake_Target_T
 bool eval_target_set_imported(EvalExecContext *ctx, String_View name, bool imported) {
     Eval_Target_Record *record = eval_target_find_record(ctx, name);
     if (!record) return false;
+    if (!eval_target_note_record(ctx, record)) return false;
     record->imported = imported;
     return true;
 }
@@ -1881,6 +2063,7 @@ bool eval_target_set_imported(EvalExecContext *ctx, String_View name, bool impor
 bool eval_target_set_imported_global(EvalExecContext *ctx, String_View name, bool imported_global) {
     Eval_Target_Record *record = eval_target_find_record(ctx, name);
     if (!record) return false;
+    if (!eval_target_note_record(ctx, record)) return false;
     record->imported_global = imported_global;
     return true;
 }
@@ -1890,13 +2073,10 @@ bool eval_target_declared_dir(EvalExecContext *ctx, String_View name, String_Vie
     *out_dir = nob_sv_from_cstr("");
     if (!ctx) return false;
 
-    Eval_Target_Model *targets = &ctx->semantic_state.targets;
-    for (size_t i = 0; i < arena_arr_len(targets->records); i++) {
-        if (!eval_sv_key_eq(targets->records[i].name, name)) continue;
-        *out_dir = targets->records[i].declared_dir;
-        return true;
-    }
-    return false;
+    Eval_Target_Record *record = eval_target_find_record(ctx, name);
+    if (!record) return false;
+    *out_dir = record->declared_dir;
+    return true;
 }
 
 bool eval_target_is_imported(EvalExecContext *ctx, String_View name) {
@@ -1910,12 +2090,8 @@ bool eval_target_is_imported_global(EvalExecContext *ctx, String_View name) {
 }
 
 bool eval_target_alias_known(EvalExecContext *ctx, String_View name) {
-    if (!ctx) return false;
-    Eval_Target_Model *targets = &ctx->semantic_state.targets;
-    for (size_t i = 0; i < arena_arr_len(targets->aliases); i++) {
-        if (eval_sv_key_eq(targets->aliases[i], name)) return true;
-    }
-    return false;
+    const Eval_Target_Name_Slot *slot = eval_target_index_lookup(ctx, name);
+    return slot && slot->alias_index != SIZE_MAX;
 }
 
 bool eval_target_alias_register(EvalExecContext *ctx, String_View name) {
@@ -1931,6 +2107,7 @@ bool eval_target_set_alias(EvalExecContext *ctx, String_View alias_name, String_
     Eval_Target_Record *alias_record = eval_target_find_record(ctx, alias_name);
     Eval_Target_Record *real_record = eval_target_find_record(ctx, real_target);
     if (!alias_record || !real_record) return false;
+    if (!eval_target_note_record(ctx, alias_record)) return false;
 
     alias_record->alias = true;
     alias_record->alias_global = real_record->imported ? real_record->imported_global : true;
@@ -1999,6 +2176,11 @@ bool eval_test_set_working_directory(EvalExecContext *ctx,
                                      String_View working_directory) {
     Eval_Test_Record *record = eval_test_find_record(ctx, name, declared_dir);
     if (!record) return false;
+    if (!eval_command_tx_note_elem(ctx,
+                                   EVAL_TX_SLICE_TEST_RECORDS,
+                                   (size_t)(record - ctx->semantic_state.tests.records))) {
+        return false;
+    }
     record->working_directory = sv_copy_to_arena(ctx->semantic_state.tests.arena, working_directory);
     if (working_directory.count > 0 && record->working_directory.count == 0) return ctx_oom(ctx);
     return true;
@@ -2047,17 +2229,6 @@ static char *sv_ascii_upper_copy(Arena *arena, String_View sv) {
     return buf;
 }
 
-static char *sv_ascii_upper_heap(String_View sv) {
-    if (!sv.data || sv.count == 0) return NULL;
-    char *buf = (char*)malloc(sv.count + 1);
-    if (!buf) return NULL;
-    for (size_t i = 0; i < sv.count; i++) {
-        buf[i] = (char)toupper((unsigned char)sv.data[i]);
-    }
-    buf[sv.count] = '\0';
-    return buf;
-}
-
 static bool sv_list_push(Arena *arena, SV_List *list, String_View sv) {
     if (!arena || !list) return false;
     return arena_arr_push(arena, *list, sv);
@@ -2091,14 +2262,13 @@ static bool sv_strip_cmake_bracket_arg(String_View in, String_View *out) {
     return true;
 }
 
-static String_View arg_to_sv_flat(EvalExecContext *ctx, const Arg *arg) {
+static String_View arg_to_sv_flat_in(EvalExecContext *ctx, Arena *arena, const Arg *arg) {
     if (!ctx || !arg || arena_arr_len(arg->items) == 0) return nob_sv_from_cstr("");
 
     size_t total = 0;
     for (size_t i = 0; i < arena_arr_len(arg->items); i++) total += arg->items[i].text.count;
 
-    // Flatten into temp arena; caller rewinds at statement boundary.
-    char *buf = (char*)arena_alloc(ctx->arena, total + 1);
+    char *buf = (char*)arena_alloc(arena, total + 1);
     EVAL_OOM_RETURN_IF_NULL(ctx, buf, nob_sv_from_cstr(""));
 
     size_t off = 0;
@@ -2113,6 +2283,11 @@ static String_View arg_to_sv_flat(EvalExecContext *ctx, const Arg *arg) {
     return nob_sv_from_cstr(buf);
 }
 
+static String_View arg_to_sv_flat(EvalExecContext *ctx, const Arg *arg) {
+    // Flatten into temp arena; caller rewinds at statement boundary.
+    return arg_to_sv_flat_in(ctx, ctx ? ctx->arena : NULL, arg);
+}
+
 #define EVAL_LITERAL_BS_BEFORE_DOLLAR_SENTINEL '\x1e'
 
 static String_View arg_restore_literal_bs_sentinel_temp(EvalExecContext *ctx, String_View in) {
@@ -2136,7 +2311,7 @@ static String_View arg_restore_literal_bs_sentinel_temp(EvalExecContext *ctx, St
     return nob_sv_from_parts(buf, in.count);
 }
 
-static String_View arg_process_quoted_literal_temp(EvalExecContext *ctx, String_View in) {
+static String_View arg_process_quoted_literal_in(EvalExecContext *ctx, Arena *arena, String_View in) {
     bool has_escape = false;
     size_t out_count = 0;
     char *buf = NULL;
@@ -2155,7 +2330,7 @@ static String_View arg_process_quoted_literal_temp(EvalExecContext *ctx, String_
     }
     if (!has_escape) return in;
 
-    buf = (char*)arena_alloc(ctx->arena, in.count + 1);
+    buf = (char*)arena_alloc(arena, in.count + 1);
     EVAL_OOM_RETURN_IF_NULL(ctx, buf, nob_sv_from_cstr(""));
 
     for (size_t i = 0; i < in.count; i++) {
@@ -2214,6 +2389,10 @@ static String_View arg_process_quoted_literal_temp(EvalExecContext *ctx, String_
     return nob_sv_from_parts(buf, out_count);
 }
 
+static String_View arg_process_quoted_literal_temp(EvalExecContext *ctx, String_View in) {
+    return arg_process_quoted_literal_in(ctx, ctx ? ctx->arena : NULL, in);
+}
+
 String_View eval_resolve_quoted_arg_temp(EvalExecContext *ctx, String_View flat, bool expand_vars) {
     if (!ctx) return nob_sv_from_cstr("");
     String_View value = arg_process_quoted_literal_temp(ctx, flat);
@@ -2222,6 +2401,243 @@ String_View eval_resolve_quoted_arg_temp(EvalExecContext *ctx, String_View flat,
     return value;
 }
 
+// -----------------------------------------------------------------------------
+// Argument templates
+// -----------------------------------------------------------------------------
+//
+// eval_resolve_args() re-flattens and rescans every argument on each
+// execution. Arguments that run again (loop bodies, function bodies,
+// re-included files) are compiled on their second execution into a template
+// of literal segments and variable slots, stored in the session arena and
+// hung off the parser Arg. Literal-only templates carry their final items and
+// resolve without copying. Shapes the template cannot express exactly
+// (nested `${${x}}`, escaped dollars, bracket expansion) keep the generic
+// path.
+
+typedef enum {
+    EVAL_ARG_SEG_LITERAL = 0,
+    EVAL_ARG_SEG_VAR,
+    EVAL_ARG_SEG_ENV,
+} Eval_Arg_Segment_Kind;
+
+typedef struct {
+    Eval_Arg_Segment_Kind kind;
+    String_View text; // literal bytes, or the NUL-terminated variable/env name
+} Eval_Arg_Segment;
+
+typedef struct {
+    Arg_Kind kind;
+    bool literal;
+    SV_List items; // literal templates only: resolved items, already split
+    Eval_Arg_Segment *segments;
+    size_t literal_bytes;
+} Eval_Arg_Template;
+
+static const Eval_Arg_Template s_eval_arg_template_generic = {0};
+
+static bool eval_arg_template_push_segment(Arena *arena,
+                                           Eval_Arg_Template *tpl,
+                                           Eval_Arg_Segment_Kind kind,
+                                           String_View text) {
+    if (kind == EVAL_ARG_SEG_LITERAL) {
+        if (text.count == 0) return true;
+        tpl->literal_bytes += text.count;
+    } else if (text.count > 0) {
+        text = sv_copy_to_arena(arena, text);
+        if (text.count == 0) return false;
+    } else {
+        text = nob_sv_from_cstr("");
+    }
+    Eval_Arg_Segment seg = {.kind = kind, .text = text};
+    return arena_arr_push(arena, tpl->segments, seg);
+}
+
+// Splits `source` the way expand_once() would scan it. Returns false with
+// *out_generic set when the text needs the generic expander.
+static bool eval_arg_template_scan(Arena *arena, Eval_Arg_Template *tpl, String_View source, bool *out_generic) {
+    *out_generic = false;
+    size_t lit_start = 0;
+    for (size_t i = 0; i < source.count; i++) {
+        char c = source.data[i];
+        if (c == EVAL_ESCAPED_DOLLAR_SENTINEL || c == EVAL_LITERAL_BS_BEFORE_DOLLAR_SENTINEL ||
+            (c == '\\' && i + 1 < source.count && source.data[i + 1] == '$')) {
+            *out_generic = true;
+            return false;
+        }
+        if (c != '$') continue;
+
+        Eval_Arg_Segment_Kind kind = EVAL_ARG_SEG_LITERAL;
+        size_t name_start = 0;
+        size_t name_end = 0;
+        if (i + 4 < source.count && memcmp(source.data + i, "$ENV{", 5) == 0) {
+            name_start = i + 5;
+            name_end = name_start;
+            while (name_end < source.count && source.data[name_end] != '}') name_end++;
+            if (name_end < source.count) kind = EVAL_ARG_SEG_ENV;
+        }
+        if (kind == EVAL_ARG_SEG_LITERAL && i + 1 < source.count && source.data[i + 1] == '{') {
+            name_start = i + 2;
+            size_t j = name_start;
+            int nested_depth = 1;
+            while (j < source.count && nested_depth > 0) {
+                if (source.data[j] == '{') nested_depth++;
+                else if (source.data[j] == '}') nested_depth--;
+                else if (source.data[j] == '$') break;
+                j++;
+            }
+            if (nested_depth != 0) {
+                *out_generic = true;
+                return false;
+            }
+            name_end = j - 1;
+            kind = EVAL_ARG_SEG_VAR;
+        }
+        if (kind == EVAL_ARG_SEG_LITERAL) continue;
+
+        if (!eval_arg_template_push_segment(arena, tpl, EVAL_ARG_SEG_LITERAL,
+                                            nob_sv_from_parts(source.data + lit_start, i - lit_start)) ||
+            !eval_arg_template_push_segment(arena, tpl, kind,
+                                            nob_sv_from_parts(source.data + name_start, name_end - name_start))) {
+            return false;
+        }
+        i = name_end;
+        lit_start = name_end + 1;
+    }
+    return eval_arg_template_push_segment(arena, tpl, EVAL_ARG_SEG_LITERAL,
+                                          nob_sv_from_parts(source.data + lit_start, source.count - lit_start));
+}
+
+static const Eval_Arg_Template *eval_arg_template_compile(EvalExecContext *ctx, const Arg *arg) {
+    Arena *arena = eval_event_arena(ctx);
+    Eval_Arg_Template *tpl = arena_alloc_zero(arena, sizeof(*tpl));
+    EVAL_OOM_RETURN_IF_NULL(ctx, tpl, NULL);
+    tpl->kind = arg->kind;
+
+    String_View source = arg_to_sv_flat_in(ctx, arena, arg);
+    if (eval_should_stop(ctx)) return NULL;
+    if (arg->kind == ARG_QUOTED) {
+        source = arg_process_quoted_literal_in(ctx, arena, source);
+        if (eval_should_stop(ctx)) return NULL;
+    }
+
+    bool generic = false;
+    if (!eval_arg_template_scan(arena, tpl, source, &generic)) {
+        if (generic) return &s_eval_arg_template_generic;
+        ctx_oom(ctx);
+        return NULL;
+    }
+
+    bool has_slots = false;
+    for (size_t i = 0; i < arena_arr_len(tpl->segments); i++) {
+        if (tpl->segments[i].kind != EVAL_ARG_SEG_LITERAL) has_slots = true;
+    }
+    if (has_slots) {
+        // Bracket content is stripped after expansion, which a template
+        // cannot reproduce without rescanning.
+        return arg->kind == ARG_BRACKET ? &s_eval_arg_template_generic : tpl;
+    }
+
+    tpl->literal = true;
+    bool ok = true;
+    if (arg->kind == ARG_QUOTED) {
+        ok = sv_list_push(arena, &tpl->items, source);
+    } else if (arg->kind == ARG_BRACKET) {
+        String_View stripped = source;
+        (void)sv_strip_cmake_bracket_arg(source, &stripped);
+        ok = sv_list_push(arena, &tpl->items, stripped);
+    } else if (source.count > 0) {
+        ok = eval_sv_split_semicolon_genex_aware(arena, source, &tpl->items);
+    }
+    if (!ok) {
+        ctx_oom(ctx);
+        return NULL;
+    }
+    return tpl;
+}
+
+// Returns the template for `arg`, or NULL when the generic path should run.
+// Arguments are compiled only once they execute a second time in a session.
+static const Eval_Arg_Template *eval_arg_template_get(EvalExecContext *ctx, const Arg *arg) {
+    Arg_Cache *cache = arg->cache;
+    if (!cache || !ctx->session) return NULL;
+    size_t owner = ctx->session->instance_id;
+    if (cache->compiled_owner != owner) {
+        cache->compiled_owner = owner;
+        cache->compiled = NULL;
+        return NULL;
+    }
+    if (!cache->compiled) {
+        cache->compiled = eval_arg_template_compile(ctx, arg);
+        if (!cache->compiled) return NULL;
+    }
+    const Eval_Arg_Template *tpl = (const Eval_Arg_Template*)cache->compiled;
+    return tpl == &s_eval_arg_template_generic ? NULL : tpl;
+}
+
+static void eval_arg_template_copy_value(char *dst, String_View value, bool quoted) {
+    bool has_sentinel = memchr(value.data, EVAL_ESCAPED_DOLLAR_SENTINEL, value.count) != NULL ||
+                        (quoted && memchr(value.data, EVAL_LITERAL_BS_BEFORE_DOLLAR_SENTINEL, value.count) != NULL);
+    if (!has_sentinel) {
+        memcpy(dst, value.data, value.count);
+        return;
+    }
+    // Mirrors the sentinel restoration the generic expander applies to its
+    // whole output.
+    for (size_t i = 0; i < value.count; i++) {
+        char ch = value.data[i];
+        if (ch == EVAL_ESCAPED_DOLLAR_SENTINEL) ch = '$';
+        else if (quoted && ch == EVAL_LITERAL_BS_BEFORE_DOLLAR_SENTINEL) ch = '\\';
+        dst[i] = ch;
+    }
+}
+
+static bool eval_arg_template_resolve(EvalExecContext *ctx, const Eval_Arg_Template *tpl, SV_List *out) {
+    if (tpl->literal) {
+        for (size_t i = 0; i < arena_arr_len(tpl->items); i++) {
+            if (!sv_list_push(ctx->arena, out, tpl->items[i])) return ctx_oom(ctx);
+        }
+        return true;
+    }
+
+    size_t seg_count = arena_arr_len(tpl->segments);
+    String_View *values = (String_View*)arena_alloc(ctx->arena, seg_count * sizeof(*values));
+    EVAL_OOM_RETURN_IF_NULL(ctx, values, false);
+    size_t total = tpl->literal_bytes;
+    for (size_t i = 0; i < seg_count; i++) {
+        const Eval_Arg_Segment *seg = &tpl->segments[i];
+        values[i] = seg->text;
+        if (seg->kind == EVAL_ARG_SEG_VAR) {
+            if (!eval_macro_bind_get(ctx, seg->text, &values[i])) values[i] = eval_var_get_visible(ctx, seg->text);
+            total += values[i].count;
+        } else if (seg->kind == EVAL_ARG_SEG_ENV) {
+            const char *env = eval_getenv_temp(ctx, seg->text.data);
+            values[i] = env ? nob_sv_from_cstr(env) : nob_sv_from_cstr("");
+            total += values[i].count;
+        }
+    }
+    if (eval_should_stop(ctx)) return false;
+
+    char *buf = (char*)arena_alloc(ctx->arena, total + 1);
+    EVAL_OOM_RETURN_IF_NULL(ctx, buf, false);
+    size_t off = 0;
+    bool quoted = tpl->kind == ARG_QUOTED;
+    for (size_t i = 0; i < seg_count; i++) {
+        if (values[i].count == 0) continue;
+        if (tpl->segments[i].kind == EVAL_ARG_SEG_LITERAL) {
+            memcpy(buf + off, values[i].data, values[i].count);
+        } else {
+            eval_arg_template_copy_value(buf + off, values[i], quoted);
+        }
+        off += values[i].count;
+    }
+    buf[off] = '\0';
+    String_View value = nob_sv_from_parts(buf, off);
+
+    if (quoted) return sv_list_push(ctx->arena, out, value) || ctx_oom(ctx);
+    if (value.count == 0) return true;
+    return eval_sv_split_semicolon_genex_aware(ctx->arena, value, out) || ctx_oom(ctx);
+}
+
 static SV_List eval_resolve_args_impl(EvalExecContext *ctx,
                                       const Args *raw_args,
                                       bool expand_vars,
@@ -2232,6 +2648,15 @@ static SV_List eval_resolve_args_impl(EvalExecContext *ctx,
     for (size_t i = 0; i < arena_arr_len(*raw_args); i++) {
         const Arg *arg = &(*raw_args)[i];
 
+        if (expand_vars && split_unquoted_lists) {
+            const Eval_Arg_Template *tpl = eval_arg_template_get(ctx, arg);
+            if (eval_should_stop(ctx)) return (SV_List){0};
+            if (tpl) {
+                if (!eval_arg_template_resolve(ctx, tpl, &out)) return (SV_List){0};
+                continue;
+            }
+        }
+
         String_View flat = arg_to_sv_flat(ctx, arg);
 
         if (arg->kind == ARG_QUOTED) {
@@ -2291,6 +2716,48 @@ SV_List eval_resolve_args_literal(EvalExecContext *ctx, const Args *raw_args) {
 // Native command registration/lookup
 // -----------------------------------------------------------------------------
 
+// Dispatch caches on AST nodes compare generations drawn from this counter.
+// Values are never reused, so a stale node cannot match a different registry
+// or user command list that happens to live at the same address.
+static size_t s_eval_dispatch_generation = 0;
+
+size_t eval_dispatch_generation_next(void) {
+    return ++s_eval_dispatch_generation;
+}
+
+#define EVAL_NATIVE_LOOKUP_STACK_KEY 128
+
+size_t eval_command_name_hash_ci(String_View name) {
+    size_t h = (size_t)2166136261u;
+    for (size_t i = 0; i < name.count; i++) {
+        h ^= (size_t)(unsigned char)toupper((unsigned char)name.data[i]);
+        h *= (size_t)16777619u;
+    }
+    return h;
+}
+
+static bool eval_command_name_matches_upper(String_View name, const char *upper) {
+    if (!upper) return false;
+    for (size_t i = 0; i < name.count; i++) {
+        if (upper[i] == '\0') return false;
+        if ((char)toupper((unsigned char)name.data[i]) != upper[i]) return false;
+    }
+    return upper[name.count] == '\0';
+}
+
+static bool eval_registry_builtin_index_reserve(EvalRegistry *registry, size_t builtin_count) {
+    size_t want = 16;
+    while (want < builtin_count * 2) want <<= 1;
+    if (registry->builtin_index && registry->builtin_index_capacity >= want) return true;
+
+    Eval_Command_Name_Slot *slots =
+        (Eval_Command_Name_Slot*)arena_alloc(registry->arena, want * sizeof(*slots));
+    if (!slots) return false;
+    registry->builtin_index = slots;
+    registry->builtin_index_capacity = want;
+    return true;
+}
+
 static bool eval_registry_index_rebuild(EvalRegistry *registry) {
     if (!registry) return false;
 
@@ -2300,39 +2767,85 @@ static bool eval_registry_index_rebuild(EvalRegistry *registry) {
     }
 
     size_t count = arena_arr_len(registry->native_commands);
+    size_t builtin_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (registry->native_commands[i].is_builtin) builtin_count++;
+    }
+    if (!eval_registry_builtin_index_reserve(registry, builtin_count)) return false;
+    for (size_t i = 0; i < registry->builtin_index_capacity; i++) {
+        registry->builtin_index[i].hash = 0;
+        registry->builtin_index[i].command_index = SIZE_MAX;
+    }
+
+    // Builtins land in the fixed slot table; only commands registered at
+    // runtime go through the string-keyed stb_ds index.
+    size_t mask = registry->builtin_index_capacity - 1;
     for (size_t i = 0; i < count; i++) {
         Eval_Native_Command *cmd = &registry->native_commands[i];
         if (!cmd->normalized_name) {
             cmd->normalized_name = sv_ascii_upper_copy(registry->arena, cmd->name);
             if (!cmd->normalized_name) return false;
         }
-        stbds_shput(registry->native_command_index, cmd->normalized_name, i);
+        if (!cmd->is_builtin) {
+            stbds_shput(registry->native_command_index, cmd->normalized_name, i);
+            continue;
+        }
+        size_t hash = eval_command_name_hash_ci(cmd->name);
+        size_t slot = hash & mask;
+        while (registry->builtin_index[slot].command_index != SIZE_MAX) slot = (slot + 1) & mask;
+        registry->builtin_index[slot].hash = hash;
+        registry->builtin_index[slot].command_index = i;
     }
 
+    registry->generation = eval_dispatch_generation_next();
     return true;
 }
 
-const Eval_Native_Command *eval_registry_find_const(const EvalRegistry *registry, String_View name) {
-    if (!registry || !name.data || name.count == 0) return NULL;
-    if (!registry->native_command_index) return NULL;
+static bool eval_registry_find_index(const EvalRegistry *registry, String_View name, size_t *out_index) {
+    if (!registry || !name.data || name.count == 0) return false;
+    size_t count = arena_arr_len(registry->native_commands);
 
-    char *lookup_key = sv_ascii_upper_heap(name);
-    if (!lookup_key) return NULL;
+    if (registry->builtin_index) {
+        size_t hash = eval_command_name_hash_ci(name);
+        size_t mask = registry->builtin_index_capacity - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const Eval_Command_Name_Slot *entry = &registry->builtin_index[slot];
+            if (entry->command_index == SIZE_MAX) break;
+            if (entry->hash != hash || entry->command_index >= count) continue;
+            if (eval_command_name_matches_upper(name, registry->native_commands[entry->command_index].normalized_name)) {
+                *out_index = entry->command_index;
+                return true;
+            }
+        }
+    }
 
-    Eval_Native_Command_Index_Entry *index = registry->native_command_index;
-    Eval_Native_Command_Index_Entry *entry = stbds_shgetp_null(index, lookup_key);
-    if (!entry) {
-        free(lookup_key);
-        return NULL;
+    if (!registry->native_command_index) return false;
+
+    // Runtime-registered names are short in practice; keep the probe key on
+    // the stack and only fall back to the heap for oversized names.
+    char stack_key[EVAL_NATIVE_LOOKUP_STACK_KEY];
+    char *lookup_key = stack_key;
+    if (name.count >= sizeof(stack_key)) {
+        lookup_key = (char*)malloc(name.count + 1);
+        if (!lookup_key) return false;
     }
-    if (entry->value >= arena_arr_len(registry->native_commands)) {
-        free(lookup_key);
-        return NULL;
+    for (size_t i = 0; i < name.count; i++) {
+        lookup_key[i] = (char)toupper((unsigned char)name.data[i]);
     }
+    lookup_key[name.count] = '\0';
 
-    const Eval_Native_Command *out = &registry->native_commands[entry->value];
-    free(lookup_key);
-    return out;
+    Eval_Native_Command_Index_Entry *index = registry->native_command_index;
+    Eval_Native_Command_Index_Entry *entry = stbds_shgetp_null(index, lookup_key);
+    bool found = entry && entry->value < count;
+    if (found) *out_index = entry->value;
+    if (lookup_key != stack_key) free(lookup_key);
+    return found;
+}
+
+const Eval_Native_Command *eval_registry_find_const(const EvalRegistry *registry, String_View name) {
+    size_t index = 0;
+    if (!eval_registry_find_index(registry, name, &index)) return NULL;
+    return &registry->native_commands[index];
 }
 
 static Eval_Native_Command *eval_registry_find(EvalRegistry *registry, String_View name) {
@@ -2367,33 +2880,16 @@ bool eval_registry_unregister_internal(EvalRegistry *registry,
                                        bool allow_builtin_remove) {
     if (!registry || name.count == 0 || !name.data) return false;
     if (registry->mutation_blocked) return false;
-    if (!registry->native_command_index) return false;
-
-    char *lookup_key = sv_ascii_upper_heap(name);
-    if (!lookup_key) return false;
 
-    Eval_Native_Command_Index_Entry *entry = stbds_shgetp_null(registry->native_command_index, lookup_key);
-    if (!entry) {
-        free(lookup_key);
-        return false;
-    }
-
-    size_t idx = entry->value;
+    size_t idx = 0;
+    if (!eval_registry_find_index(registry, name, &idx)) return false;
     size_t count = arena_arr_len(registry->native_commands);
-    if (idx >= count) {
-        free(lookup_key);
-        return false;
-    }
-    if (registry->native_commands[idx].is_builtin && !allow_builtin_remove) {
-        free(lookup_key);
-        return false;
-    }
+    if (registry->native_commands[idx].is_builtin && !allow_builtin_remove) return false;
 
     for (size_t j = idx + 1; j < count; j++) {
         registry->native_commands[j - 1] = registry->native_commands[j];
     }
     arena_arr_set_len(registry->native_commands, count - 1);
-    free(lookup_key);
     return eval_registry_index_rebuild(registry);
 }
 
@@ -2436,7 +2932,7 @@ bool eval_scope_push(EvalExecContext *ctx) {
     if (depth < arena_arr_len(scope->scopes)) {
         Var_Scope *s = &scope->scopes[depth];
         if (s->vars) {
-            stbds_shfree(s->vars);
+            stbds_hmfree(s->vars);
             s->vars = NULL;
         }
     } else {
@@ -2453,8 +2949,11 @@ void eval_scope_pop(EvalExecContext *ctx) {
         Eval_Scope_State *scope = eval_scope_slice(ctx);
         Var_Scope *s = &scope->scopes[eval_scope_visible_depth(ctx) - 1];
         if (s->vars) {
-            stbds_shfree(s->vars);
+            (void)eval_command_tx_note_scope_table(ctx, eval_scope_visible_depth(ctx) - 1);
+            stbds_hmfree(s->vars);
             s->vars = NULL;
+            // A knob set in the popped scope may have shadowed the parent's.
+            ctx->runtime_state.compat_dirty = true;
         }
         scope->visible_scope_depth--;
     }
@@ -2499,7 +2998,7 @@ static void eval_scope_state_reset_for_session(Eval_Scope_State *scope) {
     if (scope->scopes && arena_arr_len(scope->scopes) > 1) {
         for (size_t i = 1; i < arena_arr_len(scope->scopes); i++) {
             if (scope->scopes[i].vars) {
-                stbds_shfree(scope->scopes[i].vars);
+                stbds_hmfree(scope->scopes[i].vars);
                 scope->scopes[i].vars = NULL;
             }
         }
@@ -2508,6 +3007,8 @@ static void eval_scope_state_reset_for_session(Eval_Scope_State *scope) {
 
     scope->visible_scope_depth = arena_arr_len(scope->scopes) > 0 ? 1 : 0;
     if (scope->macro_frames) arena_arr_set_len(scope->macro_frames, 0);
+    if (scope->macro_bindings) arena_arr_set_len(scope->macro_bindings, 0);
+    if (scope->macro_buckets) memset(scope->macro_buckets, 0, scope->macro_bucket_count * sizeof(*scope->macro_buckets));
     if (scope->block_frames) arena_arr_set_len(scope->block_frames, 0);
     if (scope->return_propagate_vars) arena_arr_set_len(scope->return_propagate_vars, 0);
 }
@@ -2520,6 +3021,7 @@ static void eval_exec_load_session_state(EvalExecContext *ctx, EvalSession *sess
     ctx->session = session;
     ctx->event_arena = session->persistent_arena;
     ctx->transaction_arena = session->state.transaction_arena;
+    ctx->transaction_undo_arena = session->state.transaction_undo_arena;
     ctx->registry = session->state.registry;
     ctx->services = session->state.services;
     ctx->scope_state = session->state.scope_state;
@@ -2531,6 +3033,7 @@ static void eval_exec_load_session_state(EvalExecContext *ctx, EvalSession *sess
     ctx->policy_levels = session->state.policy_levels;
     ctx->visible_policy_depth = session->state.visible_policy_depth;
     ctx->runtime_state = session->state.runtime_state;
+    ctx->runtime_state.compat_dirty = true;
     ctx->cpack_module_loaded = session->state.cpack_module_loaded;
     ctx->cpack_component_module_loaded = session->state.cpack_component_module_loaded;
     ctx->fetchcontent_module_loaded = session->state.fetchcontent_module_loaded;
@@ -2576,6 +3079,7 @@ static void eval_session_commit_state_from_exec(EvalSession *session, const Eval
     session->state.runtime_state.run_report = (Eval_Run_Report){0};
     session->state.runtime_state.in_variable_watch_notification = false;
     session->state.transaction_arena = exec->transaction_arena;
+    session->state.transaction_undo_arena = exec->transaction_undo_arena;
     session->state.cpack_module_loaded = exec->cpack_module_loaded;
     session->state.cpack_component_module_loaded = exec->cpack_component_module_loaded;
     session->state.fetchcontent_module_loaded = exec->fetchcontent_module_loaded;
@@ -2627,6 +3131,9 @@ static bool eval_exec_bind_request(EvalExecContext *ctx,
 
     ctx->scope_state.visible_scope_depth = 1;
     ctx->scope_state.macro_frames = NULL;
+    ctx->scope_state.macro_bindings = NULL;
+    ctx->scope_state.macro_buckets = NULL;
+    ctx->scope_state.macro_bucket_count = 0;
     ctx->scope_state.block_frames = NULL;
     ctx->scope_state.return_propagate_vars = NULL;
     ctx->message_check_stack = NULL;
@@ -2661,6 +3168,7 @@ static bool eval_exec_bind_request(EvalExecContext *ctx,
         return false;
     }
     if (!eval_var_set_current(ctx, nob_sv_from_cstr("CMAKE_CURRENT_LIST_LINE"), nob_sv_from_cstr("0"))) return false;
+    ctx->scope_state.current_list_line_symbol = eval_symbol_find(ctx, nob_sv_from_cstr("CMAKE_CURRENT_LIST_LINE"));
     if (!eval_var_set_current(ctx, nob_sv_from_cstr(EVAL_VAR_NOBIFY_POLICY_STACK_DEPTH), nob_sv_from_cstr("1"))) return false;
 
     if (ctx->file_state.deferred_dirs) {
@@ -2745,6 +3253,11 @@ static EvalSession *eval_session_create_impl(const EvalSession_Config *cfg) {
     session->source_root = sv_copy_to_arena(cfg->persistent_arena, source_root);
     session->binary_root = sv_copy_to_arena(cfg->persistent_arena, binary_root);
     session->enable_export_host_effects = cfg->enable_export_host_effects;
+    session->instance_id = eval_dispatch_generation_next();
+    if (cfg->ast_cache_dir.count > 0) {
+        session->ast_cache_dir = arena_strndup(cfg->persistent_arena, cfg->ast_cache_dir.data, cfg->ast_cache_dir.count);
+        EVAL_SESSION_CREATE_REQUIRE(session->ast_cache_dir, "copy ast_cache_dir");
+    }
     EVAL_SESSION_CREATE_REQUIRE(!(source_root.count > 0 && session->source_root.count == 0), "copy source_root");
     EVAL_SESSION_CREATE_REQUIRE(!(binary_root.count > 0 && session->binary_root.count == 0), "copy binary_root");
 
@@ -2769,6 +3282,8 @@ static EvalSession *eval_session_create_impl(const EvalSession_Config *cfg) {
     session->state.runtime_state.in_variable_watch_notification = false;
 
     EVAL_SESSION_CREATE_REQUIRE(eval_attach_sub_arena(cfg->persistent_arena, &session->state.transaction_arena), "attach tx arena");
+    EVAL_SESSION_CREATE_REQUIRE(eval_attach_sub_arena(cfg->persistent_arena, &session->state.transaction_undo_arena),
+                                "attach tx undo arena");
     EVAL_SESSION_CREATE_REQUIRE(eval_attach_sub_arena(cfg->persistent_arena, &session->state.semantic_state.targets.arena),
                                 "attach targets arena");
     EVAL_SESSION_CREATE_REQUIRE(eval_attach_sub_arena(cfg->persistent_arena, &session->state.semantic_state.tests.arena),
@@ -2810,6 +3325,7 @@ static EvalSession *eval_session_create_impl(const EvalSession_Config *cfg) {
                                 "set CURRENT_LIST_FILE");
     EVAL_SESSION_CREATE_REQUIRE(eval_var_set_current(ctx, nob_sv_from_cstr("CMAKE_CURRENT_LIST_LINE"), nob_sv_from_cstr("0")),
                                 "set CURRENT_LIST_LINE");
+    ctx->scope_state.current_list_line_symbol = eval_symbol_find(ctx, nob_sv_from_cstr("CMAKE_CURRENT_LIST_LINE"));
     EVAL_SESSION_CREATE_REQUIRE(eval_var_set_current(ctx,
                                                      nob_sv_from_cstr(EVAL_VAR_NOBIFY_POLICY_STACK_DEPTH),
                                                      nob_sv_from_cstr("1")),
@@ -2946,6 +3462,8 @@ void eval_registry_destroy(EvalRegistry *registry) {
         stbds_shfree(registry->native_command_index);
         registry->native_command_index = NULL;
     }
+    registry->builtin_index = NULL;
+    registry->builtin_index_capacity = 0;
     registry->builtins_seeded = false;
 }
 
@@ -2984,7 +3502,7 @@ void eval_session_destroy(EvalSession *session) {
 
     EvalSessionState *state = &session->state;
     if (state->scope_state.cache_entries) {
-        stbds_shfree(state->scope_state.cache_entries);
+        stbds_hmfree(state->scope_state.cache_entries);
         state->scope_state.cache_entries = NULL;
     }
     if (state->process_state.env_overrides) {
@@ -2993,10 +3511,30 @@ void eval_session_destroy(EvalSession *session) {
     }
     for (size_t i = 0; i < arena_arr_len(state->scope_state.scopes); i++) {
         if (state->scope_state.scopes[i].vars) {
-            stbds_shfree(state->scope_state.scopes[i].vars);
+            stbds_hmfree(state->scope_state.scopes[i].vars);
             state->scope_state.scopes[i].vars = NULL;
         }
     }
+    free(state->scope_state.symbols.slots);
+    state->scope_state.symbols = (Eval_Symbol_Table){0};
+    eval_property_engine_free(&state->semantic_state.properties);
+    if (state->scope_state.list_buffers) {
+        stbds_hmfree(state->scope_state.list_buffers);
+        state->scope_state.list_buffers = NULL;
+    }
+    if (session->ast_cache) {
+        stbds_shfree(session->ast_cache);
+        session->ast_cache = NULL;
+    }
+    if (session->inline_ast_cache) {
+        stbds_shfree(session->inline_ast_cache);
+        session->inline_ast_cache = NULL;
+    }
+    if (session->dir_cache) {
+        stbds_shfree(session->dir_cache);
+        session->dir_cache = NULL;
+    }
+    eval_regex_cache_free(session);
     if (session->owns_registry && state->registry) {
         eval_registry_destroy(state->registry);
         state->registry = NULL;
@@ -3013,7 +3551,7 @@ EvalRunResult eval_session_run(EvalSession *session,
     Event_Stream *effective_stream = request->stream ? request->stream : event_stream_create(request->scratch_arena);
     if (!effective_stream) return out;
 
-    size_t emitted_before = request->stream ? request->stream->count : 0;
+    size_t emitted_before = request->stream ? request->stream->pushed_count : 0;
     EvalExecContext exec = {0};
     eval_exec_load_session_state(&exec, session);
     if (session->state.registry) session->state.registry->mutation_blocked = true;
@@ -3031,7 +3569,7 @@ EvalRunResult eval_session_run(EvalSession *session,
 
     out.result = eval_context_run_prepared(&exec, ast);
     out.report = exec.runtime_state.run_report;
-    out.emitted_event_count = request->stream ? (request->stream->count - emitted_before) : 0;
+    out.emitted_event_count = request->stream ? (request->stream->pushed_count - emitted_before) : 0;
     session->last_run_report = out.report;
     if (session->state.registry) session->state.registry->mutation_blocked = false;
     eval_session_commit_state_from_exec(session, &exec);
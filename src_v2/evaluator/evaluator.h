@@ -118,6 +118,19 @@ typedef struct {
     size_t io_env_error_count;
     size_t policy_conflict_count;
     size_t unsupported_count;
+    size_t ast_cache_hits;   // include/find_package files served from the session AST cache
+    size_t ast_cache_misses; // files read, lexed and parsed during this run
+    size_t ast_disk_cache_hits; // misses above that were loaded from the on-disk AST cache
+    size_t regex_cache_hits;   // regex lookups served by the session pattern cache
+    size_t regex_cache_misses; // patterns compiled during this run
+    size_t dir_cache_hits;     // glob directory listings served from the session cache
+    size_t dir_cache_misses;   // glob directory listings read from the filesystem
+    size_t inline_ast_cache_hits;   // cmake_language(EVAL CODE) payloads served from the session cache
+    size_t inline_ast_cache_misses; // payloads lexed and parsed during this run
+    size_t cond_program_hits;   // if()/while() conditions run from a cached program
+    size_t cond_program_builds; // condition programs compiled and stored on the AST node
+    size_t tx_undo_entries;    // command-transaction undo journal entries recorded
+    size_t tx_snapshot_bytes;  // bytes copied into command-transaction snapshots
     Eval_Run_Overall_Status overall_status;
 } Eval_Run_Report;
 
@@ -217,6 +230,7 @@ typedef struct {
     Eval_Compat_Profile compat_profile;
     String_View source_root;
     String_View binary_root;
+    String_View ast_cache_dir; /* optional; enables the on-disk AST cache (see ast_cache.h) */
     bool enable_export_host_effects;
 } EvalSession_Config;
 
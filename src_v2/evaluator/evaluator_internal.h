@@ -48,6 +48,9 @@ extern "C" {
 #define EVAL_POLICY_CMP0153 "CMP0153"
 #define EVAL_POLICY_CMP0174 "CMP0174"
 
+// Marks `\$` during variable expansion so the dollar survives as a literal.
+#define EVAL_ESCAPED_DOLLAR_SENTINEL '\x1f'
+
 typedef String_View *SV_List;
 
 typedef struct {
@@ -75,6 +78,53 @@ typedef struct Var_Scope {
     Eval_Var_Entry *vars;
 } Var_Scope;
 
+// Interned variable name. `name` is NUL-terminated and lives as long as the
+// session; scope and cache tables are stb_ds hm maps keyed by that pointer.
+typedef struct {
+    char *name;
+    size_t len;
+    size_t hash;
+} Eval_Symbol;
+
+typedef struct {
+    Eval_Symbol *slots; // open addressing, power-of-two capacity, heap-owned
+    size_t capacity;
+    size_t count;
+} Eval_Symbol_Table;
+
+// Growable backing store for values built by list(APPEND/PREPEND). Live bytes
+// occupy [lo, hi) of `base`; a view ending at `hi` may grow in place and a
+// view starting at `lo` may grow backwards, so bytes that an older view
+// covers are never rewritten.
+typedef struct {
+    char *base;
+    size_t capacity;
+    size_t lo;
+    size_t hi;
+} Eval_List_Buffer;
+
+typedef struct {
+    char *key; // first byte of a variable value stored in `value`
+    Eval_List_Buffer *value;
+} Eval_List_Buffer_Entry;
+
+// stb_ds's hm* macros take the key address through GNU `typeof`, which gcc
+// rejects under -std=c11; symbol-keyed tables pass an lvalue key instead.
+#define EVAL_SYMBOL_MAP_GETP(t, sym)                                                                  \
+    ((t) = stbds_hmget_key_wrapper((t), sizeof *(t), (void*)&(sym), sizeof (t)->key, STBDS_HM_BINARY), \
+     stbds_temp((t) - 1) == -1 ? NULL : &(t)[stbds_temp((t) - 1)])
+#define EVAL_SYMBOL_MAP_PUT(t, sym, v)                                                                \
+    ((t) = stbds_hmput_key_wrapper((t), sizeof *(t), (void*)&(sym), sizeof (t)->key, STBDS_HM_BINARY), \
+     (t)[stbds_temp((t) - 1)].key = (sym),                                                             \
+     (t)[stbds_temp((t) - 1)].value = (v))
+#define EVAL_SYMBOL_MAP_DEL(t, sym)                                                                   \
+    ((t) = stbds_hmdel_key_wrapper((t),                                                                \
+                                   sizeof *(t),                                                        \
+                                   (void*)&(sym),                                                      \
+                                   sizeof (t)->key,                                                    \
+                                   STBDS_OFFSETOF((t), key),                                           \
+                                   STBDS_HM_BINARY))
+
 typedef enum {
     USER_CMD_FUNCTION = 0,
     USER_CMD_MACRO,
@@ -85,6 +135,7 @@ typedef struct {
     User_Command_Kind kind;
     String_View *params;
     Node_List body;
+    size_t shadowed_index; // previous definition of the same name, or SIZE_MAX
 } User_Command;
 
 typedef User_Command *User_Command_List;
@@ -126,10 +177,34 @@ typedef struct Eval_Native_Command_Index_Entry {
     size_t value;
 } Eval_Native_Command_Index_Entry;
 
-typedef Var_Binding *Macro_Binding_List;
+// Slot of an open-addressed, case-insensitive command name table (builtin
+// commands and user commands). Empty slots carry SIZE_MAX as command_index.
+typedef struct {
+    size_t hash;
+    size_t command_index;
+} Eval_Command_Name_Slot;
+
+typedef enum {
+    EVAL_NODE_DISPATCH_UNRESOLVED = 0,
+    EVAL_NODE_DISPATCH_NATIVE,
+    EVAL_NODE_DISPATCH_USER,
+    EVAL_NODE_DISPATCH_UNKNOWN,
+} Eval_Node_Dispatch_Kind;
+
+// Bindings of every active macro frame share one stack; a frame records
+// where its bindings start. Buckets chain bindings newest-first, so the first
+// match is the innermost one and popping a frame only relinks bucket heads.
+typedef struct {
+    String_View key;
+    String_View value;
+    size_t hash;
+    size_t next; // older binding in the same bucket, as index + 1; 0 ends the chain
+} Macro_Binding;
+
+typedef Macro_Binding *Macro_Binding_List;
 
 typedef struct {
-    Macro_Binding_List bindings;
+    size_t first_binding;
 } Macro_Frame;
 
 typedef Macro_Frame *Macro_Frame_Stack;
@@ -302,7 +377,13 @@ typedef struct {
     // Invariant: visible_scope_depth <= arena_arr_len(scopes)
     size_t visible_scope_depth;
     Eval_Cache_Entry *cache_entries;
+    Eval_Symbol_Table symbols;
+    char *current_list_line_symbol;       // reads resolve to EvalExecContext.current_list_line
+    Eval_List_Buffer_Entry *list_buffers; // stb_ds hm map keyed by value start
     Macro_Frame_Stack macro_frames;
+    Macro_Binding_List macro_bindings;
+    size_t *macro_buckets; // chain heads (binding index + 1), power-of-two count
+    size_t macro_bucket_count;
     Block_Frame_Stack block_frames;
     String_View *return_propagate_vars;
 } Eval_Scope_State;
@@ -313,6 +394,9 @@ typedef struct {
     size_t error_budget;
     // Snapshot refreshed at command-cycle boundary (eval_node entry).
     bool continue_on_error_snapshot;
+    // Set when a CMAKE_NOBIFY_* knob may have changed; the next refresh
+    // re-reads them and clears it.
+    bool compat_dirty;
     Eval_Run_Report run_report;
     bool in_variable_watch_notification;
 } Eval_Runtime_State;
@@ -448,14 +532,46 @@ typedef struct {
 
 typedef Eval_Property_Record *Eval_Property_Record_List;
 
+typedef struct {
+    size_t hash;
+    size_t index; // SIZE_MAX marks an empty slot
+} Eval_Property_Slot;
+
+// Property records plus hash indexes over them. The indexes are derived,
+// heap-owned state: pushes extend them and rollback truncation unwinds them
+// through eval_property_engine_truncate().
 typedef struct {
     Eval_Property_Record_List records;
+    Eval_Property_Slot *record_slots;     // (scope, object, property) -> record
+    size_t record_slot_capacity;
+    Eval_Property_Slot *family_slots;     // (scope, property) -> newest record
+    size_t family_slot_capacity;
+    size_t *family_prev;                  // per record: older record of its family
+    size_t family_prev_capacity;
+    size_t indexed_record_count;
+    Eval_Property_Slot *definition_slots; // (scope, property) -> definition
+    size_t definition_slot_capacity;
+    size_t indexed_definition_count;
+    bool index_broken;                    // set after OOM; lookups scan linearly
 } Eval_Property_Engine;
 
+// Slot of the target name table. A name can be a record, a registered alias,
+// or both; empty slots carry SIZE_MAX in both indexes.
+typedef struct {
+    size_t hash;
+    size_t record_index;
+    size_t alias_index;
+} Eval_Target_Name_Slot;
+
 typedef struct {
     Arena *arena;
     Eval_Target_Record_List records;
     SV_List aliases;
+    Eval_Target_Name_Slot *name_index;
+    size_t name_index_capacity;
+    size_t name_index_entries;
+    size_t indexed_record_count;
+    size_t indexed_alias_count;
 } Eval_Target_Model;
 
 typedef struct {
@@ -531,6 +647,11 @@ typedef struct {
 typedef struct {
     Arena *user_commands_arena;
     User_Command_List user_commands;
+    size_t user_commands_generation;
+    Eval_Command_Name_Slot *user_command_index;
+    size_t user_command_index_capacity;
+    size_t user_command_index_count;
+    size_t user_command_index_generation;
     SV_List watched_variables;
     SV_List watched_variable_commands;
 } Eval_Command_State;
@@ -618,33 +739,6 @@ typedef struct {
     size_t count;
 } Eval_Var_Table_Snapshot;
 
-typedef struct {
-    Eval_Cache_Entry *entries;
-    size_t count;
-} Eval_Cache_Table_Snapshot;
-
-typedef struct {
-    Eval_Process_Env_Entry *entries;
-    size_t count;
-} Eval_Process_Env_Table_Snapshot;
-
-typedef struct {
-    String_View source_dir;
-    String_View binary_dir;
-    String_View parent_source_dir;
-    String_View parent_binary_dir;
-    String_View *declared_targets;
-    size_t declared_target_count;
-    String_View *declared_tests;
-    size_t declared_test_count;
-    Var_Binding *definition_bindings;
-    size_t definition_binding_count;
-    String_View *macro_names;
-    size_t macro_name_count;
-    String_View *listfile_stack;
-    size_t listfile_stack_count;
-} Eval_Directory_Node_Snapshot;
-
 typedef struct {
     String_View source_dir;
     String_View binary_dir;
@@ -652,6 +746,74 @@ typedef struct {
     size_t call_count;
 } Eval_Deferred_Dir_Frame_Snapshot;
 
+// Array slices covered by command transactions. Appends are undone by
+// truncating back to the length captured at tx begin; in-place writes and
+// structural edits must be journaled through eval_command_tx_note_*().
+typedef enum {
+    EVAL_TX_SLICE_MESSAGE_CHECK = 0,
+    EVAL_TX_SLICE_DIRECTORY_NODES,
+    EVAL_TX_SLICE_PROPERTY_RECORDS,
+    EVAL_TX_SLICE_TARGET_RECORDS,
+    EVAL_TX_SLICE_TARGET_ALIASES,
+    EVAL_TX_SLICE_TEST_RECORDS,
+    EVAL_TX_SLICE_INSTALL_COMPONENTS,
+    EVAL_TX_SLICE_EXPORTS,
+    EVAL_TX_SLICE_ACTIVE_FIND_PACKAGES,
+    EVAL_TX_SLICE_FOUND_PACKAGES,
+    EVAL_TX_SLICE_NOT_FOUND_PACKAGES,
+    EVAL_TX_SLICE_PACKAGE_REGISTRY,
+    EVAL_TX_SLICE_FILE_API_QUERIES,
+    EVAL_TX_SLICE_FETCHCONTENT_DECLARATIONS,
+    EVAL_TX_SLICE_FETCHCONTENT_STATES,
+    EVAL_TX_SLICE_ACTIVE_MAKEAVAILABLE,
+    EVAL_TX_SLICE_USER_COMMANDS,
+    EVAL_TX_SLICE_WATCHED_VARIABLES,
+    EVAL_TX_SLICE_WATCHED_VARIABLE_COMMANDS,
+    EVAL_TX_SLICE_PROPERTY_DEFINITIONS,
+    EVAL_TX_SLICE_FILE_GENERATE_JOBS,
+    EVAL_TX_SLICE_DEFERRED_DIRS,
+    EVAL_TX_SLICE_GENERATED_DEFERRED_IDS,
+    EVAL_TX_SLICE_CUSTOM_COMMAND_OUTPUT_STEPS,
+    EVAL_TX_SLICE_CANONICAL_ARTIFACTS,
+    EVAL_TX_SLICE_CTEST_STEPS,
+    EVAL_TX_SLICE_COUNT,
+} Eval_Tx_Slice;
+
+typedef enum {
+    EVAL_TX_UNDO_VAR = 0,
+    EVAL_TX_UNDO_SCOPE_TABLE,
+    EVAL_TX_UNDO_CACHE,
+    EVAL_TX_UNDO_ENV,
+    EVAL_TX_UNDO_ELEM,
+    EVAL_TX_UNDO_NESTED,
+    EVAL_TX_UNDO_SLICE,
+} Eval_Tx_Undo_Kind;
+
+typedef struct {
+    Eval_Tx_Undo_Kind kind;
+    Eval_Tx_Slice slice;
+    bool had_old;
+    size_t index;
+    size_t field_offset;
+    char *key;
+    union {
+        String_View var_value;
+        Eval_Cache_Value cache_value;
+        Eval_Process_Env_Value env_value;
+        Eval_Var_Table_Snapshot scope_table;
+        struct {
+            void *items;
+            size_t count;
+        } bytes;
+        struct {
+            Eval_Deferred_Dir_Frame_Snapshot *frames;
+            size_t count;
+        } deferred_dirs;
+    } as;
+} Eval_Tx_Undo_Entry;
+
+typedef Eval_Tx_Undo_Entry *Eval_Tx_Undo_Log;
+
 typedef enum {
     EVAL_TX_PROJECTION_EVENT = 0,
     EVAL_TX_PROJECTION_DIAG,
@@ -690,72 +852,16 @@ typedef struct Eval_Command_Transaction {
     size_t pending_error_count;
     Eval_Tx_Projection_List projections;
 
-    Eval_Var_Table_Snapshot *scope_vars;
-    size_t scope_var_count;
+    // Undo entries at or after undo_start belong to this transaction.
+    size_t undo_start;
+    uint32_t journaled_slices;
+    size_t slice_counts[EVAL_TX_SLICE_COUNT];
+    size_t scope_count;
     size_t visible_scope_depth;
 
-    Eval_Cache_Table_Snapshot cache_entries;
-    Eval_Process_Env_Table_Snapshot env_overrides;
-
-    String_View *message_check_stack;
-    size_t message_check_count;
-
-    Eval_Directory_Node_Snapshot *directory_nodes;
-    size_t directory_node_count;
-    Eval_Property_Record *property_records;
-    size_t property_record_count;
-    Eval_Target_Record *target_records;
-    size_t target_record_count;
-    String_View *target_aliases;
-    size_t target_alias_count;
-    Eval_Test_Record *test_records;
-    size_t test_record_count;
-    String_View *install_components;
-    size_t install_component_count;
-    String_View *export_entries;
-    size_t export_count;
-    String_View *active_find_packages;
-    size_t active_find_package_count;
-    String_View *found_packages;
-    size_t found_package_count;
-    String_View *not_found_packages;
-    size_t not_found_package_count;
-    Eval_Package_Registry_Entry *package_registry_entries;
-    size_t package_registry_entry_count;
     Eval_Dependency_Provider_State dependency_provider;
-    Eval_File_Api_Query_Record *file_api_queries;
-    size_t file_api_query_count;
     size_t file_api_next_reply_nonce;
-    Eval_FetchContent_Declaration *fetchcontent_declarations;
-    size_t fetchcontent_declaration_count;
-    Eval_FetchContent_State *fetchcontent_states;
-    size_t fetchcontent_state_count;
-    String_View *active_makeavailable;
-    size_t active_makeavailable_count;
-
-    User_Command *user_commands;
-    size_t user_command_count;
-    String_View *watched_variables;
-    size_t watched_variable_count;
-    String_View *watched_variable_commands;
-    size_t watched_variable_command_count;
-    Eval_Property_Definition *property_definitions;
-    size_t property_definition_count;
-
-    Eval_File_Generate_Job *file_generate_jobs;
-    size_t file_generate_job_count;
-    Eval_Deferred_Dir_Frame_Snapshot *deferred_dirs;
-    size_t deferred_dir_count;
-    String_View *generated_deferred_ids;
-    size_t generated_deferred_id_count;
-    struct Eval_Custom_Command_Output_Step *custom_command_output_steps;
-    size_t custom_command_output_step_count;
     size_t next_deferred_call_id;
-    Eval_Canonical_Artifact *canonical_artifacts;
-    size_t canonical_artifact_count;
-    Eval_Ctest_Step_Record *ctest_steps;
-    size_t ctest_step_count;
-
     bool cpack_module_loaded;
     bool cpack_component_module_loaded;
     bool fetchcontent_module_loaded;
@@ -774,6 +880,7 @@ typedef struct {
     size_t visible_policy_depth;
     Eval_Runtime_State runtime_state;
     Arena *transaction_arena;
+    Arena *transaction_undo_arena;
     bool cpack_module_loaded;
     bool cpack_component_module_loaded;
     bool fetchcontent_module_loaded;
@@ -784,6 +891,7 @@ struct EvalExecContext {
     Arena *arena;          // TEMP ARENA: Limpa a cada statement (usado p/ expansão de args)
     Arena *event_arena;    // PERSISTENT ARENA: storage interno do evaluator; Event_Stream owna payloads só no push
     Arena *transaction_arena;
+    Arena *transaction_undo_arena; // Undo log storage; reset when the outermost tx finishes
     Cmake_Event_Stream *stream;
     EvalRegistry *registry;
     const EvalServices *services;
@@ -793,6 +901,7 @@ struct EvalExecContext {
     Eval_Exec_Mode mode;
 
     const char *current_file;
+    size_t current_list_line; // read back through CMAKE_CURRENT_LIST_LINE
 
     Eval_Scope_State scope_state;
 
@@ -816,6 +925,7 @@ struct EvalExecContext {
     Eval_Return_Context return_context;
     Eval_Runtime_State runtime_state;
     Eval_Command_Transaction *active_transaction;
+    Eval_Tx_Undo_Log tx_undo_log;
     String_View dependency_provider_context_file;
 
     bool oom;
@@ -826,10 +936,66 @@ struct EvalRegistry {
     Arena *arena;
     Eval_Native_Command_List native_commands;
     Eval_Native_Command_Index_Entry *native_command_index;
+    Eval_Command_Name_Slot *builtin_index;
+    size_t builtin_index_capacity;
+    size_t generation;
     bool builtins_seeded;
     bool mutation_blocked;
 };
 
+// Parsed listfile kept for the lifetime of a session. A stat stamp that is
+// old enough to be trusted lets a hit skip I/O; otherwise the content hash
+// decides whether the cached tree is still current.
+typedef struct {
+    Ast_Root ast;
+    size_t size;
+    size_t content_hash;
+    long long mtime_sec;
+    long mtime_nsec;
+    bool has_stamp;
+} Eval_Ast_Cache_Value;
+
+typedef struct {
+    char *key;
+    Eval_Ast_Cache_Value value;
+} Eval_Ast_Cache_Entry;
+
+// Tree for a cmake_language(EVAL CODE) payload, keyed by the code text. The
+// tree and its source live in the persistent arena, which cannot give memory
+// back, so the cache stops admitting new payloads once
+// EVAL_INLINE_AST_CACHE_MAX_BYTES of source is held.
+#define EVAL_INLINE_AST_CACHE_MAX_BYTES (4u * 1024u * 1024u)
+
+typedef struct {
+    char *key;
+    Ast_Root value;
+} Eval_Inline_Ast_Cache_Entry;
+
+// Directory listing kept for file(GLOB_RECURSE) and the file(GLOB) fallback
+// walker. A listing is only cached while the directory's mtime is old enough
+// to be trusted, so any entry added or removed since forces a re-read.
+typedef struct {
+    String_View name;
+    bool is_dir;
+} Eval_Dir_Snapshot_Entry;
+
+typedef struct {
+    Eval_Dir_Snapshot_Entry *entries; // arena array in the persistent arena
+    long long mtime_sec;
+    long mtime_nsec;
+} Eval_Dir_Snapshot;
+
+typedef struct {
+    char *key;
+    Eval_Dir_Snapshot value;
+} Eval_Dir_Cache_Entry;
+
+// Compiled patterns shared by string(REGEX), list(FILTER/TRANSFORM REGEX),
+// if(MATCHES), file(STRINGS) and file(GET_RUNTIME_DEPENDENCIES); see
+// eval_regex_cache.h.
+#define EVAL_REGEX_CACHE_CAPACITY 64
+typedef struct Eval_Regex_Cache Eval_Regex_Cache;
+
 struct EvalSession {
     EvalSessionState state;
     Arena *persistent_arena;
@@ -837,6 +1003,13 @@ struct EvalSession {
     String_View binary_root;
     bool enable_export_host_effects;
     bool owns_registry;
+    size_t instance_id; // unique per session; stamps evaluator caches kept on AST nodes
+    Eval_Ast_Cache_Entry *ast_cache; // stb_ds string map keyed by listfile path
+    char *ast_cache_dir; // on-disk AST cache directory, or NULL when disabled
+    Eval_Inline_Ast_Cache_Entry *inline_ast_cache; // stb_ds string map keyed by script text
+    size_t inline_ast_cache_bytes; // source bytes held by inline_ast_cache
+    Eval_Regex_Cache *regex_cache; // allocated on first use
+    Eval_Dir_Cache_Entry *dir_cache; // stb_ds string map keyed by directory path
     Eval_Run_Report last_run_report;
 };
 
@@ -847,6 +1020,7 @@ void eval_request_stop_on_error(EvalExecContext *ctx);
 void eval_reset_stop_request(EvalExecContext *ctx);
 bool eval_continue_on_error(EvalExecContext *ctx);
 void eval_refresh_runtime_compat(EvalExecContext *ctx);
+void eval_compat_note_var_write(EvalExecContext *ctx, String_View key);
 bool eval_compat_set_profile(EvalExecContext *ctx, Eval_Compat_Profile profile);
 Cmake_Diag_Severity eval_compat_effective_severity(const EvalExecContext *ctx, Cmake_Diag_Severity sev);
 bool eval_compat_decide_on_diag(EvalExecContext *ctx, Cmake_Diag_Severity effective_sev);
@@ -1016,6 +1190,15 @@ static inline bool eval_mark_oom_if_null(EvalExecContext *ctx, const void *ptr)
 #define EVAL_ARR_PUSH(ctx, arena, arr, value) \
     (arena_arr_push((arena), (arr), (value)) ? true : ctx_oom((ctx)))
 
+// Used first in the eval_emit_*() helpers: when the stream is not subscribed
+// to `kind` (see event_stream_subscribe()) the helper returns what
+// eval_emit_event() would have, without copying anything for the payload.
+#define EVAL_EMIT_SKIP_UNWANTED(ctx, kind) \
+    do { if (!event_stream_wants((ctx) ? (ctx)->stream : NULL, (kind))) return !eval_should_stop(ctx); } while (0)
+
+#define EVAL_EMIT_SKIP_UNWANTED_ALLOW_STOPPED(ctx, kind) \
+    do { if (!event_stream_wants((ctx) ? (ctx)->stream : NULL, (kind))) return !(ctx)->oom; } while (0)
+
 Eval_Result eval_emit_diag(EvalExecContext *ctx,
                            Eval_Diag_Code code,
                            String_View component,
@@ -1329,6 +1512,7 @@ static inline bool eval_emit_source_mark_generated(EvalExecContext *ctx,
                                                    String_View directory_source_dir,
                                                    String_View directory_binary_dir,
                                                    bool generated) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_SOURCE_MARK_GENERATED);
     Event ev = {0};
     ev.h.kind = EVENT_SOURCE_MARK_GENERATED;
     ev.h.origin = origin;
@@ -1347,6 +1531,7 @@ static inline bool eval_emit_source_property_mutate(EvalExecContext *ctx,
                                                     String_View key,
                                                     String_View value,
                                                     Cmake_Target_Property_Op op) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_SOURCE_PROPERTY_MUTATE);
     Event ev = {0};
     ev.h.kind = EVENT_SOURCE_PROPERTY_MUTATE;
     ev.h.origin = origin;
@@ -1376,6 +1561,7 @@ static inline bool eval_emit_build_step_declare(EvalExecContext *ctx,
                                                 String_View depfile,
                                                 String_View job_pool,
                                                 String_View job_server_aware) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_BUILD_STEP_DECLARE);
     Event ev = {0};
     ev.h.kind = EVENT_BUILD_STEP_DECLARE;
     ev.h.origin = origin;
@@ -1401,6 +1587,7 @@ static inline bool eval_emit_build_step_add_output(EvalExecContext *ctx,
                                                    Event_Origin origin,
                                                    String_View step_key,
                                                    String_View path) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_BUILD_STEP_ADD_OUTPUT);
     Event ev = {0};
     ev.h.kind = EVENT_BUILD_STEP_ADD_OUTPUT;
     ev.h.origin = origin;
@@ -1413,6 +1600,7 @@ static inline bool eval_emit_build_step_add_byproduct(EvalExecContext *ctx,
                                                       Event_Origin origin,
                                                       String_View step_key,
                                                       String_View path) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_BUILD_STEP_ADD_BYPRODUCT);
     Event ev = {0};
     ev.h.kind = EVENT_BUILD_STEP_ADD_BYPRODUCT;
     ev.h.origin = origin;
@@ -1425,6 +1613,7 @@ static inline bool eval_emit_build_step_add_dependency(EvalExecContext *ctx,
                                                        Event_Origin origin,
                                                        String_View step_key,
                                                        String_View item) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_BUILD_STEP_ADD_DEPENDENCY);
     Event ev = {0};
     ev.h.kind = EVENT_BUILD_STEP_ADD_DEPENDENCY;
     ev.h.origin = origin;
@@ -1442,6 +1631,7 @@ static inline bool eval_emit_build_step_add_command(EvalExecContext *ctx,
                                                     String_View step_key,
                                                     uint32_t command_index,
                                                     const SV_List *argv) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_BUILD_STEP_ADD_COMMAND);
     Event ev = {0};
     ev.h.kind = EVENT_BUILD_STEP_ADD_COMMAND;
     ev.h.origin = origin;
@@ -1460,6 +1650,7 @@ static inline bool eval_emit_replay_action_declare(EvalExecContext *ctx,
                                                    Event_Replay_Opcode opcode,
                                                    Event_Replay_Phase phase,
                                                    String_View working_directory) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_REPLAY_ACTION_DECLARE);
     Event ev = {0};
     ev.h.kind = EVENT_REPLAY_ACTION_DECLARE;
     ev.h.origin = origin;
@@ -1475,6 +1666,7 @@ static inline bool eval_emit_replay_action_add_input(EvalExecContext *ctx,
                                                      Event_Origin origin,
                                                      String_View action_key,
                                                      String_View path) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_REPLAY_ACTION_ADD_INPUT);
     Event ev = {0};
     ev.h.kind = EVENT_REPLAY_ACTION_ADD_INPUT;
     ev.h.origin = origin;
@@ -1487,6 +1679,7 @@ static inline bool eval_emit_replay_action_add_output(EvalExecContext *ctx,
                                                       Event_Origin origin,
                                                       String_View action_key,
                                                       String_View path) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_REPLAY_ACTION_ADD_OUTPUT);
     Event ev = {0};
     ev.h.kind = EVENT_REPLAY_ACTION_ADD_OUTPUT;
     ev.h.origin = origin;
@@ -1500,6 +1693,7 @@ static inline bool eval_emit_replay_action_add_argv(EvalExecContext *ctx,
                                                     String_View action_key,
                                                     uint32_t arg_index,
                                                     String_View value) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_REPLAY_ACTION_ADD_ARGV);
     Event ev = {0};
     ev.h.kind = EVENT_REPLAY_ACTION_ADD_ARGV;
     ev.h.origin = origin;
@@ -1514,6 +1708,7 @@ static inline bool eval_emit_replay_action_add_env(EvalExecContext *ctx,
                                                    String_View action_key,
                                                    String_View key,
                                                    String_View value) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_REPLAY_ACTION_ADD_ENV);
     Event ev = {0};
     ev.h.kind = EVENT_REPLAY_ACTION_ADD_ENV;
     ev.h.origin = origin;
@@ -1557,6 +1752,7 @@ static inline bool eval_emit_target_prop_set(EvalExecContext *ctx,
                                              String_View key,
                                              String_View value,
                                              Cmake_Target_Property_Op op) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_PROP_SET);
     Event ev = {0};
     Cmake_Event_Origin semantic_origin = {
         .file_path = origin.file_path,
@@ -1589,6 +1785,7 @@ static inline bool eval_emit_target_declare(EvalExecContext *ctx,
                                             bool imported,
                                             bool alias,
                                             String_View alias_of) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_DECLARE);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_DECLARE;
     ev.h.origin = origin;
@@ -1603,6 +1800,7 @@ static inline bool eval_emit_target_dependency(EvalExecContext *ctx,
                                                Event_Origin origin,
                                                String_View target_name,
                                                String_View dependency_name) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_ADD_DEPENDENCY);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_ADD_DEPENDENCY;
     ev.h.origin = origin;
@@ -1617,6 +1815,7 @@ static inline bool eval_emit_target_add_source(EvalExecContext *ctx,
                                                String_View path,
                                                Event_Target_Source_Kind source_kind,
                                                String_View file_set_name) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_ADD_SOURCE);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_ADD_SOURCE;
     ev.h.origin = origin;
@@ -1634,6 +1833,7 @@ static inline bool eval_emit_target_file_set_declare(EvalExecContext *ctx,
                                                      String_View set_name,
                                                      Event_Target_File_Set_Kind set_kind,
                                                      Cmake_Visibility visibility) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_FILE_SET_DECLARE);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_FILE_SET_DECLARE;
     ev.h.origin = origin;
@@ -1649,6 +1849,7 @@ static inline bool eval_emit_target_file_set_add_base_dir(EvalExecContext *ctx,
                                                           String_View target_name,
                                                           String_View set_name,
                                                           String_View path) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_FILE_SET_ADD_BASE_DIR);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_FILE_SET_ADD_BASE_DIR;
     ev.h.origin = origin;
@@ -1663,6 +1864,7 @@ static inline bool eval_emit_target_link_libraries(EvalExecContext *ctx,
                                                    Cmake_Visibility visibility,
                                                    String_View item,
                                                    Event_Link_Item_Metadata semantic) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_LINK_LIBRARIES);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_LINK_LIBRARIES;
     ev.h.origin = origin;
@@ -1682,6 +1884,7 @@ static inline bool eval_emit_target_link_options_semantic(EvalExecContext *ctx,
                                                           String_View item,
                                                           bool is_before,
                                                           Event_Link_Item_Metadata semantic) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_LINK_OPTIONS);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_LINK_OPTIONS;
     ev.h.origin = origin;
@@ -1736,6 +1939,7 @@ static inline bool eval_emit_target_link_directories_semantic(EvalExecContext *c
                                                               Cmake_Visibility visibility,
                                                               String_View path,
                                                               Event_Link_Item_Metadata semantic) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_LINK_DIRECTORIES);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_LINK_DIRECTORIES;
     ev.h.origin = origin;
@@ -1789,6 +1993,7 @@ static inline bool eval_emit_target_include_directories_semantic(EvalExecContext
                                                                  bool is_system,
                                                                  bool is_before,
                                                                  Event_Link_Item_Metadata semantic) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_INCLUDE_DIRECTORIES);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_INCLUDE_DIRECTORIES;
     ev.h.origin = origin;
@@ -1846,6 +2051,7 @@ static inline bool eval_emit_target_compile_definitions_semantic(EvalExecContext
                                                                  Cmake_Visibility visibility,
                                                                  String_View item,
                                                                  Event_Link_Item_Metadata semantic) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_COMPILE_DEFINITIONS);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_COMPILE_DEFINITIONS;
     ev.h.origin = origin;
@@ -1898,6 +2104,7 @@ static inline bool eval_emit_target_compile_options_semantic(EvalExecContext *ct
                                                              String_View item,
                                                              bool is_before,
                                                              Event_Link_Item_Metadata semantic) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_COMPILE_OPTIONS);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_COMPILE_OPTIONS;
     ev.h.origin = origin;
@@ -1952,6 +2159,7 @@ static inline bool eval_emit_target_compile_features_semantic(EvalExecContext *c
                                                               Cmake_Visibility visibility,
                                                               String_View item,
                                                               Event_Link_Item_Metadata semantic) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TARGET_COMPILE_FEATURES);
     Event ev = {0};
     ev.h.kind = EVENT_TARGET_COMPILE_FEATURES;
     ev.h.origin = origin;
@@ -2001,6 +2209,7 @@ static inline bool eval_emit_var_set_current(EvalExecContext *ctx,
                                              Event_Origin origin,
                                              String_View key,
                                              String_View value) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_VAR_SET);
     Event ev = {0};
     ev.h.kind = EVENT_VAR_SET;
     ev.h.version = 2;
@@ -2013,6 +2222,7 @@ static inline bool eval_emit_var_set_current(EvalExecContext *ctx,
 static inline bool eval_emit_var_unset_current(EvalExecContext *ctx,
                                                Event_Origin origin,
                                                String_View key) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_VAR_UNSET);
     Event ev = {0};
     ev.h.kind = EVENT_VAR_UNSET;
     ev.h.version = 2;
@@ -2025,6 +2235,7 @@ static inline bool eval_emit_var_set_cache(EvalExecContext *ctx,
                                            Event_Origin origin,
                                            String_View key,
                                            String_View value) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_VAR_SET);
     Event ev = {0};
     ev.h.kind = EVENT_VAR_SET;
     ev.h.version = 2;
@@ -2037,6 +2248,7 @@ static inline bool eval_emit_var_set_cache(EvalExecContext *ctx,
 static inline bool eval_emit_var_unset_cache(EvalExecContext *ctx,
                                              Event_Origin origin,
                                              String_View key) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_VAR_UNSET);
     Event ev = {0};
     ev.h.kind = EVENT_VAR_UNSET;
     ev.h.version = 2;
@@ -2047,6 +2259,7 @@ static inline bool eval_emit_var_unset_cache(EvalExecContext *ctx,
 }
 static inline bool eval_emit_test_enable(EvalExecContext *ctx,
                                          Event_Origin origin) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TEST_ENABLE);
     Event ev = {0};
     ev.h.kind = EVENT_TEST_ENABLE;
     ev.h.origin = origin;
@@ -2060,6 +2273,7 @@ static inline bool eval_emit_test_add(EvalExecContext *ctx,
                                       String_View working_dir,
                                       bool command_expand_lists,
                                       const SV_List *configurations) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_TEST_ADD);
     Event ev = {0};
     ev.h.kind = EVENT_TEST_ADD;
     ev.h.origin = origin;
@@ -2091,6 +2305,7 @@ static inline bool eval_emit_install_rule_add(EvalExecContext *ctx,
                                               String_View runtime_destination,
                                               String_View includes_destination,
                                               String_View public_header_destination) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_INSTALL_RULE_ADD);
     Event ev = {0};
     ev.h.kind = EVENT_INSTALL_RULE_ADD;
     ev.h.origin = origin;
@@ -2120,6 +2335,7 @@ static inline bool eval_emit_export_install(EvalExecContext *ctx,
                                             String_View export_namespace,
                                             String_View file_name,
                                             String_View component) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_EXPORT_INSTALL);
     Event ev = {0};
     ev.h.kind = EVENT_EXPORT_INSTALL;
     ev.h.origin = origin;
@@ -2139,6 +2355,7 @@ static inline bool eval_emit_export_build_declare(EvalExecContext *ctx,
                                                   String_View export_namespace,
                                                   bool append,
                                                   String_View cxx_modules_directory) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_EXPORT_BUILD_DECLARE);
     Event ev = {0};
     ev.h.kind = EVENT_EXPORT_BUILD_DECLARE;
     ev.h.origin = origin;
@@ -2155,6 +2372,7 @@ static inline bool eval_emit_export_build_add_target(EvalExecContext *ctx,
                                                      Event_Origin origin,
                                                      String_View export_key,
                                                      String_View target_name) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_EXPORT_BUILD_ADD_TARGET);
     Event ev = {0};
     ev.h.kind = EVENT_EXPORT_BUILD_ADD_TARGET;
     ev.h.origin = origin;
@@ -2167,6 +2385,7 @@ static inline bool eval_emit_export_package_registry(EvalExecContext *ctx,
                                                      String_View package_name,
                                                      String_View prefix,
                                                      bool enabled) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_EXPORT_PACKAGE_REGISTRY);
     Event ev = {0};
     ev.h.kind = EVENT_EXPORT_PACKAGE_REGISTRY;
     ev.h.origin = origin;
@@ -2179,6 +2398,7 @@ static inline bool eval_emit_cpack_add_install_type(EvalExecContext *ctx,
                                                     Event_Origin origin,
                                                     String_View name,
                                                     String_View display_name) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_CPACK_ADD_INSTALL_TYPE);
     Event ev = {0};
     ev.h.kind = EVENT_CPACK_ADD_INSTALL_TYPE;
     ev.h.origin = origin;
@@ -2194,6 +2414,7 @@ static inline bool eval_emit_cpack_add_component_group(EvalExecContext *ctx,
                                                        String_View parent_group,
                                                        bool expanded,
                                                        bool bold_title) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_CPACK_ADD_COMPONENT_GROUP);
     Event ev = {0};
     ev.h.kind = EVENT_CPACK_ADD_COMPONENT_GROUP;
     ev.h.origin = origin;
@@ -2219,6 +2440,7 @@ static inline bool eval_emit_cpack_add_component(EvalExecContext *ctx,
                                                  bool hidden,
                                                  bool disabled,
                                                  bool downloaded) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_CPACK_ADD_COMPONENT);
     Event ev = {0};
     ev.h.kind = EVENT_CPACK_ADD_COMPONENT;
     ev.h.origin = origin;
@@ -2250,6 +2472,7 @@ static inline bool eval_emit_cpack_package_declare(EvalExecContext *ctx,
                                                    bool include_toplevel_directory,
                                                    bool archive_component_install,
                                                    String_View components_all) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_CPACK_PACKAGE_DECLARE);
     Event ev = {0};
     ev.h.kind = EVENT_CPACK_PACKAGE_DECLARE;
     ev.h.origin = origin;
@@ -2271,6 +2494,7 @@ static inline bool eval_emit_cpack_package_add_generator(EvalExecContext *ctx,
                                                          Event_Origin origin,
                                                          String_View package_key,
                                                          String_View generator) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_CPACK_PACKAGE_ADD_GENERATOR);
     Event ev = {0};
     ev.h.kind = EVENT_CPACK_PACKAGE_ADD_GENERATOR;
     ev.h.origin = origin;
@@ -2283,6 +2507,7 @@ static inline bool eval_emit_cpack_package_archive_name_override(EvalExecContext
                                                                  String_View package_key,
                                                                  String_View archive_key,
                                                                  String_View archive_file_name) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_CPACK_PACKAGE_ARCHIVE_NAME_OVERRIDE);
     Event ev = {0};
     ev.h.kind = EVENT_CPACK_PACKAGE_ARCHIVE_NAME_OVERRIDE;
     ev.h.origin = origin;
@@ -2299,6 +2524,7 @@ static inline bool eval_emit_package_find_result(EvalExecContext *ctx,
                                                  bool found,
                                                  bool required,
                                                  bool quiet) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_PACKAGE_FIND_RESULT);
     Event ev = {0};
     ev.h.kind = EVENT_PACKAGE_FIND_RESULT;
     ev.h.origin = origin;
@@ -2317,6 +2543,7 @@ static inline bool eval_emit_project_declare(EvalExecContext *ctx,
                                              String_View description,
                                              String_View homepage_url,
                                              String_View languages) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_PROJECT_DECLARE);
     Event ev = {0};
     ev.h.kind = EVENT_PROJECT_DECLARE;
     ev.h.origin = origin;
@@ -2331,6 +2558,7 @@ static inline bool eval_emit_project_minimum_required(EvalExecContext *ctx,
                                                       Event_Origin origin,
                                                       String_View version,
                                                       bool fatal_if_too_old) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_PROJECT_MINIMUM_REQUIRED);
     Event ev = {0};
     ev.h.kind = EVENT_PROJECT_MINIMUM_REQUIRED;
     ev.h.origin = origin;
@@ -2342,6 +2570,7 @@ static inline bool eval_emit_include_begin(EvalExecContext *ctx,
                                            Event_Origin origin,
                                            String_View path,
                                            bool no_policy_scope) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_INCLUDE_BEGIN);
     Event ev = {0};
     ev.h.kind = EVENT_INCLUDE_BEGIN;
     ev.h.origin = origin;
@@ -2353,6 +2582,7 @@ static inline bool eval_emit_include_end(EvalExecContext *ctx,
                                          Event_Origin origin,
                                          String_View path,
                                          bool success) {
+    EVAL_EMIT_SKIP_UNWANTED_ALLOW_STOPPED(ctx, EVENT_INCLUDE_END);
     Event ev = {0};
     ev.h.kind = EVENT_INCLUDE_END;
     ev.h.origin = origin;
@@ -2366,6 +2596,7 @@ static inline bool eval_emit_add_subdirectory_begin(EvalExecContext *ctx,
                                                     String_View binary_dir,
                                                     bool exclude_from_all,
                                                     bool system) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_ADD_SUBDIRECTORY_BEGIN);
     Event ev = {0};
     ev.h.kind = EVENT_ADD_SUBDIRECTORY_BEGIN;
     ev.h.origin = origin;
@@ -2380,6 +2611,7 @@ static inline bool eval_emit_add_subdirectory_end(EvalExecContext *ctx,
                                                   String_View source_dir,
                                                   String_View binary_dir,
                                                   bool success) {
+    EVAL_EMIT_SKIP_UNWANTED_ALLOW_STOPPED(ctx, EVENT_ADD_SUBDIRECTORY_END);
     Event ev = {0};
     ev.h.kind = EVENT_ADD_SUBDIRECTORY_END;
     ev.h.origin = origin;
@@ -2395,6 +2627,7 @@ static inline bool eval_emit_directory_property_mutate(EvalExecContext *ctx,
                                                        uint32_t modifier_flags,
                                                        String_View *items,
                                                        size_t item_count) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_DIRECTORY_PROPERTY_MUTATE);
     Event ev = {0};
     Cmake_Event_Origin semantic_origin = {
         .file_path = origin.file_path,
@@ -2428,6 +2661,7 @@ static inline bool eval_emit_global_property_mutate(EvalExecContext *ctx,
                                                     uint32_t modifier_flags,
                                                     String_View *items,
                                                     size_t item_count) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_GLOBAL_PROPERTY_MUTATE);
     Event ev = {0};
     Cmake_Event_Origin semantic_origin = {
         .file_path = origin.file_path,
@@ -2458,6 +2692,7 @@ static inline bool eval_emit_dir_push(EvalExecContext *ctx,
                                       Event_Origin origin,
                                       String_View source_dir,
                                       String_View binary_dir) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_DIR_PUSH);
     Event ev = {0};
     ev.h.kind = EVENT_DIR_PUSH;
     ev.h.origin = origin;
@@ -2469,6 +2704,7 @@ static inline bool eval_emit_dir_pop(EvalExecContext *ctx,
                                      Event_Origin origin,
                                      String_View source_dir,
                                      String_View binary_dir) {
+    EVAL_EMIT_SKIP_UNWANTED_ALLOW_STOPPED(ctx, EVENT_DIR_POP);
     Event ev = {0};
     ev.h.kind = EVENT_DIR_POP;
     ev.h.origin = origin;
@@ -2481,6 +2717,7 @@ static inline bool eval_emit_command_begin(EvalExecContext *ctx,
                                            String_View command_name,
                                            Event_Command_Dispatch_Kind dispatch_kind,
                                            uint32_t argc) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_COMMAND_BEGIN);
     Event ev = {0};
     ev.h.kind = EVENT_COMMAND_BEGIN;
     ev.h.origin = origin;
@@ -2495,6 +2732,7 @@ static inline bool eval_emit_command_end(EvalExecContext *ctx,
                                          Event_Command_Dispatch_Kind dispatch_kind,
                                          uint32_t argc,
                                          Event_Command_Status status) {
+    EVAL_EMIT_SKIP_UNWANTED_ALLOW_STOPPED(ctx, EVENT_COMMAND_END);
     Event ev = {0};
     ev.h.kind = EVENT_COMMAND_END;
     ev.h.origin = origin;
@@ -2516,6 +2754,7 @@ static inline bool eval_emit_command_call(EvalExecContext *ctx,
 static inline bool eval_emit_cmake_language_call(EvalExecContext *ctx,
                                                  Event_Origin origin,
                                                  String_View command_name) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_CMAKE_LANGUAGE_CALL);
     Event ev = {0};
     ev.h.kind = EVENT_CMAKE_LANGUAGE_CALL;
     ev.h.origin = origin;
@@ -2525,6 +2764,7 @@ static inline bool eval_emit_cmake_language_call(EvalExecContext *ctx,
 static inline bool eval_emit_cmake_language_eval(EvalExecContext *ctx,
                                                  Event_Origin origin,
                                                  String_View code) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_CMAKE_LANGUAGE_EVAL);
     Event ev = {0};
     ev.h.kind = EVENT_CMAKE_LANGUAGE_EVAL;
     ev.h.origin = origin;
@@ -2535,6 +2775,7 @@ static inline bool eval_emit_cmake_language_defer_queue(EvalExecContext *ctx,
                                                         Event_Origin origin,
                                                         String_View defer_id,
                                                         String_View command_name) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_CMAKE_LANGUAGE_DEFER_QUEUE);
     Event ev = {0};
     ev.h.kind = EVENT_CMAKE_LANGUAGE_DEFER_QUEUE;
     ev.h.origin = origin;
@@ -2545,6 +2786,7 @@ static inline bool eval_emit_cmake_language_defer_queue(EvalExecContext *ctx,
 static inline bool eval_emit_fs_write_file(EvalExecContext *ctx,
                                            Event_Origin origin,
                                            String_View path) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_WRITE_FILE);
     Event ev = {0};
     ev.h.kind = EVENT_FS_WRITE_FILE;
     ev.h.origin = origin;
@@ -2554,6 +2796,7 @@ static inline bool eval_emit_fs_write_file(EvalExecContext *ctx,
 static inline bool eval_emit_fs_append_file(EvalExecContext *ctx,
                                             Event_Origin origin,
                                             String_View path) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_APPEND_FILE);
     Event ev = {0};
     ev.h.kind = EVENT_FS_APPEND_FILE;
     ev.h.origin = origin;
@@ -2564,6 +2807,7 @@ static inline bool eval_emit_fs_read_file(EvalExecContext *ctx,
                                           Event_Origin origin,
                                           String_View path,
                                           String_View out_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_READ_FILE);
     Event ev = {0};
     ev.h.kind = EVENT_FS_READ_FILE;
     ev.h.origin = origin;
@@ -2576,6 +2820,7 @@ static inline bool eval_emit_fs_glob(EvalExecContext *ctx,
                                      String_View out_var,
                                      String_View base_dir,
                                      bool recursive) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_GLOB);
     Event ev = {0};
     ev.h.kind = EVENT_FS_GLOB;
     ev.h.origin = origin;
@@ -2587,6 +2832,7 @@ static inline bool eval_emit_fs_glob(EvalExecContext *ctx,
 static inline bool eval_emit_fs_mkdir(EvalExecContext *ctx,
                                       Event_Origin origin,
                                       String_View path) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_MKDIR);
     Event ev = {0};
     ev.h.kind = EVENT_FS_MKDIR;
     ev.h.origin = origin;
@@ -2597,6 +2843,7 @@ static inline bool eval_emit_fs_remove(EvalExecContext *ctx,
                                        Event_Origin origin,
                                        String_View path,
                                        bool recursive) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_REMOVE);
     Event ev = {0};
     ev.h.kind = EVENT_FS_REMOVE;
     ev.h.origin = origin;
@@ -2608,6 +2855,7 @@ static inline bool eval_emit_fs_copy(EvalExecContext *ctx,
                                      Event_Origin origin,
                                      String_View source,
                                      String_View destination) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_COPY);
     Event ev = {0};
     ev.h.kind = EVENT_FS_COPY;
     ev.h.origin = origin;
@@ -2619,6 +2867,7 @@ static inline bool eval_emit_fs_rename(EvalExecContext *ctx,
                                        Event_Origin origin,
                                        String_View source,
                                        String_View destination) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_RENAME);
     Event ev = {0};
     ev.h.kind = EVENT_FS_RENAME;
     ev.h.origin = origin;
@@ -2631,6 +2880,7 @@ static inline bool eval_emit_fs_create_link(EvalExecContext *ctx,
                                             String_View source,
                                             String_View destination,
                                             bool symbolic) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_CREATE_LINK);
     Event ev = {0};
     ev.h.kind = EVENT_FS_CREATE_LINK;
     ev.h.origin = origin;
@@ -2643,6 +2893,7 @@ static inline bool eval_emit_fs_chmod(EvalExecContext *ctx,
                                       Event_Origin origin,
                                       String_View path,
                                       bool recursive) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_CHMOD);
     Event ev = {0};
     ev.h.kind = EVENT_FS_CHMOD;
     ev.h.origin = origin;
@@ -2653,6 +2904,7 @@ static inline bool eval_emit_fs_chmod(EvalExecContext *ctx,
 static inline bool eval_emit_fs_archive_create(EvalExecContext *ctx,
                                                Event_Origin origin,
                                                String_View path) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_ARCHIVE_CREATE);
     Event ev = {0};
     ev.h.kind = EVENT_FS_ARCHIVE_CREATE;
     ev.h.origin = origin;
@@ -2663,6 +2915,7 @@ static inline bool eval_emit_fs_archive_extract(EvalExecContext *ctx,
                                                 Event_Origin origin,
                                                 String_View path,
                                                 String_View destination) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_ARCHIVE_EXTRACT);
     Event ev = {0};
     ev.h.kind = EVENT_FS_ARCHIVE_EXTRACT;
     ev.h.origin = origin;
@@ -2674,6 +2927,7 @@ static inline bool eval_emit_fs_transfer_download(EvalExecContext *ctx,
                                                   Event_Origin origin,
                                                   String_View source,
                                                   String_View destination) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_TRANSFER_DOWNLOAD);
     Event ev = {0};
     ev.h.kind = EVENT_FS_TRANSFER_DOWNLOAD;
     ev.h.origin = origin;
@@ -2685,6 +2939,7 @@ static inline bool eval_emit_fs_transfer_upload(EvalExecContext *ctx,
                                                 Event_Origin origin,
                                                 String_View source,
                                                 String_View destination) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FS_TRANSFER_UPLOAD);
     Event ev = {0};
     ev.h.kind = EVENT_FS_TRANSFER_UPLOAD;
     ev.h.origin = origin;
@@ -2696,6 +2951,7 @@ static inline bool eval_emit_proc_exec_request(EvalExecContext *ctx,
                                                Event_Origin origin,
                                                String_View command,
                                                String_View working_directory) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_PROC_EXEC_REQUEST);
     Event ev = {0};
     ev.h.kind = EVENT_PROC_EXEC_REQUEST;
     ev.h.origin = origin;
@@ -2710,6 +2966,7 @@ static inline bool eval_emit_proc_exec_result(EvalExecContext *ctx,
                                               String_View stdout_text,
                                               String_View stderr_text,
                                               bool had_error) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_PROC_EXEC_RESULT);
     Event ev = {0};
     ev.h.kind = EVENT_PROC_EXEC_RESULT;
     ev.h.origin = origin;
@@ -2723,6 +2980,7 @@ static inline bool eval_emit_proc_exec_result(EvalExecContext *ctx,
 static inline bool eval_emit_flow_if_eval(EvalExecContext *ctx,
                                           Event_Origin origin,
                                           bool result) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_IF_EVAL);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_IF_EVAL;
     ev.h.origin = origin;
@@ -2732,6 +2990,7 @@ static inline bool eval_emit_flow_if_eval(EvalExecContext *ctx,
 static inline bool eval_emit_flow_branch_taken(EvalExecContext *ctx,
                                                Event_Origin origin,
                                                String_View branch_kind) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_BRANCH_TAKEN);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_BRANCH_TAKEN;
     ev.h.origin = origin;
@@ -2741,6 +3000,7 @@ static inline bool eval_emit_flow_branch_taken(EvalExecContext *ctx,
 static inline bool eval_emit_flow_loop_begin(EvalExecContext *ctx,
                                              Event_Origin origin,
                                              String_View loop_kind) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_LOOP_BEGIN);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_LOOP_BEGIN;
     ev.h.origin = origin;
@@ -2751,6 +3011,7 @@ static inline bool eval_emit_flow_loop_end(EvalExecContext *ctx,
                                            Event_Origin origin,
                                            String_View loop_kind,
                                            uint32_t iterations) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_LOOP_END);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_LOOP_END;
     ev.h.origin = origin;
@@ -2761,6 +3022,7 @@ static inline bool eval_emit_flow_loop_end(EvalExecContext *ctx,
 static inline bool eval_emit_flow_break(EvalExecContext *ctx,
                                         Event_Origin origin,
                                         uint32_t loop_depth) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_BREAK);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_BREAK;
     ev.h.origin = origin;
@@ -2770,6 +3032,7 @@ static inline bool eval_emit_flow_break(EvalExecContext *ctx,
 static inline bool eval_emit_flow_continue(EvalExecContext *ctx,
                                            Event_Origin origin,
                                            uint32_t loop_depth) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_CONTINUE);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_CONTINUE;
     ev.h.origin = origin;
@@ -2780,6 +3043,7 @@ static inline bool eval_emit_flow_defer_queue(EvalExecContext *ctx,
                                               Event_Origin origin,
                                               String_View defer_id,
                                               String_View command_name) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_DEFER_QUEUE);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_DEFER_QUEUE;
     ev.h.origin = origin;
@@ -2790,6 +3054,7 @@ static inline bool eval_emit_flow_defer_queue(EvalExecContext *ctx,
 static inline bool eval_emit_flow_defer_flush(EvalExecContext *ctx,
                                               Event_Origin origin,
                                               uint32_t call_count) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_DEFER_FLUSH);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_DEFER_FLUSH;
     ev.h.origin = origin;
@@ -2801,6 +3066,7 @@ static inline bool eval_emit_flow_block_begin(EvalExecContext *ctx,
                                               bool variable_scope_pushed,
                                               bool policy_scope_pushed,
                                               bool has_propagate_vars) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_BLOCK_BEGIN);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_BLOCK_BEGIN;
     ev.h.origin = origin;
@@ -2813,6 +3079,7 @@ static inline bool eval_emit_flow_block_end(EvalExecContext *ctx,
                                             Event_Origin origin,
                                             bool propagate_on_return,
                                             bool had_propagate_vars) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_BLOCK_END);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_BLOCK_END;
     ev.h.origin = origin;
@@ -2824,6 +3091,7 @@ static inline bool eval_emit_flow_function_begin(EvalExecContext *ctx,
                                                  Event_Origin origin,
                                                  String_View name,
                                                  uint32_t argc) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_FUNCTION_BEGIN);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_FUNCTION_BEGIN;
     ev.h.origin = origin;
@@ -2835,6 +3103,7 @@ static inline bool eval_emit_flow_function_end(EvalExecContext *ctx,
                                                Event_Origin origin,
                                                String_View name,
                                                bool returned) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_FUNCTION_END);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_FUNCTION_END;
     ev.h.origin = origin;
@@ -2846,6 +3115,7 @@ static inline bool eval_emit_flow_macro_begin(EvalExecContext *ctx,
                                               Event_Origin origin,
                                               String_View name,
                                               uint32_t argc) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_MACRO_BEGIN);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_MACRO_BEGIN;
     ev.h.origin = origin;
@@ -2857,6 +3127,7 @@ static inline bool eval_emit_flow_macro_end(EvalExecContext *ctx,
                                             Event_Origin origin,
                                             String_View name,
                                             bool returned) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_FLOW_MACRO_END);
     Event ev = {0};
     ev.h.kind = EVENT_FLOW_MACRO_END;
     ev.h.origin = origin;
@@ -2867,6 +3138,7 @@ static inline bool eval_emit_flow_macro_end(EvalExecContext *ctx,
 static inline bool eval_emit_string_replace(EvalExecContext *ctx,
                                             Event_Origin origin,
                                             String_View out_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_STRING_REPLACE);
     Event ev = {0};
     ev.h.kind = EVENT_STRING_REPLACE;
     ev.h.origin = origin;
@@ -2876,6 +3148,7 @@ static inline bool eval_emit_string_replace(EvalExecContext *ctx,
 static inline bool eval_emit_string_configure(EvalExecContext *ctx,
                                               Event_Origin origin,
                                               String_View out_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_STRING_CONFIGURE);
     Event ev = {0};
     ev.h.kind = EVENT_STRING_CONFIGURE;
     ev.h.origin = origin;
@@ -2886,6 +3159,7 @@ static inline bool eval_emit_string_regex(EvalExecContext *ctx,
                                           Event_Origin origin,
                                           String_View mode,
                                           String_View out_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_STRING_REGEX);
     Event ev = {0};
     ev.h.kind = EVENT_STRING_REGEX;
     ev.h.origin = origin;
@@ -2897,6 +3171,7 @@ static inline bool eval_emit_string_hash(EvalExecContext *ctx,
                                          Event_Origin origin,
                                          String_View algorithm,
                                          String_View out_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_STRING_HASH);
     Event ev = {0};
     ev.h.kind = EVENT_STRING_HASH;
     ev.h.origin = origin;
@@ -2907,6 +3182,7 @@ static inline bool eval_emit_string_hash(EvalExecContext *ctx,
 static inline bool eval_emit_string_timestamp(EvalExecContext *ctx,
                                               Event_Origin origin,
                                               String_View out_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_STRING_TIMESTAMP);
     Event ev = {0};
     ev.h.kind = EVENT_STRING_TIMESTAMP;
     ev.h.origin = origin;
@@ -2916,6 +3192,7 @@ static inline bool eval_emit_string_timestamp(EvalExecContext *ctx,
 static inline bool eval_emit_list_append(EvalExecContext *ctx,
                                          Event_Origin origin,
                                          String_View list_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_LIST_APPEND);
     Event ev = {0};
     ev.h.kind = EVENT_LIST_APPEND;
     ev.h.origin = origin;
@@ -2925,6 +3202,7 @@ static inline bool eval_emit_list_append(EvalExecContext *ctx,
 static inline bool eval_emit_list_prepend(EvalExecContext *ctx,
                                           Event_Origin origin,
                                           String_View list_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_LIST_PREPEND);
     Event ev = {0};
     ev.h.kind = EVENT_LIST_PREPEND;
     ev.h.origin = origin;
@@ -2934,6 +3212,7 @@ static inline bool eval_emit_list_prepend(EvalExecContext *ctx,
 static inline bool eval_emit_list_insert(EvalExecContext *ctx,
                                          Event_Origin origin,
                                          String_View list_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_LIST_INSERT);
     Event ev = {0};
     ev.h.kind = EVENT_LIST_INSERT;
     ev.h.origin = origin;
@@ -2943,6 +3222,7 @@ static inline bool eval_emit_list_insert(EvalExecContext *ctx,
 static inline bool eval_emit_list_remove(EvalExecContext *ctx,
                                          Event_Origin origin,
                                          String_View list_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_LIST_REMOVE);
     Event ev = {0};
     ev.h.kind = EVENT_LIST_REMOVE;
     ev.h.origin = origin;
@@ -2952,6 +3232,7 @@ static inline bool eval_emit_list_remove(EvalExecContext *ctx,
 static inline bool eval_emit_list_transform(EvalExecContext *ctx,
                                             Event_Origin origin,
                                             String_View list_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_LIST_TRANSFORM);
     Event ev = {0};
     ev.h.kind = EVENT_LIST_TRANSFORM;
     ev.h.origin = origin;
@@ -2961,6 +3242,7 @@ static inline bool eval_emit_list_transform(EvalExecContext *ctx,
 static inline bool eval_emit_list_sort(EvalExecContext *ctx,
                                        Event_Origin origin,
                                        String_View list_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_LIST_SORT);
     Event ev = {0};
     ev.h.kind = EVENT_LIST_SORT;
     ev.h.origin = origin;
@@ -2971,6 +3253,7 @@ static inline bool eval_emit_math_expr(EvalExecContext *ctx,
                                        Event_Origin origin,
                                        String_View out_var,
                                        String_View format) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_MATH_EXPR);
     Event ev = {0};
     ev.h.kind = EVENT_MATH_EXPR;
     ev.h.origin = origin;
@@ -2981,6 +3264,7 @@ static inline bool eval_emit_math_expr(EvalExecContext *ctx,
 static inline bool eval_emit_path_normalize(EvalExecContext *ctx,
                                             Event_Origin origin,
                                             String_View out_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_PATH_NORMALIZE);
     Event ev = {0};
     ev.h.kind = EVENT_PATH_NORMALIZE;
     ev.h.origin = origin;
@@ -2990,6 +3274,7 @@ static inline bool eval_emit_path_normalize(EvalExecContext *ctx,
 static inline bool eval_emit_path_compare(EvalExecContext *ctx,
                                           Event_Origin origin,
                                           String_View out_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_PATH_COMPARE);
     Event ev = {0};
     ev.h.kind = EVENT_PATH_COMPARE;
     ev.h.origin = origin;
@@ -2999,6 +3284,7 @@ static inline bool eval_emit_path_compare(EvalExecContext *ctx,
 static inline bool eval_emit_path_convert(EvalExecContext *ctx,
                                           Event_Origin origin,
                                           String_View out_var) {
+    EVAL_EMIT_SKIP_UNWANTED(ctx, EVENT_PATH_CONVERT);
     Event ev = {0};
     ev.h.kind = EVENT_PATH_CONVERT;
     ev.h.origin = origin;
@@ -3036,6 +3322,14 @@ bool eval_append_configure_log(EvalExecContext *ctx, const Node *node, String_Vi
 bool eval_command_tx_begin(EvalExecContext *ctx, Eval_Command_Transaction *tx);
 void eval_command_tx_preserve_scope_vars_on_failure(EvalExecContext *ctx);
 bool eval_command_tx_finish(EvalExecContext *ctx, Eval_Command_Transaction *tx, bool commit_state);
+// Undo journal hooks: call before mutating state that existed when the active
+// transaction began. Each hook is a no-op outside transactions.
+bool eval_command_tx_note_var(EvalExecContext *ctx, size_t depth, char *key, const Eval_Var_Entry *existing);
+bool eval_command_tx_note_cache(EvalExecContext *ctx, char *key, const Eval_Cache_Entry *existing);
+bool eval_command_tx_note_env(EvalExecContext *ctx, char *key, const Eval_Process_Env_Entry *existing);
+bool eval_command_tx_note_elem(EvalExecContext *ctx, Eval_Tx_Slice slice, size_t index);
+bool eval_command_tx_note_nested(EvalExecContext *ctx, Eval_Tx_Slice slice, size_t index, size_t field_offset);
+bool eval_command_tx_note_slice(EvalExecContext *ctx, Eval_Tx_Slice slice, size_t first_index);
 bool eval_command_tx_push_event(EvalExecContext *ctx, const Event *ev, bool allow_stopped);
 bool eval_command_tx_push_diag(EvalExecContext *ctx,
                                Event_Diag_Severity input_sev,
@@ -3067,12 +3361,20 @@ bool eval_service_host_query_windows_registry(
     Eval_Windows_Registry_Query_Result *out_result);
 
 // ---- vars ----
+// Variable names are interned once per session. `eval_symbol_find` returns NULL
+// for names never interned, which no scope or cache table can contain.
+char *eval_symbol_find(EvalExecContext *ctx, String_View name);
+char *eval_symbol_intern(EvalExecContext *ctx, String_View name);
+Eval_Cache_Entry *eval_cache_entry_find(EvalExecContext *ctx, String_View key);
 String_View eval_var_get_visible(EvalExecContext *ctx, String_View key);
 static inline String_View eval_var_get(EvalExecContext *ctx, String_View key) {
     return eval_var_get_visible(ctx, key);
 }
 bool eval_var_defined_visible(EvalExecContext *ctx, String_View key);
 bool eval_var_set_current(EvalExecContext *ctx, String_View key, String_View value);
+// Appends (or prepends) `items` to the list in the current scope, reusing the
+// value's spare capacity when it was built by an earlier call.
+bool eval_var_list_append_current(EvalExecContext *ctx, String_View key, String_View items, bool prepend);
 bool eval_var_unset_current(EvalExecContext *ctx, String_View key);
 bool eval_var_defined_current(EvalExecContext *ctx, String_View key);
 bool eval_var_collect_visible_names(EvalExecContext *ctx, SV_List *out_names);
@@ -3141,6 +3443,7 @@ bool eval_target_alias_register(EvalExecContext *ctx, String_View name);
 bool eval_target_set_alias(EvalExecContext *ctx, String_View alias_name, String_View real_target);
 bool eval_target_alias_of(EvalExecContext *ctx, String_View name, String_View *out_real_target);
 bool eval_target_alias_is_global(EvalExecContext *ctx, String_View name);
+void eval_target_truncate(EvalExecContext *ctx, size_t record_count, size_t alias_count);
 bool eval_test_known(EvalExecContext *ctx, String_View name);
 bool eval_test_known_in_directory(EvalExecContext *ctx, String_View name, String_View declared_dir);
 bool eval_test_register(EvalExecContext *ctx, String_View name, String_View declared_dir);
@@ -3198,8 +3501,19 @@ bool eval_property_engine_get(EvalExecContext *ctx,
                               String_View property_upper,
                               String_View *out_value,
                               bool *out_set);
+// Collects, oldest first, the indexes of every record of one (scope, property)
+// family into a temp-arena array.
+bool eval_property_engine_collect_family(EvalExecContext *ctx,
+                                         String_View scope_upper,
+                                         String_View property_upper,
+                                         size_t **out_indexes);
+// Drops index entries for records and definitions past the given counts.
+void eval_property_engine_truncate(EvalExecContext *ctx, size_t record_count, size_t definition_count);
+void eval_property_engine_free(Eval_Property_Engine *engine);
 
 // ---- native commands ----
+size_t eval_dispatch_generation_next(void);
+size_t eval_command_name_hash_ci(String_View name);
 Eval_Native_Command *eval_native_cmd_find(EvalExecContext *ctx, String_View name);
 const Eval_Native_Command *eval_native_cmd_find_const(const EvalExecContext *ctx, String_View name);
 const Eval_Native_Command *eval_registry_find_const(const EvalRegistry *registry, String_View name);
@@ -3221,7 +3535,14 @@ bool eval_native_cmd_unregister_internal(EvalExecContext *ctx,
 // ---- user commands ----
 bool eval_user_cmd_register(EvalExecContext *ctx, const Node *node);
 bool eval_user_cmd_invoke(EvalExecContext *ctx, String_View name, const SV_List *args, Cmake_Event_Origin origin);
+bool eval_user_cmd_invoke_resolved(EvalExecContext *ctx,
+                                   const User_Command *cmd,
+                                   String_View name,
+                                   const SV_List *args,
+                                   Cmake_Event_Origin origin);
 User_Command *eval_user_cmd_find(EvalExecContext *ctx, String_View name);
+void eval_user_cmd_note_changed(EvalExecContext *ctx);
+void eval_user_cmd_truncate(EvalExecContext *ctx, size_t count);
 
 // ---- utilitários compartilhados ----
 bool eval_sv_key_eq(String_View a, String_View b);
@@ -3315,7 +3636,14 @@ bool eval_real_path_resolve_temp(EvalExecContext *ctx,
 bool eval_macro_frame_push(EvalExecContext *ctx);
 void eval_macro_frame_pop(EvalExecContext *ctx);
 bool eval_macro_bind_set(EvalExecContext *ctx, String_View key, String_View value);
-bool eval_macro_bind_get(EvalExecContext *ctx, String_View key, String_View *out_value);
+bool eval_macro_bind_lookup(EvalExecContext *ctx, String_View key, String_View *out_value);
+
+// Outside of any macro body there is nothing to substitute, so variable
+// reads skip the lookup entirely.
+static inline bool eval_macro_bind_get(EvalExecContext *ctx, String_View key, String_View *out_value) {
+    if (!ctx || arena_arr_len(ctx->scope_state.macro_frames) == 0) return false;
+    return eval_macro_bind_lookup(ctx, key, out_value);
+}
 
 // ---- Gerenciamento de Escopo ----
 bool eval_scope_push(EvalExecContext *ctx);
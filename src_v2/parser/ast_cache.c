@@ -0,0 +1,488 @@
+#include "ast_cache.h"
+#include "nob.h"
+#include "arena.h"
+#include "arena_dyn.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <direct.h>
+#include <process.h>
+#define getpid _getpid
+#endif
+
+#define AST_CACHE_MAGIC "NOBAST\0\0"
+#define AST_CACHE_VERSION 2u
+#define AST_CACHE_BYTE_ORDER 0x01020304u
+#define AST_CACHE_NULL_OFFSET UINT64_MAX
+
+// All fields are fixed width; the file is only read back on the host that
+// wrote it, and the byte-order marker rejects anything else.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t parser_version; // PARSER_AST_VERSION of the parser that built the tree
+    uint64_t source_size;
+    uint64_t source_hash;
+    uint64_t word_count;
+    uint64_t extra_size;
+} Ast_Cache_Header;
+
+uint64_t ast_cache_content_hash(String_View source) {
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < source.count; i++) {
+        hash ^= (unsigned char)source.data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static const char *ast_cache_entry_path(const char *cache_dir, uint64_t hash) {
+    return nob_temp_sprintf("%s/%016llx.ast", cache_dir, (unsigned long long)hash);
+}
+
+// --- Encoding ---
+
+typedef struct {
+    String_View source;
+    uint64_t *words;
+    size_t word_count;
+    size_t word_capacity;
+    Nob_String_Builder extra;
+    bool oom;
+} Ast_Cache_Writer;
+
+static void writer_put(Ast_Cache_Writer *w, uint64_t value) {
+    if (w->oom) return;
+    if (w->word_count == w->word_capacity) {
+        size_t new_capacity = w->word_capacity ? w->word_capacity * 2 : 256;
+        uint64_t *grown = realloc(w->words, new_capacity * sizeof(*grown));
+        if (!grown) {
+            w->oom = true;
+            return;
+        }
+        w->words = grown;
+        w->word_capacity = new_capacity;
+    }
+    w->words[w->word_count++] = value;
+}
+
+// Text that lies inside the source is stored as a source offset; anything
+// else is appended to the extra pool that follows the source in the file.
+static void writer_put_sv(Ast_Cache_Writer *w, String_View sv) {
+    if (!sv.data) {
+        writer_put(w, AST_CACHE_NULL_OFFSET);
+        writer_put(w, 0);
+        return;
+    }
+    const char *begin = w->source.data;
+    const char *end = begin ? begin + w->source.count : NULL;
+    if (begin && sv.data >= begin && sv.data + sv.count <= end) {
+        writer_put(w, (uint64_t)(sv.data - begin));
+    } else {
+        writer_put(w, (uint64_t)(w->source.count + w->extra.count));
+        nob_sb_append_buf(&w->extra, sv.data, sv.count);
+    }
+    writer_put(w, (uint64_t)sv.count);
+}
+
+static void writer_put_args(Ast_Cache_Writer *w, Args args) {
+    size_t count = arena_arr_len(args);
+    writer_put(w, count);
+    for (size_t i = 0; i < count; i++) {
+        const Arg *arg = &args[i];
+        size_t token_count = arena_arr_len(arg->items);
+        writer_put(w, (uint64_t)arg->kind);
+        writer_put(w, token_count);
+        for (size_t j = 0; j < token_count; j++) {
+            const Token *tok = &arg->items[j];
+            writer_put(w, (uint64_t)tok->kind);
+            writer_put(w, tok->line);
+            writer_put(w, tok->col);
+            writer_put(w, tok->has_space_left ? 1u : 0u);
+            writer_put_sv(w, tok->text);
+        }
+    }
+}
+
+static void writer_put_block(Ast_Cache_Writer *w, Node_List list);
+
+static void writer_put_node(Ast_Cache_Writer *w, const Node *node) {
+    writer_put(w, (uint64_t)node->kind);
+    writer_put(w, node->line);
+    writer_put(w, node->col);
+    switch (node->kind) {
+    case NODE_COMMAND:
+        writer_put_sv(w, node->as.cmd.name);
+        writer_put_args(w, node->as.cmd.args);
+        break;
+    case NODE_IF: {
+        size_t elseif_count = arena_arr_len(node->as.if_stmt.elseif_clauses);
+        writer_put_args(w, node->as.if_stmt.condition);
+        writer_put_block(w, node->as.if_stmt.then_block);
+        writer_put(w, elseif_count);
+        for (size_t i = 0; i < elseif_count; i++) {
+            writer_put_args(w, node->as.if_stmt.elseif_clauses[i].condition);
+            writer_put_block(w, node->as.if_stmt.elseif_clauses[i].block);
+        }
+        writer_put_block(w, node->as.if_stmt.else_block);
+        break;
+    }
+    case NODE_FOREACH:
+        writer_put_args(w, node->as.foreach_stmt.args);
+        writer_put_block(w, node->as.foreach_stmt.body);
+        break;
+    case NODE_WHILE:
+        writer_put_args(w, node->as.while_stmt.condition);
+        writer_put_block(w, node->as.while_stmt.body);
+        break;
+    case NODE_FUNCTION:
+    case NODE_MACRO:
+        writer_put_sv(w, node->as.func_def.name);
+        writer_put_args(w, node->as.func_def.params);
+        writer_put_block(w, node->as.func_def.body);
+        break;
+    }
+}
+
+static void writer_put_block(Ast_Cache_Writer *w, Node_List list) {
+    size_t count = arena_arr_len(list);
+    writer_put(w, count);
+    for (size_t i = 0; i < count; i++) writer_put_node(w, &list[i]);
+}
+
+// Creates `dir` and its parents without logging; the cache is best effort.
+static bool ast_cache_mkdirs(const char *dir) {
+    size_t len = strlen(dir);
+    char *path = nob_temp_alloc(len + 1);
+    if (!path) return false;
+    memcpy(path, dir, len + 1);
+    for (size_t i = 1; i <= len; i++) {
+        if (path[i] != '/' && path[i] != '\\' && path[i] != '\0') continue;
+        char saved = path[i];
+        path[i] = '\0';
+#if defined(_WIN32)
+        bool ok = _mkdir(path) == 0 || errno == EEXIST;
+#else
+        bool ok = mkdir(path, 0755) == 0 || errno == EEXIST;
+#endif
+        path[i] = saved;
+        if (!ok) return false;
+    }
+    return true;
+}
+
+bool ast_cache_store(const char *cache_dir, String_View source, Ast_Root root) {
+    if (!cache_dir || cache_dir[0] == '\0') return false;
+
+    Ast_Cache_Writer w = {0};
+    w.source = source;
+    writer_put_block(&w, root);
+    bool ok = !w.oom;
+
+    Nob_String_Builder out = {0};
+    if (ok) {
+        Ast_Cache_Header header = {0};
+        memcpy(header.magic, AST_CACHE_MAGIC, sizeof(header.magic));
+        header.version = AST_CACHE_VERSION;
+        header.byte_order = AST_CACHE_BYTE_ORDER;
+        header.parser_version = PARSER_AST_VERSION;
+        header.source_size = source.count;
+        header.source_hash = ast_cache_content_hash(source);
+        header.word_count = w.word_count;
+        header.extra_size = w.extra.count;
+        nob_sb_append_buf(&out, &header, sizeof(header));
+        nob_sb_append_buf(&out, w.words, w.word_count * sizeof(*w.words));
+        nob_sb_append_buf(&out, source.data, source.count);
+        nob_sb_append_buf(&out, w.extra.items, w.extra.count);
+    }
+
+    size_t temp_mark = nob_temp_save();
+    if (ok) ok = ast_cache_mkdirs(cache_dir);
+    if (ok) {
+        // Write beside the final name and rename so concurrent runs never
+        // observe a partially written entry.
+        const char *final_path = ast_cache_entry_path(cache_dir, ast_cache_content_hash(source));
+        const char *temp_path = nob_temp_sprintf("%s.%ld.tmp", final_path, (long)getpid());
+        ok = nob_write_entire_file(temp_path, out.items, out.count) &&
+             rename(temp_path, final_path) == 0;
+        if (!ok) remove(temp_path);
+    }
+    nob_temp_rewind(temp_mark);
+
+    nob_sb_free(out);
+    nob_sb_free(w.extra);
+    free(w.words);
+    return ok;
+}
+
+// --- Decoding ---
+
+typedef struct {
+    Arena *arena;
+    const uint64_t *words;
+    size_t word_count;
+    size_t cursor;
+    const char *pool;
+    size_t pool_size;
+    bool failed;
+} Ast_Cache_Reader;
+
+static uint64_t reader_get(Ast_Cache_Reader *r) {
+    if (r->failed || r->cursor >= r->word_count) {
+        r->failed = true;
+        return 0;
+    }
+    return r->words[r->cursor++];
+}
+
+// Element counts are bounded by the words left to read, which keeps a
+// corrupt entry from requesting absurd allocations.
+static size_t reader_get_count(Ast_Cache_Reader *r) {
+    uint64_t count = reader_get(r);
+    if (count > r->word_count - r->cursor) {
+        r->failed = true;
+        return 0;
+    }
+    return (size_t)count;
+}
+
+static String_View reader_get_sv(Ast_Cache_Reader *r) {
+    uint64_t offset = reader_get(r);
+    uint64_t count = reader_get(r);
+    if (r->failed) return (String_View){0};
+    if (offset == AST_CACHE_NULL_OFFSET) return (String_View){0};
+    if (offset > r->pool_size || count > r->pool_size - offset) {
+        r->failed = true;
+        return (String_View){0};
+    }
+    return nob_sv_from_parts(r->pool + offset, (size_t)count);
+}
+
+static Args reader_get_args(Ast_Cache_Reader *r) {
+    size_t count = reader_get_count(r);
+    if (count == 0) return NULL;
+    Args args = NULL;
+    Arg *slots = arena_arr_push_n(r->arena, args, count);
+    if (!slots) {
+        r->failed = true;
+        return NULL;
+    }
+    memset(slots, 0, count * sizeof(*slots));
+    Arg_Cache *caches = arena_alloc_zero(r->arena, count * sizeof(*caches));
+    if (!caches) {
+        r->failed = true;
+        return NULL;
+    }
+    for (size_t i = 0; i < count && !r->failed; i++) {
+        slots[i].cache = &caches[i];
+        slots[i].kind = (Arg_Kind)reader_get(r);
+        size_t token_count = reader_get_count(r);
+        if (token_count == 0) continue;
+        Token *tokens = arena_arr_push_n(r->arena, slots[i].items, token_count);
+        if (!tokens) {
+            r->failed = true;
+            break;
+        }
+        for (size_t j = 0; j < token_count; j++) {
+            tokens[j].kind = (Token_Kind)reader_get(r);
+            tokens[j].line = (size_t)reader_get(r);
+            tokens[j].col = (size_t)reader_get(r);
+            tokens[j].has_space_left = reader_get(r) != 0;
+            tokens[j].text = reader_get_sv(r);
+        }
+    }
+    return args;
+}
+
+static Node_List reader_get_block(Ast_Cache_Reader *r);
+
+static void reader_get_node(Ast_Cache_Reader *r, Node *node) {
+    memset(node, 0, sizeof(*node));
+    uint64_t kind = reader_get(r);
+    node->line = (size_t)reader_get(r);
+    node->col = (size_t)reader_get(r);
+    if (r->failed || kind > NODE_MACRO) {
+        r->failed = true;
+        return;
+    }
+    node->kind = (Node_Kind)kind;
+    switch (node->kind) {
+    case NODE_COMMAND:
+        node->as.cmd.name = reader_get_sv(r);
+        node->as.cmd.args = reader_get_args(r);
+        node->as.cmd.dispatch_cache = arena_alloc_zero(r->arena, sizeof(*node->as.cmd.dispatch_cache));
+        if (!node->as.cmd.dispatch_cache) r->failed = true;
+        break;
+    case NODE_IF: {
+        node->as.if_stmt.condition = reader_get_args(r);
+        node->as.if_stmt.condition_cache = arena_alloc_zero(r->arena, sizeof(*node->as.if_stmt.condition_cache));
+        if (!node->as.if_stmt.condition_cache) {
+            r->failed = true;
+            return;
+        }
+        node->as.if_stmt.then_block = reader_get_block(r);
+        size_t elseif_count = reader_get_count(r);
+        if (elseif_count > 0) {
+            ElseIf_Clause *clauses = arena_arr_push_n(r->arena, node->as.if_stmt.elseif_clauses, elseif_count);
+            if (!clauses) {
+                r->failed = true;
+                return;
+            }
+            for (size_t i = 0; i < elseif_count; i++) {
+                clauses[i] = (ElseIf_Clause){0};
+                clauses[i].condition = reader_get_args(r);
+                clauses[i].condition_cache = arena_alloc_zero(r->arena, sizeof(*clauses[i].condition_cache));
+                if (!clauses[i].condition_cache) {
+                    r->failed = true;
+                    return;
+                }
+                clauses[i].block = reader_get_block(r);
+            }
+        }
+        node->as.if_stmt.else_block = reader_get_block(r);
+        break;
+    }
+    case NODE_FOREACH:
+        node->as.foreach_stmt.args = reader_get_args(r);
+        node->as.foreach_stmt.body = reader_get_block(r);
+        break;
+    case NODE_WHILE:
+        node->as.while_stmt.condition = reader_get_args(r);
+        node->as.while_stmt.condition_cache = arena_alloc_zero(r->arena, sizeof(*node->as.while_stmt.condition_cache));
+        if (!node->as.while_stmt.condition_cache) r->failed = true;
+        node->as.while_stmt.body = reader_get_block(r);
+        break;
+    case NODE_FUNCTION:
+    case NODE_MACRO:
+        node->as.func_def.name = reader_get_sv(r);
+        node->as.func_def.params = reader_get_args(r);
+        node->as.func_def.body = reader_get_block(r);
+        break;
+    }
+}
+
+static Node_List reader_get_block(Ast_Cache_Reader *r) {
+    size_t count = reader_get_count(r);
+    if (count == 0) return NULL;
+    Node_List list = NULL;
+    Node *nodes = arena_arr_push_n(r->arena, list, count);
+    if (!nodes) {
+        r->failed = true;
+        return NULL;
+    }
+    for (size_t i = 0; i < count && !r->failed; i++) reader_get_node(r, &nodes[i]);
+    return list;
+}
+
+#if !defined(_WIN32)
+typedef struct {
+    void *base;
+    size_t size;
+} Ast_Cache_Mapping;
+
+static void ast_cache_unmap(void *userdata) {
+    Ast_Cache_Mapping *mapping = userdata;
+    munmap(mapping->base, mapping->size);
+}
+#endif
+
+// Maps the entry read-only, or reads it into `arena` where mapping is not
+// available. The mapping is released with `arena`.
+static bool ast_cache_map_entry(Arena *arena, const char *path, const unsigned char **out_data, size_t *out_size) {
+#if !defined(_WIN32)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    Ast_Cache_Mapping *mapping = arena_alloc(arena, sizeof(*mapping));
+    if (!mapping || !arena_on_destroy(arena, ast_cache_unmap, mapping)) {
+        munmap(base, size);
+        return false;
+    }
+    mapping->base = base;
+    mapping->size = size;
+    *out_data = base;
+    *out_size = size;
+    return true;
+#else
+    Nob_String_Builder sb = {0};
+    if (!nob_read_entire_file(path, &sb)) return false;
+    unsigned char *copy = arena_memdup(arena, sb.items, sb.count);
+    size_t size = sb.count;
+    nob_sb_free(sb);
+    if (!copy) return false;
+    *out_data = copy;
+    *out_size = size;
+    return true;
+#endif
+}
+
+bool ast_cache_load(Arena *arena, const char *cache_dir, String_View source, Ast_Root *out_root) {
+    if (!arena || !cache_dir || cache_dir[0] == '\0' || !out_root) return false;
+    *out_root = NULL;
+
+    uint64_t hash = ast_cache_content_hash(source);
+    size_t temp_mark = nob_temp_save();
+    const char *path = ast_cache_entry_path(cache_dir, hash);
+
+    Arena_Mark arena_mark_before = arena_mark(arena);
+    const unsigned char *data = NULL;
+    size_t size = 0;
+    bool mapped = ast_cache_map_entry(arena, path, &data, &size);
+    nob_temp_rewind(temp_mark);
+    if (!mapped) return false;
+
+    Ast_Cache_Header header;
+    if (size < sizeof(header)) goto stale;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, AST_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != AST_CACHE_VERSION ||
+        header.byte_order != AST_CACHE_BYTE_ORDER ||
+        header.parser_version != PARSER_AST_VERSION ||
+        header.source_size != source.count ||
+        header.source_hash != hash ||
+        header.word_count > (size - sizeof(header)) / sizeof(uint64_t)) {
+        goto stale;
+    }
+    size_t words_bytes = (size_t)header.word_count * sizeof(uint64_t);
+    size_t pool_size = size - sizeof(header) - words_bytes;
+    if (pool_size < header.source_size || pool_size - header.source_size != header.extra_size) goto stale;
+
+    // The name is only a hash; the stored source settles collisions.
+    const char *pool = (const char*)data + sizeof(header) + words_bytes;
+    if (source.count > 0 && memcmp(pool, source.data, source.count) != 0) goto stale;
+
+    Ast_Cache_Reader reader = {
+        .arena = arena,
+        .words = (const uint64_t*)(const void*)(data + sizeof(header)),
+        .word_count = (size_t)header.word_count,
+        .pool = pool,
+        .pool_size = pool_size,
+    };
+    Ast_Root root = reader_get_block(&reader);
+    if (reader.failed || reader.cursor != reader.word_count) goto stale;
+    *out_root = root;
+    return true;
+
+stale:
+    arena_rewind(arena, arena_mark_before);
+    return false;
+}
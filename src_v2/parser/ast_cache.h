@@ -0,0 +1,31 @@
+#ifndef AST_CACHE_H_
+#define AST_CACHE_H_
+
+#include "parser.h"
+
+#include <stdint.h>
+
+// Persistent on-disk cache of parsed listfiles.
+//
+// Entries live in `cache_dir` as `<content-hash>.ast` and hold the source
+// text, a flattened preorder encoding of the tree and a small pool for any
+// token text that did not come from the source. Everything is addressed by
+// offsets, so a file can be mapped anywhere; loading rebuilds only the node
+// and argument arrays, while token text keeps pointing into the mapping.
+
+// Directory name used below the binary root when the cache is enabled.
+#define AST_CACHE_DEFAULT_SUBDIR ".nobify/ast-cache"
+
+// Hash used to name cache entries (64-bit FNV-1a over the source bytes).
+uint64_t ast_cache_content_hash(String_View source);
+
+// Looks up the tree for `source`. Nodes are allocated in `arena`, and the
+// backing file stays mapped until `arena` is destroyed. Returns false on a
+// miss, on a stale or corrupt entry, or on allocation failure.
+bool ast_cache_load(Arena *arena, const char *cache_dir, String_View source, Ast_Root *out_root);
+
+// Writes `root`, parsed from `source`, into the cache. Creates `cache_dir`
+// (and its parent) as needed and replaces entries atomically.
+bool ast_cache_store(const char *cache_dir, String_View source, Ast_Root root);
+
+#endif // AST_CACHE_H_
@@ -93,6 +93,10 @@ static bool parser_append_token(Parser_Context *ctx, Arg *arg, Token tok) {
 static bool parser_append_arg(Parser_Context *ctx, Args *args, Arg arg) {
     if (!ctx || !args) return false;
     if (!parser_consume_append_budget(ctx)) return parser_report_oom(ctx);
+    if (!arg.cache) {
+        arg.cache = arena_alloc_zero(ctx->arena, sizeof(*arg.cache));
+        if (!arg.cache) return parser_report_oom(ctx);
+    }
     if (!arena_arr_push(ctx->arena, *args, arg)) return parser_report_oom(ctx);
     return true;
 }
@@ -100,6 +104,16 @@ static bool parser_append_arg(Parser_Context *ctx, Args *args, Arg arg) {
 static bool parser_append_node(Parser_Context *ctx, Node_List *list, Node node) {
     if (!ctx || !list) return false;
     if (!parser_consume_append_budget(ctx)) return parser_report_oom(ctx);
+    if (node.kind == NODE_COMMAND) {
+        node.as.cmd.dispatch_cache = arena_alloc_zero(ctx->arena, sizeof(*node.as.cmd.dispatch_cache));
+        if (!node.as.cmd.dispatch_cache) return parser_report_oom(ctx);
+    } else if (node.kind == NODE_IF) {
+        node.as.if_stmt.condition_cache = arena_alloc_zero(ctx->arena, sizeof(*node.as.if_stmt.condition_cache));
+        if (!node.as.if_stmt.condition_cache) return parser_report_oom(ctx);
+    } else if (node.kind == NODE_WHILE) {
+        node.as.while_stmt.condition_cache = arena_alloc_zero(ctx->arena, sizeof(*node.as.while_stmt.condition_cache));
+        if (!node.as.while_stmt.condition_cache) return parser_report_oom(ctx);
+    }
     if (!arena_arr_push(ctx->arena, *list, node)) return parser_report_oom(ctx);
     return true;
 }
@@ -107,6 +121,8 @@ static bool parser_append_node(Parser_Context *ctx, Node_List *list, Node node)
 static bool parser_append_elseif(Parser_Context *ctx, ElseIf_Clause_List *list, ElseIf_Clause clause) {
     if (!ctx || !list) return false;
     if (!parser_consume_append_budget(ctx)) return parser_report_oom(ctx);
+    clause.condition_cache = arena_alloc_zero(ctx->arena, sizeof(*clause.condition_cache));
+    if (!clause.condition_cache) return parser_report_oom(ctx);
     if (!arena_arr_push(ctx->arena, *list, clause)) return parser_report_oom(ctx);
     return true;
 }
@@ -5,6 +5,12 @@
 #include "lexer.h"
 #include "arena.h" 
 
+// Version of the tree the lexer and parse_tokens() produce. The on-disk AST
+// cache stores it and drops entries built by any other version, so bump it
+// whenever parser output changes: tokenization, grammar, argument splitting
+// or merging, error recovery, or the Node/Arg fields the cache serializes.
+#define PARSER_AST_VERSION 1u
+
 // --- Argument Structures ---
 
 // Tracks how an argument was quoted in the original CMake source.
@@ -14,13 +20,40 @@ typedef enum {
     ARG_BRACKET       // Bracket argument, e.g. [[raw text]]; no expansion or ';' splitting
 } Arg_Kind;
 
+// Expansion template cache owned by the evaluator. The parser allocates one
+// zeroed record per argument; compiled_owner ties the template to the session
+// that built it.
+typedef struct {
+    const void *compiled;
+    size_t compiled_owner;
+} Arg_Cache;
+
 typedef struct {
     Token *items;
     Arg_Kind kind;    // Preserves the original quoting style of this argument
+    Arg_Cache *cache; // NULL for arguments built outside the parser; never cached
 } Arg;
 
 typedef Arg *Args;
 
+// Compiled if()/while() condition owned by the evaluator. The parser allocates
+// one zeroed record per condition; compiled_owner ties the program to the
+// session that built it.
+typedef struct {
+    const void *compiled;
+    size_t compiled_owner;
+} Condition_Cache;
+
+// Command dispatch cache owned by the evaluator. The parser allocates one
+// zeroed record per command node; the generations decide whether `command`
+// is still valid.
+typedef struct {
+    const void *command;
+    size_t registry_generation;
+    size_t user_generation;
+    int kind;
+} Command_Dispatch_Cache;
+
 // --- AST Structures ---
 
 typedef enum {
@@ -38,6 +71,7 @@ typedef Node *Node_List;
 typedef struct {
     Args condition;
     Node_List block;
+    Condition_Cache *condition_cache;
 } ElseIf_Clause;
 
 typedef ElseIf_Clause *ElseIf_Clause_List;
@@ -53,6 +87,8 @@ struct Node {
         struct {
             String_View name;
             Args args;
+            // NULL for nodes built outside the parser; they are never cached.
+            Command_Dispatch_Cache *dispatch_cache;
         } cmd;
 
         struct {
@@ -60,6 +96,7 @@ struct Node {
             Node_List then_block; 
             ElseIf_Clause_List elseif_clauses;
             Node_List else_block; 
+            Condition_Cache *condition_cache;
         } if_stmt;
 
         struct {
@@ -70,6 +107,7 @@ struct Node {
         struct {
             Args condition;       
             Node_List body;       
+            Condition_Cache *condition_cache;
         } while_stmt;
 
         struct {
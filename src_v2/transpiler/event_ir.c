@@ -3,87 +3,166 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "arena_dyn.h"
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#define getpid _getpid
+#endif
 
-static bool event_copy_sv_inplace(Arena *arena, String_View *sv) {
-    if (!arena || !sv) return false;
-    if (!sv->data || sv->count == 0) return true;
+#include "arena_dyn.h"
 
-    char *copy = arena_alloc(arena, sv->count + 1);
-    if (!copy) return false;
+// Walks every string and array field an event owns. `array` replaces the
+// array pointer with a writable one before its elements are visited, so one
+// traversal serves deep copies, serialization and relocation on load.
+typedef struct Event_Field_Visitor Event_Field_Visitor;
+struct Event_Field_Visitor {
+    bool (*sv)(Event_Field_Visitor *v, String_View *sv);
+    bool (*array)(Event_Field_Visitor *v, void **items, size_t count, size_t item_size);
+};
 
-    memcpy(copy, sv->data, sv->count);
-    copy[sv->count] = '\0';
-    *sv = nob_sv_from_parts(copy, sv->count);
-    return true;
+static bool event_visit_sv(Event_Field_Visitor *v, String_View *sv) {
+    return v->sv(v, sv);
 }
 
-static bool event_copy_sv_array_inplace(Arena *arena, String_View **items, size_t count) {
-    if (!arena || !items) return false;
+static bool event_visit_sv_array(Event_Field_Visitor *v, String_View **items, size_t count) {
     if (!*items || count == 0) {
         *items = NULL;
         return true;
     }
-
-    String_View *copy = arena_alloc_array(arena, String_View, count);
-    if (!copy) return false;
-
+    if (!v->array(v, (void**)items, count, sizeof(String_View))) return false;
     for (size_t i = 0; i < count; ++i) {
-        copy[i] = (*items)[i];
-        if (!event_copy_sv_inplace(arena, &copy[i])) return false;
+        if (!v->sv(v, &(*items)[i])) return false;
     }
-
-    *items = copy;
     return true;
 }
 
-static bool event_copy_link_item_metadata_array_inplace(Arena *arena,
-                                                        Event_Link_Item_Metadata **items,
-                                                        size_t count) {
-    if (!arena || !items) return false;
+static bool event_visit_link_item_metadata(Event_Field_Visitor *v, Event_Link_Item_Metadata *item) {
+    return event_visit_sv_array(v, &item->configurations, item->configuration_count) &&
+           event_visit_sv_array(v, &item->compile_languages, item->compile_language_count) &&
+           event_visit_sv_array(v, &item->platform_ids, item->platform_id_count) &&
+           event_visit_sv(v, &item->value) &&
+           event_visit_sv(v, &item->target_name) &&
+           event_visit_sv(v, &item->property_name);
+}
+
+static bool event_visit_link_item_metadata_array(Event_Field_Visitor *v,
+                                                 Event_Link_Item_Metadata **items,
+                                                 size_t count) {
     if (!*items || count == 0) {
         *items = NULL;
         return true;
     }
+    if (!v->array(v, (void**)items, count, sizeof(Event_Link_Item_Metadata))) return false;
+    for (size_t i = 0; i < count; ++i) {
+        if (!event_visit_link_item_metadata(v, &(*items)[i])) return false;
+    }
+    return true;
+}
+
+static bool event_visit_property_mutate(Event_Field_Visitor *v, Event_Directory_Property_Mutate *mut) {
+    return event_visit_sv(v, &mut->property_name) &&
+           event_visit_sv_array(v, &mut->items, mut->item_count) &&
+           event_visit_sv_array(v, &mut->typed_items, mut->typed_item_count) &&
+           event_visit_link_item_metadata_array(v, &mut->typed_item_semantics, mut->typed_item_count);
+}
 
-    Event_Link_Item_Metadata *copy = arena_alloc_array(arena, Event_Link_Item_Metadata, count);
+static bool event_copy_sv_into(Arena *arena, String_View *sv) {
+    char *copy = arena_alloc(arena, sv->count + 1);
     if (!copy) return false;
 
-    for (size_t i = 0; i < count; ++i) {
-        copy[i] = (*items)[i];
-        if (!event_copy_sv_array_inplace(arena, &copy[i].configurations, copy[i].configuration_count) ||
-            !event_copy_sv_array_inplace(arena, &copy[i].compile_languages, copy[i].compile_language_count) ||
-            !event_copy_sv_array_inplace(arena, &copy[i].platform_ids, copy[i].platform_id_count) ||
-            !event_copy_sv_inplace(arena, &copy[i].value) ||
-            !event_copy_sv_inplace(arena, &copy[i].target_name) ||
-            !event_copy_sv_inplace(arena, &copy[i].property_name)) {
-            return false;
-        }
+    memcpy(copy, sv->data, sv->count);
+    copy[sv->count] = '\0';
+    *sv = nob_sv_from_parts(copy, sv->count);
+    return true;
+}
+
+static uint64_t event_intern_hash(String_View sv) {
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < sv.count; ++i) {
+        hash ^= (unsigned char)sv.data[i];
+        hash *= 1099511628211ull;
     }
+    return hash;
+}
 
-    *items = copy;
+// Keeps the table at most 3/4 full. Superseded slot arrays stay in the
+// stream arena; with doubling they add up to less than the live one.
+static bool event_intern_reserve(Event_Stream *stream) {
+    if ((stream->intern_count + 1) * 4 <= stream->intern_capacity * 3) return true;
+
+    size_t capacity = stream->intern_capacity ? stream->intern_capacity * 2 : 256;
+    Event_String_Intern *slots = arena_alloc_array_zero(stream->arena, Event_String_Intern, capacity);
+    if (!slots) return false;
+
+    for (size_t i = 0; i < stream->intern_capacity; ++i) {
+        const Event_String_Intern *old = &stream->intern_slots[i];
+        if (!old->text.data) continue;
+        size_t at = (size_t)old->hash & (capacity - 1);
+        while (slots[at].text.data) at = (at + 1) & (capacity - 1);
+        slots[at] = *old;
+    }
+    stream->intern_slots = slots;
+    stream->intern_capacity = capacity;
     return true;
 }
 
-static bool event_copy_link_item_metadata_inplace(Arena *arena, Event_Link_Item_Metadata *item) {
-    if (!arena || !item) return false;
-    if (!event_copy_sv_array_inplace(arena, &item->configurations, item->configuration_count) ||
-        !event_copy_sv_array_inplace(arena, &item->compile_languages, item->compile_language_count) ||
-        !event_copy_sv_array_inplace(arena, &item->platform_ids, item->platform_id_count) ||
-        !event_copy_sv_inplace(arena, &item->value) ||
-        !event_copy_sv_inplace(arena, &item->target_name) ||
-        !event_copy_sv_inplace(arena, &item->property_name)) {
-        return false;
+// Finds the slot holding `sv`, copying the text into a new slot on first
+// sight. `*found` tells the two cases apart.
+static Event_String_Intern *event_stream_intern_slot(Event_Stream *stream, String_View sv, bool *found) {
+    if (!event_intern_reserve(stream)) return NULL;
+
+    uint64_t hash = event_intern_hash(sv);
+    size_t mask = stream->intern_capacity - 1;
+    for (size_t at = (size_t)hash & mask;; at = (at + 1) & mask) {
+        Event_String_Intern *slot = &stream->intern_slots[at];
+        if (!slot->text.data) {
+            if (!event_copy_sv_into(stream->arena, &sv)) return NULL;
+            slot->hash = hash;
+            slot->text = sv;
+            stream->intern_count++;
+            *found = false;
+            return slot;
+        }
+        if (slot->hash == hash &&
+            slot->text.count == sv.count &&
+            memcmp(slot->text.data, sv.data, sv.count) == 0) {
+            *found = true;
+            return slot;
+        }
     }
+}
+
+// Replaces `sv` with the stream's canonical copy.
+static bool event_stream_intern(Event_Stream *stream, String_View *sv) {
+    bool found = false;
+    Event_String_Intern *slot = event_stream_intern_slot(stream, *sv, &found);
+    if (!slot) return false;
+    if (found) stream->intern_bytes_saved += sv->count + 1;
+    *sv = slot->text;
     return true;
 }
 
-static bool event_copy_property_mutate_inplace(Arena *arena, Event_Directory_Property_Mutate *mut) {
-    if (!arena || !mut) return false;
-    if (!event_copy_sv_inplace(arena, &mut->property_name)) return false;
-    if (!event_copy_sv_array_inplace(arena, &mut->items, mut->item_count)) return false;
-    if (!event_copy_sv_array_inplace(arena, &mut->typed_items, mut->typed_item_count)) return false;
-    if (!event_copy_link_item_metadata_array_inplace(arena, &mut->typed_item_semantics, mut->typed_item_count)) return false;
+typedef struct {
+    Event_Field_Visitor base;
+    Arena *arena;
+    Event_Stream *interner; // NULL copies every string
+} Event_Copy_Visitor;
+
+static bool event_copy_sv(Event_Field_Visitor *v, String_View *sv) {
+    if (!sv->data || sv->count == 0) return true;
+    Event_Copy_Visitor *copier = (Event_Copy_Visitor*)v;
+    if (copier->interner) return event_stream_intern(copier->interner, sv);
+    return event_copy_sv_into(copier->arena, sv);
+}
+
+static bool event_copy_array(Event_Field_Visitor *v, void **items, size_t count, size_t item_size) {
+    void *copy = arena_memdup(((Event_Copy_Visitor*)v)->arena, *items, count * item_size);
+    if (!copy) return false;
+    *items = copy;
     return true;
 }
 
@@ -234,73 +313,70 @@ static const char *event_target_file_set_kind_name(Event_Target_File_Set_Kind ki
     return "unknown";
 }
 
-static bool event_deep_copy_payload(Arena *arena, Event *ev) {
-    if (!arena || !ev) return false;
-    if (!event_copy_sv_inplace(arena, &ev->h.origin.file_path)) return false;
-
-    switch (ev->h.kind) {
+static bool event_visit_fields(Event_Field_Visitor *v, Event_Kind kind, Event_Payload *as) {
+    switch (kind) {
         case EVENT_DIAG:
-            if (!event_copy_sv_inplace(arena, &ev->as.diag.component)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.diag.command)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.diag.code)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.diag.error_class)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.diag.cause)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.diag.hint)) return false;
+            if (!event_visit_sv(v, &as->diag.component)) return false;
+            if (!event_visit_sv(v, &as->diag.command)) return false;
+            if (!event_visit_sv(v, &as->diag.code)) return false;
+            if (!event_visit_sv(v, &as->diag.error_class)) return false;
+            if (!event_visit_sv(v, &as->diag.cause)) return false;
+            if (!event_visit_sv(v, &as->diag.hint)) return false;
             break;
 
         case EVENT_COMMAND_BEGIN:
-            if (!event_copy_sv_inplace(arena, &ev->as.command_begin.command_name)) return false;
+            if (!event_visit_sv(v, &as->command_begin.command_name)) return false;
             break;
         case EVENT_COMMAND_END:
-            if (!event_copy_sv_inplace(arena, &ev->as.command_end.command_name)) return false;
+            if (!event_visit_sv(v, &as->command_end.command_name)) return false;
             break;
 
         case EVENT_INCLUDE_BEGIN:
-            if (!event_copy_sv_inplace(arena, &ev->as.include_begin.path)) return false;
+            if (!event_visit_sv(v, &as->include_begin.path)) return false;
             break;
         case EVENT_INCLUDE_END:
-            if (!event_copy_sv_inplace(arena, &ev->as.include_end.path)) return false;
+            if (!event_visit_sv(v, &as->include_end.path)) return false;
             break;
         case EVENT_ADD_SUBDIRECTORY_BEGIN:
-            if (!event_copy_sv_inplace(arena, &ev->as.add_subdirectory_begin.source_dir)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.add_subdirectory_begin.binary_dir)) return false;
+            if (!event_visit_sv(v, &as->add_subdirectory_begin.source_dir)) return false;
+            if (!event_visit_sv(v, &as->add_subdirectory_begin.binary_dir)) return false;
             break;
         case EVENT_ADD_SUBDIRECTORY_END:
-            if (!event_copy_sv_inplace(arena, &ev->as.add_subdirectory_end.source_dir)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.add_subdirectory_end.binary_dir)) return false;
+            if (!event_visit_sv(v, &as->add_subdirectory_end.source_dir)) return false;
+            if (!event_visit_sv(v, &as->add_subdirectory_end.binary_dir)) return false;
             break;
         case EVENT_CMAKE_LANGUAGE_CALL:
-            if (!event_copy_sv_inplace(arena, &ev->as.cmake_language_call.command_name)) return false;
+            if (!event_visit_sv(v, &as->cmake_language_call.command_name)) return false;
             break;
         case EVENT_CMAKE_LANGUAGE_EVAL:
-            if (!event_copy_sv_inplace(arena, &ev->as.cmake_language_eval.code)) return false;
+            if (!event_visit_sv(v, &as->cmake_language_eval.code)) return false;
             break;
         case EVENT_CMAKE_LANGUAGE_DEFER_QUEUE:
-            if (!event_copy_sv_inplace(arena, &ev->as.cmake_language_defer_queue.defer_id)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cmake_language_defer_queue.command_name)) return false;
+            if (!event_visit_sv(v, &as->cmake_language_defer_queue.defer_id)) return false;
+            if (!event_visit_sv(v, &as->cmake_language_defer_queue.command_name)) return false;
             break;
 
         case EVENT_DIRECTORY_ENTER:
-            if (!event_copy_sv_inplace(arena, &ev->as.directory_enter.source_dir)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.directory_enter.binary_dir)) return false;
+            if (!event_visit_sv(v, &as->directory_enter.source_dir)) return false;
+            if (!event_visit_sv(v, &as->directory_enter.binary_dir)) return false;
             break;
         case EVENT_DIRECTORY_LEAVE:
-            if (!event_copy_sv_inplace(arena, &ev->as.directory_leave.source_dir)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.directory_leave.binary_dir)) return false;
+            if (!event_visit_sv(v, &as->directory_leave.source_dir)) return false;
+            if (!event_visit_sv(v, &as->directory_leave.binary_dir)) return false;
             break;
         case EVENT_DIRECTORY_PROPERTY_MUTATE:
-            if (!event_copy_property_mutate_inplace(arena, &ev->as.directory_property_mutate)) return false;
+            if (!event_visit_property_mutate(v, &as->directory_property_mutate)) return false;
             break;
         case EVENT_GLOBAL_PROPERTY_MUTATE:
-            if (!event_copy_property_mutate_inplace(arena, &ev->as.global_property_mutate)) return false;
+            if (!event_visit_property_mutate(v, &as->global_property_mutate)) return false;
             break;
 
         case EVENT_VAR_SET:
-            if (!event_copy_sv_inplace(arena, &ev->as.var_set.key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.var_set.value)) return false;
+            if (!event_visit_sv(v, &as->var_set.key)) return false;
+            if (!event_visit_sv(v, &as->var_set.value)) return false;
             break;
         case EVENT_VAR_UNSET:
-            if (!event_copy_sv_inplace(arena, &ev->as.var_unset.key)) return false;
+            if (!event_visit_sv(v, &as->var_unset.key)) return false;
             break;
 
         case EVENT_SCOPE_PUSH:
@@ -317,394 +393,394 @@ static bool event_deep_copy_payload(Arena *arena, Event *ev) {
             break;
 
         case EVENT_POLICY_SET:
-            if (!event_copy_sv_inplace(arena, &ev->as.policy_set.policy_id)) return false;
+            if (!event_visit_sv(v, &as->policy_set.policy_id)) return false;
             break;
 
         case EVENT_FLOW_RETURN:
-            if (!event_copy_sv_array_inplace(arena,
-                                             &ev->as.flow_return.propagate_vars,
-                                             ev->as.flow_return.propagate_count)) return false;
+            if (!event_visit_sv_array(v,
+                                      &as->flow_return.propagate_vars,
+                                      as->flow_return.propagate_count)) return false;
             break;
         case EVENT_FLOW_BRANCH_TAKEN:
-            if (!event_copy_sv_inplace(arena, &ev->as.flow_branch_taken.branch_kind)) return false;
+            if (!event_visit_sv(v, &as->flow_branch_taken.branch_kind)) return false;
             break;
         case EVENT_FLOW_LOOP_BEGIN:
-            if (!event_copy_sv_inplace(arena, &ev->as.flow_loop_begin.loop_kind)) return false;
+            if (!event_visit_sv(v, &as->flow_loop_begin.loop_kind)) return false;
             break;
         case EVENT_FLOW_LOOP_END:
-            if (!event_copy_sv_inplace(arena, &ev->as.flow_loop_end.loop_kind)) return false;
+            if (!event_visit_sv(v, &as->flow_loop_end.loop_kind)) return false;
             break;
         case EVENT_FLOW_DEFER_QUEUE:
-            if (!event_copy_sv_inplace(arena, &ev->as.flow_defer_queue.defer_id)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.flow_defer_queue.command_name)) return false;
+            if (!event_visit_sv(v, &as->flow_defer_queue.defer_id)) return false;
+            if (!event_visit_sv(v, &as->flow_defer_queue.command_name)) return false;
             break;
         case EVENT_FLOW_FUNCTION_BEGIN:
-            if (!event_copy_sv_inplace(arena, &ev->as.flow_function_begin.name)) return false;
+            if (!event_visit_sv(v, &as->flow_function_begin.name)) return false;
             break;
         case EVENT_FLOW_FUNCTION_END:
-            if (!event_copy_sv_inplace(arena, &ev->as.flow_function_end.name)) return false;
+            if (!event_visit_sv(v, &as->flow_function_end.name)) return false;
             break;
         case EVENT_FLOW_MACRO_BEGIN:
-            if (!event_copy_sv_inplace(arena, &ev->as.flow_macro_begin.name)) return false;
+            if (!event_visit_sv(v, &as->flow_macro_begin.name)) return false;
             break;
         case EVENT_FLOW_MACRO_END:
-            if (!event_copy_sv_inplace(arena, &ev->as.flow_macro_end.name)) return false;
+            if (!event_visit_sv(v, &as->flow_macro_end.name)) return false;
             break;
 
         case EVENT_FS_WRITE_FILE:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_write_file.path)) return false;
+            if (!event_visit_sv(v, &as->fs_write_file.path)) return false;
             break;
         case EVENT_FS_APPEND_FILE:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_append_file.path)) return false;
+            if (!event_visit_sv(v, &as->fs_append_file.path)) return false;
             break;
         case EVENT_FS_READ_FILE:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_read_file.path)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_read_file.out_var)) return false;
+            if (!event_visit_sv(v, &as->fs_read_file.path)) return false;
+            if (!event_visit_sv(v, &as->fs_read_file.out_var)) return false;
             break;
         case EVENT_FS_GLOB:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_glob.out_var)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_glob.base_dir)) return false;
+            if (!event_visit_sv(v, &as->fs_glob.out_var)) return false;
+            if (!event_visit_sv(v, &as->fs_glob.base_dir)) return false;
             break;
         case EVENT_FS_MKDIR:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_mkdir.path)) return false;
+            if (!event_visit_sv(v, &as->fs_mkdir.path)) return false;
             break;
         case EVENT_FS_REMOVE:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_remove.path)) return false;
+            if (!event_visit_sv(v, &as->fs_remove.path)) return false;
             break;
         case EVENT_FS_COPY:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_copy.source)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_copy.destination)) return false;
+            if (!event_visit_sv(v, &as->fs_copy.source)) return false;
+            if (!event_visit_sv(v, &as->fs_copy.destination)) return false;
             break;
         case EVENT_FS_RENAME:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_rename.source)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_rename.destination)) return false;
+            if (!event_visit_sv(v, &as->fs_rename.source)) return false;
+            if (!event_visit_sv(v, &as->fs_rename.destination)) return false;
             break;
         case EVENT_FS_CREATE_LINK:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_create_link.source)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_create_link.destination)) return false;
+            if (!event_visit_sv(v, &as->fs_create_link.source)) return false;
+            if (!event_visit_sv(v, &as->fs_create_link.destination)) return false;
             break;
         case EVENT_FS_CHMOD:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_chmod.path)) return false;
+            if (!event_visit_sv(v, &as->fs_chmod.path)) return false;
             break;
         case EVENT_FS_ARCHIVE_CREATE:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_archive_create.path)) return false;
+            if (!event_visit_sv(v, &as->fs_archive_create.path)) return false;
             break;
         case EVENT_FS_ARCHIVE_EXTRACT:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_archive_extract.path)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_archive_extract.destination)) return false;
+            if (!event_visit_sv(v, &as->fs_archive_extract.path)) return false;
+            if (!event_visit_sv(v, &as->fs_archive_extract.destination)) return false;
             break;
         case EVENT_FS_TRANSFER_DOWNLOAD:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_transfer_download.source)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_transfer_download.destination)) return false;
+            if (!event_visit_sv(v, &as->fs_transfer_download.source)) return false;
+            if (!event_visit_sv(v, &as->fs_transfer_download.destination)) return false;
             break;
         case EVENT_FS_TRANSFER_UPLOAD:
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_transfer_upload.source)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.fs_transfer_upload.destination)) return false;
+            if (!event_visit_sv(v, &as->fs_transfer_upload.source)) return false;
+            if (!event_visit_sv(v, &as->fs_transfer_upload.destination)) return false;
             break;
 
         case EVENT_PROC_EXEC_REQUEST:
-            if (!event_copy_sv_inplace(arena, &ev->as.proc_exec_request.command)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.proc_exec_request.working_directory)) return false;
+            if (!event_visit_sv(v, &as->proc_exec_request.command)) return false;
+            if (!event_visit_sv(v, &as->proc_exec_request.working_directory)) return false;
             break;
         case EVENT_PROC_EXEC_RESULT:
-            if (!event_copy_sv_inplace(arena, &ev->as.proc_exec_result.command)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.proc_exec_result.result_code)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.proc_exec_result.stdout_text)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.proc_exec_result.stderr_text)) return false;
+            if (!event_visit_sv(v, &as->proc_exec_result.command)) return false;
+            if (!event_visit_sv(v, &as->proc_exec_result.result_code)) return false;
+            if (!event_visit_sv(v, &as->proc_exec_result.stdout_text)) return false;
+            if (!event_visit_sv(v, &as->proc_exec_result.stderr_text)) return false;
             break;
 
         case EVENT_STRING_REPLACE:
-            if (!event_copy_sv_inplace(arena, &ev->as.string_replace.out_var)) return false;
+            if (!event_visit_sv(v, &as->string_replace.out_var)) return false;
             break;
         case EVENT_STRING_CONFIGURE:
-            if (!event_copy_sv_inplace(arena, &ev->as.string_configure.out_var)) return false;
+            if (!event_visit_sv(v, &as->string_configure.out_var)) return false;
             break;
         case EVENT_STRING_REGEX:
-            if (!event_copy_sv_inplace(arena, &ev->as.string_regex.mode)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.string_regex.out_var)) return false;
+            if (!event_visit_sv(v, &as->string_regex.mode)) return false;
+            if (!event_visit_sv(v, &as->string_regex.out_var)) return false;
             break;
         case EVENT_STRING_HASH:
-            if (!event_copy_sv_inplace(arena, &ev->as.string_hash.algorithm)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.string_hash.out_var)) return false;
+            if (!event_visit_sv(v, &as->string_hash.algorithm)) return false;
+            if (!event_visit_sv(v, &as->string_hash.out_var)) return false;
             break;
         case EVENT_STRING_TIMESTAMP:
-            if (!event_copy_sv_inplace(arena, &ev->as.string_timestamp.out_var)) return false;
+            if (!event_visit_sv(v, &as->string_timestamp.out_var)) return false;
             break;
 
         case EVENT_LIST_APPEND:
-            if (!event_copy_sv_inplace(arena, &ev->as.list_append.list_var)) return false;
+            if (!event_visit_sv(v, &as->list_append.list_var)) return false;
             break;
         case EVENT_LIST_PREPEND:
-            if (!event_copy_sv_inplace(arena, &ev->as.list_prepend.list_var)) return false;
+            if (!event_visit_sv(v, &as->list_prepend.list_var)) return false;
             break;
         case EVENT_LIST_INSERT:
-            if (!event_copy_sv_inplace(arena, &ev->as.list_insert.list_var)) return false;
+            if (!event_visit_sv(v, &as->list_insert.list_var)) return false;
             break;
         case EVENT_LIST_REMOVE:
-            if (!event_copy_sv_inplace(arena, &ev->as.list_remove.list_var)) return false;
+            if (!event_visit_sv(v, &as->list_remove.list_var)) return false;
             break;
         case EVENT_LIST_TRANSFORM:
-            if (!event_copy_sv_inplace(arena, &ev->as.list_transform.list_var)) return false;
+            if (!event_visit_sv(v, &as->list_transform.list_var)) return false;
             break;
         case EVENT_LIST_SORT:
-            if (!event_copy_sv_inplace(arena, &ev->as.list_sort.list_var)) return false;
+            if (!event_visit_sv(v, &as->list_sort.list_var)) return false;
             break;
 
         case EVENT_MATH_EXPR:
-            if (!event_copy_sv_inplace(arena, &ev->as.math_expr.out_var)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.math_expr.format)) return false;
+            if (!event_visit_sv(v, &as->math_expr.out_var)) return false;
+            if (!event_visit_sv(v, &as->math_expr.format)) return false;
             break;
         case EVENT_PATH_NORMALIZE:
-            if (!event_copy_sv_inplace(arena, &ev->as.path_normalize.out_var)) return false;
+            if (!event_visit_sv(v, &as->path_normalize.out_var)) return false;
             break;
         case EVENT_PATH_COMPARE:
-            if (!event_copy_sv_inplace(arena, &ev->as.path_compare.out_var)) return false;
+            if (!event_visit_sv(v, &as->path_compare.out_var)) return false;
             break;
         case EVENT_PATH_CONVERT:
-            if (!event_copy_sv_inplace(arena, &ev->as.path_convert.out_var)) return false;
+            if (!event_visit_sv(v, &as->path_convert.out_var)) return false;
             break;
 
         case EVENT_TEST_ADD:
-            if (!event_copy_sv_inplace(arena, &ev->as.test_add.name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.test_add.command)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.test_add.working_dir)) return false;
-            if (!event_copy_sv_array_inplace(arena,
-                                             &ev->as.test_add.configurations,
-                                             ev->as.test_add.configuration_count)) {
+            if (!event_visit_sv(v, &as->test_add.name)) return false;
+            if (!event_visit_sv(v, &as->test_add.command)) return false;
+            if (!event_visit_sv(v, &as->test_add.working_dir)) return false;
+            if (!event_visit_sv_array(v,
+                                      &as->test_add.configurations,
+                                      as->test_add.configuration_count)) {
                 return false;
             }
             break;
         case EVENT_INSTALL_RULE_ADD:
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.item)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.destination)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.rename)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.component)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.archive_component)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.library_component)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.runtime_component)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.includes_component)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.public_header_component)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.namelink_component)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.export_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.archive_destination)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.library_destination)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.runtime_destination)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.includes_destination)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.install_rule_add.public_header_destination)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.item)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.destination)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.rename)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.component)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.archive_component)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.library_component)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.runtime_component)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.includes_component)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.public_header_component)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.namelink_component)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.export_name)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.archive_destination)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.library_destination)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.runtime_destination)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.includes_destination)) return false;
+            if (!event_visit_sv(v, &as->install_rule_add.public_header_destination)) return false;
             break;
         case EVENT_EXPORT_INSTALL:
-            if (!event_copy_sv_inplace(arena, &ev->as.export_install.export_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_install.destination)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_install.export_namespace)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_install.file_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_install.component)) return false;
+            if (!event_visit_sv(v, &as->export_install.export_name)) return false;
+            if (!event_visit_sv(v, &as->export_install.destination)) return false;
+            if (!event_visit_sv(v, &as->export_install.export_namespace)) return false;
+            if (!event_visit_sv(v, &as->export_install.file_name)) return false;
+            if (!event_visit_sv(v, &as->export_install.component)) return false;
             break;
         case EVENT_EXPORT_BUILD_DECLARE:
-            if (!event_copy_sv_inplace(arena, &ev->as.export_build_declare.export_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_build_declare.logical_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_build_declare.file_path)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_build_declare.export_namespace)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_build_declare.cxx_modules_directory)) return false;
+            if (!event_visit_sv(v, &as->export_build_declare.export_key)) return false;
+            if (!event_visit_sv(v, &as->export_build_declare.logical_name)) return false;
+            if (!event_visit_sv(v, &as->export_build_declare.file_path)) return false;
+            if (!event_visit_sv(v, &as->export_build_declare.export_namespace)) return false;
+            if (!event_visit_sv(v, &as->export_build_declare.cxx_modules_directory)) return false;
             break;
         case EVENT_EXPORT_BUILD_ADD_TARGET:
-            if (!event_copy_sv_inplace(arena, &ev->as.export_build_add_target.export_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_build_add_target.target_name)) return false;
+            if (!event_visit_sv(v, &as->export_build_add_target.export_key)) return false;
+            if (!event_visit_sv(v, &as->export_build_add_target.target_name)) return false;
             break;
         case EVENT_EXPORT_PACKAGE_REGISTRY:
-            if (!event_copy_sv_inplace(arena, &ev->as.export_package_registry.package_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.export_package_registry.prefix)) return false;
+            if (!event_visit_sv(v, &as->export_package_registry.package_name)) return false;
+            if (!event_visit_sv(v, &as->export_package_registry.prefix)) return false;
             break;
         case EVENT_CPACK_ADD_INSTALL_TYPE:
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_install_type.name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_install_type.display_name)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_install_type.name)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_install_type.display_name)) return false;
             break;
         case EVENT_CPACK_ADD_COMPONENT_GROUP:
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component_group.name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component_group.display_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component_group.description)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component_group.parent_group)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component_group.name)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component_group.display_name)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component_group.description)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component_group.parent_group)) return false;
             break;
         case EVENT_CPACK_ADD_COMPONENT:
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component.name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component.display_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component.description)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component.group)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component.depends)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component.install_types)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component.archive_file)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_add_component.plist)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component.name)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component.display_name)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component.description)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component.group)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component.depends)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component.install_types)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component.archive_file)) return false;
+            if (!event_visit_sv(v, &as->cpack_add_component.plist)) return false;
             break;
         case EVENT_CPACK_PACKAGE_DECLARE:
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.package_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.package_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.package_version)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.package_file_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.package_directory)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.archive_file_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.archive_file_extension)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.components_grouping)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.project_config_file)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_declare.components_all)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.package_key)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.package_name)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.package_version)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.package_file_name)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.package_directory)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.archive_file_name)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.archive_file_extension)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.components_grouping)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.project_config_file)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_declare.components_all)) return false;
             break;
         case EVENT_CPACK_PACKAGE_ADD_GENERATOR:
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_add_generator.package_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_add_generator.generator)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_add_generator.package_key)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_add_generator.generator)) return false;
             break;
         case EVENT_CPACK_PACKAGE_ARCHIVE_NAME_OVERRIDE:
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_archive_name_override.package_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_archive_name_override.archive_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.cpack_package_archive_name_override.archive_file_name)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_archive_name_override.package_key)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_archive_name_override.archive_key)) return false;
+            if (!event_visit_sv(v, &as->cpack_package_archive_name_override.archive_file_name)) return false;
             break;
         case EVENT_PACKAGE_FIND_RESULT:
-            if (!event_copy_sv_inplace(arena, &ev->as.package_find_result.package_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.package_find_result.mode)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.package_find_result.found_path)) return false;
+            if (!event_visit_sv(v, &as->package_find_result.package_name)) return false;
+            if (!event_visit_sv(v, &as->package_find_result.mode)) return false;
+            if (!event_visit_sv(v, &as->package_find_result.found_path)) return false;
             break;
         case EVENT_PROJECT_DECLARE:
-            if (!event_copy_sv_inplace(arena, &ev->as.project_declare.name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.project_declare.version)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.project_declare.description)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.project_declare.homepage_url)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.project_declare.languages)) return false;
+            if (!event_visit_sv(v, &as->project_declare.name)) return false;
+            if (!event_visit_sv(v, &as->project_declare.version)) return false;
+            if (!event_visit_sv(v, &as->project_declare.description)) return false;
+            if (!event_visit_sv(v, &as->project_declare.homepage_url)) return false;
+            if (!event_visit_sv(v, &as->project_declare.languages)) return false;
             break;
         case EVENT_PROJECT_MINIMUM_REQUIRED:
-            if (!event_copy_sv_inplace(arena, &ev->as.project_minimum_required.version)) return false;
+            if (!event_visit_sv(v, &as->project_minimum_required.version)) return false;
             break;
         case EVENT_TARGET_DECLARE:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_declare.name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_declare.alias_of)) return false;
+            if (!event_visit_sv(v, &as->target_declare.name)) return false;
+            if (!event_visit_sv(v, &as->target_declare.alias_of)) return false;
             break;
         case EVENT_TARGET_ADD_SOURCE:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_add_source.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_add_source.path)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_add_source.file_set_name)) return false;
+            if (!event_visit_sv(v, &as->target_add_source.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_add_source.path)) return false;
+            if (!event_visit_sv(v, &as->target_add_source.file_set_name)) return false;
             break;
         case EVENT_TARGET_FILE_SET_DECLARE:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_file_set_declare.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_file_set_declare.set_name)) return false;
+            if (!event_visit_sv(v, &as->target_file_set_declare.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_file_set_declare.set_name)) return false;
             break;
         case EVENT_TARGET_FILE_SET_ADD_BASE_DIR:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_file_set_add_base_dir.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_file_set_add_base_dir.set_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_file_set_add_base_dir.path)) return false;
+            if (!event_visit_sv(v, &as->target_file_set_add_base_dir.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_file_set_add_base_dir.set_name)) return false;
+            if (!event_visit_sv(v, &as->target_file_set_add_base_dir.path)) return false;
             break;
         case EVENT_SOURCE_MARK_GENERATED:
-            if (!event_copy_sv_inplace(arena, &ev->as.source_mark_generated.path)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.source_mark_generated.directory_source_dir)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.source_mark_generated.directory_binary_dir)) return false;
+            if (!event_visit_sv(v, &as->source_mark_generated.path)) return false;
+            if (!event_visit_sv(v, &as->source_mark_generated.directory_source_dir)) return false;
+            if (!event_visit_sv(v, &as->source_mark_generated.directory_binary_dir)) return false;
             break;
         case EVENT_SOURCE_PROPERTY_MUTATE:
-            if (!event_copy_sv_inplace(arena, &ev->as.source_property_mutate.path)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.source_property_mutate.directory_source_dir)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.source_property_mutate.directory_binary_dir)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.source_property_mutate.key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.source_property_mutate.value)) return false;
+            if (!event_visit_sv(v, &as->source_property_mutate.path)) return false;
+            if (!event_visit_sv(v, &as->source_property_mutate.directory_source_dir)) return false;
+            if (!event_visit_sv(v, &as->source_property_mutate.directory_binary_dir)) return false;
+            if (!event_visit_sv(v, &as->source_property_mutate.key)) return false;
+            if (!event_visit_sv(v, &as->source_property_mutate.value)) return false;
             break;
         case EVENT_TARGET_ADD_DEPENDENCY:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_add_dependency.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_add_dependency.dependency_name)) return false;
+            if (!event_visit_sv(v, &as->target_add_dependency.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_add_dependency.dependency_name)) return false;
             break;
         case EVENT_BUILD_STEP_DECLARE:
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_declare.step_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_declare.owner_target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_declare.working_directory)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_declare.comment)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_declare.main_dependency)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_declare.depfile)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_declare.job_pool)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_declare.job_server_aware)) return false;
+            if (!event_visit_sv(v, &as->build_step_declare.step_key)) return false;
+            if (!event_visit_sv(v, &as->build_step_declare.owner_target_name)) return false;
+            if (!event_visit_sv(v, &as->build_step_declare.working_directory)) return false;
+            if (!event_visit_sv(v, &as->build_step_declare.comment)) return false;
+            if (!event_visit_sv(v, &as->build_step_declare.main_dependency)) return false;
+            if (!event_visit_sv(v, &as->build_step_declare.depfile)) return false;
+            if (!event_visit_sv(v, &as->build_step_declare.job_pool)) return false;
+            if (!event_visit_sv(v, &as->build_step_declare.job_server_aware)) return false;
             break;
         case EVENT_BUILD_STEP_ADD_OUTPUT:
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_add_output.step_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_add_output.path)) return false;
+            if (!event_visit_sv(v, &as->build_step_add_output.step_key)) return false;
+            if (!event_visit_sv(v, &as->build_step_add_output.path)) return false;
             break;
         case EVENT_BUILD_STEP_ADD_BYPRODUCT:
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_add_byproduct.step_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_add_byproduct.path)) return false;
+            if (!event_visit_sv(v, &as->build_step_add_byproduct.step_key)) return false;
+            if (!event_visit_sv(v, &as->build_step_add_byproduct.path)) return false;
             break;
         case EVENT_BUILD_STEP_ADD_DEPENDENCY:
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_add_dependency.step_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_add_dependency.item)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_add_dependency.target_name)) return false;
+            if (!event_visit_sv(v, &as->build_step_add_dependency.step_key)) return false;
+            if (!event_visit_sv(v, &as->build_step_add_dependency.item)) return false;
+            if (!event_visit_sv(v, &as->build_step_add_dependency.target_name)) return false;
             break;
         case EVENT_BUILD_STEP_ADD_COMMAND:
-            if (!event_copy_sv_inplace(arena, &ev->as.build_step_add_command.step_key)) return false;
-            if (!event_copy_sv_array_inplace(arena,
-                                             &ev->as.build_step_add_command.argv,
-                                             ev->as.build_step_add_command.argc)) {
+            if (!event_visit_sv(v, &as->build_step_add_command.step_key)) return false;
+            if (!event_visit_sv_array(v,
+                                      &as->build_step_add_command.argv,
+                                      as->build_step_add_command.argc)) {
                 return false;
             }
             break;
         case EVENT_REPLAY_ACTION_DECLARE:
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_declare.action_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_declare.working_directory)) return false;
+            if (!event_visit_sv(v, &as->replay_action_declare.action_key)) return false;
+            if (!event_visit_sv(v, &as->replay_action_declare.working_directory)) return false;
             break;
         case EVENT_REPLAY_ACTION_ADD_INPUT:
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_add_input.action_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_add_input.path)) return false;
+            if (!event_visit_sv(v, &as->replay_action_add_input.action_key)) return false;
+            if (!event_visit_sv(v, &as->replay_action_add_input.path)) return false;
             break;
         case EVENT_REPLAY_ACTION_ADD_OUTPUT:
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_add_output.action_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_add_output.path)) return false;
+            if (!event_visit_sv(v, &as->replay_action_add_output.action_key)) return false;
+            if (!event_visit_sv(v, &as->replay_action_add_output.path)) return false;
             break;
         case EVENT_REPLAY_ACTION_ADD_ARGV:
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_add_argv.action_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_add_argv.value)) return false;
+            if (!event_visit_sv(v, &as->replay_action_add_argv.action_key)) return false;
+            if (!event_visit_sv(v, &as->replay_action_add_argv.value)) return false;
             break;
         case EVENT_REPLAY_ACTION_ADD_ENV:
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_add_env.action_key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_add_env.key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.replay_action_add_env.value)) return false;
+            if (!event_visit_sv(v, &as->replay_action_add_env.action_key)) return false;
+            if (!event_visit_sv(v, &as->replay_action_add_env.key)) return false;
+            if (!event_visit_sv(v, &as->replay_action_add_env.value)) return false;
             break;
         case EVENT_TARGET_PROP_SET:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_prop_set.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_prop_set.key)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_prop_set.value)) return false;
-            if (!event_copy_sv_array_inplace(arena,
-                                             &ev->as.target_prop_set.typed_items,
-                                             ev->as.target_prop_set.typed_item_count)) {
+            if (!event_visit_sv(v, &as->target_prop_set.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_prop_set.key)) return false;
+            if (!event_visit_sv(v, &as->target_prop_set.value)) return false;
+            if (!event_visit_sv_array(v,
+                                      &as->target_prop_set.typed_items,
+                                      as->target_prop_set.typed_item_count)) {
                 return false;
             }
-            if (!event_copy_link_item_metadata_array_inplace(arena,
-                                                             &ev->as.target_prop_set.typed_item_semantics,
-                                                             ev->as.target_prop_set.typed_item_count)) {
+            if (!event_visit_link_item_metadata_array(v,
+                                                      &as->target_prop_set.typed_item_semantics,
+                                                      as->target_prop_set.typed_item_count)) {
                 return false;
             }
             break;
         case EVENT_TARGET_LINK_LIBRARIES:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_link_libraries.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_link_libraries.item)) return false;
-            if (!event_copy_link_item_metadata_inplace(arena, &ev->as.target_link_libraries.semantic)) return false;
+            if (!event_visit_sv(v, &as->target_link_libraries.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_link_libraries.item)) return false;
+            if (!event_visit_link_item_metadata(v, &as->target_link_libraries.semantic)) return false;
             break;
         case EVENT_TARGET_LINK_OPTIONS:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_link_options.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_link_options.item)) return false;
-            if (!event_copy_link_item_metadata_inplace(arena, &ev->as.target_link_options.semantic)) return false;
+            if (!event_visit_sv(v, &as->target_link_options.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_link_options.item)) return false;
+            if (!event_visit_link_item_metadata(v, &as->target_link_options.semantic)) return false;
             break;
         case EVENT_TARGET_LINK_DIRECTORIES:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_link_directories.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_link_directories.path)) return false;
-            if (!event_copy_link_item_metadata_inplace(arena, &ev->as.target_link_directories.semantic)) return false;
+            if (!event_visit_sv(v, &as->target_link_directories.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_link_directories.path)) return false;
+            if (!event_visit_link_item_metadata(v, &as->target_link_directories.semantic)) return false;
             break;
         case EVENT_TARGET_INCLUDE_DIRECTORIES:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_include_directories.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_include_directories.path)) return false;
-            if (!event_copy_link_item_metadata_inplace(arena, &ev->as.target_include_directories.semantic)) return false;
+            if (!event_visit_sv(v, &as->target_include_directories.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_include_directories.path)) return false;
+            if (!event_visit_link_item_metadata(v, &as->target_include_directories.semantic)) return false;
             break;
         case EVENT_TARGET_COMPILE_DEFINITIONS:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_compile_definitions.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_compile_definitions.item)) return false;
-            if (!event_copy_link_item_metadata_inplace(arena, &ev->as.target_compile_definitions.semantic)) return false;
+            if (!event_visit_sv(v, &as->target_compile_definitions.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_compile_definitions.item)) return false;
+            if (!event_visit_link_item_metadata(v, &as->target_compile_definitions.semantic)) return false;
             break;
         case EVENT_TARGET_COMPILE_OPTIONS:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_compile_options.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_compile_options.item)) return false;
-            if (!event_copy_link_item_metadata_inplace(arena, &ev->as.target_compile_options.semantic)) return false;
+            if (!event_visit_sv(v, &as->target_compile_options.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_compile_options.item)) return false;
+            if (!event_visit_link_item_metadata(v, &as->target_compile_options.semantic)) return false;
             break;
         case EVENT_TARGET_COMPILE_FEATURES:
-            if (!event_copy_sv_inplace(arena, &ev->as.target_compile_features.target_name)) return false;
-            if (!event_copy_sv_inplace(arena, &ev->as.target_compile_features.item)) return false;
-            if (!event_copy_link_item_metadata_inplace(arena, &ev->as.target_compile_features.semantic)) return false;
+            if (!event_visit_sv(v, &as->target_compile_features.target_name)) return false;
+            if (!event_visit_sv(v, &as->target_compile_features.item)) return false;
+            if (!event_visit_link_item_metadata(v, &as->target_compile_features.semantic)) return false;
             break;
         case EVENT_KIND_COUNT:
             return false;
@@ -713,6 +789,18 @@ static bool event_deep_copy_payload(Arena *arena, Event *ev) {
     return true;
 }
 
+static bool event_visit_payload(Event_Field_Visitor *v, Event *ev) {
+    if (!v || !ev) return false;
+    return event_visit_sv(v, &ev->h.origin.file_path) &&
+           event_visit_fields(v, ev->h.kind, &ev->as);
+}
+
+static bool event_deep_copy_payload(Arena *arena, Event_Stream *interner, Event *ev) {
+    if (!arena || !ev) return false;
+    Event_Copy_Visitor copier = {{event_copy_sv, event_copy_array}, arena, interner};
+    return event_visit_payload(&copier.base, ev);
+}
+
 static const char *const k_event_family_names[EVENT_FAMILY_COUNT] = {
 #define DEFINE_EVENT_FAMILY_NAME(kind, label) [kind] = label,
     EVENT_FAMILY_LIST(DEFINE_EVENT_FAMILY_NAME)
@@ -731,6 +819,120 @@ _Static_assert(sizeof(k_event_family_names) / sizeof(k_event_family_names[0]) ==
 _Static_assert(sizeof(k_event_kind_meta) / sizeof(k_event_kind_meta[0]) == EVENT_KIND_COUNT,
                "event kind metadata must match Event_Kind");
 
+// Bytes stored per record in the kind's payload pool.
+#define EVENT_PAYLOAD_SIZE(member) ((uint16_t)sizeof(((Event_Payload*)0)->member))
+static const uint16_t k_event_payload_size[EVENT_KIND_COUNT] = {
+    [EVENT_DIAG] = EVENT_PAYLOAD_SIZE(diag),
+    [EVENT_COMMAND_BEGIN] = EVENT_PAYLOAD_SIZE(command_begin),
+    [EVENT_COMMAND_END] = EVENT_PAYLOAD_SIZE(command_end),
+    [EVENT_INCLUDE_BEGIN] = EVENT_PAYLOAD_SIZE(include_begin),
+    [EVENT_INCLUDE_END] = EVENT_PAYLOAD_SIZE(include_end),
+    [EVENT_ADD_SUBDIRECTORY_BEGIN] = EVENT_PAYLOAD_SIZE(add_subdirectory_begin),
+    [EVENT_ADD_SUBDIRECTORY_END] = EVENT_PAYLOAD_SIZE(add_subdirectory_end),
+    [EVENT_CMAKE_LANGUAGE_CALL] = EVENT_PAYLOAD_SIZE(cmake_language_call),
+    [EVENT_CMAKE_LANGUAGE_EVAL] = EVENT_PAYLOAD_SIZE(cmake_language_eval),
+    [EVENT_CMAKE_LANGUAGE_DEFER_QUEUE] = EVENT_PAYLOAD_SIZE(cmake_language_defer_queue),
+    [EVENT_DIRECTORY_ENTER] = EVENT_PAYLOAD_SIZE(directory_enter),
+    [EVENT_DIRECTORY_LEAVE] = EVENT_PAYLOAD_SIZE(directory_leave),
+    [EVENT_DIRECTORY_PROPERTY_MUTATE] = EVENT_PAYLOAD_SIZE(directory_property_mutate),
+    [EVENT_GLOBAL_PROPERTY_MUTATE] = EVENT_PAYLOAD_SIZE(global_property_mutate),
+    [EVENT_VAR_SET] = EVENT_PAYLOAD_SIZE(var_set),
+    [EVENT_VAR_UNSET] = EVENT_PAYLOAD_SIZE(var_unset),
+    [EVENT_SCOPE_PUSH] = EVENT_PAYLOAD_SIZE(scope_push),
+    [EVENT_SCOPE_POP] = EVENT_PAYLOAD_SIZE(scope_pop),
+    [EVENT_POLICY_PUSH] = EVENT_PAYLOAD_SIZE(policy_push),
+    [EVENT_POLICY_POP] = EVENT_PAYLOAD_SIZE(policy_pop),
+    [EVENT_POLICY_SET] = EVENT_PAYLOAD_SIZE(policy_set),
+    [EVENT_FLOW_RETURN] = EVENT_PAYLOAD_SIZE(flow_return),
+    [EVENT_FLOW_IF_EVAL] = EVENT_PAYLOAD_SIZE(flow_if_eval),
+    [EVENT_FLOW_BRANCH_TAKEN] = EVENT_PAYLOAD_SIZE(flow_branch_taken),
+    [EVENT_FLOW_LOOP_BEGIN] = EVENT_PAYLOAD_SIZE(flow_loop_begin),
+    [EVENT_FLOW_LOOP_END] = EVENT_PAYLOAD_SIZE(flow_loop_end),
+    [EVENT_FLOW_BREAK] = EVENT_PAYLOAD_SIZE(flow_break),
+    [EVENT_FLOW_CONTINUE] = EVENT_PAYLOAD_SIZE(flow_continue),
+    [EVENT_FLOW_DEFER_QUEUE] = EVENT_PAYLOAD_SIZE(flow_defer_queue),
+    [EVENT_FLOW_DEFER_FLUSH] = EVENT_PAYLOAD_SIZE(flow_defer_flush),
+    [EVENT_FLOW_BLOCK_BEGIN] = EVENT_PAYLOAD_SIZE(flow_block_begin),
+    [EVENT_FLOW_BLOCK_END] = EVENT_PAYLOAD_SIZE(flow_block_end),
+    [EVENT_FLOW_FUNCTION_BEGIN] = EVENT_PAYLOAD_SIZE(flow_function_begin),
+    [EVENT_FLOW_FUNCTION_END] = EVENT_PAYLOAD_SIZE(flow_function_end),
+    [EVENT_FLOW_MACRO_BEGIN] = EVENT_PAYLOAD_SIZE(flow_macro_begin),
+    [EVENT_FLOW_MACRO_END] = EVENT_PAYLOAD_SIZE(flow_macro_end),
+    [EVENT_FS_WRITE_FILE] = EVENT_PAYLOAD_SIZE(fs_write_file),
+    [EVENT_FS_APPEND_FILE] = EVENT_PAYLOAD_SIZE(fs_append_file),
+    [EVENT_FS_READ_FILE] = EVENT_PAYLOAD_SIZE(fs_read_file),
+    [EVENT_FS_GLOB] = EVENT_PAYLOAD_SIZE(fs_glob),
+    [EVENT_FS_MKDIR] = EVENT_PAYLOAD_SIZE(fs_mkdir),
+    [EVENT_FS_REMOVE] = EVENT_PAYLOAD_SIZE(fs_remove),
+    [EVENT_FS_COPY] = EVENT_PAYLOAD_SIZE(fs_copy),
+    [EVENT_FS_RENAME] = EVENT_PAYLOAD_SIZE(fs_rename),
+    [EVENT_FS_CREATE_LINK] = EVENT_PAYLOAD_SIZE(fs_create_link),
+    [EVENT_FS_CHMOD] = EVENT_PAYLOAD_SIZE(fs_chmod),
+    [EVENT_FS_ARCHIVE_CREATE] = EVENT_PAYLOAD_SIZE(fs_archive_create),
+    [EVENT_FS_ARCHIVE_EXTRACT] = EVENT_PAYLOAD_SIZE(fs_archive_extract),
+    [EVENT_FS_TRANSFER_DOWNLOAD] = EVENT_PAYLOAD_SIZE(fs_transfer_download),
+    [EVENT_FS_TRANSFER_UPLOAD] = EVENT_PAYLOAD_SIZE(fs_transfer_upload),
+    [EVENT_PROC_EXEC_REQUEST] = EVENT_PAYLOAD_SIZE(proc_exec_request),
+    [EVENT_PROC_EXEC_RESULT] = EVENT_PAYLOAD_SIZE(proc_exec_result),
+    [EVENT_STRING_REPLACE] = EVENT_PAYLOAD_SIZE(string_replace),
+    [EVENT_STRING_CONFIGURE] = EVENT_PAYLOAD_SIZE(string_configure),
+    [EVENT_STRING_REGEX] = EVENT_PAYLOAD_SIZE(string_regex),
+    [EVENT_STRING_HASH] = EVENT_PAYLOAD_SIZE(string_hash),
+    [EVENT_STRING_TIMESTAMP] = EVENT_PAYLOAD_SIZE(string_timestamp),
+    [EVENT_LIST_APPEND] = EVENT_PAYLOAD_SIZE(list_append),
+    [EVENT_LIST_PREPEND] = EVENT_PAYLOAD_SIZE(list_prepend),
+    [EVENT_LIST_INSERT] = EVENT_PAYLOAD_SIZE(list_insert),
+    [EVENT_LIST_REMOVE] = EVENT_PAYLOAD_SIZE(list_remove),
+    [EVENT_LIST_TRANSFORM] = EVENT_PAYLOAD_SIZE(list_transform),
+    [EVENT_LIST_SORT] = EVENT_PAYLOAD_SIZE(list_sort),
+    [EVENT_MATH_EXPR] = EVENT_PAYLOAD_SIZE(math_expr),
+    [EVENT_PATH_NORMALIZE] = EVENT_PAYLOAD_SIZE(path_normalize),
+    [EVENT_PATH_COMPARE] = EVENT_PAYLOAD_SIZE(path_compare),
+    [EVENT_PATH_CONVERT] = EVENT_PAYLOAD_SIZE(path_convert),
+    [EVENT_TEST_ENABLE] = EVENT_PAYLOAD_SIZE(test_enable),
+    [EVENT_TEST_ADD] = EVENT_PAYLOAD_SIZE(test_add),
+    [EVENT_INSTALL_RULE_ADD] = EVENT_PAYLOAD_SIZE(install_rule_add),
+    [EVENT_CPACK_ADD_INSTALL_TYPE] = EVENT_PAYLOAD_SIZE(cpack_add_install_type),
+    [EVENT_CPACK_ADD_COMPONENT_GROUP] = EVENT_PAYLOAD_SIZE(cpack_add_component_group),
+    [EVENT_CPACK_ADD_COMPONENT] = EVENT_PAYLOAD_SIZE(cpack_add_component),
+    [EVENT_CPACK_PACKAGE_DECLARE] = EVENT_PAYLOAD_SIZE(cpack_package_declare),
+    [EVENT_CPACK_PACKAGE_ADD_GENERATOR] = EVENT_PAYLOAD_SIZE(cpack_package_add_generator),
+    [EVENT_CPACK_PACKAGE_ARCHIVE_NAME_OVERRIDE] = EVENT_PAYLOAD_SIZE(cpack_package_archive_name_override),
+    [EVENT_PACKAGE_FIND_RESULT] = EVENT_PAYLOAD_SIZE(package_find_result),
+    [EVENT_PROJECT_DECLARE] = EVENT_PAYLOAD_SIZE(project_declare),
+    [EVENT_PROJECT_MINIMUM_REQUIRED] = EVENT_PAYLOAD_SIZE(project_minimum_required),
+    [EVENT_TARGET_DECLARE] = EVENT_PAYLOAD_SIZE(target_declare),
+    [EVENT_TARGET_ADD_SOURCE] = EVENT_PAYLOAD_SIZE(target_add_source),
+    [EVENT_TARGET_FILE_SET_DECLARE] = EVENT_PAYLOAD_SIZE(target_file_set_declare),
+    [EVENT_TARGET_FILE_SET_ADD_BASE_DIR] = EVENT_PAYLOAD_SIZE(target_file_set_add_base_dir),
+    [EVENT_SOURCE_MARK_GENERATED] = EVENT_PAYLOAD_SIZE(source_mark_generated),
+    [EVENT_SOURCE_PROPERTY_MUTATE] = EVENT_PAYLOAD_SIZE(source_property_mutate),
+    [EVENT_TARGET_ADD_DEPENDENCY] = EVENT_PAYLOAD_SIZE(target_add_dependency),
+    [EVENT_BUILD_STEP_DECLARE] = EVENT_PAYLOAD_SIZE(build_step_declare),
+    [EVENT_BUILD_STEP_ADD_OUTPUT] = EVENT_PAYLOAD_SIZE(build_step_add_output),
+    [EVENT_BUILD_STEP_ADD_BYPRODUCT] = EVENT_PAYLOAD_SIZE(build_step_add_byproduct),
+    [EVENT_BUILD_STEP_ADD_DEPENDENCY] = EVENT_PAYLOAD_SIZE(build_step_add_dependency),
+    [EVENT_BUILD_STEP_ADD_COMMAND] = EVENT_PAYLOAD_SIZE(build_step_add_command),
+    [EVENT_TARGET_PROP_SET] = EVENT_PAYLOAD_SIZE(target_prop_set),
+    [EVENT_TARGET_LINK_LIBRARIES] = EVENT_PAYLOAD_SIZE(target_link_libraries),
+    [EVENT_TARGET_LINK_OPTIONS] = EVENT_PAYLOAD_SIZE(target_link_options),
+    [EVENT_TARGET_LINK_DIRECTORIES] = EVENT_PAYLOAD_SIZE(target_link_directories),
+    [EVENT_TARGET_INCLUDE_DIRECTORIES] = EVENT_PAYLOAD_SIZE(target_include_directories),
+    [EVENT_TARGET_COMPILE_DEFINITIONS] = EVENT_PAYLOAD_SIZE(target_compile_definitions),
+    [EVENT_TARGET_COMPILE_OPTIONS] = EVENT_PAYLOAD_SIZE(target_compile_options),
+    [EVENT_TARGET_COMPILE_FEATURES] = EVENT_PAYLOAD_SIZE(target_compile_features),
+    [EVENT_EXPORT_INSTALL] = EVENT_PAYLOAD_SIZE(export_install),
+    [EVENT_EXPORT_BUILD_DECLARE] = EVENT_PAYLOAD_SIZE(export_build_declare),
+    [EVENT_EXPORT_BUILD_ADD_TARGET] = EVENT_PAYLOAD_SIZE(export_build_add_target),
+    [EVENT_EXPORT_PACKAGE_REGISTRY] = EVENT_PAYLOAD_SIZE(export_package_registry),
+    [EVENT_REPLAY_ACTION_DECLARE] = EVENT_PAYLOAD_SIZE(replay_action_declare),
+    [EVENT_REPLAY_ACTION_ADD_INPUT] = EVENT_PAYLOAD_SIZE(replay_action_add_input),
+    [EVENT_REPLAY_ACTION_ADD_OUTPUT] = EVENT_PAYLOAD_SIZE(replay_action_add_output),
+    [EVENT_REPLAY_ACTION_ADD_ARGV] = EVENT_PAYLOAD_SIZE(replay_action_add_argv),
+    [EVENT_REPLAY_ACTION_ADD_ENV] = EVENT_PAYLOAD_SIZE(replay_action_add_env),
+};
+#undef EVENT_PAYLOAD_SIZE
+
 Event_Stream *event_stream_create(Arena *arena) {
     if (!arena) return NULL;
     Event_Stream *stream = arena_alloc_zero(arena, sizeof(Event_Stream));
@@ -738,15 +940,114 @@ Event_Stream *event_stream_create(Arena *arena) {
     stream->arena = arena;
     stream->count = 0;
     stream->next_seq = 1;
+    stream->subscribed_roles = EVENT_ROLE_ALL;
     return stream;
 }
 
+void event_stream_set_sink(Event_Stream *stream,
+                           Event_Stream_Sink_Fn sink,
+                           void *userdata,
+                           uint32_t retain_families) {
+    if (!stream) return;
+    stream->sink = sink;
+    stream->sink_userdata = userdata;
+    stream->retain_families = retain_families;
+}
+
+void event_stream_subscribe(Event_Stream *stream, uint32_t roles) {
+    if (!stream) return;
+    stream->subscribed_roles = roles;
+}
+
+bool event_stream_wants(const Event_Stream *stream, Event_Kind kind) {
+    if (!stream) return true;
+    return (event_kind_role_mask(kind) & stream->subscribed_roles) != 0;
+}
+
+#define EVENT_PAYLOAD_POOL_MIN_ITEMS 4
+#define EVENT_PAYLOAD_POOL_MAX_ITEMS 256
+
+static void *event_payload_pool_alloc(Event_Stream *stream, Event_Kind kind, size_t size) {
+    Event_Payload_Pool *pool = &stream->payload_pools[kind];
+    if (pool->remaining < size) {
+        // Chunks grow with use, so kinds that occur once or twice stay small.
+        size_t items = pool->chunk_items ? pool->chunk_items * 2 : EVENT_PAYLOAD_POOL_MIN_ITEMS;
+        if (items > EVENT_PAYLOAD_POOL_MAX_ITEMS) items = EVENT_PAYLOAD_POOL_MAX_ITEMS;
+        unsigned char *chunk = arena_alloc(stream->arena, items * size);
+        if (!chunk) return NULL;
+        pool->next = chunk;
+        pool->remaining = items * size;
+        pool->chunk_items = items;
+    }
+    // Payload sizes are multiples of their alignment, so packing keeps every
+    // entry aligned.
+    void *payload = pool->next;
+    pool->next += size;
+    pool->remaining -= size;
+    return payload;
+}
+
+// Origins repeat a handful of interned paths, so the index is cached in the
+// path's intern slot.
+static bool event_stream_origin_file(Event_Stream *stream, String_View path, uint32_t *out_index) {
+    *out_index = 0;
+    if (!path.data || path.count == 0) return true;
+    bool found = false;
+    Event_String_Intern *slot = event_stream_intern_slot(stream, path, &found);
+    if (!slot) return false;
+    if (slot->origin_file == 0) {
+        if (!arena_arr_push(stream->arena, stream->origin_files, slot->text)) return false;
+        slot->origin_file = (uint32_t)arena_arr_len(stream->origin_files);
+    }
+    *out_index = slot->origin_file;
+    return true;
+}
+
+static bool event_stream_store(Event_Stream *stream, const Event *ev) {
+    size_t size = k_event_payload_size[ev->h.kind];
+    if (size == 0) return false;
+
+    Event_Record record = {0};
+    record.kind = (uint16_t)ev->h.kind;
+    record.version = ev->h.version;
+    record.flags = ev->h.flags;
+    record.seq = ev->h.seq;
+    record.scope_depth = ev->h.scope_depth;
+    record.policy_depth = ev->h.policy_depth;
+    record.origin_line = (uint32_t)ev->h.origin.line;
+    record.origin_col = (uint32_t)ev->h.origin.col;
+    if (!event_stream_origin_file(stream, ev->h.origin.file_path, &record.origin_file)) return false;
+
+    void *payload = event_payload_pool_alloc(stream, ev->h.kind, size);
+    if (!payload) return false;
+    memcpy(payload, &ev->as, size);
+    record.payload = payload;
+    return arena_arr_push(stream->arena, stream->records, record);
+}
+
+// Only the kind's own payload bytes are written; the rest of `out->as` is
+// left as it was.
+static void event_record_expand(const Event_Stream *stream, const Event_Record *record, Event *out) {
+    out->h = (Event_Header){0};
+    out->h.kind = (Event_Kind)record->kind;
+    out->h.version = record->version;
+    out->h.flags = record->flags;
+    out->h.seq = record->seq;
+    out->h.scope_depth = record->scope_depth;
+    out->h.policy_depth = record->policy_depth;
+    if (record->origin_file > 0) out->h.origin.file_path = stream->origin_files[record->origin_file - 1];
+    out->h.origin.line = record->origin_line;
+    out->h.origin.col = record->origin_col;
+    memcpy(&out->as, record->payload, k_event_payload_size[record->kind]);
+}
+
 bool event_stream_push(Event_Stream *stream, const Event *src) {
     if (!stream || !stream->arena || !src) return false;
 
     Event ev = *src;
     const Event_Kind_Meta *meta = event_kind_meta(ev.h.kind);
     if (!meta) return false;
+    if ((meta->role_mask & stream->subscribed_roles) == 0) return true;
     if (ev.h.version == 0) {
         ev.h.version = meta->default_version;
     }
@@ -754,19 +1055,28 @@ bool event_stream_push(Event_Stream *stream, const Event *src) {
         ev.h.seq = stream->next_seq;
     }
 
-    if (!event_deep_copy_payload(stream->arena, &ev)) return false;
-    if (!arena_arr_push(stream->arena, stream->items, ev)) return false;
+    // Events that are only forwarded keep pointing at the producer's memory;
+    // the sink copies whatever it wants to keep.
+    bool retain = !stream->sink || (stream->retain_families & (1u << meta->family)) != 0;
+    if (retain) {
+        if (!event_deep_copy_payload(stream->arena, stream, &ev)) return false;
+        if (!event_stream_store(stream, &ev)) return false;
+        stream->count = arena_arr_len(stream->records);
+    }
 
-    stream->count = arena_arr_len(stream->items);
+    stream->pushed_count++;
     if (stream->next_seq <= ev.h.seq) {
         stream->next_seq = ev.h.seq + 1;
     }
+    if (stream->sink) {
+        stream->sink(stream->sink_userdata, &ev);
+    }
     return true;
 }
 
 bool event_copy_into_arena(Arena *arena, Event *ev) {
     if (!arena || !ev) return false;
-    return event_deep_copy_payload(arena, ev);
+    return event_deep_copy_payload(arena, NULL, ev);
 }
 
 Event_Stream_Iterator event_stream_iter(const Event_Stream *stream) {
@@ -782,10 +1092,374 @@ bool event_stream_next(Event_Stream_Iterator *it) {
         return false;
     }
 
-    it->current = &it->stream->items[it->index++];
+    event_record_expand(it->stream, &it->stream->records[it->index++], &it->event);
+    it->current = &it->event;
+    return true;
+}
+
+bool event_stream_get(const Event_Stream *stream, size_t index, Event *out) {
+    if (!stream || !out || index >= stream->count) return false;
+    event_record_expand(stream, &stream->records[index], out);
+    return true;
+}
+
+// --- Binary event files ---
+
+#define EVENT_FILE_MAGIC "NOBEVT\0\0"
+#define EVENT_FILE_VERSION 2u
+#define EVENT_FILE_BYTE_ORDER 0x01020304u
+#define EVENT_FILE_ALIGN 16u
+
+// The file mirrors the in-memory layout: Event_Records, the origin path
+// table, then the payload, array and string pools. Every payload, string and
+// array pointer holds `offset + 1` into its pool (0 stays NULL). As with the
+// AST cache, a file is only read back on the host that wrote it; the
+// byte-order marker and the layout sizes reject anything else.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t record_size;
+    uint32_t payload_size;
+    uint64_t event_count;
+    uint64_t next_seq;
+    uint64_t origin_count;
+    uint64_t payload_pool_size;
+    uint64_t array_pool_size;
+    uint64_t string_pool_size;
+} Event_File_Header;
+
+static size_t event_file_align(size_t offset) {
+    return (offset + EVENT_FILE_ALIGN - 1) & ~(size_t)(EVENT_FILE_ALIGN - 1);
+}
+
+// The records are preceded by room for an arena array header, so a loaded
+// stream can use `records` straight from the mapping.
+#define EVENT_FILE_RECORDS_OFFSET \
+    (event_file_align(sizeof(Event_File_Header)) + sizeof(Arena_Arr_Header))
+
+static void event_file_pad(Nob_String_Builder *sb, size_t base) {
+    while ((base + sb->count) % EVENT_FILE_ALIGN != 0) nob_da_append(sb, '\0');
+}
+
+typedef struct {
+    void **slot;
+    void *data;
+    size_t size;
+} Event_File_Pending_Array;
+
+typedef struct {
+    Event_Field_Visitor base;
+    Arena *scratch;
+    Nob_String_Builder arrays;
+    Nob_String_Builder strings;
+    struct {
+        Event_File_Pending_Array *items;
+        size_t count;
+        size_t capacity;
+    } pending;
+} Event_File_Writer;
+
+static bool event_file_write_sv(Event_Field_Visitor *v, String_View *sv) {
+    Event_File_Writer *w = (Event_File_Writer*)v;
+    if (!sv->data || sv->count == 0) {
+        *sv = (String_View){0};
+        return true;
+    }
+    size_t offset = w->strings.count;
+    nob_sb_append_buf(&w->strings, sv->data, sv->count);
+    nob_sb_append_null(&w->strings);
+    sv->data = (const char*)(uintptr_t)(offset + 1);
+    return true;
+}
+
+// Arrays are rewritten in a scratch copy first; their slots are patched once
+// the whole event has been visited (see event_file_flush_arrays()).
+static bool event_file_write_array(Event_Field_Visitor *v, void **items, size_t count, size_t item_size) {
+    Event_File_Writer *w = (Event_File_Writer*)v;
+    void *copy = arena_memdup(w->scratch, *items, count * item_size);
+    if (!copy) return false;
+    Event_File_Pending_Array pending = {items, copy, count * item_size};
+    nob_da_append(&w->pending, pending);
+    *items = copy;
     return true;
 }
 
+// Nested arrays are registered after the array that holds their slot, so
+// flushing in reverse stores children before their (patched) parents.
+static void event_file_flush_arrays(Event_File_Writer *w) {
+    for (size_t i = w->pending.count; i-- > 0;) {
+        Event_File_Pending_Array *pending = &w->pending.items[i];
+        event_file_pad(&w->arrays, 0);
+        size_t offset = w->arrays.count;
+        nob_sb_append_buf(&w->arrays, pending->data, pending->size);
+        *pending->slot = (void*)(uintptr_t)(offset + 1);
+    }
+    w->pending.count = 0;
+}
+
+bool event_stream_write_file(const Event_Stream *stream, const char *path) {
+    if (!stream || !path || path[0] == '\0') return false;
+    Arena *scratch = arena_create(64 * 1024);
+    if (!scratch) return false;
+
+    Event_File_Writer w = {0};
+    w.base.sv = event_file_write_sv;
+    w.base.array = event_file_write_array;
+    w.scratch = scratch;
+
+    Nob_String_Builder records = {0};
+    Nob_String_Builder origins = {0};
+    Nob_String_Builder payloads = {0};
+    bool ok = true;
+    for (size_t i = 0; i < stream->count && ok; ++i) {
+        Arena_Mark mark = arena_mark(scratch);
+        Event_Record record = stream->records[i];
+        size_t size = k_event_payload_size[record.kind];
+        Event_Payload payload;
+        memcpy(&payload, record.payload, size);
+        ok = event_visit_fields(&w.base, (Event_Kind)record.kind, &payload);
+        if (ok) {
+            event_file_flush_arrays(&w);
+            // Payloads of different kinds share one pool in the file.
+            while (payloads.count % _Alignof(Event_Payload) != 0) nob_da_append(&payloads, '\0');
+            record.payload = (const void*)(uintptr_t)(payloads.count + 1);
+            nob_sb_append_buf(&payloads, &payload, size);
+            nob_sb_append_buf(&records, &record, sizeof(record));
+        }
+        arena_rewind(scratch, mark);
+    }
+    size_t origin_count = arena_arr_len(stream->origin_files);
+    for (size_t i = 0; i < origin_count && ok; ++i) {
+        String_View origin = stream->origin_files[i];
+        ok = event_file_write_sv(&w.base, &origin);
+        nob_sb_append_buf(&origins, &origin, sizeof(origin));
+    }
+
+    Nob_String_Builder out = {0};
+    if (ok) {
+        Event_File_Header header = {0};
+        memcpy(header.magic, EVENT_FILE_MAGIC, sizeof(header.magic));
+        header.version = EVENT_FILE_VERSION;
+        header.byte_order = EVENT_FILE_BYTE_ORDER;
+        header.record_size = (uint32_t)sizeof(Event_Record);
+        header.payload_size = (uint32_t)sizeof(Event_Payload);
+        header.event_count = stream->count;
+        header.next_seq = stream->next_seq;
+        header.origin_count = origin_count;
+        header.payload_pool_size = payloads.count;
+        header.array_pool_size = w.arrays.count;
+        header.string_pool_size = w.strings.count;
+
+        Arena_Arr_Header records_header = {0};
+        nob_sb_append_buf(&out, &header, sizeof(header));
+        event_file_pad(&out, 0);
+        nob_sb_append_buf(&out, &records_header, sizeof(records_header));
+        nob_sb_append_buf(&out, records.items, records.count);
+        event_file_pad(&out, 0);
+        nob_sb_append_buf(&out, origins.items, origins.count);
+        event_file_pad(&out, 0);
+        nob_sb_append_buf(&out, payloads.items, payloads.count);
+        event_file_pad(&out, 0);
+        nob_sb_append_buf(&out, w.arrays.items, w.arrays.count);
+        nob_sb_append_buf(&out, w.strings.items, w.strings.count);
+
+        // Write beside the final name and rename so readers never map a
+        // partially written file.
+        size_t temp_mark = nob_temp_save();
+        const char *temp_path = nob_temp_sprintf("%s.%ld.tmp", path, (long)getpid());
+        ok = nob_write_entire_file(temp_path, out.items, out.count) &&
+             rename(temp_path, path) == 0;
+        if (!ok) remove(temp_path);
+        nob_temp_rewind(temp_mark);
+    }
+
+    nob_sb_free(out);
+    nob_sb_free(payloads);
+    nob_sb_free(origins);
+    nob_sb_free(records);
+    nob_sb_free(w.arrays);
+    nob_sb_free(w.strings);
+    nob_da_free(w.pending);
+    arena_destroy(scratch);
+    return ok;
+}
+
+typedef struct {
+    Event_Field_Visitor base;
+    char *arrays;
+    size_t array_pool_size;
+    const char *strings;
+    size_t string_pool_size;
+} Event_File_Reader;
+
+static bool event_file_read_sv(Event_Field_Visitor *v, String_View *sv) {
+    Event_File_Reader *r = (Event_File_Reader*)v;
+    uintptr_t ref = (uintptr_t)sv->data;
+    if (ref == 0) return sv->count == 0;
+    size_t offset = (size_t)(ref - 1);
+    // Every stored string is followed by its NUL terminator.
+    if (offset >= r->string_pool_size || sv->count >= r->string_pool_size - offset) return false;
+    sv->data = r->strings + offset;
+    return true;
+}
+
+static bool event_file_read_array(Event_Field_Visitor *v, void **items, size_t count, size_t item_size) {
+    Event_File_Reader *r = (Event_File_Reader*)v;
+    size_t offset = (size_t)((uintptr_t)*items - 1);
+    if (offset >= r->array_pool_size ||
+        offset % EVENT_FILE_ALIGN != 0 ||
+        count > (r->array_pool_size - offset) / item_size) {
+        return false;
+    }
+    *items = r->arrays + offset;
+    return true;
+}
+
+#if !defined(_WIN32)
+typedef struct {
+    void *base;
+    size_t size;
+} Event_File_Mapping;
+
+static void event_file_unmap(void *userdata) {
+    Event_File_Mapping *mapping = userdata;
+    munmap(mapping->base, mapping->size);
+}
+#endif
+
+// Maps the file copy-on-write, so relocation only dirties the pages holding
+// records, payloads and arrays, or reads it into `arena` where mapping is not
+// available. The mapping is released with `arena`.
+static bool event_file_map(Arena *arena, const char *path, unsigned char **out_data, size_t *out_size) {
+#if !defined(_WIN32)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    Event_File_Mapping *mapping = arena_alloc(arena, sizeof(*mapping));
+    if (!mapping || !arena_on_destroy(arena, event_file_unmap, mapping)) {
+        munmap(base, size);
+        return false;
+    }
+    mapping->base = base;
+    mapping->size = size;
+    *out_data = base;
+    *out_size = size;
+    return true;
+#else
+    Nob_String_Builder sb = {0};
+    if (!nob_read_entire_file(path, &sb)) return false;
+    unsigned char *copy = arena_memdup(arena, sb.items, sb.count);
+    size_t size = sb.count;
+    nob_sb_free(sb);
+    if (!copy) return false;
+    *out_data = copy;
+    *out_size = size;
+    return true;
+#endif
+}
+
+// Checks that a section of `count` items of `item_size` bytes starting at
+// `offset` lies inside the file.
+static bool event_file_section_fits(size_t size, size_t offset, uint64_t count, size_t item_size) {
+    return offset <= size && count <= (size - offset) / item_size;
+}
+
+Event_Stream *event_stream_load_file(Arena *arena, const char *path) {
+    if (!arena || !path || path[0] == '\0') return NULL;
+
+    Arena_Mark mark = arena_mark(arena);
+    unsigned char *data = NULL;
+    size_t size = 0;
+    if (!event_file_map(arena, path, &data, &size)) return NULL;
+
+    Event_File_Header header;
+    if (size < EVENT_FILE_RECORDS_OFFSET) goto corrupt;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, EVENT_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != EVENT_FILE_VERSION ||
+        header.byte_order != EVENT_FILE_BYTE_ORDER ||
+        header.record_size != sizeof(Event_Record) ||
+        header.payload_size != sizeof(Event_Payload) ||
+        !event_file_section_fits(size, EVENT_FILE_RECORDS_OFFSET, header.event_count, sizeof(Event_Record))) {
+        goto corrupt;
+    }
+    size_t count = (size_t)header.event_count;
+    size_t origins_offset = event_file_align(EVENT_FILE_RECORDS_OFFSET + count * sizeof(Event_Record));
+    if (!event_file_section_fits(size, origins_offset, header.origin_count, sizeof(String_View))) goto corrupt;
+    size_t origin_count = (size_t)header.origin_count;
+    size_t payloads_offset = event_file_align(origins_offset + origin_count * sizeof(String_View));
+    if (!event_file_section_fits(size, payloads_offset, header.payload_pool_size, 1)) goto corrupt;
+    size_t payload_pool_size = (size_t)header.payload_pool_size;
+    size_t arrays_offset = event_file_align(payloads_offset + payload_pool_size);
+    if (!event_file_section_fits(size, arrays_offset, header.array_pool_size, 1) ||
+        header.string_pool_size != size - arrays_offset - header.array_pool_size) {
+        goto corrupt;
+    }
+
+    Event_File_Reader reader = {0};
+    reader.base.sv = event_file_read_sv;
+    reader.base.array = event_file_read_array;
+    reader.arrays = (char*)data + arrays_offset;
+    reader.array_pool_size = (size_t)header.array_pool_size;
+    reader.strings = reader.arrays + reader.array_pool_size;
+    reader.string_pool_size = (size_t)header.string_pool_size;
+
+    Event_Stream *stream = event_stream_create(arena);
+    if (!stream) goto corrupt;
+
+    // The origin table is small and may grow with later pushes, so it is the
+    // one section copied into the arena.
+    String_View *origins = (String_View*)(void*)(data + origins_offset);
+    for (size_t i = 0; i < origin_count; ++i) {
+        if (!event_file_read_sv(&reader.base, &origins[i])) goto corrupt;
+        if (!arena_arr_push(arena, stream->origin_files, origins[i])) goto corrupt;
+    }
+
+    unsigned char *payloads = data + payloads_offset;
+    Event_Record *records = (Event_Record*)(void*)(data + EVENT_FILE_RECORDS_OFFSET);
+    for (size_t i = 0; i < count; ++i) {
+        Event_Record *record = &records[i];
+        if (!event_kind_meta((Event_Kind)record->kind) || record->origin_file > origin_count) goto corrupt;
+        size_t payload_size = k_event_payload_size[record->kind];
+        size_t offset = (size_t)((uintptr_t)record->payload - 1);
+        if ((uintptr_t)record->payload == 0 ||
+            offset % _Alignof(Event_Payload) != 0 ||
+            !event_file_section_fits(payload_pool_size, offset, payload_size, 1)) {
+            goto corrupt;
+        }
+        Event_Payload payload;
+        memcpy(&payload, payloads + offset, payload_size);
+        if (!event_visit_fields(&reader.base, (Event_Kind)record->kind, &payload)) goto corrupt;
+        memcpy(payloads + offset, &payload, payload_size);
+        record->payload = payloads + offset;
+    }
+
+    if (count > 0) {
+        Arena_Arr_Header *records_header = (Arena_Arr_Header*)(void*)records - 1;
+        records_header->capacity = count;
+        records_header->count = count;
+        stream->records = records;
+    }
+    stream->count = count;
+    stream->pushed_count = count;
+    stream->next_seq = header.next_seq;
+    return stream;
+
+corrupt:
+    arena_rewind(arena, mark);
+    return NULL;
+}
+
 const Event_Kind_Meta *event_kind_meta(Event_Kind kind) {
     size_t count = sizeof(k_event_kind_meta) / sizeof(k_event_kind_meta[0]);
     if ((size_t)kind >= count) return NULL;
@@ -819,11 +1493,11 @@ const char *event_kind_name(Event_Kind kind) {
     return meta ? meta->label : "unknown_event";
 }
 
-static void event_dump_one(const Event *ev) {
-    if (!ev) return;
+void event_dump(FILE *out, const Event *ev) {
+    if (!out || !ev) return;
 
     Event_Family family = event_kind_family(ev->h.kind);
-    printf("[%llu] %s/%s @ %.*s:%zu:%zu",
+    fprintf(out, "[%llu] %s/%s @ %.*s:%zu:%zu",
            (unsigned long long)ev->h.seq,
            event_family_name(family),
            event_kind_name(ev->h.kind),
@@ -834,21 +1508,21 @@ static void event_dump_one(const Event *ev) {
 
     switch (ev->h.kind) {
         case EVENT_DIAG:
-            printf(" severity=%d code=%.*s",
+            fprintf(out, " severity=%d code=%.*s",
                    (int)ev->as.diag.severity,
                    (int)ev->as.diag.code.count,
                    ev->as.diag.code.data ? ev->as.diag.code.data : "");
             break;
 
         case EVENT_COMMAND_BEGIN:
-            printf(" command=%.*s dispatch=%s argc=%u",
+            fprintf(out, " command=%.*s dispatch=%s argc=%u",
                    (int)ev->as.command_begin.command_name.count,
                    ev->as.command_begin.command_name.data ? ev->as.command_begin.command_name.data : "",
                    event_command_dispatch_name(ev->as.command_begin.dispatch_kind),
                    (unsigned)ev->as.command_begin.argc);
             break;
         case EVENT_COMMAND_END:
-            printf(" command=%.*s dispatch=%s argc=%u status=%s",
+            fprintf(out, " command=%.*s dispatch=%s argc=%u status=%s",
                    (int)ev->as.command_end.command_name.count,
                    ev->as.command_end.command_name.data ? ev->as.command_end.command_name.data : "",
                    event_command_dispatch_name(ev->as.command_end.dispatch_kind),
@@ -857,21 +1531,21 @@ static void event_dump_one(const Event *ev) {
             break;
 
         case EVENT_DIRECTORY_ENTER:
-            printf(" source_dir=%.*s binary_dir=%.*s",
+            fprintf(out, " source_dir=%.*s binary_dir=%.*s",
                    (int)ev->as.directory_enter.source_dir.count,
                    ev->as.directory_enter.source_dir.data ? ev->as.directory_enter.source_dir.data : "",
                    (int)ev->as.directory_enter.binary_dir.count,
                    ev->as.directory_enter.binary_dir.data ? ev->as.directory_enter.binary_dir.data : "");
             break;
         case EVENT_DIRECTORY_LEAVE:
-            printf(" source_dir=%.*s binary_dir=%.*s",
+            fprintf(out, " source_dir=%.*s binary_dir=%.*s",
                    (int)ev->as.directory_leave.source_dir.count,
                    ev->as.directory_leave.source_dir.data ? ev->as.directory_leave.source_dir.data : "",
                    (int)ev->as.directory_leave.binary_dir.count,
                    ev->as.directory_leave.binary_dir.data ? ev->as.directory_leave.binary_dir.data : "");
             break;
         case EVENT_DIRECTORY_PROPERTY_MUTATE:
-            printf(" property=%.*s op=%s items=%zu modifiers=0x%x",
+            fprintf(out, " property=%.*s op=%s items=%zu modifiers=0x%x",
                    (int)ev->as.directory_property_mutate.property_name.count,
                    ev->as.directory_property_mutate.property_name.data ? ev->as.directory_property_mutate.property_name.data : "",
                    event_property_mutate_op_name(ev->as.directory_property_mutate.op),
@@ -879,7 +1553,7 @@ static void event_dump_one(const Event *ev) {
                    (unsigned)ev->as.directory_property_mutate.modifier_flags);
             break;
         case EVENT_GLOBAL_PROPERTY_MUTATE:
-            printf(" property=%.*s op=%s items=%zu modifiers=0x%x",
+            fprintf(out, " property=%.*s op=%s items=%zu modifiers=0x%x",
                    (int)ev->as.global_property_mutate.property_name.count,
                    ev->as.global_property_mutate.property_name.data ? ev->as.global_property_mutate.property_name.data : "",
                    event_property_mutate_op_name(ev->as.global_property_mutate.op),
@@ -888,30 +1562,30 @@ static void event_dump_one(const Event *ev) {
             break;
 
         case EVENT_VAR_SET:
-            printf(" key=%.*s target=%s",
+            fprintf(out, " key=%.*s target=%s",
                    (int)ev->as.var_set.key.count,
                    ev->as.var_set.key.data ? ev->as.var_set.key.data : "",
                    event_var_target_name(ev->as.var_set.target_kind));
             break;
         case EVENT_VAR_UNSET:
-            printf(" key=%.*s target=%s",
+            fprintf(out, " key=%.*s target=%s",
                    (int)ev->as.var_unset.key.count,
                    ev->as.var_unset.key.data ? ev->as.var_unset.key.data : "",
                    event_var_target_name(ev->as.var_unset.target_kind));
             break;
 
         case EVENT_PROJECT_DECLARE:
-            printf(" name=%.*s",
+            fprintf(out, " name=%.*s",
                    (int)ev->as.project_declare.name.count,
                    ev->as.project_declare.name.data ? ev->as.project_declare.name.data : "");
             break;
         case EVENT_PROJECT_MINIMUM_REQUIRED:
-            printf(" version=%.*s",
+            fprintf(out, " version=%.*s",
                    (int)ev->as.project_minimum_required.version.count,
                    ev->as.project_minimum_required.version.data ? ev->as.project_minimum_required.version.data : "");
             break;
         case EVENT_INSTALL_RULE_ADD:
-            printf(" rule_type=%d item=%.*s destination=%.*s rename=%.*s export=%.*s component=%.*s archive_component=%.*s library_component=%.*s runtime_component=%.*s public_header_component=%.*s",
+            fprintf(out, " rule_type=%d item=%.*s destination=%.*s rename=%.*s export=%.*s component=%.*s archive_component=%.*s library_component=%.*s runtime_component=%.*s public_header_component=%.*s",
                    (int)ev->as.install_rule_add.rule_type,
                    (int)ev->as.install_rule_add.item.count,
                    ev->as.install_rule_add.item.data ? ev->as.install_rule_add.item.data : "",
@@ -933,7 +1607,7 @@ static void event_dump_one(const Event *ev) {
                    ev->as.install_rule_add.public_header_component.data ? ev->as.install_rule_add.public_header_component.data : "");
             break;
         case EVENT_EXPORT_INSTALL:
-            printf(" export=%.*s destination=%.*s namespace=%.*s file=%.*s component=%.*s",
+            fprintf(out, " export=%.*s destination=%.*s namespace=%.*s file=%.*s component=%.*s",
                    (int)ev->as.export_install.export_name.count,
                    ev->as.export_install.export_name.data ? ev->as.export_install.export_name.data : "",
                    (int)ev->as.export_install.destination.count,
@@ -946,7 +1620,7 @@ static void event_dump_one(const Event *ev) {
                    ev->as.export_install.component.data ? ev->as.export_install.component.data : "");
             break;
         case EVENT_EXPORT_BUILD_DECLARE:
-            printf(" export_key=%.*s source_kind=%s name=%.*s file=%.*s namespace=%.*s append=%d cxx_modules_directory=%.*s",
+            fprintf(out, " export_key=%.*s source_kind=%s name=%.*s file=%.*s namespace=%.*s append=%d cxx_modules_directory=%.*s",
                    (int)ev->as.export_build_declare.export_key.count,
                    ev->as.export_build_declare.export_key.data ? ev->as.export_build_declare.export_key.data : "",
                    event_export_source_kind_name(ev->as.export_build_declare.source_kind),
@@ -961,14 +1635,14 @@ static void event_dump_one(const Event *ev) {
                    ev->as.export_build_declare.cxx_modules_directory.data ? ev->as.export_build_declare.cxx_modules_directory.data : "");
             break;
         case EVENT_EXPORT_BUILD_ADD_TARGET:
-            printf(" export_key=%.*s target=%.*s",
+            fprintf(out, " export_key=%.*s target=%.*s",
                    (int)ev->as.export_build_add_target.export_key.count,
                    ev->as.export_build_add_target.export_key.data ? ev->as.export_build_add_target.export_key.data : "",
                    (int)ev->as.export_build_add_target.target_name.count,
                    ev->as.export_build_add_target.target_name.data ? ev->as.export_build_add_target.target_name.data : "");
             break;
         case EVENT_EXPORT_PACKAGE_REGISTRY:
-            printf(" package=%.*s prefix=%.*s enabled=%d",
+            fprintf(out, " package=%.*s prefix=%.*s enabled=%d",
                    (int)ev->as.export_package_registry.package_name.count,
                    ev->as.export_package_registry.package_name.data ? ev->as.export_package_registry.package_name.data : "",
                    (int)ev->as.export_package_registry.prefix.count,
@@ -977,12 +1651,12 @@ static void event_dump_one(const Event *ev) {
             break;
 
         case EVENT_TARGET_DECLARE:
-            printf(" name=%.*s",
+            fprintf(out, " name=%.*s",
                    (int)ev->as.target_declare.name.count,
                    ev->as.target_declare.name.data ? ev->as.target_declare.name.data : "");
             break;
         case EVENT_TARGET_ADD_SOURCE:
-            printf(" target=%.*s path=%.*s visibility=%s source_kind=%s file_set=%.*s",
+            fprintf(out, " target=%.*s path=%.*s visibility=%s source_kind=%s file_set=%.*s",
                    (int)ev->as.target_add_source.target_name.count,
                    ev->as.target_add_source.target_name.data ? ev->as.target_add_source.target_name.data : "",
                    (int)ev->as.target_add_source.path.count,
@@ -993,7 +1667,7 @@ static void event_dump_one(const Event *ev) {
                    ev->as.target_add_source.file_set_name.data ? ev->as.target_add_source.file_set_name.data : "");
             break;
         case EVENT_TARGET_FILE_SET_DECLARE:
-            printf(" target=%.*s set=%.*s kind=%s visibility=%s",
+            fprintf(out, " target=%.*s set=%.*s kind=%s visibility=%s",
                    (int)ev->as.target_file_set_declare.target_name.count,
                    ev->as.target_file_set_declare.target_name.data ? ev->as.target_file_set_declare.target_name.data : "",
                    (int)ev->as.target_file_set_declare.set_name.count,
@@ -1002,7 +1676,7 @@ static void event_dump_one(const Event *ev) {
                    event_visibility_name(ev->as.target_file_set_declare.visibility));
             break;
         case EVENT_TARGET_FILE_SET_ADD_BASE_DIR:
-            printf(" target=%.*s set=%.*s path=%.*s",
+            fprintf(out, " target=%.*s set=%.*s path=%.*s",
                    (int)ev->as.target_file_set_add_base_dir.target_name.count,
                    ev->as.target_file_set_add_base_dir.target_name.data ? ev->as.target_file_set_add_base_dir.target_name.data : "",
                    (int)ev->as.target_file_set_add_base_dir.set_name.count,
@@ -1011,13 +1685,13 @@ static void event_dump_one(const Event *ev) {
                    ev->as.target_file_set_add_base_dir.path.data ? ev->as.target_file_set_add_base_dir.path.data : "");
             break;
         case EVENT_SOURCE_MARK_GENERATED:
-            printf(" path=%.*s generated=%d",
+            fprintf(out, " path=%.*s generated=%d",
                    (int)ev->as.source_mark_generated.path.count,
                    ev->as.source_mark_generated.path.data ? ev->as.source_mark_generated.path.data : "",
                    (int)ev->as.source_mark_generated.generated);
             break;
         case EVENT_SOURCE_PROPERTY_MUTATE:
-            printf(" path=%.*s key=%.*s value=%.*s op=%s",
+            fprintf(out, " path=%.*s key=%.*s value=%.*s op=%s",
                    (int)ev->as.source_property_mutate.path.count,
                    ev->as.source_property_mutate.path.data ? ev->as.source_property_mutate.path.data : "",
                    (int)ev->as.source_property_mutate.key.count,
@@ -1027,14 +1701,14 @@ static void event_dump_one(const Event *ev) {
                    event_property_mutate_op_name((Event_Property_Mutate_Op)ev->as.source_property_mutate.op));
             break;
         case EVENT_TARGET_ADD_DEPENDENCY:
-            printf(" target=%.*s dep=%.*s",
+            fprintf(out, " target=%.*s dep=%.*s",
                    (int)ev->as.target_add_dependency.target_name.count,
                    ev->as.target_add_dependency.target_name.data ? ev->as.target_add_dependency.target_name.data : "",
                    (int)ev->as.target_add_dependency.dependency_name.count,
                    ev->as.target_add_dependency.dependency_name.data ? ev->as.target_add_dependency.dependency_name.data : "");
             break;
         case EVENT_BUILD_STEP_DECLARE:
-            printf(" step=%.*s kind=%s owner_target=%.*s",
+            fprintf(out, " step=%.*s kind=%s owner_target=%.*s",
                    (int)ev->as.build_step_declare.step_key.count,
                    ev->as.build_step_declare.step_key.data ? ev->as.build_step_declare.step_key.data : "",
                    event_build_step_kind_name(ev->as.build_step_declare.step_kind),
@@ -1042,35 +1716,35 @@ static void event_dump_one(const Event *ev) {
                    ev->as.build_step_declare.owner_target_name.data ? ev->as.build_step_declare.owner_target_name.data : "");
             break;
         case EVENT_BUILD_STEP_ADD_OUTPUT:
-            printf(" step=%.*s path=%.*s",
+            fprintf(out, " step=%.*s path=%.*s",
                    (int)ev->as.build_step_add_output.step_key.count,
                    ev->as.build_step_add_output.step_key.data ? ev->as.build_step_add_output.step_key.data : "",
                    (int)ev->as.build_step_add_output.path.count,
                    ev->as.build_step_add_output.path.data ? ev->as.build_step_add_output.path.data : "");
             break;
         case EVENT_BUILD_STEP_ADD_BYPRODUCT:
-            printf(" step=%.*s path=%.*s",
+            fprintf(out, " step=%.*s path=%.*s",
                    (int)ev->as.build_step_add_byproduct.step_key.count,
                    ev->as.build_step_add_byproduct.step_key.data ? ev->as.build_step_add_byproduct.step_key.data : "",
                    (int)ev->as.build_step_add_byproduct.path.count,
                    ev->as.build_step_add_byproduct.path.data ? ev->as.build_step_add_byproduct.path.data : "");
             break;
         case EVENT_BUILD_STEP_ADD_DEPENDENCY:
-            printf(" step=%.*s dep=%.*s",
+            fprintf(out, " step=%.*s dep=%.*s",
                    (int)ev->as.build_step_add_dependency.step_key.count,
                    ev->as.build_step_add_dependency.step_key.data ? ev->as.build_step_add_dependency.step_key.data : "",
                    (int)ev->as.build_step_add_dependency.item.count,
                    ev->as.build_step_add_dependency.item.data ? ev->as.build_step_add_dependency.item.data : "");
             break;
         case EVENT_BUILD_STEP_ADD_COMMAND:
-            printf(" step=%.*s command_index=%u argc=%zu",
+            fprintf(out, " step=%.*s command_index=%u argc=%zu",
                    (int)ev->as.build_step_add_command.step_key.count,
                    ev->as.build_step_add_command.step_key.data ? ev->as.build_step_add_command.step_key.data : "",
                    (unsigned)ev->as.build_step_add_command.command_index,
                    ev->as.build_step_add_command.argc);
             break;
         case EVENT_TEST_ADD:
-            printf(" name=%.*s command=%.*s working_dir=%.*s expand_lists=%d configurations=%zu",
+            fprintf(out, " name=%.*s command=%.*s working_dir=%.*s expand_lists=%d configurations=%zu",
                    (int)ev->as.test_add.name.count,
                    ev->as.test_add.name.data ? ev->as.test_add.name.data : "",
                    (int)ev->as.test_add.command.count,
@@ -1081,7 +1755,7 @@ static void event_dump_one(const Event *ev) {
                    ev->as.test_add.configuration_count);
             break;
         case EVENT_REPLAY_ACTION_DECLARE:
-            printf(" action=%.*s kind=%s opcode=%s phase=%s",
+            fprintf(out, " action=%.*s kind=%s opcode=%s phase=%s",
                    (int)ev->as.replay_action_declare.action_key.count,
                    ev->as.replay_action_declare.action_key.data ? ev->as.replay_action_declare.action_key.data : "",
                    event_replay_action_kind_name(ev->as.replay_action_declare.action_kind),
@@ -1089,21 +1763,21 @@ static void event_dump_one(const Event *ev) {
                    event_replay_phase_name(ev->as.replay_action_declare.phase));
             break;
         case EVENT_REPLAY_ACTION_ADD_INPUT:
-            printf(" action=%.*s path=%.*s",
+            fprintf(out, " action=%.*s path=%.*s",
                    (int)ev->as.replay_action_add_input.action_key.count,
                    ev->as.replay_action_add_input.action_key.data ? ev->as.replay_action_add_input.action_key.data : "",
                    (int)ev->as.replay_action_add_input.path.count,
                    ev->as.replay_action_add_input.path.data ? ev->as.replay_action_add_input.path.data : "");
             break;
         case EVENT_REPLAY_ACTION_ADD_OUTPUT:
-            printf(" action=%.*s path=%.*s",
+            fprintf(out, " action=%.*s path=%.*s",
                    (int)ev->as.replay_action_add_output.action_key.count,
                    ev->as.replay_action_add_output.action_key.data ? ev->as.replay_action_add_output.action_key.data : "",
                    (int)ev->as.replay_action_add_output.path.count,
                    ev->as.replay_action_add_output.path.data ? ev->as.replay_action_add_output.path.data : "");
             break;
         case EVENT_REPLAY_ACTION_ADD_ARGV:
-            printf(" action=%.*s arg_index=%u value=%.*s",
+            fprintf(out, " action=%.*s arg_index=%u value=%.*s",
                    (int)ev->as.replay_action_add_argv.action_key.count,
                    ev->as.replay_action_add_argv.action_key.data ? ev->as.replay_action_add_argv.action_key.data : "",
                    (unsigned)ev->as.replay_action_add_argv.arg_index,
@@ -1111,7 +1785,7 @@ static void event_dump_one(const Event *ev) {
                    ev->as.replay_action_add_argv.value.data ? ev->as.replay_action_add_argv.value.data : "");
             break;
         case EVENT_REPLAY_ACTION_ADD_ENV:
-            printf(" action=%.*s key=%.*s value=%.*s",
+            fprintf(out, " action=%.*s key=%.*s value=%.*s",
                    (int)ev->as.replay_action_add_env.action_key.count,
                    ev->as.replay_action_add_env.action_key.data ? ev->as.replay_action_add_env.action_key.data : "",
                    (int)ev->as.replay_action_add_env.key.count,
@@ -1120,56 +1794,56 @@ static void event_dump_one(const Event *ev) {
                    ev->as.replay_action_add_env.value.data ? ev->as.replay_action_add_env.value.data : "");
             break;
         case EVENT_TARGET_PROP_SET:
-            printf(" target=%.*s key=%.*s",
+            fprintf(out, " target=%.*s key=%.*s",
                    (int)ev->as.target_prop_set.target_name.count,
                    ev->as.target_prop_set.target_name.data ? ev->as.target_prop_set.target_name.data : "",
                    (int)ev->as.target_prop_set.key.count,
                    ev->as.target_prop_set.key.data ? ev->as.target_prop_set.key.data : "");
             break;
         case EVENT_TARGET_LINK_LIBRARIES:
-            printf(" target=%.*s item=%.*s",
+            fprintf(out, " target=%.*s item=%.*s",
                    (int)ev->as.target_link_libraries.target_name.count,
                    ev->as.target_link_libraries.target_name.data ? ev->as.target_link_libraries.target_name.data : "",
                    (int)ev->as.target_link_libraries.item.count,
                    ev->as.target_link_libraries.item.data ? ev->as.target_link_libraries.item.data : "");
             break;
         case EVENT_TARGET_LINK_OPTIONS:
-            printf(" target=%.*s item=%.*s",
+            fprintf(out, " target=%.*s item=%.*s",
                    (int)ev->as.target_link_options.target_name.count,
                    ev->as.target_link_options.target_name.data ? ev->as.target_link_options.target_name.data : "",
                    (int)ev->as.target_link_options.item.count,
                    ev->as.target_link_options.item.data ? ev->as.target_link_options.item.data : "");
             break;
         case EVENT_TARGET_LINK_DIRECTORIES:
-            printf(" target=%.*s path=%.*s",
+            fprintf(out, " target=%.*s path=%.*s",
                    (int)ev->as.target_link_directories.target_name.count,
                    ev->as.target_link_directories.target_name.data ? ev->as.target_link_directories.target_name.data : "",
                    (int)ev->as.target_link_directories.path.count,
                    ev->as.target_link_directories.path.data ? ev->as.target_link_directories.path.data : "");
             break;
         case EVENT_TARGET_INCLUDE_DIRECTORIES:
-            printf(" target=%.*s path=%.*s",
+            fprintf(out, " target=%.*s path=%.*s",
                    (int)ev->as.target_include_directories.target_name.count,
                    ev->as.target_include_directories.target_name.data ? ev->as.target_include_directories.target_name.data : "",
                    (int)ev->as.target_include_directories.path.count,
                    ev->as.target_include_directories.path.data ? ev->as.target_include_directories.path.data : "");
             break;
         case EVENT_TARGET_COMPILE_DEFINITIONS:
-            printf(" target=%.*s item=%.*s",
+            fprintf(out, " target=%.*s item=%.*s",
                    (int)ev->as.target_compile_definitions.target_name.count,
                    ev->as.target_compile_definitions.target_name.data ? ev->as.target_compile_definitions.target_name.data : "",
                    (int)ev->as.target_compile_definitions.item.count,
                    ev->as.target_compile_definitions.item.data ? ev->as.target_compile_definitions.item.data : "");
             break;
         case EVENT_TARGET_COMPILE_OPTIONS:
-            printf(" target=%.*s item=%.*s",
+            fprintf(out, " target=%.*s item=%.*s",
                    (int)ev->as.target_compile_options.target_name.count,
                    ev->as.target_compile_options.target_name.data ? ev->as.target_compile_options.target_name.data : "",
                    (int)ev->as.target_compile_options.item.count,
                    ev->as.target_compile_options.item.data ? ev->as.target_compile_options.item.data : "");
             break;
         case EVENT_TARGET_COMPILE_FEATURES:
-            printf(" target=%.*s item=%.*s",
+            fprintf(out, " target=%.*s item=%.*s",
                    (int)ev->as.target_compile_features.target_name.count,
                    ev->as.target_compile_features.target_name.data ? ev->as.target_compile_features.target_name.data : "",
                    (int)ev->as.target_compile_features.item.count,
@@ -1180,12 +1854,13 @@ static void event_dump_one(const Event *ev) {
             break;
     }
 
-    putchar('\n');
+    fputc('\n', out);
 }
 
 void event_stream_dump(const Event_Stream *stream) {
     if (!stream) return;
-    for (size_t i = 0; i < arena_arr_len(stream->items); ++i) {
-        event_dump_one(&stream->items[i]);
+    Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        event_dump(stdout, it.current);
     }
 }
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include "arena.h"
 #include "nob.h"
@@ -18,6 +19,10 @@ typedef enum {
     EVENT_ROLE_BUILD_SEMANTIC = 1u << 4,
 } Event_Role;
 
+#define EVENT_ROLE_ALL \
+    (EVENT_ROLE_TRACE | EVENT_ROLE_DIAGNOSTIC | EVENT_ROLE_RUNTIME_EFFECT | \
+     EVENT_ROLE_STATE | EVENT_ROLE_BUILD_SEMANTIC)
+
 #define EVENT_FAMILY_LIST(X) \
     X(EVENT_FAMILY_TRACE, "trace") \
     X(EVENT_FAMILY_DIAG, "diag") \
@@ -1071,137 +1076,190 @@ typedef struct {
     Event_Origin origin;
 } Event_Header;
 
+typedef union {
+    Event_Diag diag;
+    Event_Command_Begin command_begin;
+    Event_Command_Begin command_call; // legacy alias
+    Event_Command_End command_end;
+    Event_Include_Begin include_begin;
+    Event_Include_End include_end;
+    Event_Add_Subdirectory_Begin add_subdirectory_begin;
+    Event_Add_Subdirectory_End add_subdirectory_end;
+    Event_Cmake_Language_Call cmake_language_call;
+    Event_Cmake_Language_Eval cmake_language_eval;
+    Event_Cmake_Language_Defer_Queue cmake_language_defer_queue;
+    Event_Directory_Enter directory_enter;
+    Event_Directory_Enter dir_push; // legacy alias
+    Event_Directory_Leave directory_leave;
+    Event_Directory_Leave dir_pop; // legacy alias
+    Event_Directory_Property_Mutate directory_property_mutate;
+    Event_Global_Property_Mutate global_property_mutate;
+    Event_Var_Set var_set;
+    Event_Var_Unset var_unset;
+    Event_Scope_Push scope_push;
+    Event_Scope_Pop scope_pop;
+    Event_Policy_Push policy_push;
+    Event_Policy_Pop policy_pop;
+    Event_Policy_Set policy_set;
+    Event_Flow_Return flow_return;
+    Event_Flow_If_Eval flow_if_eval;
+    Event_Flow_Branch_Taken flow_branch_taken;
+    Event_Flow_Loop_Begin flow_loop_begin;
+    Event_Flow_Loop_End flow_loop_end;
+    Event_Flow_Break flow_break;
+    Event_Flow_Continue flow_continue;
+    Event_Flow_Defer_Queue flow_defer_queue;
+    Event_Flow_Defer_Flush flow_defer_flush;
+    Event_Flow_Block_Begin flow_block_begin;
+    Event_Flow_Block_End flow_block_end;
+    Event_Flow_Function_Begin flow_function_begin;
+    Event_Flow_Function_End flow_function_end;
+    Event_Flow_Macro_Begin flow_macro_begin;
+    Event_Flow_Macro_End flow_macro_end;
+    Event_Fs_Write_File fs_write_file;
+    Event_Fs_Append_File fs_append_file;
+    Event_Fs_Read_File fs_read_file;
+    Event_Fs_Glob fs_glob;
+    Event_Fs_Mkdir fs_mkdir;
+    Event_Fs_Remove fs_remove;
+    Event_Fs_Copy fs_copy;
+    Event_Fs_Rename fs_rename;
+    Event_Fs_Create_Link fs_create_link;
+    Event_Fs_Chmod fs_chmod;
+    Event_Fs_Archive_Create fs_archive_create;
+    Event_Fs_Archive_Extract fs_archive_extract;
+    Event_Fs_Transfer_Download fs_transfer_download;
+    Event_Fs_Transfer_Upload fs_transfer_upload;
+    Event_Proc_Exec_Request proc_exec_request;
+    Event_Proc_Exec_Result proc_exec_result;
+    Event_String_Replace string_replace;
+    Event_String_Configure string_configure;
+    Event_String_Regex string_regex;
+    Event_String_Hash string_hash;
+    Event_String_Timestamp string_timestamp;
+    Event_List_Append list_append;
+    Event_List_Prepend list_prepend;
+    Event_List_Insert list_insert;
+    Event_List_Remove list_remove;
+    Event_List_Transform list_transform;
+    Event_List_Sort list_sort;
+    Event_Math_Expr math_expr;
+    Event_Path_Normalize path_normalize;
+    Event_Path_Compare path_compare;
+    Event_Path_Convert path_convert;
+    Event_Test_Enable test_enable;
+    Event_Test_Enable testing_enable; // legacy alias
+    Event_Test_Add test_add;
+    Event_Install_Rule_Add install_rule_add;
+    Event_Install_Rule_Add install_add_rule; // legacy alias
+    Event_Cpack_Add_Install_Type cpack_add_install_type;
+    Event_Cpack_Add_Component_Group cpack_add_component_group;
+    Event_Cpack_Add_Component cpack_add_component;
+    Event_Cpack_Package_Declare cpack_package_declare;
+    Event_Cpack_Package_Add_Generator cpack_package_add_generator;
+    Event_Cpack_Package_Archive_Name_Override cpack_package_archive_name_override;
+    Event_Package_Find_Result package_find_result;
+    Event_Package_Find_Result find_package; // legacy alias
+    Event_Project_Declare project_declare;
+    Event_Project_Minimum_Required project_minimum_required;
+    Event_Target_Declare target_declare;
+    Event_Target_Add_Source target_add_source;
+    Event_Target_File_Set_Declare target_file_set_declare;
+    Event_Target_File_Set_Add_Base_Dir target_file_set_add_base_dir;
+    Event_Source_Mark_Generated source_mark_generated;
+    Event_Source_Property_Mutate source_property_mutate;
+    Event_Target_Add_Dependency target_add_dependency;
+    Event_Build_Step_Declare build_step_declare;
+    Event_Build_Step_Add_Output build_step_add_output;
+    Event_Build_Step_Add_Byproduct build_step_add_byproduct;
+    Event_Build_Step_Add_Dependency build_step_add_dependency;
+    Event_Build_Step_Add_Command build_step_add_command;
+    Event_Replay_Action_Declare replay_action_declare;
+    Event_Replay_Action_Add_Input replay_action_add_input;
+    Event_Replay_Action_Add_Output replay_action_add_output;
+    Event_Replay_Action_Add_Argv replay_action_add_argv;
+    Event_Replay_Action_Add_Env replay_action_add_env;
+    Event_Target_Prop_Set target_prop_set;
+    Event_Target_Link_Libraries target_link_libraries;
+    Event_Target_Link_Options target_link_options;
+    Event_Target_Link_Directories target_link_directories;
+    Event_Target_Include_Directories target_include_directories;
+    Event_Target_Compile_Definitions target_compile_definitions;
+    Event_Target_Compile_Options target_compile_options;
+    Event_Target_Compile_Features target_compile_features;
+    Event_Export_Install export_install;
+    Event_Export_Build_Declare export_build_declare;
+    Event_Export_Build_Add_Target export_build_add_target;
+    Event_Export_Package_Registry export_package_registry;
+} Event_Payload;
+
 typedef struct {
     Event_Header h;
-    union {
-        Event_Diag diag;
-        Event_Command_Begin command_begin;
-        Event_Command_Begin command_call; // legacy alias
-        Event_Command_End command_end;
-        Event_Include_Begin include_begin;
-        Event_Include_End include_end;
-        Event_Add_Subdirectory_Begin add_subdirectory_begin;
-        Event_Add_Subdirectory_End add_subdirectory_end;
-        Event_Cmake_Language_Call cmake_language_call;
-        Event_Cmake_Language_Eval cmake_language_eval;
-        Event_Cmake_Language_Defer_Queue cmake_language_defer_queue;
-        Event_Directory_Enter directory_enter;
-        Event_Directory_Enter dir_push; // legacy alias
-        Event_Directory_Leave directory_leave;
-        Event_Directory_Leave dir_pop; // legacy alias
-        Event_Directory_Property_Mutate directory_property_mutate;
-        Event_Global_Property_Mutate global_property_mutate;
-        Event_Var_Set var_set;
-        Event_Var_Unset var_unset;
-        Event_Scope_Push scope_push;
-        Event_Scope_Pop scope_pop;
-        Event_Policy_Push policy_push;
-        Event_Policy_Pop policy_pop;
-        Event_Policy_Set policy_set;
-        Event_Flow_Return flow_return;
-        Event_Flow_If_Eval flow_if_eval;
-        Event_Flow_Branch_Taken flow_branch_taken;
-        Event_Flow_Loop_Begin flow_loop_begin;
-        Event_Flow_Loop_End flow_loop_end;
-        Event_Flow_Break flow_break;
-        Event_Flow_Continue flow_continue;
-        Event_Flow_Defer_Queue flow_defer_queue;
-        Event_Flow_Defer_Flush flow_defer_flush;
-        Event_Flow_Block_Begin flow_block_begin;
-        Event_Flow_Block_End flow_block_end;
-        Event_Flow_Function_Begin flow_function_begin;
-        Event_Flow_Function_End flow_function_end;
-        Event_Flow_Macro_Begin flow_macro_begin;
-        Event_Flow_Macro_End flow_macro_end;
-        Event_Fs_Write_File fs_write_file;
-        Event_Fs_Append_File fs_append_file;
-        Event_Fs_Read_File fs_read_file;
-        Event_Fs_Glob fs_glob;
-        Event_Fs_Mkdir fs_mkdir;
-        Event_Fs_Remove fs_remove;
-        Event_Fs_Copy fs_copy;
-        Event_Fs_Rename fs_rename;
-        Event_Fs_Create_Link fs_create_link;
-        Event_Fs_Chmod fs_chmod;
-        Event_Fs_Archive_Create fs_archive_create;
-        Event_Fs_Archive_Extract fs_archive_extract;
-        Event_Fs_Transfer_Download fs_transfer_download;
-        Event_Fs_Transfer_Upload fs_transfer_upload;
-        Event_Proc_Exec_Request proc_exec_request;
-        Event_Proc_Exec_Result proc_exec_result;
-        Event_String_Replace string_replace;
-        Event_String_Configure string_configure;
-        Event_String_Regex string_regex;
-        Event_String_Hash string_hash;
-        Event_String_Timestamp string_timestamp;
-        Event_List_Append list_append;
-        Event_List_Prepend list_prepend;
-        Event_List_Insert list_insert;
-        Event_List_Remove list_remove;
-        Event_List_Transform list_transform;
-        Event_List_Sort list_sort;
-        Event_Math_Expr math_expr;
-        Event_Path_Normalize path_normalize;
-        Event_Path_Compare path_compare;
-        Event_Path_Convert path_convert;
-        Event_Test_Enable test_enable;
-        Event_Test_Enable testing_enable; // legacy alias
-        Event_Test_Add test_add;
-        Event_Install_Rule_Add install_rule_add;
-        Event_Install_Rule_Add install_add_rule; // legacy alias
-        Event_Cpack_Add_Install_Type cpack_add_install_type;
-        Event_Cpack_Add_Component_Group cpack_add_component_group;
-        Event_Cpack_Add_Component cpack_add_component;
-        Event_Cpack_Package_Declare cpack_package_declare;
-        Event_Cpack_Package_Add_Generator cpack_package_add_generator;
-        Event_Cpack_Package_Archive_Name_Override cpack_package_archive_name_override;
-        Event_Package_Find_Result package_find_result;
-        Event_Package_Find_Result find_package; // legacy alias
-        Event_Project_Declare project_declare;
-        Event_Project_Minimum_Required project_minimum_required;
-        Event_Target_Declare target_declare;
-        Event_Target_Add_Source target_add_source;
-        Event_Target_File_Set_Declare target_file_set_declare;
-        Event_Target_File_Set_Add_Base_Dir target_file_set_add_base_dir;
-        Event_Source_Mark_Generated source_mark_generated;
-        Event_Source_Property_Mutate source_property_mutate;
-        Event_Target_Add_Dependency target_add_dependency;
-        Event_Build_Step_Declare build_step_declare;
-        Event_Build_Step_Add_Output build_step_add_output;
-        Event_Build_Step_Add_Byproduct build_step_add_byproduct;
-        Event_Build_Step_Add_Dependency build_step_add_dependency;
-        Event_Build_Step_Add_Command build_step_add_command;
-        Event_Replay_Action_Declare replay_action_declare;
-        Event_Replay_Action_Add_Input replay_action_add_input;
-        Event_Replay_Action_Add_Output replay_action_add_output;
-        Event_Replay_Action_Add_Argv replay_action_add_argv;
-        Event_Replay_Action_Add_Env replay_action_add_env;
-        Event_Target_Prop_Set target_prop_set;
-        Event_Target_Link_Libraries target_link_libraries;
-        Event_Target_Link_Options target_link_options;
-        Event_Target_Link_Directories target_link_directories;
-        Event_Target_Include_Directories target_include_directories;
-        Event_Target_Compile_Definitions target_compile_definitions;
-        Event_Target_Compile_Options target_compile_options;
-        Event_Target_Compile_Features target_compile_features;
-        Event_Export_Install export_install;
-        Event_Export_Build_Declare export_build_declare;
-        Event_Export_Build_Add_Target export_build_add_target;
-        Event_Export_Package_Registry export_package_registry;
-    } as;
+    Event_Payload as;
 } Event;
 
+// Push consumer called for every accepted event, in emission order. The
+// event is only valid for the duration of the call.
+typedef void (*Event_Stream_Sink_Fn)(void *userdata, const Event *ev);
+
+typedef struct {
+    uint64_t hash;
+    String_View text;
+    uint32_t origin_file; // Event_Record.origin_file for this path, 0 if unused
+} Event_String_Intern;
+
+// Stored form of one event: the header in fixed-width fields plus a pointer
+// into the payload pool of its kind, which holds only that kind's payload
+// struct instead of a whole `Event_Payload`. Use event_stream_next() or
+// event_stream_get() to expand records back into `Event`s.
+typedef struct {
+    uint16_t kind;
+    uint16_t version;
+    uint32_t flags;
+    uint64_t seq;
+    uint32_t scope_depth;
+    uint32_t policy_depth;
+    uint32_t origin_file; // 1-based index into Event_Stream.origin_files, 0 for none
+    uint32_t origin_line;
+    uint32_t origin_col;
+    const void *payload;
+} Event_Record;
+
+// Payloads of one kind are packed back to back in arena chunks that never
+// move, so records can point at them directly.
+typedef struct {
+    unsigned char *next;
+    size_t remaining;
+    size_t chunk_items;
+} Event_Payload_Pool;
+
 typedef struct {
     Arena *arena;
-    Event *items;
-    size_t count; // compatibility mirror for arena_arr_len(items)
+    Event_Record *records;
+    size_t count; // compatibility mirror for arena_arr_len(records)
     uint64_t next_seq;
+    size_t pushed_count; // every accepted event, including ones not kept in `records`
+    // Optional sink; see event_stream_set_sink().
+    Event_Stream_Sink_Fn sink;
+    void *sink_userdata;
+    uint32_t retain_families; // bit (1u << Event_Family) keeps that family in `records`
+    uint32_t subscribed_roles; // Event_Role bits accepted; see event_stream_subscribe()
+    String_View *origin_files; // distinct origin paths
+    Event_Payload_Pool payload_pools[EVENT_KIND_COUNT];
+    // Open-addressed table of the payload strings copied so far. Equal text
+    // pushed into one stream shares a single copy, so it also compares equal
+    // by pointer.
+    Event_String_Intern *intern_slots;
+    size_t intern_capacity;
+    size_t intern_count; // distinct strings stored
+    size_t intern_bytes_saved; // bytes (including terminators) not copied again
 } Event_Stream;
 
 typedef struct {
     const Event_Stream *stream;
     size_t index;
-    const Event *current;
+    const Event *current; // points at `event`; valid until the next call
+    Event event;
 } Event_Stream_Iterator;
 
 typedef Event_Directory_Enter Event_Dir_Push;
@@ -1273,11 +1331,39 @@ typedef Event_Diag_Severity Cmake_Diag_Severity;
 Event_Stream *event_stream_create(Arena *arena);
 // Append one canonical event into the stream. This is the only supported
 // payload ownership boundary: strings and string arrays are deep-copied into
-// the stream arena on success.
+// the stream arena on success, with each distinct string stored once, and the
+// event is kept as a compact Event_Record.
 bool event_stream_push(Event_Stream *stream, const Event *ev);
+// Streams events into `sink` as they are pushed. While a sink is set, only
+// families selected by `retain_families` are still stored in `records`, so the
+// stream's memory no longer grows with the events the sink consumes.
+void event_stream_set_sink(Event_Stream *stream,
+                           Event_Stream_Sink_Fn sink,
+                           void *userdata,
+                           uint32_t retain_families);
+// Limits the stream to kinds carrying at least one of `roles` (a new stream
+// accepts EVENT_ROLE_ALL). Other events are dropped by event_stream_push()
+// without being counted, and producers can ask event_stream_wants() first
+// to avoid building their payloads at all.
+void event_stream_subscribe(Event_Stream *stream, uint32_t roles);
+// True when event_stream_push() would accept `kind`. A NULL stream filters
+// nothing.
+bool event_stream_wants(const Event_Stream *stream, Event_Kind kind);
 bool event_copy_into_arena(Arena *arena, Event *ev);
 Event_Stream_Iterator event_stream_iter(const Event_Stream *stream);
+// Expands the next record into `it->event`.
 bool event_stream_next(Event_Stream_Iterator *it);
+// Expands record `index` into `out`; false when out of range.
+bool event_stream_get(const Event_Stream *stream, size_t index, Event *out);
+// Writes the events kept in `stream->records` as a binary snapshot. Payloads,
+// strings and arrays become offsets into pools behind the records; the file
+// is replaced atomically and is only meant to be read back on the same host.
+bool event_stream_write_file(const Event_Stream *stream, const char *path);
+// Maps a file written by event_stream_write_file() and relocates it in place:
+// records, payloads, arrays and strings are used straight from the private mapping,
+// which stays alive until `arena` is destroyed. Returns NULL when the file is
+// missing, stale or corrupt.
+Event_Stream *event_stream_load_file(Arena *arena, const char *path);
 
 const Event_Kind_Meta *event_kind_meta(Event_Kind kind);
 bool event_kind_has_role(Event_Kind kind, Event_Role role);
@@ -1285,6 +1371,7 @@ uint32_t event_kind_role_mask(Event_Kind kind);
 Event_Family event_kind_family(Event_Kind kind);
 const char *event_family_name(Event_Family family);
 const char *event_kind_name(Event_Kind kind);
+void event_dump(FILE *out, const Event *ev);
 void event_stream_dump(const Event_Stream *stream);
 
 #endif // EVENT_IR_H_
@@ -1235,6 +1235,141 @@ TEST(build_model_marks_generated_sources_without_producer_steps) {
     TEST_PASS();
 }
 
+// Synthetic model with `count` output rules, each producing one source of a
+// single target and depending on the previous rule's output, plus `count`
+// mark-only generated sources. Re-freezes the draft once, reports how long
+// that took and checks the producer of every source in the result.
+static bool build_model_bench_freeze_generated_sources(size_t count, uint64_t *out_nanos) {
+    Arena *arena = arena_create(8 * 1024 * 1024);
+    Arena *validate_arena = arena_create(2 * 1024 * 1024);
+    Arena *model_arena = arena_create(8 * 1024 * 1024);
+    Test_Semantic_Pipeline_Build_Result build = {0};
+    Event_Stream *stream = NULL;
+    Event ev = {0};
+    const Build_Model *model = NULL;
+    BM_Target_Id app_id = BM_TARGET_ID_INVALID;
+    Arena *freeze_arena = NULL;
+    bool ok = false;
+    if (!arena || !validate_arena || !model_arena) goto defer;
+
+    stream = event_stream_create(arena);
+    if (!stream) goto defer;
+
+    build_model_init_event(&ev, EVENT_DIRECTORY_ENTER, 1);
+    ev.as.directory_enter.source_dir = nob_sv_from_cstr("freeze_bench_src");
+    ev.as.directory_enter.binary_dir = nob_sv_from_cstr("freeze_bench_build");
+    if (!event_stream_push(stream, &ev)) goto defer;
+
+    build_model_init_event(&ev, EVENT_TARGET_DECLARE, 2);
+    ev.as.target_declare.name = nob_sv_from_cstr("app");
+    ev.as.target_declare.target_type = EV_TARGET_EXECUTABLE;
+    if (!event_stream_push(stream, &ev)) goto defer;
+
+    for (size_t i = 0; i < count; ++i) {
+        const char *step_key = arena_strdup(arena, nob_temp_sprintf("gen_%zu", i));
+        const char *output = arena_strdup(arena, nob_temp_sprintf("gen/out_%zu.c", i));
+        const char *byproduct = arena_strdup(arena, nob_temp_sprintf("gen/out_%zu.log", i));
+        const char *marked = arena_strdup(arena, nob_temp_sprintf("gen/marked_%zu.c", i));
+        const char *mark_path = arena_strdup(arena, nob_temp_sprintf("freeze_bench_build/gen/marked_%zu.c", i));
+        nob_temp_reset();
+        if (!step_key || !output || !byproduct || !marked || !mark_path) goto defer;
+
+        build_model_init_event(&ev, EVENT_BUILD_STEP_DECLARE, 3);
+        ev.as.build_step_declare.step_key = nob_sv_from_cstr(step_key);
+        ev.as.build_step_declare.step_kind = EVENT_BUILD_STEP_OUTPUT_RULE;
+        if (!event_stream_push(stream, &ev)) goto defer;
+
+        build_model_init_event(&ev, EVENT_BUILD_STEP_ADD_OUTPUT, 4);
+        ev.as.build_step_add_output.step_key = nob_sv_from_cstr(step_key);
+        ev.as.build_step_add_output.path = nob_sv_from_cstr(output);
+        if (!event_stream_push(stream, &ev)) goto defer;
+
+        build_model_init_event(&ev, EVENT_BUILD_STEP_ADD_BYPRODUCT, 5);
+        ev.as.build_step_add_byproduct.step_key = nob_sv_from_cstr(step_key);
+        ev.as.build_step_add_byproduct.path = nob_sv_from_cstr(byproduct);
+        if (!event_stream_push(stream, &ev)) goto defer;
+
+        if (i > 0) {
+            const char *dependency = arena_strdup(arena, nob_temp_sprintf("freeze_bench_build/gen/out_%zu.c", i - 1));
+            nob_temp_reset();
+            if (!dependency) goto defer;
+            build_model_init_event(&ev, EVENT_BUILD_STEP_ADD_DEPENDENCY, 6);
+            ev.as.build_step_add_dependency.step_key = nob_sv_from_cstr(step_key);
+            ev.as.build_step_add_dependency.item = nob_sv_from_cstr(dependency);
+            ev.as.build_step_add_dependency.kind = EVENT_BUILD_STEP_DEP_PATH_TOKEN;
+            if (!event_stream_push(stream, &ev)) goto defer;
+        }
+
+        build_model_init_event(&ev, EVENT_TARGET_ADD_SOURCE, 7);
+        ev.as.target_add_source.target_name = nob_sv_from_cstr("app");
+        ev.as.target_add_source.path = nob_sv_from_cstr(output);
+        if (!event_stream_push(stream, &ev)) goto defer;
+
+        build_model_init_event(&ev, EVENT_TARGET_ADD_SOURCE, 8);
+        ev.as.target_add_source.target_name = nob_sv_from_cstr("app");
+        ev.as.target_add_source.path = nob_sv_from_cstr(marked);
+        if (!event_stream_push(stream, &ev)) goto defer;
+
+        build_model_init_event(&ev, EVENT_SOURCE_MARK_GENERATED, 9);
+        ev.as.source_mark_generated.path = nob_sv_from_cstr(mark_path);
+        ev.as.source_mark_generated.directory_source_dir = nob_sv_from_cstr("freeze_bench_src");
+        ev.as.source_mark_generated.directory_binary_dir = nob_sv_from_cstr("freeze_bench_build");
+        ev.as.source_mark_generated.generated = true;
+        if (!event_stream_push(stream, &ev)) goto defer;
+    }
+
+    build_model_init_event(&ev, EVENT_DIRECTORY_LEAVE, 10);
+    ev.as.directory_leave.source_dir = nob_sv_from_cstr("freeze_bench_src");
+    ev.as.directory_leave.binary_dir = nob_sv_from_cstr("freeze_bench_build");
+    if (!event_stream_push(stream, &ev)) goto defer;
+
+    if (!test_semantic_pipeline_build_model_from_stream(arena, validate_arena, model_arena, stream, &build) ||
+        !build.freeze_ok ||
+        !build.model) {
+        goto defer;
+    }
+
+    freeze_arena = arena_create(8 * 1024 * 1024);
+    if (!freeze_arena) goto defer;
+    uint64_t start = nob_nanos_since_unspecified_epoch();
+    model = bm_freeze_draft(build.draft, freeze_arena, build.sink);
+    *out_nanos = nob_nanos_since_unspecified_epoch() - start;
+    if (!model) goto defer;
+
+    app_id = bm_query_target_by_name(model, nob_sv_from_cstr("app"));
+    if (app_id == BM_TARGET_ID_INVALID ||
+        bm_query_target_source_count(model, app_id) != count * 2 ||
+        bm_query_build_step_producer_dependencies(model, (BM_Build_Step_Id)(count - 1)).count != (count > 1 ? 1 : 0)) {
+        goto defer;
+    }
+    for (size_t i = 0; i < bm_query_target_source_count(model, app_id); ++i) {
+        BM_Build_Step_Id producer = bm_query_target_source_producer_step(model, app_id, i);
+        if (!bm_query_target_source_generated(model, app_id, i)) goto defer;
+        if (producer != (i % 2 == 0 ? (BM_Build_Step_Id)(i / 2) : BM_BUILD_STEP_ID_INVALID)) goto defer;
+    }
+    ok = true;
+
+defer:
+    if (freeze_arena) arena_destroy(freeze_arena);
+    if (arena) arena_destroy(arena);
+    if (validate_arena) arena_destroy(validate_arena);
+    if (model_arena) arena_destroy(model_arena);
+    return ok;
+}
+
+TEST(build_model_freeze_resolves_producers_for_many_generated_sources) {
+    uint64_t small_nanos = 0;
+    uint64_t large_nanos = 0;
+    ASSERT(build_model_bench_freeze_generated_sources(500, &small_nanos));
+    ASSERT(build_model_bench_freeze_generated_sources(4000, &large_nanos));
+
+    nob_log(NOB_INFO,
+            "build model bench: freezing 500 generated sources took %.3f ms, 4000 took %.3f ms",
+            (double)small_nanos / 1e6,
+            (double)large_nanos / 1e6);
+    TEST_PASS();
+}
+
 TEST(build_model_freeze_rejects_duplicate_effective_producers_and_execution_cycles) {
     Arena *dup_arena = arena_create(2 * 1024 * 1024);
     Arena *dup_validate_arena = arena_create(512 * 1024);
@@ -6343,6 +6478,7 @@ void run_build_model_v2_tests(int *passed, int *failed, int *skipped) {
     test_build_model_resolves_source_and_stripped_generated_source_producers(passed, failed, skipped);
     test_build_model_resolves_byproduct_producers_and_keeps_unresolved_file_dependencies(passed, failed, skipped);
     test_build_model_marks_generated_sources_without_producer_steps(passed, failed, skipped);
+    test_build_model_freeze_resolves_producers_for_many_generated_sources(passed, failed, skipped);
     test_build_model_freeze_rejects_duplicate_effective_producers_and_execution_cycles(passed, failed, skipped);
     test_build_model_replay_actions_freeze_query_and_preserve_order(passed, failed, skipped);
     test_build_model_replay_action_resolved_operands_use_query_context(passed, failed, skipped);
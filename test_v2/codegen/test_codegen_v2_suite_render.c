@@ -372,6 +372,110 @@ TEST(codegen_render_imported_config_branches_do_not_depend_on_imported_raw_prope
     TEST_PASS();
 }
 
+// Builds a model with `target_count` libraries that each link one of a few
+// shared bases and name it in a $<TARGET_FILE_NAME:...> definition, so every
+// target costs a couple of by-name target lookups when rendered. Each library
+// also gets a test and a package so the name indexes of all three kinds are
+// checked against every id before the model is rendered once.
+static bool codegen_bench_render_targets(size_t target_count, uint64_t *out_nanos) {
+    enum { BASE_COUNT = 8 };
+    Test_Semantic_Pipeline_Config pipeline_config = {0};
+    Test_Semantic_Pipeline_Fixture fixture = {0};
+    Nob_String_Builder script = {0};
+    Nob_String_Builder sb = {0};
+    Nob_Codegen_Options opts = {
+        .input_path = nob_sv_from_cstr("render_bench_src/CMakeLists.txt"),
+        .output_path = nob_sv_from_cstr("render_bench_nob.c"),
+        .source_root = nob_sv_from_cstr("render_bench_src"),
+        .binary_root = nob_sv_from_cstr("render_bench_build"),
+    };
+    const Build_Model *model = NULL;
+    bool ok = false;
+
+    nob_sb_append_cstr(&script, "project(Bench C)\nenable_testing()\n");
+    for (size_t i = 0; i < BASE_COUNT; ++i) {
+        nob_sb_appendf(&script, "add_library(base_%zu STATIC base_%zu.c)\n", i, i);
+    }
+    for (size_t i = 0; i < target_count; ++i) {
+        size_t base = i % BASE_COUNT;
+        nob_sb_appendf(&script, "add_library(lib_%zu STATIC lib_%zu.c)\n", i, i);
+        nob_sb_appendf(&script, "target_link_libraries(lib_%zu PRIVATE base_%zu)\n", i, base);
+        nob_sb_appendf(&script,
+                       "target_compile_definitions(lib_%zu PRIVATE BASE_FILE=$<TARGET_FILE_NAME:base_%zu>)\n",
+                       i,
+                       base);
+        nob_sb_appendf(&script, "add_test(NAME test_%zu COMMAND bench_runner %zu)\n", i, i);
+        nob_sb_appendf(&script, "find_package(Pkg_%zu QUIET CONFIG NO_DEFAULT_PATH)\n", i);
+    }
+    nob_sb_append_null(&script);
+
+    nob_temp_reset();
+    test_semantic_pipeline_config_init(&pipeline_config);
+    pipeline_config.current_file = "render_bench_src/CMakeLists.txt";
+    pipeline_config.source_dir = nob_sv_from_cstr("render_bench_src");
+    pipeline_config.binary_dir = nob_sv_from_cstr("render_bench_build");
+    if (!test_semantic_pipeline_fixture_from_script(&fixture, script.items, &pipeline_config) ||
+        !fixture.eval_ok ||
+        !fixture.build.freeze_ok ||
+        !fixture.build.model) {
+        goto defer;
+    }
+    nob_temp_reset();
+
+    model = fixture.build.model;
+    if (bm_query_target_count(model) != target_count + BASE_COUNT ||
+        bm_query_test_count(model) != target_count ||
+        bm_query_package_count(model) != target_count) {
+        goto defer;
+    }
+    for (size_t id = 0; id < bm_query_target_count(model); ++id) {
+        String_View name = bm_query_target_name(model, (BM_Target_Id)id);
+        if (bm_query_target_by_name(model, name) != (BM_Target_Id)id) goto defer;
+    }
+    for (size_t id = 0; id < bm_query_test_count(model); ++id) {
+        String_View name = bm_query_test_name(model, (BM_Test_Id)id);
+        if (bm_query_test_by_name(model, name) != (BM_Test_Id)id) goto defer;
+    }
+    for (size_t id = 0; id < bm_query_package_count(model); ++id) {
+        String_View name = bm_query_package_name(model, (BM_Package_Id)id);
+        if (bm_query_package_by_name(model, name) != (BM_Package_Id)id) goto defer;
+    }
+    if (bm_query_target_by_name(model, nob_sv_from_cstr("lib_missing")) != BM_TARGET_ID_INVALID ||
+        bm_query_test_by_name(model, nob_sv_from_cstr("test_missing")) != BM_TEST_ID_INVALID ||
+        bm_query_package_by_name(model, nob_sv_from_cstr("Pkg_missing")) != BM_PACKAGE_ID_INVALID) {
+        goto defer;
+    }
+
+    Arena *codegen_arena = arena_create(4 * 1024 * 1024);
+    if (!codegen_arena) goto defer;
+    size_t temp_mark = nob_temp_save();
+    uint64_t start = nob_nanos_since_unspecified_epoch();
+    bool rendered = nob_codegen_render(model, codegen_arena, &opts, &sb);
+    *out_nanos = nob_nanos_since_unspecified_epoch() - start;
+    nob_temp_rewind(temp_mark);
+    arena_destroy(codegen_arena);
+    ok = rendered;
+
+defer:
+    nob_sb_free(sb);
+    nob_sb_free(script);
+    test_semantic_pipeline_fixture_destroy(&fixture);
+    return ok;
+}
+
+TEST(codegen_render_name_lookups_resolve_every_target_test_and_package) {
+    uint64_t small_nanos = 0;
+    uint64_t large_nanos = 0;
+    ASSERT(codegen_bench_render_targets(100, &small_nanos));
+    ASSERT(codegen_bench_render_targets(1600, &large_nanos));
+
+    nob_log(NOB_INFO,
+            "codegen bench: rendering 100 targets took %.3f ms, 1600 targets took %.3f ms",
+            (double)small_nanos / 1e6,
+            (double)large_nanos / 1e6);
+    TEST_PASS();
+}
+
 void run_codegen_v2_render_tests(int *passed, int *failed, int *skipped) {
     test_codegen_simple_executable_generates_compilable_nob(passed, failed, skipped);
     test_codegen_static_interface_alias_usage_propagates_flags(passed, failed, skipped);
@@ -384,4 +488,5 @@ void run_codegen_v2_render_tests(int *passed, int *failed, int *skipped) {
     test_codegen_generated_nob_compiles_cleanly_with_werror_for_representative_paths(passed, failed, skipped);
     test_codegen_render_multi_config_mixed_language_and_imported_queries_stay_stable(passed, failed, skipped);
     test_codegen_render_imported_config_branches_do_not_depend_on_imported_raw_property_suffixes(passed, failed, skipped);
+    test_codegen_render_name_lookups_resolve_every_target_test_and_package(passed, failed, skipped);
 }
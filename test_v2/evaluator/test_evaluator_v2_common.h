@@ -50,6 +50,7 @@ typedef struct {
     Eval_Compat_Profile compat_profile;
     EvalRegistry *registry;
     bool disable_export_host_effects;
+    String_View ast_cache_dir;
 } Eval_Test_Init;
 
 typedef struct {
@@ -202,6 +203,7 @@ static Eval_Test_Runtime *eval_test_create(const Eval_Test_Init *init) {
     cfg.source_root = init->source_dir;
     cfg.binary_root = init->binary_dir;
     cfg.enable_export_host_effects = !init->disable_export_host_effects;
+    cfg.ast_cache_dir = init->ast_cache_dir;
 
     ctx->session = eval_session_create(&cfg);
     if (!ctx->session) {
@@ -287,8 +289,9 @@ static bool eval_test_target_known(const Eval_Test_Runtime *ctx, String_View tar
 
 static bool eval_test_var_event_seen(const Cmake_Event_Stream *stream, String_View key) {
     if (!stream) return false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_VAR_SET) continue;
         if (nob_sv_eq(ev->as.var_set.key, key)) return true;
     }
@@ -402,14 +405,16 @@ static bool evaluator_find_last_diag_for_command(const Cmake_Event_Stream *strea
                                                  String_View command,
                                                  Event_Diag_Severity *out_severity) {
     if (!stream || !out_severity) return false;
-    for (size_t i = stream->count; i > 0; i--) {
-        const Cmake_Event *ev = &stream->items[i - 1];
+    bool found = false;
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (!nob_sv_eq(ev->as.diag.command, command)) continue;
         *out_severity = ev->as.diag.severity;
-        return true;
+        found = true;
     }
-    return false;
+    return found;
 }
 
 static Eval_Result native_test_handler_snapshot_set_unsupported_error(EvalExecContext *ctx, const Node *node) {
@@ -1109,16 +1114,18 @@ static bool evaluator_snapshot_from_ast(Ast_Root root, const char *current_file,
 
     nob_sb_append_cstr(out_sb, nob_temp_sprintf("DIAG errors=%zu warnings=%zu\n", diag_error_count(), diag_warning_count()));
     size_t visible_count = 0;
-    for (size_t i = 0; i < stream->count; i++) {
-        if (snapshot_event_is_visible(&stream->items[i])) visible_count++;
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        if (snapshot_event_is_visible(it.current)) visible_count++;
     }
 
     nob_sb_append_cstr(out_sb, nob_temp_sprintf("EVENTS count=%zu\n", visible_count));
 
     size_t visible_index = 0;
-    for (size_t i = 0; i < stream->count; i++) {
-        if (!snapshot_event_is_visible(&stream->items[i])) continue;
-        append_event_line(out_sb, visible_index++, &stream->items[i]);
+    it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        if (!snapshot_event_is_visible(it.current)) continue;
+        append_event_line(out_sb, visible_index++, it.current);
     }
 
     eval_test_destroy(ctx);
@@ -1133,11 +1140,12 @@ static size_t evaluator_find_command_begin_index(const Cmake_Event_Stream *strea
                                                  Event_Command_Dispatch_Kind dispatch_kind) {
     if (!stream) return (size_t)-1;
     for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
-        if (ev->h.kind != EVENT_COMMAND_BEGIN) continue;
-        if (ev->h.origin.line != origin_line) continue;
-        if (ev->as.command_begin.dispatch_kind != dispatch_kind) continue;
-        if (!nob_sv_eq(ev->as.command_begin.command_name, command_name)) continue;
+        Cmake_Event ev = {0};
+        if (!event_stream_get(stream, i, &ev)) break;
+        if (ev.h.kind != EVENT_COMMAND_BEGIN) continue;
+        if (ev.h.origin.line != origin_line) continue;
+        if (ev.as.command_begin.dispatch_kind != dispatch_kind) continue;
+        if (!nob_sv_eq(ev.as.command_begin.command_name, command_name)) continue;
         return i;
     }
     return (size_t)-1;
@@ -1150,12 +1158,13 @@ static size_t evaluator_find_command_end_index(const Cmake_Event_Stream *stream,
                                                Event_Command_Status status) {
     if (!stream) return (size_t)-1;
     for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
-        if (ev->h.kind != EVENT_COMMAND_END) continue;
-        if (ev->h.origin.line != origin_line) continue;
-        if (ev->as.command_end.dispatch_kind != dispatch_kind) continue;
-        if (ev->as.command_end.status != status) continue;
-        if (!nob_sv_eq(ev->as.command_end.command_name, command_name)) continue;
+        Cmake_Event ev = {0};
+        if (!event_stream_get(stream, i, &ev)) break;
+        if (ev.h.kind != EVENT_COMMAND_END) continue;
+        if (ev.h.origin.line != origin_line) continue;
+        if (ev.as.command_end.dispatch_kind != dispatch_kind) continue;
+        if (ev.as.command_end.status != status) continue;
+        if (!nob_sv_eq(ev.as.command_end.command_name, command_name)) continue;
         return i;
     }
     return (size_t)-1;
@@ -1167,11 +1176,12 @@ static size_t evaluator_find_diag_index(const Cmake_Event_Stream *stream,
                                         String_View cause) {
     if (!stream) return (size_t)-1;
     for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
-        if (ev->h.kind != EVENT_DIAG) continue;
-        if (ev->h.origin.line != origin_line) continue;
-        if (!nob_sv_eq(ev->as.diag.command, command_name)) continue;
-        if (!nob_sv_eq(ev->as.diag.cause, cause)) continue;
+        Cmake_Event ev = {0};
+        if (!event_stream_get(stream, i, &ev)) break;
+        if (ev.h.kind != EVENT_DIAG) continue;
+        if (ev.h.origin.line != origin_line) continue;
+        if (!nob_sv_eq(ev.as.diag.command, command_name)) continue;
+        if (!nob_sv_eq(ev.as.diag.cause, cause)) continue;
         return i;
     }
     return (size_t)-1;
@@ -1180,10 +1190,11 @@ static size_t evaluator_find_diag_index(const Cmake_Event_Stream *stream,
 static bool evaluator_stream_has_monotonic_sequence(const Cmake_Event_Stream *stream) {
     if (!stream) return false;
     uint64_t prev_seq = 0;
-    for (size_t i = 0; i < stream->count; i++) {
-        if (stream->items[i].h.version != 1) return false;
-        if (stream->items[i].h.seq <= prev_seq) return false;
-        prev_seq = stream->items[i].h.seq;
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        if (it.current->h.version != 1) return false;
+        if (it.current->h.seq <= prev_seq) return false;
+        prev_seq = it.current->h.seq;
     }
     return true;
 }
@@ -1,4 +1,12 @@
 #include "test_evaluator_v2_support.h"
+#include "eval_expr.h"
+
+#include <time.h>
+#if defined(_WIN32)
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
 
 typedef struct {
     size_t call_count;
@@ -101,9 +109,11 @@ TEST(evaluator_public_api_profile_and_report_snapshot) {
     ASSERT(snapshot->error_count == report->error_count);
 
     bool found_diag_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        if (stream->items[i].h.kind != EV_DIAGNOSTIC) continue;
-        if (stream->items[i].as.diag.severity == EV_DIAG_ERROR) {
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
+        if (ev->h.kind != EV_DIAGNOSTIC) continue;
+        if (ev->as.diag.severity == EV_DIAG_ERROR) {
             found_diag_error = true;
             break;
         }
@@ -397,8 +407,9 @@ TEST(evaluator_command_transaction_rollback_suppresses_semantic_state_and_events
     bool saw_diag = false;
     bool saw_begin = false;
     bool saw_end = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_VAR_SET &&
             nob_sv_eq(ev->as.var_set.key, nob_sv_from_cstr("TX_ROLLBACK_HIT"))) {
             saw_target_declare = true;
@@ -431,6 +442,332 @@ TEST(evaluator_command_transaction_rollback_suppresses_semantic_state_and_events
     TEST_PASS();
 }
 
+TEST(evaluator_command_transaction_rollback_restores_state_mutated_by_committed_children) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "set(TX_CACHE old CACHE STRING \"doc\")\n"
+        "set(ENV{TX_ENV} old)\n"
+        "set_property(GLOBAL PROPERTY TX_PROP old)\n"
+        "add_library(tx_keep INTERFACE)\n"
+        "function(tx_fail)\n"
+        "  set(TX_CACHE new CACHE STRING \"doc\" FORCE)\n"
+        "  set(TX_CACHE_NEW fresh CACHE STRING \"doc\")\n"
+        "  set(ENV{TX_ENV} new)\n"
+        "  set_property(GLOBAL PROPERTY TX_PROP new)\n"
+        "  add_library(tx_drop INTERFACE)\n"
+        "  message(SEND_ERROR \"tx rollback probe\")\n"
+        "endfunction()\n"
+        "tx_fail()\n"
+        "set(TX_CACHE_AFTER \"${TX_CACHE}\")\n"
+        "if(DEFINED TX_CACHE_NEW)\n"
+        "  set(TX_CACHE_NEW_AFTER defined)\n"
+        "endif()\n"
+        "set(TX_ENV_AFTER \"$ENV{TX_ENV}\")\n"
+        "get_property(TX_PROP_AFTER GLOBAL PROPERTY TX_PROP)\n"
+        "if(TARGET tx_keep AND NOT TARGET tx_drop)\n"
+        "  set(TX_TARGETS_AFTER ok)\n"
+        "endif()\n");
+    Eval_Result run_res = eval_test_run(ctx, root);
+    ASSERT(!eval_result_is_fatal(run_res));
+
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("TX_CACHE_AFTER")), nob_sv_from_cstr("old")));
+    ASSERT(eval_test_var_get(ctx, nob_sv_from_cstr("TX_CACHE_NEW_AFTER")).count == 0);
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("TX_ENV_AFTER")), nob_sv_from_cstr("old")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("TX_PROP_AFTER")), nob_sv_from_cstr("old")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("TX_TARGETS_AFTER")), nob_sv_from_cstr("ok")));
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+static bool evaluator_tx_bench_set_commands(size_t target_count,
+                                            uint64_t *out_nanos,
+                                            Eval_Run_Report *out_report) {
+    enum { SET_COMMANDS = 2000, ROUNDS = 3 };
+    Arena *temp_arena = arena_create(16 * 1024 * 1024);
+    Arena *event_arena = arena_create(16 * 1024 * 1024);
+    if (!temp_arena || !event_arena) return false;
+
+    bool ok = false;
+    Eval_Test_Runtime *ctx = NULL;
+    Nob_String_Builder setup = {0};
+    Nob_String_Builder sets = {0};
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = event_stream_create(event_arena);
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+    if (!init.stream) goto defer;
+    ctx = eval_test_create(&init);
+    if (!ctx) goto defer;
+
+    for (size_t i = 0; i < target_count; i++) {
+        nob_sb_appendf(&setup, "add_library(tx_bench_%zu INTERFACE)\n", i);
+    }
+    nob_sb_append_null(&setup);
+    if (eval_result_is_fatal(eval_test_run(ctx, parse_cmake(temp_arena, setup.items)))) goto defer;
+
+    for (size_t i = 0; i < SET_COMMANDS; i++) {
+        nob_sb_appendf(&sets, "set(TX_BENCH_VALUE %zu)\n", i);
+    }
+    nob_sb_append_null(&sets);
+    Ast_Root set_root = parse_cmake(temp_arena, sets.items);
+
+    uint64_t best = UINT64_MAX;
+    for (size_t round = 0; round < ROUNDS; round++) {
+        uint64_t start = nob_nanos_since_unspecified_epoch();
+        if (eval_result_is_fatal(eval_test_run(ctx, set_root))) goto defer;
+        uint64_t elapsed = nob_nanos_since_unspecified_epoch() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    *out_nanos = best;
+    *out_report = *eval_test_report(ctx);
+    ok = true;
+
+defer:
+    nob_sb_free(setup);
+    nob_sb_free(sets);
+    if (ctx) eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    return ok;
+}
+
+TEST(evaluator_command_transaction_cost_stays_flat_as_target_count_grows) {
+    uint64_t small_nanos = 0;
+    uint64_t large_nanos = 0;
+    Eval_Run_Report small_report = {0};
+    Eval_Run_Report large_report = {0};
+    ASSERT(evaluator_tx_bench_set_commands(64, &small_nanos, &small_report));
+    ASSERT(evaluator_tx_bench_set_commands(4096, &large_nanos, &large_report));
+
+    nob_log(NOB_INFO,
+            "tx bench: 2000 set() commands took %.3f ms with 64 targets, %.3f ms with 4096 targets",
+            (double)small_nanos / 1e6,
+            (double)large_nanos / 1e6);
+
+    // Each set() journals its own variable; nothing a command records may
+    // depend on how many targets the session already holds.
+    ASSERT(small_report.tx_undo_entries > 0);
+    ASSERT(small_report.tx_undo_entries == large_report.tx_undo_entries);
+    ASSERT(small_report.tx_snapshot_bytes == large_report.tx_snapshot_bytes);
+    TEST_PASS();
+}
+
+TEST(evaluator_condition_programs_follow_expansion_shape_changes) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "set(OP_RESULTS \"\")\n"
+        "foreach(op STREQUAL LESS STRLESS MATCHES STREQUAL STRLESS)\n"
+        "  if(abc ${op} abd)\n"
+        "    list(APPEND OP_RESULTS 1)\n"
+        "  else()\n"
+        "    list(APPEND OP_RESULTS 0)\n"
+        "  endif()\n"
+        "endforeach()\n"
+        "set(SHAPE_A 1)\n"
+        "set(SHAPE_B \"\")\n"
+        "set(SHAPE_C \"NOT;1\")\n"
+        "set(SHAPE_RESULTS \"\")\n"
+        "foreach(name SHAPE_A SHAPE_A SHAPE_C SHAPE_B SHAPE_A)\n"
+        "  if(${${name}} OR FALSE)\n"
+        "    list(APPEND SHAPE_RESULTS 1)\n"
+        "  else()\n"
+        "    list(APPEND SHAPE_RESULTS 0)\n"
+        "  endif()\n"
+        "endforeach()\n"
+        "set(SKIP_RESULTS \"\")\n"
+        "foreach(i RANGE 2)\n"
+        "  set(CMAKE_MATCH_1 \"\")\n"
+        "  if(0 AND abc MATCHES \"(b)\")\n"
+        "  endif()\n"
+        "  list(APPEND SKIP_RESULTS \"${CMAKE_MATCH_1}\")\n"
+        "  if(1 OR NOT_A_DEFINED_VAR)\n"
+        "    list(APPEND SKIP_RESULTS or)\n"
+        "  endif()\n"
+        "  if((1 AND 0) OR (NOT 0 AND 2 GREATER 1))\n"
+        "    list(APPEND SKIP_RESULTS nested)\n"
+        "  endif()\n"
+        "endforeach()\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+
+    // Same token count, different operator classes on every iteration.
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("OP_RESULTS")),
+                     nob_sv_from_cstr("0;0;1;0;0;1")));
+    // "OR FALSE" reparses as a bare operand with a trailing token, so the
+    // invalid-syntax diagnostic still fires once the program is cached.
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("SHAPE_RESULTS")),
+                     nob_sv_from_cstr("1;1;0;0;1")));
+    ASSERT(eval_test_report(ctx)->error_count == 1);
+    // A skipped right-hand side that sets CMAKE_MATCH_* is still evaluated.
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("SKIP_RESULTS")),
+                     nob_sv_from_cstr("b;or;nested;b;or;nested;b;or;nested")));
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+// Unrolls every single-line if()/elseif()/while() condition in the golden
+// casepack into a flat script and times its first run (each condition is
+// compiled as it executes) against warm runs that reuse cached programs.
+// Reports the program cache counters of the storing run and the last warm run.
+static bool evaluator_condition_bench_fixture(uint64_t *out_cold_nanos,
+                                              uint64_t *out_warm_nanos,
+                                              size_t *out_condition_count,
+                                              Eval_Run_Report *out_store_report,
+                                              Eval_Run_Report *out_warm_report) {
+    enum { COPIES = 40, WARM_ROUNDS = 3 };
+    Arena *temp_arena = arena_create(16 * 1024 * 1024);
+    Arena *event_arena = arena_create(16 * 1024 * 1024);
+    if (!temp_arena || !event_arena) return false;
+
+    bool ok = false;
+    Eval_Test_Runtime *ctx = NULL;
+    Nob_String_Builder script = {0};
+    String_View fixture = {0};
+    size_t condition_count = 0;
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = event_stream_create(event_arena);
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+    if (!init.stream) goto defer;
+    ctx = eval_test_create(&init);
+    if (!ctx) goto defer;
+
+    if (!evaluator_load_text_file_to_arena(temp_arena,
+                                           nob_temp_sprintf("%s/evaluator_all.cmake", EVALUATOR_GOLDEN_DIR),
+                                           &fixture)) {
+        goto defer;
+    }
+
+    nob_sb_append_cstr(&script,
+                       "set(I 2)\nset(C 1)\nset(O 0)\nset(FOO ON)\nset(A 1)\nset(MYLIST a;b)\n"
+                       "set(ACC \"\")\nset(OUT \"\")\nset(ZIP_ACC \"\")\n");
+    for (size_t copy = 0; copy < COPIES; copy++) {
+        String_View rest = fixture;
+        while (rest.count > 0) {
+            String_View line = nob_sv_trim(nob_sv_chop_by_delim(&rest, '\n'));
+            size_t prefix = 0;
+            if (nob_sv_starts_with(line, nob_sv_from_cstr("if("))) prefix = 3;
+            else if (nob_sv_starts_with(line, nob_sv_from_cstr("elseif("))) prefix = 7;
+            else if (nob_sv_starts_with(line, nob_sv_from_cstr("while("))) prefix = 6;
+            if (prefix == 0 || line.count <= prefix || line.data[line.count - 1] != ')') continue;
+            String_View cond = nob_sv_from_parts(line.data + prefix, line.count - prefix - 1);
+            nob_sb_append_cstr(&script, "if(");
+            nob_sb_append_buf(&script, cond.data, cond.count);
+            nob_sb_append_cstr(&script, ")\nendif()\n");
+            if (copy == 0) condition_count++;
+        }
+    }
+    nob_sb_append_null(&script);
+    if (condition_count == 0) goto defer;
+    Ast_Root root = parse_cmake(temp_arena, script.items);
+
+    uint64_t start = nob_nanos_since_unspecified_epoch();
+    if (eval_result_is_fatal(eval_test_run(ctx, root))) goto defer;
+    *out_cold_nanos = nob_nanos_since_unspecified_epoch() - start;
+
+    // The second run stores the programs; later runs only execute them.
+    if (eval_result_is_fatal(eval_test_run(ctx, root))) goto defer;
+    *out_store_report = *eval_test_report(ctx);
+    uint64_t best = UINT64_MAX;
+    for (size_t round = 0; round < WARM_ROUNDS; round++) {
+        start = nob_nanos_since_unspecified_epoch();
+        if (eval_result_is_fatal(eval_test_run(ctx, root))) goto defer;
+        uint64_t elapsed = nob_nanos_since_unspecified_epoch() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    *out_warm_nanos = best;
+    *out_warm_report = *eval_test_report(ctx);
+    *out_condition_count = condition_count * COPIES;
+    ok = true;
+
+defer:
+    nob_sb_free(script);
+    if (ctx) eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    return ok;
+}
+
+TEST(evaluator_condition_program_bench_over_golden_fixture) {
+    uint64_t cold_nanos = 0;
+    uint64_t warm_nanos = 0;
+    size_t condition_count = 0;
+    Eval_Run_Report store_report = {0};
+    Eval_Run_Report warm_report = {0};
+    ASSERT(evaluator_condition_bench_fixture(&cold_nanos,
+                                             &warm_nanos,
+                                             &condition_count,
+                                             &store_report,
+                                             &warm_report));
+
+    nob_log(NOB_INFO,
+            "condition bench: %zu fixture conditions took %.3f ms cold, %.3f ms with cached programs",
+            condition_count,
+            (double)cold_nanos / 1e6,
+            (double)warm_nanos / 1e6);
+    nob_log(NOB_INFO,
+            "condition bench: storing run built %zu programs, warm run hit %zu and built %zu",
+            store_report.cond_program_builds,
+            warm_report.cond_program_hits,
+            warm_report.cond_program_builds);
+
+    // Every condition node is compiled once and then reused as is.
+    ASSERT(store_report.cond_program_builds > 0);
+    ASSERT(store_report.cond_program_builds <= condition_count * (COND_PROGRAM_MAX_REBUILDS + 1));
+    ASSERT(warm_report.cond_program_builds == 0);
+    ASSERT(warm_report.cond_program_hits == condition_count);
+    TEST_PASS();
+}
+
 TEST(evaluator_g5_legacy_wrapper_capabilities_promoted_to_full) {
     Arena *temp_arena = arena_create(2 * 1024 * 1024);
     Arena *event_arena = arena_create(2 * 1024 * 1024);
@@ -586,6 +923,308 @@ TEST(evaluator_native_command_registry_runtime_extension) {
     TEST_PASS();
 }
 
+TEST(evaluator_dispatch_cache_follows_command_registry_changes) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root_mixed_case = parse_cmake(temp_arena, "SET(MIXED_A 1)\nSeT(MIXED_B 2)\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root_mixed_case)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("MIXED_A")), nob_sv_from_cstr("1")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("MIXED_B")), nob_sv_from_cstr("2")));
+
+    // The same parsed call site is dispatched repeatedly while the command it
+    // names changes from unknown, to native, to user-defined, to redefined.
+    Ast_Root root_call = parse_cmake(temp_arena, "Cache_Probe()\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root_call)));
+    ASSERT(eval_test_var_get(ctx, nob_sv_from_cstr("NATIVE_HIT")).count == 0);
+
+    EvalNativeCommandDef probe = {
+        .name = nob_sv_from_cstr("cache_probe"),
+        .handler = native_test_handler_set_hit,
+        .implemented_level = EVAL_CMD_IMPL_PARTIAL,
+        .fallback_behavior = EVAL_FALLBACK_NOOP_WARN,
+    };
+    ASSERT(eval_test_register_native_command(ctx, &probe));
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root_call)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("NATIVE_HIT")), nob_sv_from_cstr("1")));
+    ASSERT(eval_test_unregister_native_command(ctx, nob_sv_from_cstr("CACHE_PROBE")));
+
+    Ast_Root root_define_v1 = parse_cmake(
+        temp_arena,
+        "function(cache_probe)\n"
+        "  set(USER_HIT v1 PARENT_SCOPE)\n"
+        "endfunction()\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root_define_v1)));
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root_call)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("USER_HIT")), nob_sv_from_cstr("v1")));
+
+    Ast_Root root_define_v2 = parse_cmake(
+        temp_arena,
+        "function(cache_probe)\n"
+        "  set(USER_HIT v2 PARENT_SCOPE)\n"
+        "endfunction()\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root_define_v2)));
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root_call)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("USER_HIT")), nob_sv_from_cstr("v2")));
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_user_command_index_keeps_latest_definition_and_rollback) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "foreach(i RANGE 1 200)\n"
+        "  cmake_language(EVAL CODE \"function(helper_${i})\\nendfunction()\")\n"
+        "endforeach()\n"
+        "function(Probe_Cmd)\n"
+        "  set(PROBE v1 PARENT_SCOPE)\n"
+        "endfunction()\n"
+        "function(probe_cmd)\n"
+        "  set(PROBE v2 PARENT_SCOPE)\n"
+        "endfunction()\n"
+        "PROBE_CMD()\n"
+        "set(LATEST ${PROBE})\n"
+        "_probe_cmd()\n"
+        "set(OVERRIDDEN ${PROBE})\n"
+        "function(redefine_then_fail)\n"
+        "  function(probe_cmd)\n"
+        "    set(PROBE v3 PARENT_SCOPE)\n"
+        "  endfunction()\n"
+        "  function(rolled_back_helper)\n"
+        "  endfunction()\n"
+        "  message(SEND_ERROR \"boom\")\n"
+        "endfunction()\n"
+        "redefine_then_fail()\n"
+        "probe_cmd()\n"
+        "set(AFTER_ROLLBACK ${PROBE})\n"
+        "if(COMMAND rolled_back_helper)\n"
+        "  set(HELPER_SURVIVED 1)\n"
+        "endif()\n"
+        "if(COMMAND HELPER_150)\n"
+        "  set(HELPER_150_FOUND 1)\n"
+        "endif()\n");
+    (void)eval_test_run(ctx, root);
+
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("LATEST")), nob_sv_from_cstr("v2")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("OVERRIDDEN")), nob_sv_from_cstr("v1")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("AFTER_ROLLBACK")), nob_sv_from_cstr("v2")));
+    ASSERT(eval_test_var_get(ctx, nob_sv_from_cstr("HELPER_SURVIVED")).count == 0);
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("HELPER_150_FOUND")), nob_sv_from_cstr("1")));
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_property_index_tracks_updates_definitions_and_rollback) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "foreach(i RANGE 1 300)\n"
+        "  set_property(GLOBAL PROPERTY IDX_PROP_${i} v${i})\n"
+        "endforeach()\n"
+        "set_property(GLOBAL APPEND PROPERTY IDX_PROP_150 more)\n"
+        "define_property(GLOBAL PROPERTY IDX_DOC BRIEF_DOCS first FULL_DOCS first)\n"
+        "define_property(GLOBAL PROPERTY IDX_DOC BRIEF_DOCS second FULL_DOCS second)\n"
+        "set_source_files_properties(gen_a.c gen_b.c PROPERTIES GENERATED ON)\n"
+        "function(idx_fail)\n"
+        "  set_property(GLOBAL PROPERTY IDX_PROP_7 changed)\n"
+        "  set_property(GLOBAL PROPERTY IDX_DROPPED x)\n"
+        "  define_property(GLOBAL PROPERTY IDX_DROPPED_DOC BRIEF_DOCS b FULL_DOCS f)\n"
+        "  message(SEND_ERROR \"boom\")\n"
+        "endfunction()\n"
+        "idx_fail()\n"
+        "get_property(P1 GLOBAL PROPERTY IDX_PROP_1)\n"
+        "get_property(P7 GLOBAL PROPERTY IDX_PROP_7)\n"
+        "get_property(P150 GLOBAL PROPERTY IDX_PROP_150)\n"
+        "get_property(P300 GLOBAL PROPERTY IDX_PROP_300)\n"
+        "get_property(DROPPED_SET GLOBAL PROPERTY IDX_DROPPED SET)\n"
+        "get_property(DOC GLOBAL PROPERTY IDX_DOC BRIEF_DOCS)\n"
+        "get_property(DROPPED_DOC GLOBAL PROPERTY IDX_DROPPED_DOC DEFINED)\n"
+        "set_property(GLOBAL PROPERTY IDX_DROPPED again)\n"
+        "get_property(DROPPED_AGAIN GLOBAL PROPERTY IDX_DROPPED)\n"
+        "get_source_file_property(GEN_B gen_b.c GENERATED)\n"
+        "get_source_file_property(GEN_C gen_c.c GENERATED)\n"
+        "if(GEN_B AND NOT GEN_C)\n"
+        "  set(GEN_B_ON 1)\n"
+        "endif()\n");
+    (void)eval_test_run(ctx, root);
+
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("P1")), nob_sv_from_cstr("v1")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("P7")), nob_sv_from_cstr("v7")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("P150")), nob_sv_from_cstr("v150;more")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("P300")), nob_sv_from_cstr("v300")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("DROPPED_SET")), nob_sv_from_cstr("0")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("DOC")), nob_sv_from_cstr("first")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("DROPPED_DOC")), nob_sv_from_cstr("0")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("DROPPED_AGAIN")), nob_sv_from_cstr("again")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("GEN_B_ON")), nob_sv_from_cstr("1")));
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_target_name_index_tracks_aliases_and_rollback) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "foreach(i RANGE 1 300)\n"
+        "  add_library(idx_lib_${i} INTERFACE)\n"
+        "endforeach()\n"
+        "add_library(idx::alias ALIAS idx_lib_42)\n"
+        "function(idx_fail)\n"
+        "  add_library(idx_dropped INTERFACE)\n"
+        "  add_library(idx::dropped ALIAS idx_lib_7)\n"
+        "  message(SEND_ERROR \"boom\")\n"
+        "endfunction()\n"
+        "idx_fail()\n"
+        "if(TARGET idx_lib_1 AND TARGET idx_lib_300 AND NOT TARGET idx_lib_301)\n"
+        "  set(KNOWN ok)\n"
+        "endif()\n"
+        "if(TARGET idx::alias AND NOT TARGET idx::dropped AND NOT TARGET idx_dropped)\n"
+        "  set(ROLLED_BACK ok)\n"
+        "endif()\n"
+        "get_target_property(ALIASED idx::alias ALIASED_TARGET)\n"
+        "get_target_property(NOT_ALIASED idx_lib_42 ALIASED_TARGET)\n"
+        "add_library(idx_dropped INTERFACE)\n"
+        "add_library(idx::dropped ALIAS idx_dropped)\n"
+        "get_target_property(READDED idx::dropped ALIASED_TARGET)\n");
+    (void)eval_test_run(ctx, root);
+
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("KNOWN")), nob_sv_from_cstr("ok")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("ROLLED_BACK")), nob_sv_from_cstr("ok")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("ALIASED")), nob_sv_from_cstr("idx_lib_42")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("NOT_ALIASED")), nob_sv_from_cstr("NOT_ALIASED-NOTFOUND")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("READDED")), nob_sv_from_cstr("idx_dropped")));
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_compiled_arg_templates_match_generic_expansion_on_reexecution) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    // Every iteration after the first runs through compiled templates; the
+    // per-iteration records must match the first, generic one.
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "set(NAME_SUFFIX B)\n"
+        "set(VAR_B inner)\n"
+        "set(ENV{TPL_ENV} env)\n"
+        "set(SEEN)\n"
+        "foreach(i RANGE 1 4)\n"
+        "  set(LIST_V \"x;y${i}\")\n"
+        "  set(ROW \"q=${i}:${LIST_V}\" ${LIST_V} lit;a$<CONFIG>b \"\\${i}\" [[br;${i}]] ${VAR_${NAME_SUFFIX}} $ENV{TPL_ENV} \"tab\\tend\")\n"
+        "  list(LENGTH ROW ROW_LEN)\n"
+        "  string(REPLACE \";\" \",\" ROW_FLAT \"${ROW}\")\n"
+        "  list(APPEND SEEN \"${ROW_LEN}|${ROW_FLAT}\")\n"
+        "endforeach()\n"
+        "list(GET SEEN 0 FIRST)\n"
+        "list(GET SEEN 3 LAST)\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FIRST")),
+                     nob_sv_from_cstr("11|q=1:x,y1,x,y1,lita$<CONFIG>b,${i},br,1,inner,env,tab\tend")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("LAST")),
+                     nob_sv_from_cstr("11|q=4:x,y4,x,y4,lita$<CONFIG>b,${i},br,4,inner,env,tab\tend")));
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
 TEST(evaluator_command_capability_remains_native_only_introspection) {
     Arena *temp_arena = arena_create(2 * 1024 * 1024);
     Arena *event_arena = arena_create(2 * 1024 * 1024);
@@ -622,8 +1261,9 @@ TEST(evaluator_command_capability_remains_native_only_introspection) {
     ASSERT(user_cap.implemented_level == EVAL_CMD_IMPL_MISSING);
 
     bool saw_target = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_DECLARE) continue;
         if (!nob_sv_eq(ev->as.target_declare.name, nob_sv_from_cstr("user_capability_target"))) continue;
         saw_target = true;
@@ -752,9 +1392,11 @@ TEST(evaluator_compat_refresh_snapshot_applies_next_command_cycle) {
     ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("CMAKE_NOBIFY_CONTINUE_ON_ERROR")), nob_sv_from_cstr("0")));
 
     size_t snapshot_diag_count = 0;
-    for (size_t i = 0; i < stream->count; i++) {
-        if (stream->items[i].h.kind != EV_DIAGNOSTIC) continue;
-        if (!nob_sv_eq(stream->items[i].as.diag.component, nob_sv_from_cstr("native_snapshot"))) continue;
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
+        if (ev->h.kind != EV_DIAGNOSTIC) continue;
+        if (!nob_sv_eq(ev->as.diag.component, nob_sv_from_cstr("native_snapshot"))) continue;
         snapshot_diag_count++;
     }
     ASSERT(snapshot_diag_count == 2);
@@ -834,8 +1476,9 @@ TEST(evaluator_global_diag_strict_controls_event_report_and_runtime_gating) {
     ok = ok && severity == EV_DIAG_ERROR;
 
     bool saw_after_target = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_DECLARE) continue;
         if (!nob_sv_eq(ev->as.target_declare.name, nob_sv_from_cstr("global_strict_after"))) continue;
         saw_after_target = true;
@@ -949,6 +1592,73 @@ TEST(evaluator_run_result_kind_tri_state_contract) {
     TEST_PASS();
 }
 
+TEST(evaluator_list_line_and_compat_knobs_resolve_without_per_statement_writes) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    Arena *stream_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena && stream_arena);
+
+    // Events live in their own arena so event_arena only measures evaluator state.
+    Cmake_Event_Stream *stream = event_stream_create(stream_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "set(FIRST_LINE ${CMAKE_CURRENT_LIST_LINE})\n"
+        "function(line_probe)\n"
+        "  set(FN_LINE ${CMAKE_CURRENT_LIST_LINE} PARENT_SCOPE)\n"
+        "endfunction()\n"
+        "line_probe()\n"
+        "if(DEFINED CMAKE_CURRENT_LIST_LINE)\n"
+        "  set(LINE_DEFINED ${CMAKE_CURRENT_LIST_LINE})\n"
+        "endif()\n"
+        "function(scoped_policy)\n"
+        "  set(CMAKE_NOBIFY_UNSUPPORTED_POLICY ERROR)\n"
+        "endfunction()\n"
+        "scoped_policy()\n"
+        "unknown_command_after_scoped_policy()\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FIRST_LINE")), nob_sv_from_cstr("1")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FN_LINE")), nob_sv_from_cstr("3")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("LINE_DEFINED")), nob_sv_from_cstr("7")));
+    ASSERT(eval_test_report(ctx)->error_count == 0);
+
+    Ast_Root policy_root = parse_cmake(
+        temp_arena,
+        "set(CMAKE_NOBIFY_UNSUPPORTED_POLICY ERROR)\n"
+        "unknown_command_after_policy()\n");
+    (void)eval_test_run(ctx, policy_root);
+    ASSERT(eval_test_report(ctx)->error_count == 1);
+
+    // Plain statements must not leave anything behind in persistent memory.
+    Nob_String_Builder sb = {0};
+    for (size_t i = 0; i < 20000; i++) nob_sb_append_cstr(&sb, "if(0)\nendif()\n");
+    nob_sb_append_null(&sb);
+    Ast_Root bulk_root = parse_cmake(temp_arena, sb.items);
+    size_t allocated_before = arena_total_allocated(event_arena);
+    (void)eval_test_run(ctx, bulk_root);
+    size_t growth = arena_total_allocated(event_arena) - allocated_before;
+    nob_sb_free(sb);
+    ASSERT(growth < 64 * 1024);
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    arena_destroy(stream_arena);
+    TEST_PASS();
+}
+
 TEST(evaluator_link_libraries_supports_qualifiers_and_rejects_dangling_qualifier) {
     Arena *temp_arena = arena_create(2 * 1024 * 1024);
     Arena *event_arena = arena_create(2 * 1024 * 1024);
@@ -984,8 +1694,9 @@ TEST(evaluator_link_libraries_supports_qualifiers_and_rejects_dangling_qualifier
     bool saw_plain = false;
     bool saw_diag = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TARGET_LINK_LIBRARIES) {
             String_View item = ev->as.target_link_libraries.item;
             if (nob_sv_eq(item, nob_sv_from_cstr("$<$<CONFIG:Debug>:dbg>"))) saw_dbg = true;
@@ -1129,8 +1840,9 @@ TEST(evaluator_cmake_path_extended_surface_and_strict_validation) {
     bool saw_bad_native = false;
     bool saw_bad_convert = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TARGET_COMPILE_DEFINITIONS &&
             nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("cmake_path_probe"))) {
             String_View item = ev->as.target_compile_definitions.item;
@@ -1305,10 +2017,12 @@ TEST(evaluator_flow_commands_reject_extra_arguments) {
     ASSERT(report->error_count == 3);
 
     size_t usage_hint_hits = 0;
-    for (size_t i = 0; i < stream->count; i++) {
-        if (stream->items[i].h.kind != EV_DIAGNOSTIC) continue;
-        if (stream->items[i].as.diag.severity != EV_DIAG_ERROR) continue;
-        if (!nob_sv_eq(stream->items[i].as.diag.cause, nob_sv_from_cstr("Command does not accept arguments"))) continue;
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
+        if (ev->h.kind != EV_DIAGNOSTIC) continue;
+        if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
+        if (!nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("Command does not accept arguments"))) continue;
         usage_hint_hits++;
     }
     ASSERT(usage_hint_hits == 3);
@@ -1349,10 +2063,12 @@ TEST(evaluator_foreach_rejects_empty_signature) {
     ASSERT(report->error_count == 1);
 
     bool saw_foreach_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        if (stream->items[i].h.kind != EV_DIAGNOSTIC) continue;
-        if (stream->items[i].as.diag.severity != EV_DIAG_ERROR) continue;
-        if (!nob_sv_eq(stream->items[i].as.diag.command, nob_sv_from_cstr("foreach"))) continue;
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
+        if (ev->h.kind != EV_DIAGNOSTIC) continue;
+        if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
+        if (!nob_sv_eq(ev->as.diag.command, nob_sv_from_cstr("foreach"))) continue;
         saw_foreach_error = true;
         break;
     }
@@ -1410,8 +2126,9 @@ TEST(evaluator_while_iteration_limit_snapshot_applies_per_loop_entry) {
     ASSERT(report->error_count == 1);
 
     size_t limit_diag_count = 0;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (!nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("Iteration limit exceeded"))) continue;
@@ -1462,8 +2179,9 @@ TEST(evaluator_while_iteration_limit_invalid_value_warns_and_falls_back) {
     ASSERT(report->error_count == 0);
 
     bool saw_invalid_limit = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity != EV_DIAG_WARNING) continue;
         if (!nob_sv_eq(ev->as.diag.cause,
@@ -1514,8 +2232,9 @@ TEST(evaluator_enable_testing_does_not_set_build_testing_variable) {
 
     bool saw_enable_event = false;
     bool saw_build_testing_zero = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TESTING_ENABLE && ev->as.test_enable.enabled) {
             saw_enable_event = true;
         }
@@ -1562,8 +2281,9 @@ TEST(evaluator_enable_testing_rejects_extra_arguments) {
     ASSERT(report->error_count == 1);
 
     bool saw_arity_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("Command does not accept arguments")) &&
             nob_sv_eq(ev->as.diag.hint, nob_sv_from_cstr("Usage: enable_testing()"))) {
@@ -1617,8 +2337,9 @@ TEST(evaluator_include_supports_result_variable_optional_and_module_search) {
     bool saw_myinc_flag = false;
     bool saw_mod_res_nonempty = false;
     bool saw_miss_notfound = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("include_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("MYINC_FLAG=1"))) saw_myinc_flag = true;
@@ -1639,6 +2360,325 @@ TEST(evaluator_include_supports_result_variable_optional_and_module_search) {
     TEST_PASS();
 }
 
+TEST(evaluator_include_reuses_cached_ast_until_file_content_changes) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "file(WRITE cached_inc.cmake [=[set(INC_MARK A)\nlist(APPEND INC_LOG a)\n]=])\n"
+        "include(${CMAKE_CURRENT_SOURCE_DIR}/cached_inc.cmake)\n"
+        "include(${CMAKE_CURRENT_SOURCE_DIR}/cached_inc.cmake)\n"
+        "include(${CMAKE_CURRENT_SOURCE_DIR}/cached_inc.cmake)\n"
+        "set(MARK_BEFORE ${INC_MARK})\n"
+        "file(WRITE cached_inc.cmake [=[set(INC_MARK B)\nlist(APPEND INC_LOG b)\n]=])\n"
+        "include(${CMAKE_CURRENT_SOURCE_DIR}/cached_inc.cmake)\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("INC_LOG")), nob_sv_from_cstr("a;a;a;b")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("MARK_BEFORE")), nob_sv_from_cstr("A")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("INC_MARK")), nob_sv_from_cstr("B")));
+
+    const Eval_Run_Report *report = eval_test_report(ctx);
+    ASSERT(report != NULL);
+    ASSERT(report->error_count == 0);
+    ASSERT(report->ast_cache_misses == 2);
+    ASSERT(report->ast_cache_hits == 2);
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_regex_cache_shares_patterns_across_commands_and_evicts_lru) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "set(RX_ITEMS \"alpha;Beta;gamma;abba\")\n"
+        "foreach(i RANGE 9)\n"
+        "  string(REGEX MATCH \"a(b+)a\" RX_MATCH \"xabbay\")\n"
+        "  string(REGEX REPLACE \"a(b+)a\" \"<\\\\1>\" RX_REPLACED \"xabbay\")\n"
+        "  list(FILTER RX_ITEMS INCLUDE REGEX \"^[a-z]+$\")\n"
+        "  if(\"abba\" MATCHES \"a(b+)a\")\n"
+        "    set(RX_GROUP ${CMAKE_MATCH_1})\n"
+        "  endif()\n"
+        "endforeach()\n"
+        "file(WRITE rx_lines.txt \"one\\ntwo\\nthree\\n\")\n"
+        "file(STRINGS rx_lines.txt RX_LINES REGEX \"^t\")\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("RX_MATCH")), nob_sv_from_cstr("abba")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("RX_REPLACED")), nob_sv_from_cstr("x<bb>y")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("RX_ITEMS")), nob_sv_from_cstr("alpha;gamma;abba")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("RX_GROUP")), nob_sv_from_cstr("bb")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("RX_LINES")), nob_sv_from_cstr("two;three")));
+
+    const Eval_Run_Report *report = eval_test_report(ctx);
+    ASSERT(report != NULL);
+    ASSERT(report->error_count == 0);
+    ASSERT(report->regex_cache_misses == 3);
+    ASSERT(report->regex_cache_hits == 38);
+
+    // 65 fresh patterns overflow the cache and push out everything above.
+    Ast_Root evict_root = parse_cmake(
+        temp_arena,
+        "foreach(i RANGE 64)\n"
+        "  string(REGEX MATCH \"p${i}\" RX_EVICT \"p1\")\n"
+        "endforeach()\n"
+        "string(REGEX MATCH \"a(b+)a\" RX_MATCH \"abbba\")\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, evict_root)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("RX_MATCH")), nob_sv_from_cstr("abbba")));
+    report = eval_test_report(ctx);
+    ASSERT(report->regex_cache_misses == 66);
+    ASSERT(report->regex_cache_hits == 0);
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_macro_bindings_shadow_nested_frames_and_survive_rehash) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Nob_String_Builder sb = {0};
+    nob_sb_append_cstr(&sb,
+        "macro(inner a)\n"
+        "  set(IN_A \"${a}\")\n"
+        "  set(IN_ARGN \"${ARGN}\")\n"
+        "  set(IN_ARGV0 \"${ARGV0}\")\n"
+        "  set(IN_ARGC \"${ARGC}\")\n"
+        "endmacro()\n"
+        "macro(outer a b)\n"
+        "  inner(xone tail)\n"
+        "  set(OUT_A \"${a}\")\n"
+        "  set(OUT_B \"${b}\")\n"
+        "  set(OUT_ARGN \"${ARGN}\")\n"
+        "  set(OUT_ARGV0 \"${ARGV0}\")\n"
+        "  set(OUT_ARGC \"${ARGC}\")\n"
+        "endmacro()\n"
+        "outer(one two three four)\n"
+        "set(AFTER_A \"${a}\")\n"
+        "macro(wide)\n"
+        "  set(WIDE_FIRST \"${ARGV0}\")\n"
+        "  set(WIDE_LAST \"${ARGV79}\")\n"
+        "  set(WIDE_ARGC \"${ARGC}\")\n"
+        "endmacro()\n"
+        "macro(wrap p)\n"
+        "  wide(");
+    // 80 arguments bind 83 names in the inner frame, enough to grow the
+    // bucket array while the outer frame is still active.
+    for (int i = 0; i < 80; i++) nob_sb_appendf(&sb, " w%d", i);
+    nob_sb_append_cstr(&sb,
+        ")\n"
+        "  set(WRAP_P \"${p}\")\n"
+        "  set(WRAP_ARGC \"${ARGC}\")\n"
+        "  set(WRAP_ARGN \"${ARGN}\")\n"
+        "endmacro()\n"
+        "wrap(P q r)\n");
+    nob_sb_append_null(&sb);
+
+    Ast_Root root = parse_cmake(temp_arena, sb.items);
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+    nob_sb_free(sb);
+
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("IN_A")), nob_sv_from_cstr("xone")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("IN_ARGN")), nob_sv_from_cstr("tail")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("IN_ARGV0")), nob_sv_from_cstr("xone")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("IN_ARGC")), nob_sv_from_cstr("2")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("OUT_A")), nob_sv_from_cstr("one")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("OUT_B")), nob_sv_from_cstr("two")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("OUT_ARGN")), nob_sv_from_cstr("three;four")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("OUT_ARGV0")), nob_sv_from_cstr("one")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("OUT_ARGC")), nob_sv_from_cstr("4")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("AFTER_A")), nob_sv_from_cstr("")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("WIDE_FIRST")), nob_sv_from_cstr("w0")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("WIDE_LAST")), nob_sv_from_cstr("w79")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("WIDE_ARGC")), nob_sv_from_cstr("80")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("WRAP_P")), nob_sv_from_cstr("P")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("WRAP_ARGC")), nob_sv_from_cstr("3")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("WRAP_ARGN")), nob_sv_from_cstr("q;r")));
+
+    const Eval_Run_Report *report = eval_test_report(ctx);
+    ASSERT(report != NULL);
+    ASSERT(report->error_count == 0);
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+static bool evaluator_test_backdate_path(const char *path) {
+    struct utimbuf times = {0};
+    times.actime = time(NULL) - 60;
+    times.modtime = times.actime;
+    return utime(path, &times) == 0;
+}
+
+TEST(evaluator_glob_walks_each_base_once_and_reuses_stable_listings) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root setup = parse_cmake(
+        temp_arena,
+        "file(MAKE_DIRECTORY glob_tree/sub/deep)\n"
+        "file(WRITE glob_tree/a.c \"\")\n"
+        "file(WRITE glob_tree/b.h \"\")\n"
+        "file(WRITE glob_tree/sub/c.c \"\")\n"
+        "file(WRITE glob_tree/sub/deep/d.c \"\")\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, setup)));
+    ASSERT(evaluator_test_backdate_path("glob_tree"));
+    ASSERT(evaluator_test_backdate_path("glob_tree/sub"));
+    ASSERT(evaluator_test_backdate_path("glob_tree/sub/deep"));
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "file(GLOB_RECURSE G_MULTI RELATIVE glob_tree glob_tree/*.c glob_tree/*.h glob_tree/*/*.c)\n"
+        "file(GLOB_RECURSE G_TOP RELATIVE glob_tree glob_tree/*.c)\n"
+        "file(GLOB_RECURSE G_SUB RELATIVE glob_tree glob_tree/sub/*.c)\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("G_MULTI")), nob_sv_from_cstr("a.c;b.h;sub/c.c")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("G_TOP")), nob_sv_from_cstr("a.c")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("G_SUB")), nob_sv_from_cstr("sub/c.c")));
+
+    // glob_tree and glob_tree/sub are listed once; sub/deep lies below every pattern.
+    const Eval_Run_Report *report = eval_test_report(ctx);
+    ASSERT(report != NULL);
+    ASSERT(report->error_count == 0);
+    ASSERT(report->dir_cache_misses == 2);
+    ASSERT(report->dir_cache_hits == 2);
+
+    // A new entry moves the directory mtime, so the stale listing is dropped.
+    Ast_Root changed = parse_cmake(
+        temp_arena,
+        "file(WRITE glob_tree/e.c \"\")\n"
+        "file(GLOB_RECURSE G_TOP RELATIVE glob_tree glob_tree/*.c)\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, changed)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("G_TOP")), nob_sv_from_cstr("a.c;e.c")));
+    report = eval_test_report(ctx);
+    ASSERT(report->dir_cache_misses == 1);
+    ASSERT(report->dir_cache_hits == 0);
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_include_reuses_on_disk_ast_cache_across_sessions) {
+    const char *scripts[] = {
+        "file(WRITE disk_inc.cmake [=[set(DISK_MARK A)\nlist(APPEND DISK_LOG a)\n]=])\n"
+        "include(${CMAKE_CURRENT_SOURCE_DIR}/disk_inc.cmake)\n",
+        "include(${CMAKE_CURRENT_SOURCE_DIR}/disk_inc.cmake)\n"
+        "file(WRITE disk_inc.cmake [=[set(DISK_MARK B)\nlist(APPEND DISK_LOG b)\n]=])\n"
+        "include(${CMAKE_CURRENT_SOURCE_DIR}/disk_inc.cmake)\n",
+    };
+    const size_t expected_disk_hits[] = {0, 1};
+    const char *expected_log[] = {"a", "a;b"};
+
+    for (size_t run = 0; run < NOB_ARRAY_LEN(scripts); run++) {
+        Arena *temp_arena = arena_create(2 * 1024 * 1024);
+        Arena *event_arena = arena_create(2 * 1024 * 1024);
+        ASSERT(temp_arena && event_arena);
+
+        Cmake_Event_Stream *stream = event_stream_create(event_arena);
+        ASSERT(stream != NULL);
+
+        Eval_Test_Init init = {0};
+        init.arena = temp_arena;
+        init.event_arena = event_arena;
+        init.stream = stream;
+        init.source_dir = nob_sv_from_cstr(".");
+        init.binary_dir = nob_sv_from_cstr(".");
+        init.current_file = "CMakeLists.txt";
+        init.ast_cache_dir = nob_sv_from_cstr("ast_cache");
+
+        Eval_Test_Runtime *ctx = eval_test_create(&init);
+        ASSERT(ctx != NULL);
+
+        Ast_Root root = parse_cmake(temp_arena, scripts[run]);
+        ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+        ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("DISK_LOG")),
+                         nob_sv_from_cstr(expected_log[run])));
+
+        const Eval_Run_Report *report = eval_test_report(ctx);
+        ASSERT(report != NULL);
+        ASSERT(report->error_count == 0);
+        ASSERT(report->ast_cache_misses == run + 1);
+        ASSERT(report->ast_disk_cache_hits == expected_disk_hits[run]);
+
+        eval_test_destroy(ctx);
+        arena_destroy(temp_arena);
+        arena_destroy(event_arena);
+    }
+    ASSERT(nob_file_exists("ast_cache") == 1);
+    TEST_PASS();
+}
+
 TEST(evaluator_include_validates_options_strictly) {
     Arena *temp_arena = arena_create(2 * 1024 * 1024);
     Arena *event_arena = arena_create(2 * 1024 * 1024);
@@ -1671,8 +2711,9 @@ TEST(evaluator_include_validates_options_strictly) {
 
     bool saw_bad_opt = false;
     bool saw_missing_result_var = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("include() received unexpected argument")) &&
             nob_sv_eq(ev->as.diag.hint, nob_sv_from_cstr("BAD_OPT"))) {
@@ -1737,8 +2778,9 @@ TEST(evaluator_include_cmp0017_search_order_from_builtin_modules) {
 
     bool saw_pick_old = false;
     bool saw_pick_new = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("include_cmp0017_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("PICK_OLD=user"))) saw_pick_old = true;
@@ -1787,8 +2829,9 @@ TEST(evaluator_include_guard_default_scope_is_strict_and_warning_free) {
     ASSERT(report->warning_count == 0);
 
     bool saw_var_hit = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("guard_var_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("VAR_HIT=1"))) {
@@ -1838,8 +2881,9 @@ TEST(evaluator_include_guard_directory_scope_applies_only_to_directory_and_child
     ASSERT(report->warning_count == 0);
 
     bool saw_dir_hit = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("guard_dir_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("DIR_HIT=x"))) saw_dir_hit = true;
@@ -1890,8 +2934,9 @@ TEST(evaluator_include_guard_global_scope_persists_across_function_scope) {
     ASSERT(report->warning_count == 0);
 
     bool saw_global_hit = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("guard_global_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("GLOBAL_GUARD_HITS=x"))) {
@@ -1940,8 +2985,9 @@ TEST(evaluator_include_guard_rejects_invalid_arguments) {
 
     bool saw_invalid_scope = false;
     bool saw_extra_args = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("include_guard() received invalid scope"))) {
             saw_invalid_scope = true;
@@ -2006,8 +3052,9 @@ TEST(evaluator_enable_language_updates_enabled_language_state_and_validates_scop
 
     bool saw_scope_error = false;
     bool saw_optional_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("enable_language() must be called at file scope"))) {
             saw_scope_error = true;
@@ -2058,8 +3105,9 @@ TEST(evaluator_add_test_name_signature_parses_supported_options) {
 
     bool saw_smoke = false;
     bool saw_legacy = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TEST_ADD) continue;
         if (nob_sv_eq(ev->as.test_add.name, nob_sv_from_cstr("smoke")) &&
             nob_sv_eq(ev->as.test_add.command, nob_sv_from_cstr("app --flag value")) &&
@@ -2116,8 +3164,9 @@ TEST(evaluator_add_test_name_signature_rejects_unexpected_arguments) {
     bool saw_unexpected_diag = false;
     bool emitted_bad_test = false;
     bool emitted_legacy_ok = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC &&
             ev->as.diag.severity == EV_DIAG_ERROR &&
             nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("add_test(NAME ...) received unexpected argument")) &&
@@ -2180,8 +3229,9 @@ TEST(evaluator_add_definitions_routes_d_flags_to_compile_definitions) {
     bool saw_target_opt_dash_d = false;
     bool saw_target_opt_invalid_d = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TARGET_COMPILE_DEFINITIONS &&
                    nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("defs_probe"))) {
             if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("LEGACY=1"))) saw_target_def_legacy = true;
@@ -2252,8 +3302,9 @@ TEST(evaluator_add_compile_definitions_updates_existing_and_future_targets) {
     bool saw_after_bar = false;
     bool saw_dash_prefixed = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (nob_sv_starts_with(ev->as.target_compile_definitions.item, nob_sv_from_cstr("-D"))) saw_dash_prefixed = true;
         if (nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("defs_before"))) {
@@ -2328,8 +3379,9 @@ TEST(evaluator_execute_process_captures_output_and_models_3_28_fatal_mode) {
     ASSERT(process_data.saw_pipeline_input);
 
     bool saw_fatal = false;
-    for (size_t i = 0; i < fixture->stream->count; i++) {
-        const Cmake_Event *ev = &fixture->stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(fixture->stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("execute_process() child process failed"))) {
             saw_fatal = true;
@@ -2379,8 +3431,9 @@ TEST(evaluator_execute_process_rejects_incomplete_and_invalid_option_forms) {
     bool saw_missing_output_var = false;
     bool saw_invalid_command_echo = false;
     bool saw_invalid_fatal_none = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("execute_process() requires at least one COMMAND clause"))) {
             saw_missing_command_clause = true;
@@ -2450,8 +3503,9 @@ TEST(evaluator_directory_option_commands_expand_shell_and_linker_tokens_once) {
 
     bool saw_compile_mutation = false;
     bool saw_link_mutation = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
             nob_sv_eq(ev->as.directory_property_mutate.property_name, nob_sv_from_cstr("COMPILE_OPTIONS"))) {
             saw_compile_mutation =
@@ -2485,14 +3539,24 @@ void run_evaluator_v2_batch1(int *passed, int *failed, int *skipped) {
     test_evaluator_registry_api_supports_custom_commands_and_null_stream_runs(passed, failed, skipped);
     test_evaluator_session_services_env_lookup_is_injected(passed, failed, skipped);
     test_evaluator_command_transaction_rollback_suppresses_semantic_state_and_events(passed, failed, skipped);
+    test_evaluator_command_transaction_rollback_restores_state_mutated_by_committed_children(passed, failed, skipped);
+    test_evaluator_command_transaction_cost_stays_flat_as_target_count_grows(passed, failed, skipped);
+    test_evaluator_condition_programs_follow_expansion_shape_changes(passed, failed, skipped);
+    test_evaluator_condition_program_bench_over_golden_fixture(passed, failed, skipped);
     test_evaluator_g5_legacy_wrapper_capabilities_promoted_to_full(passed, failed, skipped);
     test_evaluator_native_command_registry_runtime_extension(passed, failed, skipped);
+    test_evaluator_dispatch_cache_follows_command_registry_changes(passed, failed, skipped);
+    test_evaluator_user_command_index_keeps_latest_definition_and_rollback(passed, failed, skipped);
+    test_evaluator_property_index_tracks_updates_definitions_and_rollback(passed, failed, skipped);
+    test_evaluator_target_name_index_tracks_aliases_and_rollback(passed, failed, skipped);
+    test_evaluator_compiled_arg_templates_match_generic_expansion_on_reexecution(passed, failed, skipped);
     test_evaluator_command_capability_remains_native_only_introspection(passed, failed, skipped);
     test_evaluator_native_command_registry_case_insensitive_index_lookup(passed, failed, skipped);
     test_evaluator_compat_refresh_snapshot_applies_next_command_cycle(passed, failed, skipped);
     test_evaluator_global_diag_strict_controls_event_report_and_runtime_gating(passed, failed, skipped);
     test_evaluator_unsupported_policy_snapshot_applies_next_command_cycle(passed, failed, skipped);
     test_evaluator_run_result_kind_tri_state_contract(passed, failed, skipped);
+    test_evaluator_list_line_and_compat_knobs_resolve_without_per_statement_writes(passed, failed, skipped);
     test_evaluator_link_libraries_supports_qualifiers_and_rejects_dangling_qualifier(passed, failed, skipped);
     test_evaluator_cmake_path_extended_surface_and_strict_validation(passed, failed, skipped);
     test_evaluator_cmake_path_getters_and_relative_absolute_roundtrip_cover_remaining_components(passed, failed, skipped);
@@ -2503,6 +3567,11 @@ void run_evaluator_v2_batch1(int *passed, int *failed, int *skipped) {
     test_evaluator_enable_testing_does_not_set_build_testing_variable(passed, failed, skipped);
     test_evaluator_enable_testing_rejects_extra_arguments(passed, failed, skipped);
     test_evaluator_include_supports_result_variable_optional_and_module_search(passed, failed, skipped);
+    test_evaluator_include_reuses_cached_ast_until_file_content_changes(passed, failed, skipped);
+    test_evaluator_regex_cache_shares_patterns_across_commands_and_evicts_lru(passed, failed, skipped);
+    test_evaluator_macro_bindings_shadow_nested_frames_and_survive_rehash(passed, failed, skipped);
+    test_evaluator_glob_walks_each_base_once_and_reuses_stable_listings(passed, failed, skipped);
+    test_evaluator_include_reuses_on_disk_ast_cache_across_sessions(passed, failed, skipped);
     test_evaluator_include_validates_options_strictly(passed, failed, skipped);
     test_evaluator_include_cmp0017_search_order_from_builtin_modules(passed, failed, skipped);
     test_evaluator_include_guard_default_scope_is_strict_and_warning_free(passed, failed, skipped);
@@ -68,8 +68,9 @@ TEST(evaluator_cmake_language_core_subcommands_work) {
     bool saw_eval = false;
     bool saw_log = false;
     bool saw_defer = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("cml_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("CALL_OUT=alpha"))) saw_call = true;
@@ -97,6 +98,128 @@ TEST(evaluator_cmake_language_core_subcommands_work) {
     TEST_PASS();
 }
 
+TEST(evaluator_cmake_language_call_passes_resolved_args_verbatim) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "function(fn_probe)\n"
+        "  set(FN_ARGC \"${ARGC}\" PARENT_SCOPE)\n"
+        "  set(FN_ARG0 \"${ARGV0}\" PARENT_SCOPE)\n"
+        "  set(FN_ARG1 \"${ARGV1}\" PARENT_SCOPE)\n"
+        "  set(FN_ARG2 \"${ARGV2}\" PARENT_SCOPE)\n"
+        "endfunction()\n"
+        "macro(mac_probe first)\n"
+        "  set(MAC_FIRST \"${first}\")\n"
+        "  set(MAC_ARGN \"${ARGN}\")\n"
+        "endmacro()\n"
+        "set(TRICKY \"a]]b]=]c\")\n"
+        "set(LISTY \"x;y\")\n"
+        "foreach(i RANGE 2)\n"
+        "  cmake_language(CALL fn_probe \"${TRICKY}\" \"\" \"${LISTY}\")\n"
+        "endforeach()\n"
+        "cmake_language(CALL mac_probe \"${TRICKY}\" tail)\n"
+        "cmake_language(CALL set CALL_LIST \"${LISTY}\")\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+
+    const Eval_Run_Report *report = eval_test_report(ctx);
+    ASSERT(report != NULL);
+    ASSERT(report->error_count == 0);
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FN_ARGC")), nob_sv_from_cstr("3")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FN_ARG0")), nob_sv_from_cstr("a]]b]=]c")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FN_ARG1")), nob_sv_from_cstr("")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FN_ARG2")), nob_sv_from_cstr("x;y")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("MAC_FIRST")), nob_sv_from_cstr("a]]b]=]c")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("MAC_ARGN")), nob_sv_from_cstr("tail")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("CALL_LIST")), nob_sv_from_cstr("x;y")));
+
+    size_t call_events = 0;
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
+        if (ev->h.kind != EVENT_CMAKE_LANGUAGE_CALL) continue;
+        call_events++;
+        if (call_events == 4) {
+            ASSERT(nob_sv_eq(ev->as.cmake_language_call.command_name, nob_sv_from_cstr("mac_probe")));
+        }
+    }
+    ASSERT(call_events == 5);
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_cmake_language_eval_code_reuses_parsed_payloads) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "set(ACC \"\")\n"
+        "foreach(i RANGE 4)\n"
+        "  cmake_language(EVAL CODE \"string(APPEND ACC \\\"\\${i}\\\")\")\n"
+        "endforeach()\n"
+        "cmake_language(EVAL CODE \"set(OTHER \" \"yes)\")\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("ACC")), nob_sv_from_cstr("01234")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("OTHER")), nob_sv_from_cstr("yes")));
+
+    const Eval_Run_Report *report = eval_test_report(ctx);
+    ASSERT(report != NULL);
+    ASSERT(report->error_count == 0);
+    ASSERT(report->inline_ast_cache_misses == 2);
+    ASSERT(report->inline_ast_cache_hits == 4);
+
+    // The cache lives in the session, so a later run parses nothing.
+    Ast_Root again = parse_cmake(
+        temp_arena,
+        "set(i 9)\n"
+        "cmake_language(EVAL CODE \"string(APPEND ACC \\\"\\${i}\\\")\")\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, again)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("ACC")), nob_sv_from_cstr("012349")));
+    report = eval_test_report(ctx);
+    ASSERT(report->inline_ast_cache_misses == 0);
+    ASSERT(report->inline_ast_cache_hits == 1);
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
 TEST(evaluator_defer_replay_in_subdirectory_uses_child_execution_context) {
     Arena *temp_arena = arena_create(2 * 1024 * 1024);
     Arena *event_arena = arena_create(2 * 1024 * 1024);
@@ -143,8 +266,9 @@ TEST(evaluator_defer_replay_in_subdirectory_uses_child_execution_context) {
     bool saw_defer_list_dir = false;
     bool saw_defer_file = false;
     bool saw_root_file = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("ctx_phase_c_probe"))) {
             if (sv_contains_sv(ev->as.target_compile_definitions.item, nob_sv_from_cstr("DEFER_SRC=subdir"))) saw_defer_src = true;
@@ -264,8 +388,9 @@ TEST(evaluator_cmake_language_defer_only_allows_leading_underscore_for_generated
     ASSERT(eval_test_var_get(ctx, nob_sv_from_cstr("MANUAL")).count == 0);
 
     bool saw_bad_manual_id = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("cmake_language(DEFER ID) only allows a leading '_' for ids generated earlier by ID_VAR"))) {
@@ -929,8 +1054,9 @@ TEST(evaluator_fetchcontent_entrypoints_reject_incomplete_argument_shapes) {
     bool saw_populate_missing_decl = false;
     bool saw_setpopulated_context = false;
     bool saw_setpopulated_source_dir = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("FetchContent_MakeAvailable() requires at least one dependency name"))) {
@@ -1027,8 +1153,9 @@ TEST(evaluator_fetchcontent_negative_declarations_and_hash_failure_surface_diags
     bool saw_missing_git_repo = false;
     bool saw_missing_url = false;
     bool saw_hash_failure = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EVENT_DIAG) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("FetchContent_Declare() may not mix download transports"))) {
             saw_mixed = true;
@@ -1304,8 +1431,9 @@ TEST(evaluator_fetchcontent_git_update_disconnected_unknown_ref_surfaces_error)
     ASSERT(report->error_count == 1);
 
     bool saw_missing_ref = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("FetchContent Git update disconnected and requested ref is not available locally"))) {
@@ -1647,8 +1775,9 @@ TEST(evaluator_fetchcontent_saved_populate_rejects_second_call) {
     ASSERT(report->error_count == 1);
 
     bool saw_repeat_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("FetchContent_Populate() may only be called once per dependency when using saved details"))) {
@@ -1921,8 +2050,9 @@ TEST(evaluator_cmake_language_rejects_incomplete_and_unknown_forms) {
     bool saw_missing_eval_code_text = false;
     bool saw_missing_log_var = false;
     bool saw_unknown_subcommand = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("cmake_language() requires a subcommand"))) {
             saw_missing_subcommand = true;
@@ -2009,8 +2139,9 @@ TEST(evaluator_cmake_language_dependency_provider_rejects_invalid_forms) {
     bool saw_method = false;
     bool saw_bypass = false;
     bool saw_context = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("cmake_language(SET_DEPENDENCY_PROVIDER) must be called at file scope"))) {
             saw_scope = true;
@@ -2073,8 +2204,9 @@ TEST(evaluator_target_compile_definitions_normalizes_dash_d_items) {
     bool saw_qux = false;
     bool saw_dash_prefixed = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("norm_defs"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("FOO"))) saw_foo = true;
@@ -2136,8 +2268,9 @@ TEST(evaluator_add_custom_command_target_validates_signature_and_target) {
     bool saw_multi_stage = false;
     bool saw_unexpected_depends = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_COMMAND_END &&
             nob_sv_eq(ev->as.command_end.command_name, nob_sv_from_cstr("add_custom_command"))) {
             if (ev->as.command_end.status == EVENT_COMMAND_STATUS_SUCCESS) {
@@ -2208,8 +2341,9 @@ TEST(evaluator_add_custom_command_output_validates_conflicts) {
     bool saw_pool_error = false;
     bool saw_valid_output_event = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_COMMAND_END &&
             nob_sv_eq(ev->as.command_end.command_name, nob_sv_from_cstr("add_custom_command")) &&
             ev->as.command_end.status == EVENT_COMMAND_STATUS_SUCCESS) {
@@ -2282,8 +2416,9 @@ TEST(evaluator_add_custom_command_output_emits_build_graph_and_tokenized_command
     bool saw_first_command = false;
     bool saw_second_command = false;
 
-    for (size_t i = 0; i < stream->count; ++i) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         switch (ev->h.kind) {
             case EVENT_BUILD_STEP_DECLARE:
                 declare_count++;
@@ -2387,8 +2522,9 @@ TEST(evaluator_add_custom_target_emits_build_step_without_commands) {
     size_t command_count = 0;
     size_t generated_count = 0;
 
-    for (size_t i = 0; i < stream->count; ++i) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_TARGET_DECLARE &&
             nob_sv_eq(ev->as.target_declare.name, nob_sv_from_cstr("prepare"))) {
             saw_target = true;
@@ -2457,8 +2593,9 @@ TEST(evaluator_add_custom_command_target_preserves_exact_stage_kinds) {
     size_t command_count = 0;
     size_t generated_count = 0;
 
-    for (size_t i = 0; i < stream->count; ++i) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_BUILD_STEP_DECLARE) {
             ASSERT(nob_sv_eq(ev->as.build_step_declare.owner_target_name, nob_sv_from_cstr("gen")));
             if (ev->as.build_step_declare.step_kind == EVENT_BUILD_STEP_TARGET_PRE_BUILD) {
@@ -2519,8 +2656,9 @@ TEST(evaluator_generated_source_property_apis_emit_source_marks) {
     size_t generated_count = 0;
     bool saw_a = false;
     bool saw_b = false;
-    for (size_t i = 0; i < stream->count; ++i) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EVENT_SOURCE_MARK_GENERATED) continue;
         generated_count++;
         ASSERT(ev->as.source_mark_generated.generated);
@@ -2779,10 +2917,12 @@ TEST(evaluator_event_ir_metadata_and_stream_contract) {
     command_name[0] = 'X';
 
     ASSERT(stream->count == 1);
-    ASSERT(stream->items[0].h.version == 1);
-    ASSERT(stream->items[0].h.seq == 1);
-    ASSERT(nob_sv_eq(stream->items[0].h.origin.file_path, nob_sv_from_cstr("origin.cmake")));
-    ASSERT(nob_sv_eq(stream->items[0].as.command_begin.command_name, nob_sv_from_cstr("ephemeral_command")));
+    Event stored = {0};
+    ASSERT(event_stream_get(stream, 0, &stored));
+    ASSERT(stored.h.version == 1);
+    ASSERT(stored.h.seq == 1);
+    ASSERT(nob_sv_eq(stored.h.origin.file_path, nob_sv_from_cstr("origin.cmake")));
+    ASSERT(nob_sv_eq(stored.as.command_begin.command_name, nob_sv_from_cstr("ephemeral_command")));
 
     char *property_name = arena_strndup(source_arena, "INCLUDE_DIRECTORIES", strlen("INCLUDE_DIRECTORIES"));
     char *item_buf = arena_strndup(source_arena, "include", strlen("include"));
@@ -2830,23 +2970,228 @@ TEST(evaluator_event_ir_metadata_and_stream_contract) {
 
     ASSERT(stream->count == 3);
     ASSERT(evaluator_stream_has_monotonic_sequence(stream));
-    ASSERT(nob_sv_eq(stream->items[1].as.directory_property_mutate.property_name,
+    ASSERT(event_stream_get(stream, 1, &stored));
+    ASSERT(nob_sv_eq(stored.as.directory_property_mutate.property_name,
                      nob_sv_from_cstr("INCLUDE_DIRECTORIES")));
-    ASSERT(stream->items[1].as.directory_property_mutate.item_count == 1);
-    ASSERT(nob_sv_eq(stream->items[1].as.directory_property_mutate.items[0],
+    ASSERT(stored.as.directory_property_mutate.item_count == 1);
+    ASSERT(nob_sv_eq(stored.as.directory_property_mutate.items[0],
                      nob_sv_from_cstr("include")));
-    ASSERT(nob_sv_eq(stream->items[2].as.global_property_mutate.property_name,
+    ASSERT(event_stream_get(stream, 2, &stored));
+    ASSERT(nob_sv_eq(stored.as.global_property_mutate.property_name,
                      nob_sv_from_cstr("IR_GLOBAL_PROP")));
-    ASSERT(stream->items[2].as.global_property_mutate.item_count == 2);
-    ASSERT(nob_sv_eq(stream->items[2].as.global_property_mutate.items[0],
+    ASSERT(stored.as.global_property_mutate.item_count == 2);
+    ASSERT(nob_sv_eq(stored.as.global_property_mutate.items[0],
                      nob_sv_from_cstr("global_a")));
-    ASSERT(nob_sv_eq(stream->items[2].as.global_property_mutate.items[1],
+    ASSERT(nob_sv_eq(stored.as.global_property_mutate.items[1],
                      nob_sv_from_cstr("global_b")));
 
     arena_destroy(arena);
     TEST_PASS();
 }
 
+TEST(evaluator_event_stream_interns_repeated_payload_strings) {
+    Arena *arena = arena_create(1024 * 1024);
+    ASSERT(arena != NULL);
+    Event_Stream *stream = event_stream_create(arena);
+    ASSERT(stream != NULL);
+
+    char first_origin[] = "src/CMakeLists.txt";
+    char second_origin[] = "src/CMakeLists.txt";
+    char first_name[] = "core";
+    char second_name[] = "core";
+    // Same prefix, different content: must not be folded into "core".
+    static const char nul_name[] = {'c', 'o', 'r', 'e', '\0', 'x'};
+
+    Event ev = {0};
+    ev.h.kind = EVENT_TARGET_DECLARE;
+    ev.h.origin.file_path = nob_sv_from_cstr(first_origin);
+    ev.as.target_declare.name = nob_sv_from_cstr(first_name);
+    ASSERT(event_stream_push(stream, &ev));
+
+    ev = (Event){0};
+    ev.h.kind = EVENT_TARGET_ADD_SOURCE;
+    ev.h.origin.file_path = nob_sv_from_cstr(second_origin);
+    ev.as.target_add_source.target_name = nob_sv_from_cstr(second_name);
+    ev.as.target_add_source.path = nob_sv_from_parts(nul_name, sizeof(nul_name));
+    ASSERT(event_stream_push(stream, &ev));
+
+    ASSERT(stream->count == 2);
+    Event declare = {0};
+    Event add_source = {0};
+    ASSERT(event_stream_get(stream, 0, &declare));
+    ASSERT(event_stream_get(stream, 1, &add_source));
+    ASSERT(declare.h.origin.file_path.data == add_source.h.origin.file_path.data);
+    ASSERT(declare.as.target_declare.name.data == add_source.as.target_add_source.target_name.data);
+    ASSERT(declare.h.origin.file_path.data != first_origin);
+    ASSERT(add_source.as.target_add_source.path.count == sizeof(nul_name));
+    ASSERT(add_source.as.target_add_source.path.data != declare.as.target_declare.name.data);
+    ASSERT(memcmp(add_source.as.target_add_source.path.data, nul_name, sizeof(nul_name)) == 0);
+
+    ASSERT(stream->intern_count == 3);
+    ASSERT(stream->intern_bytes_saved == sizeof(second_origin) + sizeof(second_name));
+
+    // Enough distinct strings to force several table resizes.
+    size_t temp_mark = nob_temp_save();
+    for (size_t i = 0; i < 1000; ++i) {
+        ev = (Event){0};
+        ev.h.kind = EVENT_VAR_SET;
+        ev.h.origin.file_path = nob_sv_from_cstr(first_origin);
+        ev.as.var_set.key = nob_sv_from_cstr(nob_temp_sprintf("VAR_%zu", i));
+        ev.as.var_set.value = nob_sv_from_cstr("core");
+        ASSERT(event_stream_push(stream, &ev));
+    }
+    nob_temp_rewind(temp_mark);
+    ASSERT(stream->intern_count == 1003);
+    for (size_t i = 0; i < 1000; ++i) {
+        Event set = {0};
+        ASSERT(event_stream_get(stream, 2 + i, &set));
+        ASSERT(set.h.origin.file_path.data == declare.h.origin.file_path.data);
+        ASSERT(set.as.var_set.value.data == declare.as.target_declare.name.data);
+    }
+    ASSERT(event_stream_get(stream, 1001, &ev));
+    ASSERT(nob_sv_eq(ev.as.var_set.key, nob_sv_from_cstr("VAR_999")));
+
+    arena_destroy(arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_event_stream_stores_compact_records) {
+    Arena *arena = arena_create(1024 * 1024);
+    ASSERT(arena != NULL);
+    Event_Stream *stream = event_stream_create(arena);
+    ASSERT(stream != NULL);
+    ASSERT(sizeof(Event_Record) < sizeof(Event));
+
+    size_t temp_mark = nob_temp_save();
+    for (size_t i = 0; i < 300; ++i) {
+        Event ev = {0};
+        ev.h.kind = (i % 3 == 0) ? EVENT_COMMAND_BEGIN : EVENT_VAR_SET;
+        ev.h.scope_depth = (uint32_t)(i % 7);
+        ev.h.origin.file_path = nob_sv_from_cstr((i % 2 == 0) ? "CMakeLists.txt" : "sub/CMakeLists.txt");
+        ev.h.origin.line = i + 1;
+        ev.h.origin.col = 3;
+        if (ev.h.kind == EVENT_COMMAND_BEGIN) {
+            ev.as.command_begin.command_name = nob_sv_from_cstr("set");
+            ev.as.command_begin.argc = (uint32_t)i;
+        } else {
+            ev.as.var_set.key = nob_sv_from_cstr(nob_temp_sprintf("K%zu", i));
+            ev.as.var_set.value = nob_sv_from_cstr("v");
+        }
+        ASSERT(event_stream_push(stream, &ev));
+    }
+    nob_temp_rewind(temp_mark);
+
+    ASSERT(stream->count == 300);
+    ASSERT(arena_arr_len(stream->records) == 300);
+    ASSERT(arena_arr_len(stream->origin_files) == 2);
+    ASSERT(stream->records[0].origin_file == 1);
+    ASSERT(stream->records[1].origin_file == 2);
+
+    size_t index = 0;
+    Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Event *ev = it.current;
+        ASSERT(ev->h.seq == index + 1);
+        ASSERT(ev->h.scope_depth == index % 7);
+        ASSERT(ev->h.origin.line == index + 1);
+        ASSERT(ev->h.origin.col == 3);
+        ASSERT(nob_sv_eq(ev->h.origin.file_path,
+                         nob_sv_from_cstr((index % 2 == 0) ? "CMakeLists.txt" : "sub/CMakeLists.txt")));
+        if (index % 3 == 0) {
+            ASSERT(ev->h.kind == EVENT_COMMAND_BEGIN);
+            ASSERT(ev->as.command_begin.argc == index);
+            ASSERT(nob_sv_eq(ev->as.command_begin.command_name, nob_sv_from_cstr("set")));
+        } else {
+            ASSERT(ev->h.kind == EVENT_VAR_SET);
+            ASSERT(nob_sv_eq(ev->as.var_set.value, nob_sv_from_cstr("v")));
+        }
+        index++;
+    }
+    ASSERT(index == 300);
+
+    Event ev = {0};
+    ASSERT(event_stream_get(stream, 299, &ev));
+    ASSERT(ev.h.kind == EVENT_VAR_SET);
+    ASSERT(nob_sv_eq(ev.as.var_set.key, nob_sv_from_cstr("K299")));
+    ASSERT(!event_stream_get(stream, 300, &ev));
+    ASSERT(event_stream_get(stream, 150, &ev));
+    ASSERT(ev.h.origin.line == 151);
+
+    arena_destroy(arena);
+    TEST_PASS();
+}
+
+TEST(evaluator_event_stream_subscription_skips_unwanted_roles) {
+    static const char *script =
+        "set(DEF_VALUE on)\n"
+        "function(add_defs target)\n"
+        "  foreach(item A B)\n"
+        "    if(DEF_VALUE)\n"
+        "      target_compile_definitions(${target} PRIVATE ${item}=${DEF_VALUE})\n"
+        "    endif()\n"
+        "  endforeach()\n"
+        "endfunction()\n"
+        "add_executable(app main.c)\n"
+        "add_defs(app)\n"
+        "enable_testing()\n"
+        "add_test(NAME app_test COMMAND app)\n";
+
+    size_t semantic_counts[2] = {0};
+    for (size_t pass = 0; pass < 2; ++pass) {
+        Arena *temp_arena = arena_create(2 * 1024 * 1024);
+        Arena *event_arena = arena_create(2 * 1024 * 1024);
+        ASSERT(temp_arena && event_arena);
+
+        Cmake_Event_Stream *stream = event_stream_create(event_arena);
+        ASSERT(stream != NULL);
+        ASSERT(stream->subscribed_roles == EVENT_ROLE_ALL);
+        if (pass == 1) event_stream_subscribe(stream, EVENT_ROLE_BUILD_SEMANTIC);
+        ASSERT(event_stream_wants(stream, EVENT_TARGET_DECLARE));
+        ASSERT(event_stream_wants(stream, EVENT_COMMAND_BEGIN) == (pass == 0));
+
+        Eval_Test_Init init = {0};
+        init.arena = temp_arena;
+        init.event_arena = event_arena;
+        init.stream = stream;
+        init.source_dir = nob_sv_from_cstr(".");
+        init.binary_dir = nob_sv_from_cstr(".");
+        init.current_file = "CMakeLists.txt";
+
+        Eval_Test_Runtime *ctx = eval_test_create(&init);
+        ASSERT(ctx != NULL);
+        ASSERT(!eval_result_is_fatal(eval_test_run(ctx, parse_cmake(temp_arena, script))));
+        ASSERT(eval_test_report(ctx)->error_count == 0);
+
+        bool saw_trace = false;
+        bool saw_def_a = false;
+        bool saw_def_b = false;
+        bool saw_test = false;
+        Event_Stream_Iterator it = event_stream_iter(stream);
+        while (event_stream_next(&it)) {
+            const Event *ev = it.current;
+            if (!event_kind_has_role(ev->h.kind, EVENT_ROLE_BUILD_SEMANTIC)) {
+                saw_trace = true;
+                continue;
+            }
+            semantic_counts[pass]++;
+            if (ev->h.kind == EVENT_TARGET_COMPILE_DEFINITIONS) {
+                if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("A=on"))) saw_def_a = true;
+                if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("B=on"))) saw_def_b = true;
+            }
+            if (ev->h.kind == EVENT_TEST_ADD) saw_test = true;
+        }
+        ASSERT(saw_trace == (pass == 0));
+        ASSERT(saw_def_a && saw_def_b && saw_test);
+        if (pass == 1) ASSERT(stream->pushed_count == stream->count);
+
+        eval_test_destroy(ctx);
+        arena_destroy(temp_arena);
+        arena_destroy(event_arena);
+    }
+    ASSERT(semantic_counts[0] == semantic_counts[1]);
+    TEST_PASS();
+}
+
 TEST(evaluator_event_ir_directory_semantics_and_trace_surface) {
     Arena *temp_arena = arena_create(2 * 1024 * 1024);
     Arena *event_arena = arena_create(2 * 1024 * 1024);
@@ -2908,85 +3253,86 @@ TEST(evaluator_event_ir_directory_semantics_and_trace_surface) {
     size_t subdir_end = (size_t)-1;
 
     for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
-        if (ev->h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
-            nob_sv_eq(ev->as.directory_property_mutate.property_name, nob_sv_from_cstr("COMPILE_OPTIONS"))) {
+        Cmake_Event ev = {0};
+        if (!event_stream_get(stream, i, &ev)) break;
+        if (ev.h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
+            nob_sv_eq(ev.as.directory_property_mutate.property_name, nob_sv_from_cstr("COMPILE_OPTIONS"))) {
             saw_compile_options =
-                ev->as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_APPEND_LIST &&
-                ev->as.directory_property_mutate.item_count == 1 &&
-                nob_sv_eq(ev->as.directory_property_mutate.items[0], nob_sv_from_cstr("-Wall"));
+                ev.as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_APPEND_LIST &&
+                ev.as.directory_property_mutate.item_count == 1 &&
+                nob_sv_eq(ev.as.directory_property_mutate.items[0], nob_sv_from_cstr("-Wall"));
         }
-        if (ev->h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
-            nob_sv_eq(ev->as.directory_property_mutate.property_name, nob_sv_from_cstr("COMPILE_DEFINITIONS"))) {
+        if (ev.h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
+            nob_sv_eq(ev.as.directory_property_mutate.property_name, nob_sv_from_cstr("COMPILE_DEFINITIONS"))) {
             saw_compile_definitions =
-                ev->as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_APPEND_LIST &&
-                ev->as.directory_property_mutate.item_count == 1 &&
-                nob_sv_eq(ev->as.directory_property_mutate.items[0], nob_sv_from_cstr("IR_DEF"));
+                ev.as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_APPEND_LIST &&
+                ev.as.directory_property_mutate.item_count == 1 &&
+                nob_sv_eq(ev.as.directory_property_mutate.items[0], nob_sv_from_cstr("IR_DEF"));
         }
-        if (ev->h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
-            nob_sv_eq(ev->as.directory_property_mutate.property_name, nob_sv_from_cstr("LINK_OPTIONS"))) {
+        if (ev.h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
+            nob_sv_eq(ev.as.directory_property_mutate.property_name, nob_sv_from_cstr("LINK_OPTIONS"))) {
             saw_link_options =
-                ev->as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_APPEND_LIST &&
-                ev->as.directory_property_mutate.item_count == 1 &&
-                nob_sv_eq(ev->as.directory_property_mutate.items[0], nob_sv_from_cstr("-Wl,--as-needed"));
+                ev.as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_APPEND_LIST &&
+                ev.as.directory_property_mutate.item_count == 1 &&
+                nob_sv_eq(ev.as.directory_property_mutate.items[0], nob_sv_from_cstr("-Wl,--as-needed"));
         }
-        if (ev->h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
-            nob_sv_eq(ev->as.directory_property_mutate.property_name, nob_sv_from_cstr("INCLUDE_DIRECTORIES"))) {
+        if (ev.h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
+            nob_sv_eq(ev.as.directory_property_mutate.property_name, nob_sv_from_cstr("INCLUDE_DIRECTORIES"))) {
             saw_include_directories =
-                ev->as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_PREPEND_LIST &&
-                (ev->as.directory_property_mutate.modifier_flags & EVENT_PROPERTY_MODIFIER_BEFORE) != 0 &&
-                (ev->as.directory_property_mutate.modifier_flags & EVENT_PROPERTY_MODIFIER_SYSTEM) != 0 &&
-                ev->as.directory_property_mutate.item_count == 2 &&
-                sv_contains_sv(ev->as.directory_property_mutate.items[0], nob_sv_from_cstr("ir_inc_a")) &&
-                sv_contains_sv(ev->as.directory_property_mutate.items[1], nob_sv_from_cstr("ir_inc_b"));
+                ev.as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_PREPEND_LIST &&
+                (ev.as.directory_property_mutate.modifier_flags & EVENT_PROPERTY_MODIFIER_BEFORE) != 0 &&
+                (ev.as.directory_property_mutate.modifier_flags & EVENT_PROPERTY_MODIFIER_SYSTEM) != 0 &&
+                ev.as.directory_property_mutate.item_count == 2 &&
+                sv_contains_sv(ev.as.directory_property_mutate.items[0], nob_sv_from_cstr("ir_inc_a")) &&
+                sv_contains_sv(ev.as.directory_property_mutate.items[1], nob_sv_from_cstr("ir_inc_b"));
         }
-        if (ev->h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
-            nob_sv_eq(ev->as.directory_property_mutate.property_name, nob_sv_from_cstr("LINK_DIRECTORIES"))) {
+        if (ev.h.kind == EVENT_DIRECTORY_PROPERTY_MUTATE &&
+            nob_sv_eq(ev.as.directory_property_mutate.property_name, nob_sv_from_cstr("LINK_DIRECTORIES"))) {
             saw_link_directories =
-                ev->as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_PREPEND_LIST &&
-                (ev->as.directory_property_mutate.modifier_flags & EVENT_PROPERTY_MODIFIER_BEFORE) != 0 &&
-                ev->as.directory_property_mutate.item_count == 1 &&
-                sv_contains_sv(ev->as.directory_property_mutate.items[0], nob_sv_from_cstr("ir_lib"));
+                ev.as.directory_property_mutate.op == EVENT_PROPERTY_MUTATE_PREPEND_LIST &&
+                (ev.as.directory_property_mutate.modifier_flags & EVENT_PROPERTY_MODIFIER_BEFORE) != 0 &&
+                ev.as.directory_property_mutate.item_count == 1 &&
+                sv_contains_sv(ev.as.directory_property_mutate.items[0], nob_sv_from_cstr("ir_lib"));
         }
-        if (ev->h.kind == EVENT_GLOBAL_PROPERTY_MUTATE &&
-            nob_sv_eq(ev->as.global_property_mutate.property_name, nob_sv_from_cstr("IR_GLOBAL_PROP"))) {
+        if (ev.h.kind == EVENT_GLOBAL_PROPERTY_MUTATE &&
+            nob_sv_eq(ev.as.global_property_mutate.property_name, nob_sv_from_cstr("IR_GLOBAL_PROP"))) {
             saw_global_property =
-                ev->as.global_property_mutate.op == EVENT_PROPERTY_MUTATE_SET &&
-                ev->as.global_property_mutate.item_count == 2 &&
-                nob_sv_eq(ev->as.global_property_mutate.items[0], nob_sv_from_cstr("ir_global_a")) &&
-                nob_sv_eq(ev->as.global_property_mutate.items[1], nob_sv_from_cstr("ir_global_b"));
+                ev.as.global_property_mutate.op == EVENT_PROPERTY_MUTATE_SET &&
+                ev.as.global_property_mutate.item_count == 2 &&
+                nob_sv_eq(ev.as.global_property_mutate.items[0], nob_sv_from_cstr("ir_global_a")) &&
+                nob_sv_eq(ev.as.global_property_mutate.items[1], nob_sv_from_cstr("ir_global_b"));
         }
-        if (ev->h.kind == EVENT_INCLUDE_BEGIN &&
-            sv_contains_sv(ev->as.include_begin.path, nob_sv_from_cstr("ir_include.cmake"))) {
+        if (ev.h.kind == EVENT_INCLUDE_BEGIN &&
+            sv_contains_sv(ev.as.include_begin.path, nob_sv_from_cstr("ir_include.cmake"))) {
             saw_include_begin = true;
             include_begin = i;
         }
-        if (ev->h.kind == EVENT_INCLUDE_END &&
-            sv_contains_sv(ev->as.include_end.path, nob_sv_from_cstr("ir_include.cmake"))) {
+        if (ev.h.kind == EVENT_INCLUDE_END &&
+            sv_contains_sv(ev.as.include_end.path, nob_sv_from_cstr("ir_include.cmake"))) {
             saw_include_end = true;
             include_end = i;
         }
-        if (ev->h.kind == EVENT_ADD_SUBDIRECTORY_BEGIN &&
-            sv_contains_sv(ev->as.add_subdirectory_begin.source_dir, nob_sv_from_cstr("ir_subdir"))) {
+        if (ev.h.kind == EVENT_ADD_SUBDIRECTORY_BEGIN &&
+            sv_contains_sv(ev.as.add_subdirectory_begin.source_dir, nob_sv_from_cstr("ir_subdir"))) {
             saw_subdir_begin = true;
             subdir_begin = i;
         }
-        if (ev->h.kind == EVENT_ADD_SUBDIRECTORY_END &&
-            sv_contains_sv(ev->as.add_subdirectory_end.source_dir, nob_sv_from_cstr("ir_subdir"))) {
+        if (ev.h.kind == EVENT_ADD_SUBDIRECTORY_END &&
+            sv_contains_sv(ev.as.add_subdirectory_end.source_dir, nob_sv_from_cstr("ir_subdir"))) {
             saw_subdir_end = true;
             subdir_end = i;
         }
-        if (ev->h.kind == EVENT_DIRECTORY_ENTER) saw_directory_enter = true;
-        if (ev->h.kind == EVENT_DIRECTORY_LEAVE) saw_directory_leave = true;
-        if (ev->h.kind == EVENT_COMMAND_BEGIN &&
-            nob_sv_eq(ev->as.command_begin.command_name, nob_sv_from_cstr("unknown_event_ir_cmd")) &&
-            ev->as.command_begin.dispatch_kind == EVENT_COMMAND_DISPATCH_UNKNOWN) {
+        if (ev.h.kind == EVENT_DIRECTORY_ENTER) saw_directory_enter = true;
+        if (ev.h.kind == EVENT_DIRECTORY_LEAVE) saw_directory_leave = true;
+        if (ev.h.kind == EVENT_COMMAND_BEGIN &&
+            nob_sv_eq(ev.as.command_begin.command_name, nob_sv_from_cstr("unknown_event_ir_cmd")) &&
+            ev.as.command_begin.dispatch_kind == EVENT_COMMAND_DISPATCH_UNKNOWN) {
             saw_unknown_begin = true;
         }
-        if (ev->h.kind == EVENT_COMMAND_END &&
-            nob_sv_eq(ev->as.command_end.command_name, nob_sv_from_cstr("unknown_event_ir_cmd")) &&
-            ev->as.command_end.dispatch_kind == EVENT_COMMAND_DISPATCH_UNKNOWN &&
-            ev->as.command_end.status == EVENT_COMMAND_STATUS_UNSUPPORTED) {
+        if (ev.h.kind == EVENT_COMMAND_END &&
+            nob_sv_eq(ev.as.command_end.command_name, nob_sv_from_cstr("unknown_event_ir_cmd")) &&
+            ev.as.command_end.dispatch_kind == EVENT_COMMAND_DISPATCH_UNKNOWN &&
+            ev.as.command_end.status == EVENT_COMMAND_STATUS_UNSUPPORTED) {
             saw_unknown_end = true;
         }
     }
@@ -3013,13 +3359,17 @@ TEST(evaluator_event_ir_directory_semantics_and_trace_surface) {
     size_t include_enter = (size_t)-1;
     size_t include_leave = (size_t)-1;
     for (size_t i = include_begin + 1; i < include_end; i++) {
-        if (stream->items[i].h.kind == EVENT_DIRECTORY_ENTER) {
+        Event ev = {0};
+        if (!event_stream_get(stream, i, &ev)) break;
+        if (ev.h.kind == EVENT_DIRECTORY_ENTER) {
             include_enter = i;
             break;
         }
     }
     for (size_t i = include_enter + 1; i < include_end; i++) {
-        if (stream->items[i].h.kind == EVENT_DIRECTORY_LEAVE) {
+        Event ev = {0};
+        if (!event_stream_get(stream, i, &ev)) break;
+        if (ev.h.kind == EVENT_DIRECTORY_LEAVE) {
             include_leave = i;
             break;
         }
@@ -3033,13 +3383,17 @@ TEST(evaluator_event_ir_directory_semantics_and_trace_surface) {
     size_t subdir_enter = (size_t)-1;
     size_t subdir_leave = (size_t)-1;
     for (size_t i = subdir_begin + 1; i < subdir_end; i++) {
-        if (stream->items[i].h.kind == EVENT_DIRECTORY_ENTER) {
+        Event ev = {0};
+        if (!event_stream_get(stream, i, &ev)) break;
+        if (ev.h.kind == EVENT_DIRECTORY_ENTER) {
             subdir_enter = i;
             break;
         }
     }
     for (size_t i = subdir_enter + 1; i < subdir_end; i++) {
-        if (stream->items[i].h.kind == EVENT_DIRECTORY_LEAVE) {
+        Event ev = {0};
+        if (!event_stream_get(stream, i, &ev)) break;
+        if (ev.h.kind == EVENT_DIRECTORY_LEAVE) {
             subdir_leave = i;
             break;
         }
@@ -3383,8 +3737,9 @@ TEST(evaluator_return_in_macro_returns_from_callsite_context) {
     bool saw_macro_ret_before = false;
     bool saw_after_macro_defined_no = false;
     bool saw_after_include_top = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC &&
             ev->as.diag.severity == EV_DIAG_ERROR &&
             nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("return() cannot be used inside macro()"))) {
@@ -3463,8 +3818,9 @@ TEST(evaluator_return_cmp0140_old_ignores_args_and_new_enables_propagate) {
 
     bool saw_ret_old_root = false;
     bool saw_ret_new_changed = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("ret_cmp0140")) &&
             nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("RET_OLD=root_old"))) {
@@ -3488,6 +3844,8 @@ TEST(evaluator_return_cmp0140_old_ignores_args_and_new_enables_propagate) {
 
 void run_evaluator_v2_batch2(int *passed, int *failed, int *skipped) {
     test_evaluator_cmake_language_core_subcommands_work(passed, failed, skipped);
+    test_evaluator_cmake_language_call_passes_resolved_args_verbatim(passed, failed, skipped);
+    test_evaluator_cmake_language_eval_code_reuses_parsed_payloads(passed, failed, skipped);
     test_evaluator_defer_replay_in_subdirectory_uses_child_execution_context(passed, failed, skipped);
     test_evaluator_cmake_language_defer_allows_duplicate_ids_and_missing_get_call_returns_empty(passed, failed, skipped);
     test_evaluator_cmake_language_defer_only_allows_leading_underscore_for_generated_ids(passed, failed, skipped);
@@ -3514,6 +3872,9 @@ void run_evaluator_v2_batch2(int *passed, int *failed, int *skipped) {
     test_evaluator_generated_source_property_apis_emit_source_marks(passed, failed, skipped);
     test_evaluator_event_ir_taxonomy_is_frozen(passed, failed, skipped);
     test_evaluator_event_ir_metadata_and_stream_contract(passed, failed, skipped);
+    test_evaluator_event_stream_interns_repeated_payload_strings(passed, failed, skipped);
+    test_evaluator_event_stream_stores_compact_records(passed, failed, skipped);
+    test_evaluator_event_stream_subscription_skips_unwanted_roles(passed, failed, skipped);
     test_evaluator_event_ir_directory_semantics_and_trace_surface(passed, failed, skipped);
     test_evaluator_event_ir_command_trace_sequences_unknown_and_error_paths(passed, failed, skipped);
     test_evaluator_event_ir_command_trace_sequences_success_paths(passed, failed, skipped);
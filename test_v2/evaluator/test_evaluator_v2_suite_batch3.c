@@ -131,8 +131,9 @@ TEST(evaluator_target_usage_semantics_rejects_unsupported_genex_forms_early) {
     size_t compile_definitions_conditional_errors = 0;
     bool saw_target_interface_compile_options_error = false;
     bool saw_global_compile_options_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("unsupported conditional operator in target-usage item"))) {
             ASSERT(nob_sv_eq(ev->as.diag.hint, nob_sv_from_cstr("$<IF:$<BOOL:1>,1,0>")));
@@ -190,8 +191,9 @@ TEST(evaluator_target_usage_semantics_accepts_bool_constant_genex) {
 
     bool saw_visible = false;
     bool saw_hidden = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("bool_usage"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.semantic.value, nob_sv_from_cstr("VISIBLE_DEF"))) saw_visible = true;
@@ -246,8 +248,9 @@ TEST(evaluator_if_matches_populates_cmake_match_variables) {
     bool saw_m2 = false;
     bool saw_m3 = false;
     bool saw_mc = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("match_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("M0=FMT_VERSION 120100"))) saw_m0 = true;
@@ -300,8 +303,9 @@ TEST(evaluator_list_transform_output_variable_requires_single_output_var) {
     ASSERT(report->error_count == 2);
 
     size_t output_arity_errors = 0;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (!nob_sv_eq(ev->as.diag.cause,
                        nob_sv_from_cstr("list(TRANSFORM OUTPUT_VARIABLE) expects exactly one output variable"))) {
@@ -317,6 +321,76 @@ TEST(evaluator_list_transform_output_variable_requires_single_output_var) {
     TEST_PASS();
 }
 
+TEST(evaluator_list_append_grows_in_place_without_disturbing_earlier_values) {
+    Arena *temp_arena = arena_create(2 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "set(L a)\n"
+        "list(APPEND L b c)\n"
+        "set(SNAP \"${L}\")\n"
+        "list(APPEND L d)\n"
+        "list(PREPEND L z)\n"
+        "list(PREPEND L y)\n"
+        "list(LENGTH L LEN)\n"
+        "list(GET L 0 -1 ENDS)\n"
+        "function(grow)\n"
+        "  list(APPEND L inner)\n"
+        "  set(FROM_FN \"${L}\" PARENT_SCOPE)\n"
+        "endfunction()\n"
+        "grow()\n"
+        "list(APPEND L e)\n"
+        "list(APPEND EMPTY_START x)\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("SNAP")), nob_sv_from_cstr("a;b;c")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("LEN")), nob_sv_from_cstr("6")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("ENDS")), nob_sv_from_cstr("y;d")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FROM_FN")), nob_sv_from_cstr("y;z;a;b;c;d;inner")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("L")), nob_sv_from_cstr("y;z;a;b;c;d;e")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("EMPTY_START")), nob_sv_from_cstr("x")));
+
+    // Growing a long list must cost persistent memory linear in its size.
+    size_t allocated_before = arena_total_allocated(event_arena);
+    Ast_Root grow_root = parse_cmake(
+        temp_arena,
+        "foreach(i RANGE 1 4000)\n"
+        "  list(APPEND BIG item_with_a_reasonably_long_name_${i})\n"
+        "endforeach()\n"
+        "list(LENGTH BIG BIG_LEN)\n"
+        "list(GET BIG -1 BIG_LAST)\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, grow_root)));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("BIG_LEN")), nob_sv_from_cstr("4000")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("BIG_LAST")),
+                     nob_sv_from_cstr("item_with_a_reasonably_long_name_4000")));
+    ASSERT(arena_total_allocated(event_arena) - allocated_before < 64 * 1024 * 1024);
+
+    const Eval_Run_Report *report = eval_test_report(ctx);
+    ASSERT(report != NULL);
+    ASSERT(report->error_count == 0);
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
 TEST(evaluator_list_sort_and_transform_selector_surface_matches_documented_combinations) {
     Arena *temp_arena = arena_create(2 * 1024 * 1024);
     Arena *event_arena = arena_create(2 * 1024 * 1024);
@@ -405,13 +479,15 @@ TEST(evaluator_math_rejects_empty_and_incomplete_invocations) {
 
     bool found_empty_error = false;
     bool found_expr_arity_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        if (stream->items[i].h.kind != EV_DIAGNOSTIC) continue;
-        if (stream->items[i].as.diag.severity != EV_DIAG_ERROR) continue;
-        if (nob_sv_eq(stream->items[i].as.diag.cause, nob_sv_from_cstr("math() requires a subcommand"))) {
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
+        if (ev->h.kind != EV_DIAGNOSTIC) continue;
+        if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
+        if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("math() requires a subcommand"))) {
             found_empty_error = true;
         }
-        if (nob_sv_eq(stream->items[i].as.diag.cause,
+        if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("math(EXPR) requires output variable and expression"))) {
             found_expr_arity_error = true;
         }
@@ -457,8 +533,9 @@ TEST(evaluator_set_target_properties_rejects_alias_target) {
 
     bool found_alias_error = false;
     bool emitted_prop_for_alias = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC &&
             ev->as.diag.severity == EV_DIAG_ERROR &&
             nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("set_target_properties() cannot be used on ALIAS targets"))) {
@@ -522,8 +599,9 @@ TEST(evaluator_add_executable_imported_and_alias_signatures) {
     bool saw_alias_of_alias_err = false;
     bool saw_imported_sources_err = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TARGET_PROP_SET) {
             if (nob_sv_eq(ev->as.target_prop_set.target_name, nob_sv_from_cstr("tool")) &&
                 nob_sv_eq(ev->as.target_prop_set.key, nob_sv_from_cstr("IMPORTED")) &&
@@ -609,8 +687,9 @@ TEST(evaluator_add_library_imported_alias_and_default_type) {
     bool saw_bad_alias_err = false;
     bool saw_bad_import_err = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TARGET_DECLARE) {
             if (nob_sv_eq(ev->as.target_declare.name, nob_sv_from_cstr("auto_lib")) &&
                 ev->as.target_declare.type == EV_TARGET_LIBRARY_SHARED) {
@@ -705,8 +784,9 @@ TEST(evaluator_set_property_target_rejects_alias_and_unknown_target) {
     bool emitted_for_alias = false;
     bool emitted_for_missing = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC && ev->as.diag.severity == EV_DIAG_ERROR) {
             if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("set_property(TARGET ...) cannot be used on ALIAS targets"))) {
                 saw_alias_error = true;
@@ -772,8 +852,9 @@ TEST(evaluator_define_property_initializes_target_properties_from_variable) {
     size_t custom_flag_prop_sets = 0;
     bool saw_real_seeded = false;
     bool saw_app_second = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_PROP_SET) continue;
         if (!nob_sv_eq(ev->as.target_prop_set.key, nob_sv_from_cstr("CUSTOM_FLAG"))) continue;
         custom_flag_prop_sets++;
@@ -836,8 +917,9 @@ TEST(evaluator_set_property_source_test_directory_clauses_parse_and_apply) {
     bool saw_source_target_dir_var_set = false;
     bool saw_test_dir_var_set = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_VAR_SET) continue;
         if (nob_sv_eq(ev->as.var_set.value, nob_sv_from_cstr("C")) &&
             nob_sv_eq(ev->as.var_set.key,
@@ -902,8 +984,9 @@ TEST(evaluator_set_property_allows_zero_objects_and_validates_test_lookup) {
 
     bool saw_missing_test_error = false;
     bool saw_smoke_label_set = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC &&
             ev->as.diag.severity == EV_DIAG_ERROR &&
             nob_sv_eq(ev->as.diag.cause,
@@ -959,8 +1042,9 @@ TEST(evaluator_set_property_cache_requires_existing_entry) {
 
     bool saw_missing_cache_error = false;
     bool saw_cache_value_update = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC && ev->as.diag.severity == EV_DIAG_ERROR &&
             nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("set_property(CACHE ...) cache entry does not exist"))) {
             saw_missing_cache_error = true;
@@ -1564,8 +1648,9 @@ TEST(evaluator_install_signatures_emit_expected_rules_and_component_inventory) {
     bool saw_export_android = false;
     bool saw_imported_runtime_artifacts = false;
     bool saw_runtime_dependency_set = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_EXPORT_INSTALL &&
             nob_sv_eq(ev->as.export_install.export_name, nob_sv_from_cstr("InstExport")) &&
             nob_sv_eq(ev->as.export_install.destination, nob_sv_from_cstr("share/cmake/Inst"))) {
@@ -1683,8 +1768,9 @@ TEST(evaluator_install_omitted_components_materialize_as_unspecified_without_def
     bool saw_file_unspecified = false;
     bool saw_target_unspecified = false;
     bool saw_export_unspecified = false;
-    for (size_t i = 0; i < stream->count; ++i) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_INSTALL_ADD_RULE &&
             nob_sv_eq(ev->as.install_add_rule.item, nob_sv_from_cstr("install_unspecified.txt")) &&
             nob_sv_eq(ev->as.install_add_rule.component, nob_sv_from_cstr("Unspecified"))) {
@@ -1840,8 +1926,9 @@ TEST(evaluator_directory_scoped_property_queries_require_known_directories) {
     bool saw_get_test_error = false;
     bool saw_set_source_error = false;
     bool saw_set_test_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("get_directory_property(DIRECTORY ...) directory is not known"))) {
@@ -1930,8 +2017,9 @@ TEST(evaluator_directory_property_inheritance_uses_directory_graph_parent) {
     ASSERT(report->error_count == 0);
 
     bool saw_child_mark_from_parent = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("graph_child_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("CHILD_MARK=from_parent"))) {
@@ -2001,8 +2089,9 @@ TEST(evaluator_option_mark_as_advanced_and_include_regular_expression_follow_pol
     bool saw_old_missing_cache = false;
     bool saw_new_missing_cache = false;
     bool saw_opt_new_cache = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_SET_CACHE_ENTRY || ev->as.var_set.target_kind != EVENT_VAR_TARGET_CACHE) continue;
         if (nob_sv_eq(ev->as.var_set.key, nob_sv_from_cstr("OPT_OLD")) &&
             nob_sv_eq(ev->as.var_set.value, nob_sv_from_cstr("ON"))) {
@@ -2133,8 +2222,9 @@ TEST(evaluator_separate_arguments_rejects_invalid_option_shapes) {
     bool saw_multi_mode = false;
     bool saw_separate_only = false;
     bool saw_unexpected = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (!nob_sv_eq(ev->as.diag.command, nob_sv_from_cstr("separate_arguments"))) continue;
 
@@ -2200,8 +2290,9 @@ TEST(evaluator_remove_definitions_updates_directory_definition_and_option_state)
 
     bool saw_remove_defs_event = false;
     bool saw_remove_opts_event = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EVENT_DIRECTORY_PROPERTY_MUTATE) continue;
         if (ev->h.origin.line != 2) continue;
         if (nob_sv_eq(ev->as.directory_property_mutate.property_name,
@@ -2343,8 +2434,9 @@ TEST(evaluator_load_cache_rejects_missing_path_empty_legacy_clauses_and_incomple
     bool saw_empty_include_internals = false;
     bool saw_unsupported_argument = false;
     bool saw_incomplete_prefixed = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("load_cache() requires a build directory path"))) {
@@ -2550,8 +2642,9 @@ TEST(evaluator_host_system_information_rejects_incomplete_and_unknown_queries) {
 
     bool saw_missing_clauses = false;
     bool saw_unknown_query = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("cmake_host_system_information() requires RESULT and QUERY clauses"))) {
@@ -2631,8 +2724,9 @@ TEST(evaluator_build_name_and_build_command_follow_policy_gates) {
     ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("BC_NEW")), expected_bc_new));
 
     bool saw_cmp0036_diag = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("build_name() is disallowed by CMP0036"))) {
@@ -2690,8 +2784,9 @@ TEST(evaluator_host_build_commands_reject_invalid_shapes_and_warn_on_ignored_pro
     bool saw_build_command_too_many = false;
     bool saw_build_command_bad_arg = false;
     bool saw_project_name_warning = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity == EV_DIAG_ERROR) {
             if (nob_sv_eq(ev->as.diag.cause,
@@ -2965,8 +3060,9 @@ TEST(evaluator_try_run_executes_native_artifacts_and_stages_crosscompile_placeho
     ASSERT(sv_contains_sv(try_run_results, nob_sv_from_cstr("PLEASE_FILL_OUT-NOTFOUND")));
 
     bool saw_cross_compile_diag = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("try_run() invoked in cross-compiling mode without preset cache answers"))) {
@@ -3213,8 +3309,9 @@ TEST(evaluator_try_run_rejects_incomplete_argument_shapes) {
     bool saw_run_output_missing_value = false;
     bool saw_run_output_conflict = false;
     bool saw_project_source_dir_required = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("try_run() requires run result, compile result and try_compile-style inputs"))) {
@@ -3297,8 +3394,9 @@ TEST(evaluator_exec_program_respects_cmp0153_and_legacy_wrapper_surface) {
     bool saw_output_diag = false;
     bool saw_return_diag = false;
     bool saw_bogus_diag = false;
-    for (size_t i = 0; i < fixture->stream->count; i++) {
-        const Cmake_Event *ev = &fixture->stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(fixture->stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("exec_program() is disallowed by CMP0153"))) {
             saw_cmp0153_diag = true;
@@ -3444,8 +3542,9 @@ TEST(evaluator_batch6_metadata_commands_cover_documented_subset) {
     bool saw_export_set_target = false;
     String_View targets_export_key = {0};
     String_View export_set_key = {0};
-    for (size_t i = 0; i < stream->count; ++i) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_EXPORT_BUILD_DECLARE &&
             nob_sv_eq(ev->as.export_build_declare.logical_name, nob_sv_from_cstr("meta-targets")) &&
             ev->as.export_build_declare.source_kind == EVENT_EXPORT_SOURCE_TARGETS &&
@@ -3498,8 +3597,9 @@ TEST(evaluator_batch6_metadata_commands_cover_documented_subset) {
     ASSERT(sv_contains_sv(cache_reply, nob_sv_from_cstr("\"kind\": \"cache\"")));
 
     bool saw_malformed_cache_warning = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_WARNING) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("load_cache() skipped a malformed cache entry"))) {
             saw_malformed_cache_warning = true;
@@ -3653,8 +3753,9 @@ TEST(evaluator_batch6_metadata_commands_reject_incomplete_option_values) {
     bool saw_msproject_platform_error = false;
     bool saw_file_api_version_error = false;
     bool saw_export_namespace_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("include_external_msproject(TYPE ...) requires a GUID value"))) {
@@ -3689,6 +3790,7 @@ void run_evaluator_v2_batch3(int *passed, int *failed, int *skipped) {
     test_evaluator_target_usage_semantics_accepts_bool_constant_genex(passed, failed, skipped);
     test_evaluator_if_matches_populates_cmake_match_variables(passed, failed, skipped);
     test_evaluator_list_transform_output_variable_requires_single_output_var(passed, failed, skipped);
+    test_evaluator_list_append_grows_in_place_without_disturbing_earlier_values(passed, failed, skipped);
     test_evaluator_list_sort_and_transform_selector_surface_matches_documented_combinations(passed, failed, skipped);
     test_evaluator_math_rejects_empty_and_incomplete_invocations(passed, failed, skipped);
     test_evaluator_set_target_properties_rejects_alias_target(passed, failed, skipped);
@@ -845,8 +845,9 @@ TEST(evaluator_load_cache_allows_read_with_prefix_but_rejects_legacy_form_in_scr
     ASSERT(report->error_count == 1);
 
     size_t legacy_form_errors = 0;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("load_cache() legacy form is available only in CMake projects"))) {
@@ -1027,8 +1028,9 @@ TEST(evaluator_export_rejects_invalid_extension_and_alias_targets) {
 
     bool saw_bad_extension = false;
     bool saw_alias_reject = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("export(... FILE ...) requires a filename ending in .cmake"))) {
@@ -1459,8 +1461,9 @@ TEST(evaluator_ctest_start_models_documented_group_append_and_checkout_flow) {
                          nob_sv_from_cstr("OverrideGroup")));
 
         bool saw_append_warning = false;
-        for (size_t i = 0; i < stream->count; i++) {
-            const Cmake_Event *ev = &stream->items[i];
+        Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+        while (event_stream_next(&it)) {
+            const Cmake_Event *ev = it.current;
             if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_WARNING) continue;
             if (nob_sv_eq(ev->as.diag.cause,
                           nob_sv_from_cstr("ctest_start(APPEND) overriding model/group from existing TAG file"))) {
@@ -2075,8 +2078,9 @@ TEST(evaluator_ctest_coverage_executes_documented_command_order_and_stages_submi
         bool saw_argv_count = false;
         bool saw_command = false;
         bool saw_flag = false;
-        for (size_t i = 0; i < stream->count; ++i) {
-            const Cmake_Event *ev = &stream->items[i];
+        Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+        while (event_stream_next(&it)) {
+            const Cmake_Event *ev = it.current;
             if (ev->h.kind == EVENT_REPLAY_ACTION_DECLARE &&
                 ev->as.replay_action_declare.opcode == EVENT_REPLAY_OPCODE_TEST_DRIVER_CTEST_COVERAGE_LOCAL) {
                 declare_count++;
@@ -2755,8 +2759,9 @@ TEST(evaluator_ctest_memcheck_executes_backend_and_stages_submit_part) {
         bool saw_prefix_count = false;
         bool saw_prefix_command = false;
         bool saw_prefix_option = false;
-        for (size_t i = 0; i < stream->count; ++i) {
-            const Cmake_Event *ev = &stream->items[i];
+        Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+        while (event_stream_next(&it)) {
+            const Cmake_Event *ev = it.current;
             if (ev->h.kind == EVENT_REPLAY_ACTION_DECLARE &&
                 ev->as.replay_action_declare.opcode == EVENT_REPLAY_OPCODE_TEST_DRIVER_CTEST_MEMCHECK_LOCAL) {
                 declare_count++;
@@ -3280,8 +3285,9 @@ TEST(evaluator_ctest_submit_rejects_invalid_parts_and_mixed_signatures) {
     bool saw_invalid_part = false;
     bool saw_mixed_signature = false;
     bool saw_type_without_upload = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("ctest_submit() received an invalid PARTS value"))) {
@@ -3392,8 +3398,9 @@ TEST(evaluator_ctest_memcheck_rejects_invalid_documented_shapes) {
     bool saw_parallel_level = false;
     bool saw_repeat_mode = false;
     bool saw_repeat_count = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("ctest command keyword requires a value"))) {
@@ -3466,8 +3473,9 @@ TEST(evaluator_ctest_entrypoints_reject_incomplete_argument_shapes) {
     bool saw_start_positionals = false;
     bool saw_submit_files_values = false;
     bool saw_upload_files_required = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("ctest_empty_binary_directory() requires exactly one directory argument"))) {
@@ -3591,8 +3599,9 @@ TEST(evaluator_batch8_legacy_commands_register_and_model_compat_paths) {
 
     size_t install_rule_count = 0;
     bool saw_unknown_command = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_INSTALL_ADD_RULE) install_rule_count++;
         if (ev->h.kind == EV_DIAGNOSTIC && nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("Unknown command"))) {
             saw_unknown_command = true;
@@ -3650,8 +3659,9 @@ TEST(evaluator_batch8_legacy_commands_reject_invalid_forms) {
     bool saw_qt_wrap_cpp = false;
     bool saw_qt_wrap_ui = false;
     bool saw_fltk_wrap_ui = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("make_directory() requires at least one directory"))) {
             saw_make_directory = true;
@@ -3791,8 +3801,9 @@ TEST(evaluator_target_sources_compile_features_and_precompile_headers_model_usag
     bool saw_missing_pch_error = false;
     bool saw_missing_src_error = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TARGET_ADD_SOURCE &&
             nob_sv_eq(ev->as.target_add_source.target_name, nob_sv_from_cstr("real"))) {
             if (sv_contains_sv(ev->as.target_add_source.path, nob_sv_from_cstr("include/public.hpp"))) {
@@ -4105,8 +4116,9 @@ TEST(evaluator_target_usage_commands_store_canonical_direct_and_interface_proper
     bool saw_interface_link_option_before = false;
     bool saw_debug_link_library = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TARGET_COMPILE_OPTIONS &&
             nob_sv_eq(ev->as.target_compile_options.target_name, nob_sv_from_cstr("usage_props")) &&
             nob_sv_eq(ev->as.target_compile_options.item, nob_sv_from_cstr("-pub")) &&
@@ -4234,8 +4246,9 @@ TEST(evaluator_add_dependencies_projects_manual_dependency_property) {
 
     bool saw_main_dep = false;
     bool saw_iface_dep = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_ADD_DEPENDENCY) continue;
         if (nob_sv_eq(ev->as.target_add_dependency.target_name, nob_sv_from_cstr("main")) &&
             nob_sv_eq(ev->as.target_add_dependency.dependency_name, nob_sv_from_cstr("dep"))) {
@@ -4313,8 +4326,9 @@ TEST(evaluator_target_usage_commands_require_visibility_and_restrict_imported_ta
     bool saw_imported_link_opts_error = false;
     bool saw_imported_link_dirs_error = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
 
         if (nob_sv_eq(ev->as.diag.cause,
@@ -4430,8 +4444,9 @@ TEST(evaluator_target_usage_commands_project_system_and_before_into_canonical_pr
 
     bool saw_before_link_event = false;
     bool saw_system_include_event = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TARGET_LINK_OPTIONS &&
             nob_sv_eq(ev->as.target_link_options.target_name, nob_sv_from_cstr("usage")) &&
             nob_sv_eq(ev->as.target_link_options.item, nob_sv_from_cstr("LINK_IFACE_B")) &&
@@ -4504,8 +4519,9 @@ TEST(evaluator_target_sources_file_set_headers_project_include_directory_side_ef
 
     bool saw_header_dirs_prop = false;
     bool saw_include_dirs_side_effect = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_PROP_SET ||
             !nob_sv_eq(ev->as.target_prop_set.target_name, nob_sv_from_cstr("usage"))) {
             continue;
@@ -4685,8 +4701,9 @@ TEST(evaluator_source_group_supports_files_tree_and_regex_forms) {
     bool saw_txt_regex_name = false;
     bool saw_tree_outside_error = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_VAR_SET) {
             if (sv_contains_sv(ev->as.var_set.key, nob_sv_from_cstr("NOBIFY_SOURCE_GROUP_FILE::")) &&
                 sv_contains_sv(ev->as.var_set.key, nob_sv_from_cstr("main.c")) &&
@@ -4790,8 +4807,9 @@ TEST(evaluator_message_mode_severity_mapping) {
     size_t error_diag_count = 0;
     bool saw_check_pass_cause = false;
     bool saw_check_fail_cause = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity == EV_DIAG_WARNING) warning_diag_count++;
         if (ev->as.diag.severity == EV_DIAG_ERROR) error_diag_count++;
@@ -4837,8 +4855,9 @@ TEST(evaluator_message_check_pass_without_start_is_error) {
     ASSERT(report->error_count == 1);
 
     bool found = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
@@ -4892,8 +4911,9 @@ TEST(evaluator_message_deprecation_respects_control_variables) {
     bool saw_hidden = false;
     bool saw_shown_warn = false;
     bool saw_err_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("hidden"))) saw_hidden = true;
         if (ev->as.diag.severity == EV_DIAG_WARNING &&
@@ -4994,8 +5014,9 @@ TEST(evaluator_set_and_unset_env_forms) {
     bool saw_a_empty = false;
     bool saw_b_value = false;
     bool saw_b2_empty = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC &&
             ev->as.diag.severity == EV_DIAG_WARNING &&
             nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("set(ENV{...}) ignores extra arguments after value"))) {
@@ -5151,8 +5172,9 @@ TEST(evaluator_cmake_parse_arguments_supports_direct_and_parse_argv_forms) {
     bool saw_m0 = false;
     bool saw_m1 = false;
     bool saw_unparsed = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC &&
             ev->as.diag.severity == EV_DIAG_WARNING &&
             nob_sv_eq(ev->as.diag.cause,
@@ -5220,8 +5242,9 @@ TEST(evaluator_cmake_parse_arguments_rejects_invalid_shapes_and_contexts) {
     bool saw_parse_argv_shape = false;
     bool saw_parse_argv_context = false;
     bool saw_parse_argv_index = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (!nob_sv_eq(ev->as.diag.command, nob_sv_from_cstr("cmake_parse_arguments"))) continue;
 
@@ -5277,8 +5300,9 @@ TEST(evaluator_unset_env_rejects_options) {
     ASSERT(report->error_count == 1);
 
     bool saw_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("unset(ENV{...}) does not accept options"))) {
@@ -5335,8 +5359,9 @@ TEST(evaluator_set_cache_cmp0126_old_and_new_semantics) {
     bool saw_new_binding_from_local = false;
     bool saw_cache_old_set = false;
     bool saw_cache_new_set = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_SET_CACHE_ENTRY && ev->as.var_set.target_kind == EVENT_VAR_TARGET_CACHE) {
             if (nob_sv_eq(ev->as.var_set.key, nob_sv_from_cstr("CACHE_OLD")) &&
                 nob_sv_eq(ev->as.var_set.value, nob_sv_from_cstr("cache_old"))) {
@@ -5401,8 +5426,9 @@ TEST(evaluator_set_cache_policy_version_defaults_cmp0126_to_new) {
 
     bool saw_cache_ver_set = false;
     bool saw_local_binding = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_SET_CACHE_ENTRY &&
             ev->as.var_set.target_kind == EVENT_VAR_TARGET_CACHE &&
             nob_sv_eq(ev->as.var_set.key, nob_sv_from_cstr("CACHE_VER")) &&
@@ -5465,8 +5491,9 @@ TEST(evaluator_var_commands_reject_invalid_option_shapes) {
     bool saw_option_empty_name = false;
     bool saw_mark_missing = false;
     bool saw_unset_unsupported = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("set(... CACHE ...) requires <type> and <docstring>"))) {
             saw_set_missing_doc = true;
@@ -190,8 +190,9 @@ TEST(evaluator_find_item_command_rejects_unknown_option) {
     ASSERT(report->error_count == 1);
 
     bool saw_unknown = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (!nob_sv_eq(ev->as.diag.command, nob_sv_from_cstr("find_file"))) continue;
@@ -237,8 +238,9 @@ TEST(evaluator_find_item_command_rejects_missing_output_variable) {
     ASSERT(report->error_count == 1);
 
     bool saw_missing = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (!nob_sv_eq(ev->as.diag.command, nob_sv_from_cstr("find_file"))) continue;
@@ -291,8 +293,9 @@ TEST(evaluator_find_item_command_rejects_missing_registry_or_validator_values) {
     bool saw_registry = false;
     bool saw_validator = false;
     bool saw_doc_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (!nob_sv_eq(ev->as.diag.command, nob_sv_from_cstr("find_file"))) continue;
@@ -346,8 +349,9 @@ TEST(evaluator_find_item_command_rejects_malformed_env_clause) {
     ASSERT(report->error_count == 2);
 
     size_t malformed_env_diags = 0;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (!nob_sv_eq(ev->as.diag.command, nob_sv_from_cstr("find_file"))) continue;
@@ -512,8 +516,9 @@ TEST(evaluator_get_filename_component_rejects_invalid_option_shapes) {
     bool saw_missing_base_dir = false;
     bool saw_missing_program_args_var = false;
     bool saw_bad_mode = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause,
                       nob_sv_from_cstr("get_filename_component() requires <var> <file> <component>"))) {
@@ -586,8 +591,9 @@ TEST(evaluator_find_package_no_module_names_configs_path_suffixes_and_registry_v
     bool saw_found = false;
     bool saw_src_config = false;
     bool saw_rv_host = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_FIND_PACKAGE &&
             nob_sv_eq(ev->as.package_find_result.package_name, nob_sv_from_cstr("DemoFP"))) {
             saw_find_event = true;
@@ -657,8 +663,9 @@ TEST(evaluator_find_package_auto_prefers_config_when_requested) {
 
     bool saw_config_location = false;
     bool saw_from_config = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_FIND_PACKAGE &&
             nob_sv_eq(ev->as.package_find_result.package_name, nob_sv_from_cstr("PrefPkg"))) {
             saw_config_location =
@@ -738,8 +745,9 @@ TEST(evaluator_find_package_cmp0074_old_ignores_root_and_new_uses_root) {
     bool saw_new_location = false;
     bool saw_old_from_prefix = false;
     bool saw_new_from_root = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_FIND_PACKAGE &&
             nob_sv_eq(ev->as.package_find_result.package_name, nob_sv_from_cstr("Cmp0074Old"))) {
             saw_old_location =
@@ -837,8 +845,9 @@ TEST(evaluator_find_package_uses_export_package_registry_and_respects_cmp0090_ga
     bool saw_off_registry_event = false;
     bool saw_on_registry_event = false;
     bool saw_blocked_registry_event = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_FIND_PACKAGE) {
             if (nob_sv_eq(ev->as.package_find_result.package_name, nob_sv_from_cstr("NobifyPkgRegOff"))) {
                 saw_off_not_found = !ev->as.package_find_result.found;
@@ -924,8 +933,9 @@ TEST(evaluator_export_commands_emit_build_semantics_without_host_effects_when_di
     ASSERT(report != NULL);
     ASSERT(report->error_count == 0);
 
-    for (size_t i = 0; i < stream->count; ++i) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_EXPORT_BUILD_DECLARE &&
             nob_sv_eq(ev->as.export_build_declare.logical_name, nob_sv_from_cstr("CoreTargets")) &&
             ev->as.export_build_declare.source_kind == EVENT_EXPORT_SOURCE_TARGETS) {
@@ -1026,8 +1036,9 @@ TEST(evaluator_project_full_signature_and_variable_surface) {
     bool saw_sub_root_name = false;
     bool saw_sub_home = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_PROJECT_DECLARE) {
             if (nob_sv_eq(ev->as.project_declare.name, nob_sv_from_cstr("MainProj")) &&
                 nob_sv_eq(ev->as.project_declare.version, nob_sv_from_cstr("1.2.3.4")) &&
@@ -1138,8 +1149,9 @@ TEST(evaluator_project_cmp0048_new_clears_and_old_preserves_version_vars_without
     bool saw_new_maj_empty = false;
     bool saw_old_ver_keep = false;
     bool saw_old_maj_keep = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("project_new_nover"))) {
             if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("NEW_VER="))) saw_new_ver_empty = true;
@@ -1201,8 +1213,9 @@ TEST(evaluator_project_rejects_invalid_signature_forms) {
     bool saw_missing_home = false;
     bool saw_unexpected = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("project(VERSION ...) expects numeric components"))) {
             saw_bad_version = true;
@@ -1277,8 +1290,9 @@ TEST(evaluator_policy_known_unknown_and_if_predicate) {
     bool saw_if_unknown_empty = false;
 
     bool saw_unknown_policy_error = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC && ev->as.diag.severity == EV_DIAG_ERROR) {
             if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("cmake_policy(GET ...) requires a known CMP policy id"))) {
                 saw_unknown_policy_error = true;
@@ -1350,8 +1364,9 @@ TEST(evaluator_policy_strict_arity_and_version_validation) {
     bool saw_min_running = false;
     bool saw_max_lt_min = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC || ev->as.diag.severity != EV_DIAG_ERROR) continue;
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("cmake_policy(PUSH) does not accept extra arguments"))) {
             saw_push_arity = true;
@@ -1425,8 +1440,9 @@ TEST(evaluator_cmake_minimum_required_inside_function_applies_policy_not_variabl
 
     bool saw_out_pol = false;
     bool saw_min_ver_empty = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("OUT_POL=NEW"))) {
             saw_out_pol = true;
@@ -1494,8 +1510,9 @@ TEST(evaluator_foreach_cmp0124_old_defines_empty_and_new_unsets) {
     bool saw_old_def = false;
     bool saw_old_val_empty = false;
     bool saw_new_def_zero = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("OLD_I_DEF=1"))) {
             saw_old_def = true;
@@ -1551,8 +1568,9 @@ TEST(evaluator_cpack_commands_require_cpackcomponent_module_and_parse_component_
 
     bool saw_gate_error = false;
     bool saw_component_event = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_DIAGNOSTIC &&
             ev->as.diag.severity == EV_DIAG_ERROR &&
             nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("Unknown command")) &&
@@ -1619,8 +1637,9 @@ TEST(evaluator_cpack_commands_reject_missing_names_and_warn_on_extra_args) {
     bool saw_group_extra = false;
     bool saw_component_extra = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (ev->as.diag.severity == EV_DIAG_ERROR) {
             if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("cpack_add_install_type() missing name"))) {
@@ -1706,8 +1725,9 @@ TEST(evaluator_diag_codes_are_explicit_and_report_classes) {
     bool saw_message_warning = false;
     bool saw_message_error = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
 
         if (nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("Unknown command"))) {
@@ -1911,8 +1931,9 @@ TEST(evaluator_string_hash_repeat_and_json_full_surface) {
     bool saw_e2 = false;
     bool saw_err2 = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("string_full_probe"))) continue;
         String_View it = ev->as.target_compile_definitions.item;
@@ -2046,8 +2067,9 @@ TEST(evaluator_string_text_regex_and_misc_dispatch_events) {
     bool saw_hash_event = false;
     bool saw_timestamp_event = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_TARGET_COMPILE_DEFINITIONS &&
             nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("string_split_probe"))) {
             String_View it = ev->as.target_compile_definitions.item;
@@ -2158,8 +2180,9 @@ TEST(evaluator_string_regex_parse_error_keeps_diag_surface) {
     ASSERT(report->input_error_count == 1);
 
     bool saw_parse_diag = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_DIAGNOSTIC) continue;
         if (!nob_sv_eq(ev->as.diag.cause, nob_sv_from_cstr("Invalid regex pattern"))) continue;
         ASSERT(ev->as.diag.severity == EV_DIAG_ERROR);
@@ -2328,8 +2351,9 @@ TEST(evaluator_file_extra_subcommands_and_download_expected_hash) {
     bool saw_dl_bad_len = false;
     bool saw_dl_bad_code = false;
 
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("file_extra_probe"))) continue;
         String_View it = ev->as.target_compile_definitions.item;
@@ -2360,6 +2384,87 @@ TEST(evaluator_file_extra_subcommands_and_download_expected_hash) {
     TEST_PASS();
 }
 
+TEST(evaluator_file_hash_streams_large_files_like_string_hash) {
+    Arena *temp_arena = arena_create(8 * 1024 * 1024);
+    Arena *event_arena = arena_create(2 * 1024 * 1024);
+    ASSERT(temp_arena && event_arena);
+
+    Cmake_Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+
+    Eval_Test_Init init = {0};
+    init.arena = temp_arena;
+    init.event_arena = event_arena;
+    init.stream = stream;
+    init.source_dir = nob_sv_from_cstr(".");
+    init.binary_dir = nob_sv_from_cstr(".");
+    init.current_file = "CMakeLists.txt";
+
+    Eval_Test_Runtime *ctx = eval_test_create(&init);
+    ASSERT(ctx != NULL);
+
+    // 150003 bytes: spans several read chunks and ends mid-block.
+    Ast_Root root = parse_cmake(
+        temp_arena,
+        "string(REPEAT \"0123456789\" 15000 HASH_BIG)\n"
+        "string(APPEND HASH_BIG \"xyz\")\n"
+        "file(WRITE hash_big.bin \"${HASH_BIG}\")\n"
+        "foreach(algo MD5 SHA1 SHA224 SHA256 SHA384 SHA512 SHA3_224 SHA3_256 SHA3_384 SHA3_512)\n"
+        "  file(${algo} hash_big.bin FILE_${algo})\n"
+        "  string(${algo} STRING_${algo} \"${HASH_BIG}\")\n"
+        "  if(NOT FILE_${algo} STREQUAL STRING_${algo})\n"
+        "    list(APPEND HASH_MISMATCH ${algo})\n"
+        "  endif()\n"
+        "endforeach()\n"
+        "string(REPEAT \"0123456789abcdefghij\" 5003 HASH_KAT)\n"
+        "file(WRITE hash_kat.bin \"${HASH_KAT}\")\n"
+        "file(SHA256 hash_kat.bin HASH_KAT_FILE_SHA256)\n"
+        "file(SHA224 hash_kat.bin HASH_KAT_FILE_SHA224)\n"
+        "string(SHA256 HASH_KAT_STRING_SHA256 \"${HASH_KAT}\")\n"
+        "string(SHA224 HASH_KAT_STRING_SHA224 \"${HASH_KAT}\")\n"
+        "file(WRITE hash_abc.txt \"abc\")\n"
+        "file(SHA512 hash_abc.txt HASH_ABC_512)\n"
+        "file(SHA3_256 hash_abc.txt HASH_ABC_SHA3)\n"
+        "file(DOWNLOAD hash_big.bin hash_big_dl.bin EXPECTED_HASH SHA256=${FILE_SHA256} STATUS HASH_DL_STATUS)\n"
+        "list(GET HASH_DL_STATUS 0 HASH_DL_CODE)\n");
+    ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
+
+    const Eval_Run_Report *report = eval_test_report(ctx);
+    ASSERT(report != NULL);
+    ASSERT(report->error_count == 0);
+    ASSERT(eval_test_var_get(ctx, nob_sv_from_cstr("HASH_MISMATCH")).count == 0);
+    // Known answers from an independent SHA-2 implementation, so a broken
+    // hardware kernel cannot pass by agreeing with itself.
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FILE_SHA256")),
+                     nob_sv_from_cstr("0afbd3e1da9e058aaf08be9a339ae417784e9113aca944241bc9c9059459d227")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("FILE_SHA224")),
+                     nob_sv_from_cstr("4fcbb52bc10ec5cec2b21dd1a28331e1f607939fbcc88aec14399707")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("HASH_KAT_FILE_SHA256")),
+                     nob_sv_from_cstr("4a82fd713d879100d89fef61616f2147ff60e29ee2cfe3ae224ee5aec30cbf1d")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("HASH_KAT_STRING_SHA256")),
+                     nob_sv_from_cstr("4a82fd713d879100d89fef61616f2147ff60e29ee2cfe3ae224ee5aec30cbf1d")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("HASH_KAT_FILE_SHA224")),
+                     nob_sv_from_cstr("406c8d0319f47579365e3d512c5aaf378e35dc6ca9d02d7185c78bc1")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("HASH_KAT_STRING_SHA224")),
+                     nob_sv_from_cstr("406c8d0319f47579365e3d512c5aaf378e35dc6ca9d02d7185c78bc1")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("HASH_ABC_512")),
+                     nob_sv_from_cstr("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                                      "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("HASH_ABC_SHA3")),
+                     nob_sv_from_cstr("3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532")));
+    ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("HASH_DL_CODE")), nob_sv_from_cstr("0")));
+
+    Ast_Root missing = parse_cmake(temp_arena, "file(SHA256 hash_missing.bin HASH_MISSING)\n");
+    (void)eval_test_run(ctx, missing);
+    report = eval_test_report(ctx);
+    ASSERT(report->error_count == 1);
+
+    eval_test_destroy(ctx);
+    arena_destroy(temp_arena);
+    arena_destroy(event_arena);
+    TEST_PASS();
+}
+
 TEST(evaluator_file_runtime_dependencies_resolve_known_host_binary) {
     char host_binary[_TINYDIR_PATH_MAX] = {0};
 #if defined(_WIN32)
@@ -2402,8 +2507,9 @@ TEST(evaluator_file_runtime_dependencies_resolve_known_host_binary) {
 
     bool saw_rd_res_len = false;
     bool saw_rd_unres_len = false;
-    for (size_t i = 0; i < fixture->stream->count; i++) {
-        const Cmake_Event *ev = &fixture->stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(fixture->stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("file_runtime_dep_probe"))) {
             continue;
@@ -2476,8 +2582,9 @@ TEST(evaluator_file_dispatcher_routes_glob_rw_and_copy_families) {
     bool saw_write_event = false;
     bool saw_read_event = false;
     bool saw_copy_read_event = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_FS_GLOB &&
             nob_sv_eq(ev->as.fs_glob.out_var, nob_sv_from_cstr("DISPATCH_GLOB")) &&
             ev->as.fs_glob.recursive &&
@@ -2559,8 +2666,9 @@ TEST(evaluator_file_deterministic_fsops_emit_replay_actions) {
     size_t chmod_count = 0;
     size_t chmod_recurse_count = 0;
 
-    for (size_t i = 0; i < stream->count; ++i) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EVENT_REPLAY_ACTION_DECLARE) continue;
         switch (ev->as.replay_action_declare.opcode) {
             case EVENT_REPLAY_OPCODE_FS_COPY_FILE: copy_file_count++; break;
@@ -2643,8 +2751,9 @@ TEST(evaluator_file_glob_and_strings_cover_curl_style_queries) {
     ASSERT(nob_sv_eq(eval_test_var_get(ctx, nob_sv_from_cstr("CURL_CA_COUNT")), nob_sv_from_cstr("1")));
 
     bool saw_glob_event = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EVENT_FS_GLOB &&
                    nob_sv_eq(ev->as.fs_glob.out_var, nob_sv_from_cstr("CURL_CA_FILES")) &&
                    !ev->as.fs_glob.recursive &&
@@ -2797,8 +2906,9 @@ TEST(evaluator_file_real_path_cmp0152_old_and_new) {
 
     bool saw_old = false;
     bool saw_new = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("real_path_policy_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr(old_item))) saw_old = true;
@@ -2866,8 +2976,9 @@ TEST(evaluator_file_generate_is_deferred_until_end_of_run) {
     ASSERT(report->error_count == 0);
 
     bool saw_before_zero = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("gen_deferred_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("GEN_BEFORE=0"))) {
@@ -2892,8 +3003,9 @@ TEST(evaluator_file_generate_is_deferred_until_end_of_run) {
     bool saw_out = false;
     bool saw_in = false;
     bool saw_skip = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("gen_deferred_verify"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("GEN_OUT=OUT"))) saw_out = true;
@@ -2946,8 +3058,9 @@ TEST(evaluator_file_lock_directory_and_duplicate_lock_result) {
     bool saw_l1_ok = false;
     bool saw_l2_nonzero = false;
     bool saw_l3_ok = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("lock_probe"))) continue;
         String_View item = ev->as.target_compile_definitions.item;
@@ -3003,8 +3116,9 @@ TEST(evaluator_file_download_probe_mode_without_destination) {
 
     bool saw_len = false;
     bool saw_code = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("dl_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("DL_LEN=2"))) saw_len = true;
@@ -3056,8 +3170,9 @@ TEST(evaluator_try_compile_no_cache_and_cmake_flags_do_not_leak) {
     bool saw_parent_empty = false;
     bool saw_cache_entry = false;
     bool saw_parent_binding = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_SET_CACHE_ENTRY &&
             ev->as.var_set.target_kind == EVENT_VAR_TARGET_CACHE &&
             nob_sv_eq(ev->as.var_set.key, nob_sv_from_cstr("TC_LOCAL_ONLY"))) {
@@ -3125,8 +3240,9 @@ TEST(evaluator_try_compile_failure_populates_output_variable) {
     bool saw_fail_result = false;
     size_t fail_log_len = 0;
     bool saw_fail_log_len = false;
-    for (size_t i = 0; i < stream->count; i++) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind != EV_TARGET_COMPILE_DEFINITIONS) continue;
         if (!nob_sv_eq(ev->as.target_compile_definitions.target_name, nob_sv_from_cstr("tc_try_fail_probe"))) continue;
         if (nob_sv_eq(ev->as.target_compile_definitions.item, nob_sv_from_cstr("TC_FAIL=FALSE"))) {
@@ -3288,8 +3404,9 @@ TEST(evaluator_include_cpack_materializes_package_snapshot_events) {
     bool saw_tgz = false;
     bool saw_zip = false;
     bool saw_runtime_override = false;
-    for (size_t i = 0; i < stream->count; ++i) {
-        const Cmake_Event *ev = &stream->items[i];
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
         if (ev->h.kind == EV_CPACK_PACKAGE_DECLARE) {
             saw_declare = true;
             ASSERT(nob_sv_eq(ev->as.cpack_package_declare.package_name, nob_sv_from_cstr("PackMe")));
@@ -3346,9 +3463,11 @@ TEST(evaluator_include_cpackcomponent_alone_does_not_materialize_package_snapsho
         "cpack_add_install_type(Full)\n");
     ASSERT(!eval_result_is_fatal(eval_test_run(ctx, root)));
 
-    for (size_t i = 0; i < stream->count; ++i) {
-        ASSERT(stream->items[i].h.kind != EV_CPACK_PACKAGE_DECLARE);
-        ASSERT(stream->items[i].h.kind != EV_CPACK_PACKAGE_ADD_GENERATOR);
+    Cmake_Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        const Cmake_Event *ev = it.current;
+        ASSERT(ev->h.kind != EV_CPACK_PACKAGE_DECLARE);
+        ASSERT(ev->h.kind != EV_CPACK_PACKAGE_ADD_GENERATOR);
     }
 
     eval_test_destroy(ctx);
@@ -3386,6 +3505,7 @@ void run_evaluator_v2_batch5(int *passed, int *failed, int *skipped) {
     test_evaluator_string_regex_parse_error_keeps_diag_surface(passed, failed, skipped);
     test_evaluator_string_find_compare_configure_random_timestamp_and_uuid_cover_remaining_option_modes(passed, failed, skipped);
     test_evaluator_file_extra_subcommands_and_download_expected_hash(passed, failed, skipped);
+    test_evaluator_file_hash_streams_large_files_like_string_hash(passed, failed, skipped);
     test_evaluator_file_dispatcher_routes_glob_rw_and_copy_families(passed, failed, skipped);
     test_evaluator_file_deterministic_fsops_emit_replay_actions(passed, failed, skipped);
     test_evaluator_file_glob_and_strings_cover_curl_style_queries(passed, failed, skipped);
@@ -52,6 +52,7 @@ typedef struct {
     Eval_Compat_Profile compat_profile;
     EvalRegistry *registry;
     bool disable_export_host_effects;
+    String_View ast_cache_dir;
 } Eval_Test_Init;
 
 typedef struct {
@@ -8,6 +8,7 @@
 #include "diagnostics.h"
 #include "lexer.h"
 #include "parser.h"
+#include "ast_cache.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -269,6 +270,73 @@ TEST(parser_golden_all_cases) {
     TEST_PASS();
 }
 
+TEST(parser_ast_cache_round_trips_tree_and_rejects_changed_source) {
+    static const char *script =
+        "cmake_minimum_required(VERSION 3.16)\n"
+        "if(A AND (B OR \"C D\"))\n"
+        "  set(X [=[raw;text]=] lib${V}.a)\n"
+        "elseif(E)\n"
+        "  message(STATUS \"e\")\n"
+        "else()\n"
+        "  foreach(i IN LISTS L)\n"
+        "    while(i)\n"
+        "      set(i \"\")\n"
+        "    endwhile()\n"
+        "  endforeach()\n"
+        "endif()\n"
+        "function(f a b)\n"
+        "  macro(m)\n"
+        "  endmacro()\n"
+        "endfunction()\n";
+
+    Arena *arena = arena_create(1024 * 1024);
+    Arena *load_arena = arena_create(1024 * 1024);
+    ASSERT(arena && load_arena);
+
+    String_View source = nob_sv_from_cstr(script);
+    Ast_Root parsed = parse_script_local(arena, script);
+    ASSERT(parsed != NULL);
+    ASSERT(ast_cache_store("ast_cache", source, parsed));
+
+    Ast_Root loaded = NULL;
+    ASSERT(ast_cache_load(load_arena, "ast_cache", source, &loaded));
+
+    Nob_String_Builder expected = {0};
+    Nob_String_Builder actual = {0};
+    snapshot_append_node_list(&expected, &parsed, 0);
+    snapshot_append_node_list(&actual, &loaded, 0);
+    bool same = expected.count == actual.count &&
+                memcmp(expected.items, actual.items, expected.count) == 0;
+    nob_sb_free(expected);
+    nob_sb_free(actual);
+    ASSERT(same);
+
+    // An edit that keeps the length must still miss.
+    char *edited = arena_strdup(arena, script);
+    ASSERT(edited != NULL);
+    edited[strlen(edited) - 2] = ' ';
+    ASSERT(!ast_cache_load(load_arena, "ast_cache", nob_sv_from_cstr(edited), &loaded));
+    ASSERT(loaded == NULL);
+
+    // An entry written by another parser version must miss for the same source.
+    const char *entry_path = nob_temp_sprintf("ast_cache/%016llx.ast",
+        (unsigned long long)ast_cache_content_hash(source));
+    Nob_String_Builder entry = {0};
+    ASSERT(nob_read_entire_file(entry_path, &entry));
+    ASSERT(entry.count >= 24);
+    uint64_t other_version = PARSER_AST_VERSION + 1;
+    memcpy(entry.items + 16, &other_version, sizeof(other_version));
+    bool rewritten = nob_write_entire_file(entry_path, entry.items, entry.count);
+    nob_sb_free(entry);
+    ASSERT(rewritten);
+    ASSERT(!ast_cache_load(load_arena, "ast_cache", source, &loaded));
+    ASSERT(loaded == NULL);
+
+    arena_destroy(load_arena);
+    arena_destroy(arena);
+    TEST_PASS();
+}
+
 void run_parser_v2_tests(int *passed, int *failed, int *skipped) {
     Test_Workspace ws = {0};
     char prev_cwd[_TINYDIR_PATH_MAX] = {0};
@@ -290,6 +358,7 @@ void run_parser_v2_tests(int *passed, int *failed, int *skipped) {
     }
 
     test_parser_golden_all_cases(passed, failed, skipped);
+    test_parser_ast_cache_round_trips_tree_and_rejects_changed_source(passed, failed, skipped);
 
     if (!test_ws_leave(prev_cwd)) {
         if (failed) (*failed)++;
@@ -997,6 +997,215 @@ TEST(pipeline_build_graph_snapshot_surfaces_replay_actions) {
     TEST_PASS();
 }
 
+typedef struct {
+    BM_Builder *builder;
+    size_t forwarded;
+    bool failed;
+} Pipeline_Stream_Sink;
+
+static void pipeline_stream_sink(void *userdata, const Event *ev) {
+    Pipeline_Stream_Sink *sink = (Pipeline_Stream_Sink *)userdata;
+    sink->forwarded++;
+    if (!sink->failed && !bm_builder_apply_event(sink->builder, ev)) sink->failed = true;
+}
+
+TEST(pipeline_streaming_sink_builds_same_model_as_batch_stream) {
+    static const char *script =
+        "project(StreamDemo C)\n"
+        "add_library(core STATIC core.c)\n"
+        "target_compile_definitions(core PUBLIC CORE=1)\n"
+        "foreach(i RANGE 3)\n"
+        "  set(NOISE_${i} ${i})\n"
+        "endforeach()\n"
+        "add_executable(app main.c)\n"
+        "target_link_libraries(app PRIVATE core)\n"
+        "enable_testing()\n"
+        "add_test(NAME smoke COMMAND app)\n";
+    Test_Semantic_Pipeline_Config config = {0};
+    Test_Semantic_Pipeline_Fixture fixture = {0};
+    Nob_String_Builder batch_sb = {0};
+    Nob_String_Builder stream_sb = {0};
+
+    test_semantic_pipeline_config_init(&config);
+    ASSERT(test_semantic_pipeline_fixture_from_script(&fixture, script, &config));
+    ASSERT(fixture.eval_ok && fixture.build.freeze_ok);
+    append_model_snapshot(&batch_sb, fixture.build.model);
+
+    Arena *scratch_arena = arena_create(config.scratch_arena_size);
+    Arena *event_arena = arena_create(config.event_arena_size);
+    Arena *builder_arena = arena_create(config.builder_arena_size);
+    Arena *validate_arena = arena_create(config.validate_arena_size);
+    Arena *model_arena = arena_create(config.model_arena_size);
+    ASSERT(scratch_arena && event_arena && builder_arena && validate_arena && model_arena);
+
+    Diag_Sink *diag_sink = bm_diag_sink_create_default(builder_arena);
+    Pipeline_Stream_Sink sink = {0};
+    sink.builder = bm_builder_create(builder_arena, diag_sink);
+    ASSERT(sink.builder != NULL);
+
+    Event ev = {0};
+    pipeline_init_event(&ev, EVENT_DIRECTORY_ENTER, 0);
+    ev.as.directory_enter.source_dir = fixture.source_dir;
+    ev.as.directory_enter.binary_dir = fixture.binary_dir;
+    ASSERT(bm_builder_apply_event(sink.builder, &ev));
+
+    Event_Stream *stream = event_stream_create(event_arena);
+    ASSERT(stream != NULL);
+    event_stream_set_sink(stream, pipeline_stream_sink, &sink, 1u << EVENT_FAMILY_TEST);
+
+    EvalSession_Config eval_cfg = {0};
+    eval_cfg.persistent_arena = event_arena;
+    eval_cfg.source_root = fixture.source_dir;
+    eval_cfg.binary_root = fixture.binary_dir;
+    EvalSession *session = eval_session_create(&eval_cfg);
+    ASSERT(session != NULL);
+
+    EvalExec_Request request = {0};
+    request.scratch_arena = scratch_arena;
+    request.source_dir = fixture.source_dir;
+    request.binary_dir = fixture.binary_dir;
+    request.list_file = fixture.current_file;
+    request.stream = stream;
+    EvalRunResult run = eval_session_run(session, &request, fixture.ast);
+    eval_session_destroy(session);
+    ASSERT(!eval_result_is_fatal(run.result));
+
+    // Every event reached the sink, but only the test family was kept.
+    ASSERT(sink.forwarded == stream->pushed_count);
+    ASSERT(run.emitted_event_count == stream->pushed_count);
+    ASSERT(stream->pushed_count == fixture.stream->count);
+    ASSERT(stream->count == 2);
+    ASSERT(event_stream_get(stream, 0, &ev));
+    ASSERT(ev.h.kind == EVENT_TEST_ENABLE);
+    ASSERT(event_stream_get(stream, 1, &ev));
+    ASSERT(ev.h.kind == EVENT_TEST_ADD);
+
+    pipeline_init_event(&ev, EVENT_DIRECTORY_LEAVE, 0);
+    ev.as.directory_leave.source_dir = fixture.source_dir;
+    ev.as.directory_leave.binary_dir = fixture.binary_dir;
+    ASSERT(!sink.failed);
+    ASSERT(bm_builder_apply_event(sink.builder, &ev));
+
+    const Build_Model_Draft *draft = bm_builder_finalize(sink.builder);
+    ASSERT(draft != NULL);
+    ASSERT(bm_validate_draft(draft, validate_arena, diag_sink));
+    const Build_Model *model = bm_freeze_draft(draft, model_arena, diag_sink);
+    ASSERT(model != NULL);
+    append_model_snapshot(&stream_sb, model);
+
+    ASSERT(batch_sb.count == stream_sb.count);
+    ASSERT(memcmp(batch_sb.items, stream_sb.items, batch_sb.count) == 0);
+
+    nob_sb_free(batch_sb);
+    nob_sb_free(stream_sb);
+    arena_destroy(model_arena);
+    arena_destroy(validate_arena);
+    arena_destroy(builder_arena);
+    arena_destroy(event_arena);
+    arena_destroy(scratch_arena);
+    test_semantic_pipeline_fixture_destroy(&fixture);
+    TEST_PASS();
+}
+
+static bool pipeline_dump_stream(const Event_Stream *stream, Nob_String_Builder *out) {
+    FILE *f = tmpfile();
+    if (!f) return false;
+    Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) event_dump(f, it.current);
+    long size = ftell(f);
+    bool ok = size >= 0 && fseek(f, 0, SEEK_SET) == 0;
+    if (ok) {
+        nob_da_reserve(out, out->count + (size_t)size);
+        ok = fread(out->items + out->count, 1, (size_t)size, f) == (size_t)size;
+        if (ok) out->count += (size_t)size;
+    }
+    fclose(f);
+    return ok;
+}
+
+TEST(pipeline_event_file_round_trip_matches_live_stream) {
+    static const char *script =
+        "project(EventFile C)\n"
+        "set_property(GLOBAL APPEND PROPERTY DEMO_ITEMS alpha beta)\n"
+        "add_library(core STATIC core.c)\n"
+        "target_link_libraries(core PUBLIC $<$<CONFIG:Debug>:m> dl)\n"
+        "add_custom_command(OUTPUT gen.c COMMAND gen --out gen.c)\n"
+        "add_executable(app main.c gen.c)\n"
+        "target_link_libraries(app PRIVATE core)\n"
+        "enable_testing()\n"
+        "add_test(NAME smoke COMMAND app CONFIGURATIONS Debug Release)\n";
+    Test_Semantic_Pipeline_Config config = {0};
+    Test_Semantic_Pipeline_Fixture fixture = {0};
+    Nob_String_Builder live_dump = {0};
+    Nob_String_Builder loaded_dump = {0};
+    Nob_String_Builder live_model = {0};
+    Nob_String_Builder loaded_model = {0};
+    Nob_String_Builder bytes = {0};
+
+    test_semantic_pipeline_config_init(&config);
+    ASSERT(test_semantic_pipeline_fixture_from_script(&fixture, script, &config));
+    ASSERT(fixture.eval_ok && fixture.build.freeze_ok);
+    ASSERT(event_stream_write_file(fixture.build_stream, "events.bin"));
+
+    Arena *load_arena = arena_create(64 * 1024);
+    Arena *builder_arena = arena_create(config.builder_arena_size);
+    Arena *validate_arena = arena_create(config.validate_arena_size);
+    Arena *model_arena = arena_create(config.model_arena_size);
+    ASSERT(load_arena && builder_arena && validate_arena && model_arena);
+
+    const Event_Stream *loaded = event_stream_load_file(load_arena, "events.bin");
+    ASSERT(loaded != NULL);
+    ASSERT(loaded->count == fixture.build_stream->count);
+    ASSERT(arena_arr_len(loaded->records) == loaded->count);
+    ASSERT(loaded->next_seq == fixture.build_stream->next_seq);
+
+    bool saw_test_configs = false;
+    Event_Stream_Iterator it = event_stream_iter(loaded);
+    while (event_stream_next(&it)) {
+        const Event *ev = it.current;
+        if (ev->h.kind != EVENT_TEST_ADD) continue;
+        ASSERT(ev->as.test_add.configuration_count == 2);
+        ASSERT(nob_sv_eq(ev->as.test_add.configurations[1], nob_sv_from_cstr("Release")));
+        ASSERT(ev->as.test_add.name.data[ev->as.test_add.name.count] == '\0');
+        saw_test_configs = true;
+    }
+    ASSERT(saw_test_configs);
+
+    ASSERT(pipeline_dump_stream(fixture.build_stream, &live_dump));
+    ASSERT(pipeline_dump_stream(loaded, &loaded_dump));
+    ASSERT(live_dump.count == loaded_dump.count);
+    ASSERT(memcmp(live_dump.items, loaded_dump.items, live_dump.count) == 0);
+
+    Test_Semantic_Pipeline_Build_Result build = {0};
+    ASSERT(test_semantic_pipeline_build_model_from_stream(builder_arena,
+                                                          validate_arena,
+                                                          model_arena,
+                                                          loaded,
+                                                          &build));
+    append_model_snapshot(&live_model, fixture.build.model);
+    append_model_snapshot(&loaded_model, build.model);
+    ASSERT(live_model.count == loaded_model.count);
+    ASSERT(memcmp(live_model.items, loaded_model.items, live_model.count) == 0);
+
+    // A truncated file is rejected rather than relocated out of bounds.
+    ASSERT(nob_read_entire_file("events.bin", &bytes));
+    ASSERT(nob_write_entire_file("events_truncated.bin", bytes.items, bytes.count - 1));
+    ASSERT(event_stream_load_file(load_arena, "events_truncated.bin") == NULL);
+    ASSERT(event_stream_load_file(load_arena, "missing_events.bin") == NULL);
+
+    nob_sb_free(bytes);
+    nob_sb_free(loaded_model);
+    nob_sb_free(live_model);
+    nob_sb_free(loaded_dump);
+    nob_sb_free(live_dump);
+    arena_destroy(model_arena);
+    arena_destroy(validate_arena);
+    arena_destroy(builder_arena);
+    arena_destroy(load_arena);
+    test_semantic_pipeline_fixture_destroy(&fixture);
+    TEST_PASS();
+}
+
 void run_pipeline_v2_tests(int *passed, int *failed, int *skipped) {
     Test_Workspace ws = {0};
     char prev_cwd[_TINYDIR_PATH_MAX] = {0};
@@ -1020,6 +1229,8 @@ void run_pipeline_v2_tests(int *passed, int *failed, int *skipped) {
     test_pipeline_golden_all_cases(passed, failed, skipped);
     test_pipeline_golden_build_graph_cases(passed, failed, skipped);
     test_pipeline_build_graph_snapshot_surfaces_replay_actions(passed, failed, skipped);
+    test_pipeline_streaming_sink_builds_same_model_as_batch_stream(passed, failed, skipped);
+    test_pipeline_event_file_round_trip_matches_live_stream(passed, failed, skipped);
 
     if (!test_ws_leave(prev_cwd)) {
         if (failed) (*failed)++;
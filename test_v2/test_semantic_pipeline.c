@@ -88,8 +88,9 @@ Event_Stream *test_semantic_pipeline_wrap_stream_with_root(Arena *arena,
     ev.as.directory_enter.binary_dir = binary_dir;
     if (!event_stream_push(wrapped, &ev)) return NULL;
 
-    for (size_t i = 0; i < stream->count; ++i) {
-        if (!event_stream_push(wrapped, &stream->items[i])) return NULL;
+    Event_Stream_Iterator it = event_stream_iter(stream);
+    while (event_stream_next(&it)) {
+        if (!event_stream_push(wrapped, it.current)) return NULL;
     }
 
     test_semantic_pipeline_init_event(&ev, EVENT_DIRECTORY_LEAVE, current_file, 0);